@@ -0,0 +1,325 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        |
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+/******************************************************************************
+ * based on LeMonADE: https://github.com/LeMonADE-project/LeMonADE/
+ * author: Toni Müller
+ * email: mueller-toni@ipfdd.de
+ * project: LeMonADE-Phantom Modulus
+ *****************************************************************************/
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureBox.h>
+#include <LeMonADE/feature/FeatureSystemInformationLinearMeltWithCrosslinker.h>
+
+#include <extern/catchorg/clara/clara.hpp>
+
+#include <LeMonADE_PM/updater/UpdaterReadCrosslinkConnections.h>
+#include <LeMonADE_PM/updater/moves/MoveForceEquilibrium.h>
+#include <LeMonADE_PM/updater/moves/MoveNonLinearForceEquilibrium.h>
+#include <LeMonADE_PM/feature/FeatureCrosslinkConnectionsLookUp.h>
+#include <LeMonADE_PM/analyzer/AnalyzerEquilbratedPosition.h>
+#include <LeMonADE_PM/utility/RunReport.h>
+#include <LeMonADE_PM/utility/EndLinkedNetworkGenerator.h>
+
+typedef LOKI_TYPELIST_3(FeatureBox, FeatureSystemInformationLinearMeltWithCrosslinker, FeatureCrosslinkConnectionsLookUp) Features;
+typedef ConfigureSystem<VectorDouble3,Features,7> Config;
+typedef Ingredients<Config> IngredientsType;
+
+//! keeps the results of the kernels alive
+volatile double sink(0.);
+
+//! discards the output of the kernels during the measurement
+class NullBuffer : public std::streambuf {
+protected:
+	virtual int overflow(int c){return traits_type::not_eof(c);}
+};
+
+//! redirects std::cout to a NullBuffer for the lifetime of the object
+class SilentScope {
+public:
+	SilentScope():original(std::cout.rdbuf(&buffer)){}
+	~SilentScope(){std::cout.rdbuf(original);}
+private:
+	NullBuffer buffer;
+	std::streambuf* original;
+};
+
+/**
+ * @brief times repetitions calls of kernel after one call for warm up
+ * @details prepare is called before each call of kernel and is not timed.
+ * Each call adds to the phase name, its time to the series name and the
+ * items to the counter name/items. The rate name/itemsPerSecond follows.
+ */
+template<class Prepare, class Kernel>
+void measure(RunReport& report, const std::string& name, uint32_t repetitions, double items, Prepare prepare, Kernel kernel){
+	for(uint32_t rep=0; rep<=repetitions; rep++){
+		double seconds(0.);
+		{
+			SilentScope silent;
+			prepare();
+			std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+			kernel();
+			seconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+		}
+		if( rep == 0 ) continue;
+		report.addPhase(name,seconds);
+		report.addValue(name,seconds);
+		report.addCount(name+"/items",items);
+	}
+	report.addRate(name+"/itemsPerSecond",name+"/items",name);
+	RunReport::Phase phase(report.getPhase(name));
+	std::vector<double> series(report.getSeries(name));
+	double fastest(*std::min_element(series.begin(),series.end()));
+	std::cout << std::left << std::setw(32) << name
+	          << " mean " << std::setw(12) << phase.seconds/phase.calls << " s"
+	          << " min " << std::setw(12) << fastest << " s"
+	          << " " << 1e9*fastest/items << " ns/item" << std::endl;
+}
+
+//! nothing to prepare
+void noPreparation(){}
+
+//! read a comma separated list of crosslink numbers (1e5 is accepted)
+std::vector<uint32_t> parseSizes(const std::string& list){
+	std::vector<uint32_t> sizes;
+	std::stringstream ss(list);
+	std::string item;
+	while( std::getline(ss,item,',') ){
+		std::stringstream value(item);
+		double size;
+		value >> size;
+		if( value.fail() || size < 2 || size > UINT32_MAX ){
+			std::stringstream errormessage;
+			errormessage << "parseSizes: cannot read " << item << " in " << list;
+			throw std::runtime_error(errormessage.str());
+		}
+		sizes.push_back(static_cast<uint32_t>(size));
+	}
+	return sizes;
+}
+
+/**
+ * @brief force extension curve in the format of MoveNonLinearForceEquilibrium
+ * @details Pade approximation of the inverse Langevin function of a freely
+ * jointed chain with the segments of a strand and the bond length 2.68.
+ */
+void writeForceExtensionCurve(const std::string& filename, uint32_t nMonomersPerChain){
+	std::ofstream out(filename.c_str());
+	if( !out.good() )
+		throw std::runtime_error("writeForceExtensionCurve: cannot open " + filename);
+	const double bondlength(2.68);
+	const double contourLength(bondlength*(nMonomersPerChain+1));
+	const uint32_t nPoints(1000);
+	out << "#force extension\n";
+	for(uint32_t i=1; i<=nPoints; i++){
+		double x(0.99*static_cast<double>(i)/nPoints);
+		double force(x*(3.-x*x)/(1.-x*x)/bondlength);
+		out << force << " " << x*contourLength << "\n";
+	}
+	if( !out.good() )
+		throw std::runtime_error("writeForceExtensionCurve: cannot write " + filename);
+}
+
+//! true if kernel is in the comma separated list or the list is "all"
+bool isSelected(const std::string& list, const std::string& kernel){
+	if( list == "all" ) return true;
+	std::stringstream ss(list);
+	std::string item;
+	while( std::getline(ss,item,',') )
+		if( item == kernel ) return true;
+	return false;
+}
+
+int main(int argc, char* argv[]){
+	try{
+		///////////////////////////////////////////////////////////////////////////////
+		///parse options///
+		std::string crosslinks("1e3,1e4,1e5");
+		uint32_t functionality(4);
+		uint32_t nMonomersPerChain(32);
+		uint32_t repetitions(5);
+		uint32_t seed(1);
+		std::string kernels("all");
+		std::string output("PhantomModulusBenchmarks.json");
+
+		bool showHelp = false;
+		auto parser
+			= clara::detail::Opt(       crosslinks, "crosslinks (=1e3,1e4,1e5)"          ) ["-n"]["--crosslinks"   ] ("(optional) Comma separated numbers of crosslinks of the networks. Default 1e3,1e4,1e5.").optional()
+			| clara::detail::Opt(    functionality, "functionality (=4)"                 ) ["-f"]["--functionality"] ("(optional) Functionality of the crosslinks (3 to 7). Default 4."                        ).optional()
+			| clara::detail::Opt(nMonomersPerChain, "nMonomersPerChain (=32)"            ) ["-N"]["--chainLength"  ] ("(optional) Monomers per chain (not 2). Default 32."                                   ).optional()
+			| clara::detail::Opt(      repetitions, "repetitions (=5)"                   ) ["-r"]["--repetitions"  ] ("(optional) Timed calls per kernel after one call for warm up. Default 5."              ).optional()
+			| clara::detail::Opt(             seed, "seed (=1)"                          ) ["-s"]["--seed"         ] ("(optional) Seed of the networks and extensions. Default 1."                           ).optional()
+			| clara::detail::Opt(          kernels, "kernels (=all)"                     ) ["-k"]["--kernels"      ] ("(optional) Comma separated kernels: lookup, shiftGauss, shiftNonLinear, forceTable, replay, dump. Default all.").optional()
+			| clara::detail::Opt(           output, "output (=PhantomModulusBenchmarks.json)") ["-o"]["--output"   ] ("(optional) Output filename of the JSON results."                                      ).optional()
+			| clara::Help( showHelp );
+
+	    auto result = parser.parse( clara::Args( argc, argv ) );
+	    if( !result ) {
+	      std::cerr << "Error in command line: " << result.errorMessage() << std::endl;
+	      exit(1);
+	    }else if( functionality < 3 || functionality > 7 || repetitions == 0 ){
+	      std::cerr << "Error in command line: the functionality must be in 3..7 and the repetitions positive" << std::endl;
+	      exit(1);
+	    }else if(showHelp == true){
+	      std::cout << "Benchmarks of the kernels of the force equilibration on synthetic end-linked networks."<< std::endl;
+	      std::cout << "The kernels write their files into the working directory."<< std::endl;
+	      parser.writeToStream(std::cout);
+	      exit(0);
+	    }else{
+	      std::cout << "crosslinks            : " << crosslinks             << std::endl;
+	      std::cout << "functionality         : " << functionality          << std::endl;
+	      std::cout << "nMonomersPerChain     : " << nMonomersPerChain      << std::endl;
+	      std::cout << "repetitions           : " << repetitions            << std::endl;
+	      std::cout << "seed                  : " << seed                   << std::endl;
+	      std::cout << "kernels               : " << kernels                << std::endl;
+	      std::cout << "output                : " << output                 << std::endl;
+	    }
+		std::vector<uint32_t> sizes(parseSizes(crosslinks));
+		const std::string connectionTable("BenchmarkConnections.dat");
+		const std::string feCurve("BenchmarkForceExtension.dat");
+
+		RunReport report;
+		report.addCount("fixture/functionality",functionality);
+		report.addCount("fixture/nMonomersPerChain",nMonomersPerChain);
+		report.addCount("fixture/seed",seed);
+		report.addCount("fixture/repetitions",repetitions);
+
+		for(size_t s=0; s<sizes.size(); s++){
+			std::stringstream suffix;
+			suffix << "/" << sizes[s];
+			///////////////////////////////////////////////////////////////////////////////
+			///fixture///
+			std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+			EndLinkedNetworkGenerator generator(sizes[s],functionality,nMonomersPerChain);
+			generator.generate(seed);
+			IngredientsType ingredients;
+			generator.copyTo(ingredients);
+			{
+				SilentScope silent;
+				ingredients.synchronize();
+			}
+			report.addPhase("fixture"+suffix.str(),std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count());
+			report.addCount("fixture"+suffix.str()+"/monomers",generator.getNumOfMonomers());
+			report.addCount("fixture"+suffix.str()+"/chains",generator.getNumOfChains());
+			std::cout << "network of " << sizes[s] << " crosslinks, " << generator.getNumOfChains() << " chains and "
+			          << generator.getNumOfMonomers() << " monomers in a box of " << generator.getBoxSize()
+			          << " with the conversion " << generator.getConversion() << std::endl;
+			const uint32_t firstCrosslink(generator.getFirstCrosslink());
+			const double nStrands(static_cast<double>(sizes[s])*functionality);
+
+			///////////////////////////////////////////////////////////////////////////////
+			///kernels///
+			//look up table of the strands between the crosslinks (fillTables)
+			if( isSelected(kernels,"lookup") )
+				measure(report,"lookup"+suffix.str(),repetitions,sizes[s],noPreparation,
+					[&](){ingredients.synchronize();});
+			//shift of all crosslinks for the gaussian relation (CalculateShift)
+			if( isSelected(kernels,"shiftGauss") ){
+				MoveForceEquilibrium move;
+				measure(report,"shiftGauss"+suffix.str(),repetitions,sizes[s],noPreparation,[&](){
+					double sum(0.);
+					for(uint32_t i=0; i<sizes[s]; i++){
+						move.init(ingredients,firstCrosslink+i);
+						sum+=move.getShiftVector().getX();
+					}
+					sink=sum;
+				});
+			}
+			//shift of all crosslinks for a force extension curve (CalculateShift and EFBlock)
+			if( isSelected(kernels,"shiftNonLinear") || isSelected(kernels,"forceTable") )
+				writeForceExtensionCurve(feCurve,nMonomersPerChain);
+			if( isSelected(kernels,"shiftNonLinear") ){
+				MoveNonLinearForceEquilibrium move;
+				{
+					SilentScope silent;
+					move.setFilename(feCurve);
+				}
+				measure(report,"shiftNonLinear"+suffix.str(),repetitions,sizes[s],noPreparation,[&](){
+					double sum(0.);
+					for(uint32_t i=0; i<sizes[s]; i++){
+						move.init(ingredients,firstCrosslink+i);
+						sum+=move.getShiftVector().getX();
+					}
+					sink=sum;
+				});
+			}
+			//force extension table for one extension per strand end (EFBlock)
+			if( isSelected(kernels,"forceTable") ){
+				MoveNonLinearForceEquilibrium move;
+				{
+					SilentScope silent;
+					move.setFilename(feCurve);
+				}
+				const uint32_t n(static_cast<uint32_t>(nStrands));
+				std::vector<double> rx(n), ry(n), rz(n), fx(n), fy(n), fz(n);
+				std::mt19937 engine(seed);
+				std::normal_distribution<double> component(0.,2.68*std::sqrt((nMonomersPerChain+1)/3.));
+				for(uint32_t i=0; i<n; i++){
+					rx[i]=component(engine); ry[i]=component(engine); rz[i]=component(engine);
+				}
+				measure(report,"forceTable"+suffix.str(),repetitions,n,noPreparation,[&](){
+					move.EFBlock(&rx[0],&ry[0],&rz[0],&fx[0],&fy[0],&fz[0],n);
+					sink=fx[n-1];
+				});
+			}
+			//replay of the connection table from the disconnected network (UpdaterReadCrosslinkConnections::execute)
+			if( isSelected(kernels,"replay") ){
+				generator.writeConnectionTable(connectionTable);
+				IngredientsType replayIngredients;
+				std::unique_ptr< UpdaterReadCrosslinkConnections<IngredientsType> > updater;
+				measure(report,"replay"+suffix.str(),repetitions,generator.getConnections().size(),[&](){
+					replayIngredients=ingredients;
+					updater.reset(new UpdaterReadCrosslinkConnections<IngredientsType>(replayIngredients,connectionTable,1.,1.));
+					updater->initialize();
+				},[&](){updater->execute();});
+			}
+			//output of the positions and the strands (AnalyzerEquilbratedPosition::dumpData)
+			if( isSelected(kernels,"dump") ){
+				AnalyzerEquilbratedPosition<IngredientsType> analyzer(ingredients,"BenchmarkPositions.dat","BenchmarkDistances.dat");
+				measure(report,"dump"+suffix.str(),repetitions,sizes[s],noPreparation,[&](){analyzer.dumpData();});
+			}
+		}
+		report.write(output);
+		std::cout << "peak memory " << RunReport::getPeakMemoryKB() << " kB, results written to " << output << std::endl;
+	}
+	catch(std::exception& e){
+		std::cerr<<"Error:\n"
+		<<e.what()<<std::endl;
+		return 1;
+	}
+	catch(...){
+		std::cerr<<"Error: unknown exception\n";
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,205 @@
+/******************************************************************************
+ * based on LeMonADE: https://github.com/LeMonADE-project/LeMonADE/
+ * author: Toni Müller
+ * email: mueller-toni@ipfdd.de
+ * project: Phantom modulus
+ *****************************************************************************/
+
+#ifndef LEMONADE_PM_ANALYZER_ANALYZERCROSSLINKFLUCTUATION_H
+#define LEMONADE_PM_ANALYZER_ANALYZERCROSSLINKFLUCTUATION_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+
+#include <LeMonADE/analyzer/AbstractAnalyzer.h>
+#include <LeMonADE/utility/ResultFormattingTools.h>
+
+#include <LeMonADE_PM/utility/NetworkLaplacian.h>
+#include <LeMonADE_PM/utility/NetworkConversion.h>
+
+/*************************************************************************
+ * definition of AnalyzerCrosslinkFluctuation class
+ * ***********************************************************************/
+
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @class AnalyzerCrosslinkFluctuation
+ *
+ * @brief Thermal fluctuations of the crosslinks and strands of a gaussian phantom network
+ *
+ * @details The mean positions of the force equilibration are only half of the
+ * phantom model, the crosslinks fluctuate around them with <dR^2>=b^2 L^+_ii
+ * (see NetworkLaplacian). Both fluctuations are estimated with nProbes random
+ * probes, each one a conjugate gradient solve on the strand table, without any
+ * Monte Carlo sampling. Two tables are written per call of execute, the names
+ * get the conversion as prefix like in AnalyzerEquilbratedPosition:
+ * - crosslinks: ID <dR^2> error
+ * - strands: ID1 ID2 N <dR^2> error <dR^2>/(N b^2)
+ *
+ * The last column of the strands is 2/f for a perfect network of functionality f.
+ * The estimate only depends on the topology, thus it can run before or after
+ * the equilibration.
+ *
+ * @tparam IngredientsType Ingredients class with a crosslink lookup (e.g. FeatureCrosslinkConnectionsLookUp)
+ */
+template < class IngredientsType > class AnalyzerCrosslinkFluctuation : public AbstractAnalyzer
+{
+private:
+	//! reference to the complete system
+	const IngredientsType& ingredients;
+	//! basename of the crosslink table, empty to skip it
+	std::string outputCrossLinks;
+	//! basename of the strand table, empty to skip it
+	std::string outputStrands;
+	//! number of random probes
+	uint32_t nProbes;
+	//! seed of the random probes
+	uint64_t seed;
+	//! relative residual of the conjugate gradient
+	double tolerance;
+	//! average bond length of the strands
+	double bondlength;
+	//! graph and estimate of the last call of execute
+	NetworkLaplacian laplacian;
+public:
+	//! constructor
+	AnalyzerCrosslinkFluctuation(const IngredientsType& ingredients_, 
+		std::string outputCrossLinks_="CrosslinkFluctuation.dat", std::string outputStrands_="StrandFluctuation.dat", uint32_t nProbes_=64);
+
+	//! destructor. does nothing
+	virtual ~AnalyzerCrosslinkFluctuation(){}
+
+	//! does nothing
+	virtual void initialize(){}
+
+	//! Estimates the fluctuations and writes the tables. Called by TaskManager::execute()
+	virtual bool execute();
+
+	//! does nothing, the tables are written in execute
+	virtual void cleanup(){}
+
+	//! fills the graph from the lookup and estimates the fluctuations
+	void estimate();
+	//! graph and estimate of the last call of estimate()
+	const NetworkLaplacian& getLaplacian() const {return laplacian;}
+
+	//! setter for the number of random probes (default 64)
+	void setNumProbes(uint32_t nProbes_){nProbes=nProbes_;}
+	//! getter for the number of random probes
+	uint32_t getNumProbes() const {return nProbes;}
+	//! setter for the seed of the random probes (default 0)
+	void setSeed(uint64_t seed_){seed=seed_;}
+	//! setter for the relative residual of the conjugate gradient (default 1e-6)
+	void setTolerance(double tolerance_){tolerance=tolerance_;}
+	//! setter for the average bond length (default 2.68)
+	void setBondlength(double bondlength_){bondlength=bondlength_;}
+	//! getter for the average bond length
+	double getBondlength() const {return bondlength;}
+
+private:
+	//! conversion as defined in AnalyzerEquilbratedPosition (NetworkConversion)
+	double calculateConversion() const;
+};
+
+/*************************************************************************
+ * implementation of memebers
+ * ***********************************************************************/
+
+/**
+ * @param ingredients_ reference to the object holding all information of the system
+ * @param outputCrossLinks_ basename of the crosslink table, an empty name disables it
+ * @param outputStrands_ basename of the strand table, an empty name disables it
+ * @param nProbes_ number of random probes, the relative error decreases as sqrt(2/nProbes)
+ * */
+template<class IngredientsType>
+AnalyzerCrosslinkFluctuation<IngredientsType>::AnalyzerCrosslinkFluctuation(const IngredientsType& ingredients_, 
+	std::string outputCrossLinks_, std::string outputStrands_, uint32_t nProbes_)
+:ingredients(ingredients_)
+,outputCrossLinks(outputCrossLinks_)
+,outputStrands(outputStrands_)
+,nProbes(nProbes_)
+,seed(0)
+,tolerance(1e-6)
+,bondlength(2.68)
+{}
+
+template<class IngredientsType>
+double AnalyzerCrosslinkFluctuation<IngredientsType>::calculateConversion() const
+{
+	return NetworkConversion::calculate(ingredients);
+}
+
+template<class IngredientsType>
+void AnalyzerCrosslinkFluctuation<IngredientsType>::estimate()
+{
+	laplacian.fill(ingredients);
+	laplacian.estimate(nProbes,seed,tolerance);
+}
+
+template<class IngredientsType>
+bool AnalyzerCrosslinkFluctuation<IngredientsType>::execute()
+{
+	estimate();
+	const double conversion(calculateConversion());
+	const double b2(bondlength*bondlength);
+	const uint32_t nCrossLinks(laplacian.getNumCrossLinks());
+	const uint32_t nStrands(laplacian.getNumStrands());
+
+	std::vector< std::vector<double> > crosslinks(3,std::vector<double>(nCrossLinks));
+	double meanCrossLink(0.0);
+	for (uint32_t n = 0; n < nCrossLinks; n++){
+		crosslinks[0][n]=laplacian.getCrossLinkID(n);
+		crosslinks[1][n]=b2*laplacian.getVariance(n);
+		crosslinks[2][n]=b2*laplacian.getVarianceError(n);
+		meanCrossLink+=crosslinks[1][n];
+	}
+	std::vector< std::vector<double> > strands(6,std::vector<double>(nStrands));
+	double meanReduced(0.0);
+	for (uint32_t e = 0; e < nStrands; e++){
+		const double N(laplacian.getStrandSegments(e));
+		strands[0][e]=laplacian.getStrandID1(e);
+		strands[1][e]=laplacian.getStrandID2(e);
+		strands[2][e]=N;
+		strands[3][e]=b2*laplacian.getResistance(e);
+		strands[4][e]=b2*laplacian.getResistanceError(e);
+		strands[5][e]=laplacian.getResistance(e)/N;
+		meanReduced+=strands[5][e];
+	}
+
+	std::cout << "AnalyzerCrosslinkFluctuation :"<<std::endl;
+	std::cout << "conversion         =" << conversion <<std::endl;
+	std::cout << "probes/iterations  =" << nProbes << "/" << laplacian.getMaxIterations() <<std::endl;
+	std::cout << "<dR2> crosslinks   =" << (nCrossLinks > 0 ? meanCrossLink/nCrossLinks : 0.0) <<std::endl;
+	std::cout << "<dR2/(Nb2)> strands=" << (nStrands > 0 ? meanReduced/nStrands : 0.0) <<std::endl;
+	std::cout << "////////////////////////////////////"<<std::endl;
+
+	if( !outputCrossLinks.empty() ){
+		std::stringstream comment;
+		comment << "Created by AnalyzerCrosslinkFluctuation\n";
+		comment << "conversion=" << conversion << "\n";
+		comment << "fluctuation around the mean position of the phantom network with b=" << bondlength << " from " << nProbes << " probes\n";
+		comment << "ID dR2 error\n";
+		std::stringstream filename;
+		filename << std::setprecision(3) << "C" << conversion << "_" << outputCrossLinks;
+		ResultFormattingTools::writeResultFile(filename.str(), ingredients, crosslinks, comment.str());
+	}
+	if( !outputStrands.empty() ){
+		std::stringstream comment;
+		comment << "Created by AnalyzerCrosslinkFluctuation\n";
+		comment << "conversion=" << conversion << "\n";
+		comment << "fluctuation of the strand vectors of the phantom network with b=" << bondlength << " from " << nProbes << " probes\n";
+		comment << "ID1 ID2 N dR2 error dR2/(Nb2)\n";
+		std::stringstream filename;
+		filename << std::setprecision(3) << "C" << conversion << "_" << outputStrands;
+		ResultFormattingTools::writeResultFile(filename.str(), ingredients, strands, comment.str());
+	}
+	return true;
+}
+
+#endif /*LEMONADE_PM_ANALYZER_ANALYZERCROSSLINKFLUCTUATION_H*/
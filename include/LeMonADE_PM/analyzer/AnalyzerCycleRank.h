@@ -0,0 +1,165 @@
+/******************************************************************************
+ * based on LeMonADE: https://github.com/LeMonADE-project/LeMonADE/
+ * author: Toni Müller
+ * email: mueller-toni@ipfdd.de
+ * project: Phantom modulus
+ *****************************************************************************/
+
+#ifndef LEMONADE_PM_ANALYZER_ANALYZERCYCLERANK_H
+#define LEMONADE_PM_ANALYZER_ANALYZERCYCLERANK_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <sstream>
+
+#include <LeMonADE/analyzer/AbstractAnalyzer.h>
+#include <LeMonADE/utility/ResultFormattingTools.h>
+
+#include <LeMonADE_PM/utility/NetworkClassifier.h>
+#include <LeMonADE_PM/utility/NetworkConversion.h>
+
+/*************************************************************************
+ * definition of AnalyzerCycleRank class
+ * ***********************************************************************/
+
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @class AnalyzerCycleRank
+ *
+ * @brief Cycle rank and phantom modulus of a gaussian network from the topology
+ *
+ * @details The phantom modulus of a gaussian network only depends on its cycle
+ * rank xi (James and Guth), G = xi kT / V. The cycle rank is evaluated on the
+ * elastically active backbone found by NetworkClassifier, no positions are
+ * relaxed:
+ * xi = active strands - active junctions + components of the backbone.
+ * Junctions of two strands do not change xi. For the periodic network every
+ * component adds one to xi, which is a finite size term. Thus nu-mu is also
+ * written, which is the cycle rank per box of the infinite periodic network.
+ * One row per call of execute (i.e. per conversion):
+ * MCS conversion nJunctions nStrands nComponents xi G nu-mu
+ *
+ * @tparam IngredientsType Ingredients class with a crosslink lookup (e.g. FeatureCrosslinkConnectionsLookUp)
+ */
+template < class IngredientsType > class AnalyzerCycleRank : public AbstractAnalyzer
+{
+public:
+	//! number of columns of the summary row
+	enum {NCOLUMNS=8};
+private:
+	//! reference to the complete system
+	const IngredientsType& ingredients;
+	//! name of the output file
+	std::string outputFile;
+	//! true after the header was written
+	bool headerWritten;
+	//! values of the last call of execute
+	std::vector<double> summary;
+public:
+	//! constructor
+	AnalyzerCycleRank(const IngredientsType& ingredients_, std::string outputFile_="CycleRank.dat");
+
+	//! destructor. does nothing
+	virtual ~AnalyzerCycleRank(){}
+
+	//! Initializes data structures. Called by TaskManager::initialize()
+	virtual void initialize(){headerWritten=false;}
+
+	//! Evaluates the cycle rank and appends the row to the output file. Called by TaskManager::execute()
+	virtual bool execute();
+
+	//! does nothing, every row is written in execute
+	virtual void cleanup(){}
+
+	//! classifies the crosslink graph and returns the summary row (see getSummary)
+	std::vector<double> calculateSummary() const;
+
+	//! MCS conversion nJunctions nStrands nComponents xi G nu-mu
+	const std::vector<double>& getSummary() const {return summary;}
+
+	//! setter for the output filename
+	void setFilename(std::string outputFile_){outputFile=outputFile_; headerWritten=false;}
+	//! getter for the output filename
+	std::string getFilename() const {return outputFile;}
+};
+
+/*************************************************************************
+ * implementation of memebers
+ * ***********************************************************************/
+
+/**
+ * @param ingredients_ reference to the object holding all information of the system
+ * @param outputFile_ name of the summary file, an empty name disables the output
+ * */
+template<class IngredientsType>
+AnalyzerCycleRank<IngredientsType>::AnalyzerCycleRank(const IngredientsType& ingredients_, std::string outputFile_)
+:ingredients(ingredients_)
+,outputFile(outputFile_)
+,headerWritten(false)
+,summary(NCOLUMNS,0.0)
+{}
+
+/**
+ * @details The conversion is counted by NetworkConversion.
+ * */
+template<class IngredientsType>
+std::vector<double> AnalyzerCycleRank<IngredientsType>::calculateSummary() const {
+	const auto& molecules(ingredients.getMolecules());
+	NetworkClassifier network;
+	network.classify(ingredients);
+	const double nJunctions(network.getNumActiveCrossLinks());
+	const double nStrands(network.getNumActiveStrands());
+	const double nComponents(network.getNumActiveComponents());
+	const double xi(nStrands-nJunctions+nComponents);
+	const double volume(static_cast<double>(ingredients.getBoxX())*ingredients.getBoxY()*ingredients.getBoxZ());
+
+	std::vector<double> row(NCOLUMNS,0.0);
+	row[0]=molecules.getAge();
+	row[1]=NetworkConversion::calculate(ingredients);
+	row[2]=nJunctions;
+	row[3]=nStrands;
+	row[4]=nComponents;
+	row[5]=xi;
+	row[6]=xi/volume;
+	row[7]=nStrands-nJunctions;
+	return row;
+}
+
+/**
+ * @details The first row creates the file with the header of the ingredients,
+ * all further rows are appended.
+ * */
+template<class IngredientsType>
+bool AnalyzerCycleRank<IngredientsType>::execute()
+{
+	summary=calculateSummary();
+	std::cout << "AnalyzerCycleRank :"<<std::endl;
+	std::cout << "conversion         =" << summary[1] <<std::endl;
+	std::cout << "junctions/strands  =" << summary[2] << "/" << summary[3] <<std::endl;
+	std::cout << "xi                 =" << summary[5] <<std::endl;
+	std::cout << "G                  =" << summary[6] <<std::endl;
+	std::cout << "////////////////////////////////////"<<std::endl;
+	if( outputFile.empty() ) return true;
+
+	std::vector< std::vector<double> > row(NCOLUMNS);
+	for (size_t c = 0; c < NCOLUMNS; c++)
+		row[c].push_back(summary[c]);
+	if( headerWritten ){
+		ResultFormattingTools::appendToResultFile(outputFile, row);
+	}else{
+		std::stringstream comment;
+		comment << "Created by AnalyzerCycleRank\n";
+		comment << "cycle rank xi=strands-junctions+components of the elastically active backbone\n";
+		comment << "phantom modulus G=xi/V in kT per lattice volume, nu-mu is the cycle rank per box of the periodic network\n";
+		comment << "MCS conversion nJunctions nStrands nComponents xi G nu-mu\n";
+		ResultFormattingTools::writeResultFile(outputFile, ingredients, row, comment.str());
+		headerWritten=true;
+	}
+	return true;
+}
+
+#endif /*LEMONADE_PM_ANALYZER_ANALYZERCYCLERANK_H*/
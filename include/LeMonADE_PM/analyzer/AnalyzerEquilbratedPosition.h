@@ -9,6 +9,8 @@
 #define LEMONADE_PM_ANALYZER_ANALYZEREQUILIBRATEPOSITON_H
 
 #include <string>
+#include <iomanip>
+#include <memory>
 
 #include <LeMonADE/utility/Vector3D.h>
 #include <LeMonADE/analyzer/AbstractAnalyzer.h>
@@ -16,6 +18,11 @@
 #include <LeMonADE/utility/MonomerGroup.h>
 #include <LeMonADE/utility/DistanceCalculation.h>
 
+#include <LeMonADE_PM/utility/ColumnarFile.h>
+#include <LeMonADE_PM/utility/AsyncWriter.h>
+#include <LeMonADE_PM/utility/RunReport.h>
+#include <LeMonADE_PM/utility/NetworkConversion.h>
+
 /*************************************************************************
  * definition of AnalyzerEquilbratedPosition class
  * ***********************************************************************/
@@ -46,12 +53,49 @@ private:
 
 	//! reference to the complete system
 	const IngredientsType& ingredients;
+
+	//! binary output of all conversions, NULL for the ASCII output
+	ColumnarFileWriter* binaryWriter;
+	//! name of the binary output file, empty for the ASCII output
+	std::string outBinaryFilename;
+	//! compress the chunks of the binary output with zlib
+	bool binaryCompression;
+	//! store the vectors in the binary output as float instead of double
+	bool binarySinglePrecision;
+	//! conversion and age of the last binary frame, cleanup() must not repeat it
+	double lastBinaryConversion;
+	uint64_t lastBinaryAge;
+
+	//! background thread for the ASCII tables, NULL for synchronous output
+	AsyncWriter* asyncWriter;
+
+	//! snapshot of one ASCII table for the asynchronous output
+	struct TableSnapshot{
+		TableSnapshot(const std::string& filename_, const IngredientsType& ing, const std::string& comment_)
+		:filename(filename_),metaData(ing),comment(comment_){}
+		std::string filename;
+		MetaDataSnapshot metaData;
+		std::string comment;
+		std::vector< std::vector<double> > data;
+	};
+	static void writeTable(const std::shared_ptr<TableSnapshot>& table){
+		ResultFormattingTools::writeResultFile(table->filename, table->metaData, table->data, table->comment);
+	}
+	//! writes the table directly or hands it over to the background thread (data is moved)
+	void writeResultFile(const std::string& filename, std::vector< std::vector<double> >& data, const std::string& comment);
+
+	//! streams the positions and the strands as typed columns into one frame
+	template<class FloatType>
+	void writeBinaryFrame(double conversion);
+	//! writes the segment counts of the strands with the smallest sufficient type
+	template<class SegmentType>
+	void writeSegmentColumn(size_t nStrands);
 public:
 	//! constructor
 	AnalyzerEquilbratedPosition(const IngredientsType& ingredients_, std::string outAvPosBasename_, std::string outDistBasename_);
 
-	//! destructor. does nothing
-	virtual ~AnalyzerEquilbratedPosition(){}
+	//! destructor. closes the binary output
+	virtual ~AnalyzerEquilbratedPosition(){delete asyncWriter; delete binaryWriter;}
 
 	//! Initializes data structures. Called by TaskManager::initialize()
 	virtual void initialize();
@@ -71,6 +115,9 @@ public:
 	//! save the current values in Rg2TimeSeriesX, etc., to disk
 	void dumpData();
 
+	//! fraction of the reacted sites of the crosslinks
+	double calculateConversion() const;
+
 	//! calculates the distance between crosslinks and stores IDs, distance vector and chainID
 	std::vector< std::vector<double> >  CalculateDistance();
 
@@ -82,6 +129,29 @@ public:
         outAvPosBasename= outAvPosBasename_;
         outDistBasename=outDistBasename_;
     }
+
+    /**
+     * @brief write all conversions into one binary file instead of two ASCII files per conversion
+     * @param filename name of the ColumnarFile, an empty name switches back to ASCII
+     * @param compress compress the chunks with zlib (needs LEMONADE_PM_USE_ZLIB)
+     * @param singlePrecision store positions and strand vectors as float
+     */
+    void setBinaryOutput(std::string filename, bool compress=false, bool singlePrecision=true){
+        outBinaryFilename=filename;
+        binaryCompression=compress;
+        binarySinglePrecision=singlePrecision;
+    }
+    //! getter for the name of the binary output
+    std::string getBinaryFilename() const {return outBinaryFilename;}
+
+    /**
+     * @brief write the ASCII tables in a background thread
+     * @param maxQueued number of conversions waiting for the output, 0 for synchronous output
+     */
+    void setAsyncOutput(size_t maxQueued){
+        delete asyncWriter;
+        asyncWriter = (maxQueued > 0) ? new AsyncWriter(maxQueued) : NULL;
+    }
 };
 
 /*************************************************************************
@@ -95,6 +165,13 @@ template<class IngredientsType>
 AnalyzerEquilbratedPosition<IngredientsType>::AnalyzerEquilbratedPosition(
 	const IngredientsType& ingredients_, std::string outAvPosBasename_, std::string outDistBasename_)
 :ingredients(ingredients_)
+,binaryWriter(NULL)
+,outBinaryFilename("")
+,binaryCompression(false)
+,binarySinglePrecision(true)
+,lastBinaryConversion(-1.0)
+,lastBinaryAge(0)
+,asyncWriter(NULL)
 ,outAvPosBasename(outAvPosBasename_)
 ,outDistBasename(outDistBasename_)
 {}
@@ -164,36 +241,123 @@ template<class IngredientsType>
 void AnalyzerEquilbratedPosition<IngredientsType>::cleanup()
 {
   dumpData();
+  //waits for the background thread and reports its errors
+  if( asyncWriter != NULL )
+    asyncWriter->flush();
+  //writes the index of the binary output
+  delete binaryWriter;
+  binaryWriter=NULL;
 }
 
 
 template<class IngredientsType>
-void AnalyzerEquilbratedPosition<IngredientsType>::dumpData()
+double AnalyzerEquilbratedPosition<IngredientsType>::calculateConversion() const
 {
-  	double conversion, NReactedSites(0.0), NReactiveSites(0.0);
-	auto crosslinkID(ingredients.getCrosslinkIDs());
-	std::cout << "Analyze conversion of "<<crosslinkID.size()<<" crosslinks."<<std::endl;
-	for (size_t i = 0 ; i < crosslinkID.size(); i++){
-		auto IDx(crosslinkID[i]);	
-		if( ingredients.getMolecules()[IDx].isReactive()){		
-			uint32_t nIrreversibleBonds=0;
-			for (uint32_t n = 0 ; n < ingredients.getMolecules().getNumLinks(IDx) ;n++){
-				uint32_t neighbor(ingredients.getMolecules().getNeighborIdx(IDx,n));
-				if( ingredients.getMolecules()[neighbor].isReactive() )
-					NReactedSites++;
-				else
-					nIrreversibleBonds++;
-			}
-			NReactiveSites+=(ingredients.getMolecules()[IDx].getNumMaxLinks()-nIrreversibleBonds);
+	std::cout << "Analyze conversion of "<<ingredients.getCrosslinkIDs().size()<<" crosslinks."<<std::endl;
+	NetworkConversion::Sites sites(NetworkConversion::countSites(ingredients));
+	std::cout << "NReactiveSites     =" << sites.reactive <<std::endl;
+	std::cout << "NReactedSites      =" << sites.reacted <<std::endl;
+	return sites.getConversion();
+}
+
+/**
+ * @details Table "positions": ID, x, y, z of the crosslinks. Table "strands": 
+ * ID1, ID2, x, y, z of the strand vector and the number of segments (uint16, 
+ * or uint32 for longer strands). The length of the strands follows from the vector.
+ * */
+template<class IngredientsType>
+template<class FloatType>
+void AnalyzerEquilbratedPosition<IngredientsType>::writeBinaryFrame(double conversion)
+{
+	if( binaryWriter == NULL )
+		binaryWriter = new ColumnarFileWriter(outBinaryFilename, binaryCompression);
+	const std::vector<uint32_t>& crosslinkID(ingredients.getCrosslinkIDs());
+	const size_t nCrossLinks(crosslinkID.size());
+	size_t nStrands(0);
+	uint32_t maxSegments(0);
+	for (size_t i = 0 ; i < nCrossLinks; i++){
+		auto neighbors(ingredients.getCrossLinkNeighborIDs(crosslinkID[i]));
+		nStrands+=neighbors.size();
+		for (size_t j=0; j < neighbors.size() ;j++)
+			if( neighbors[j].segDistance > maxSegments ) maxSegments=neighbors[j].segDistance;
+	}
+
+	binaryWriter->beginFrame(conversion, ingredients.getMolecules().getAge());
+	{
+		std::vector<FloatType> x(nCrossLinks), y(nCrossLinks), z(nCrossLinks);
+		for (size_t i = 0 ; i < nCrossLinks; i++){
+			const VectorDouble3& pos(ingredients.getMolecules()[crosslinkID[i]].getVector3D());
+			x[i]=pos.getX(); y[i]=pos.getY(); z[i]=pos.getZ();
+		}
+		binaryWriter->writeColumn("positions","ID",crosslinkID);
+		binaryWriter->writeColumn("positions","x",x);
+		binaryWriter->writeColumn("positions","y",y);
+		binaryWriter->writeColumn("positions","z",z);
+	}
+	std::vector<uint32_t> ID1, ID2;
+	std::vector<FloatType> x, y, z;
+	ID1.reserve(nStrands); ID2.reserve(nStrands);
+	x.reserve(nStrands); y.reserve(nStrands); z.reserve(nStrands);
+	for (size_t i = 0 ; i < nCrossLinks; i++){
+		auto IDx(crosslinkID[i]);
+		auto neighbors(ingredients.getCrossLinkNeighborIDs(IDx));
+		for (size_t j=0; j < neighbors.size() ;j++){
+			VectorDouble3 vec(ingredients.getMolecules()[neighbors[j].ID].getVector3D()-ingredients.getMolecules()[IDx].getVector3D()-neighbors[j].jump);
+			ID1.push_back(IDx);
+			ID2.push_back(neighbors[j].ID);
+			x.push_back(vec.getX());
+			y.push_back(vec.getY());
+			z.push_back(vec.getZ());
 		}
 	}
-	conversion=NReactedSites/NReactiveSites;
+	binaryWriter->writeColumn("strands","ID1",ID1);
+	binaryWriter->writeColumn("strands","ID2",ID2);
+	binaryWriter->writeColumn("strands","x",x);
+	binaryWriter->writeColumn("strands","y",y);
+	binaryWriter->writeColumn("strands","z",z);
+	if( maxSegments <= 0xFFFF )
+		writeSegmentColumn<uint16_t>(nStrands);
+	else
+		writeSegmentColumn<uint32_t>(nStrands);
+	binaryWriter->endFrame();
+}
+
+template<class IngredientsType>
+template<class SegmentType>
+void AnalyzerEquilbratedPosition<IngredientsType>::writeSegmentColumn(size_t nStrands)
+{
+	const std::vector<uint32_t>& crosslinkID(ingredients.getCrosslinkIDs());
+	std::vector<SegmentType> segments;
+	segments.reserve(nStrands);
+	for (size_t i = 0 ; i < crosslinkID.size(); i++){
+		auto neighbors(ingredients.getCrossLinkNeighborIDs(crosslinkID[i]));
+		for (size_t j=0; j < neighbors.size() ;j++)
+			segments.push_back(neighbors[j].segDistance);
+	}
+	binaryWriter->writeColumn("strands","segments",segments);
+}
+
+template<class IngredientsType>
+void AnalyzerEquilbratedPosition<IngredientsType>::dumpData()
+{
+	LEMONADE_PM_PHASE("output");
+	double conversion(calculateConversion());
 	std::cout << "AnalyzerEquilbratedPosition :"<<std::endl;
-	std::cout << "NReactiveSites     =" << NReactiveSites <<std::endl;
-	std::cout << "NReactedSites      =" << NReactedSites <<std::endl;
 	std::cout << "conversion         =" << conversion <<std::endl;	
 	std::cout << "////////////////////////////////////"<<std::endl;	
 
+	if( !outBinaryFilename.empty() ){
+		if( binaryWriter != NULL && conversion == lastBinaryConversion && ingredients.getMolecules().getAge() == lastBinaryAge )
+			return;
+		if( binarySinglePrecision )
+			writeBinaryFrame<float>(conversion);
+		else
+			writeBinaryFrame<double>(conversion);
+		lastBinaryConversion=conversion;
+		lastBinaryAge=ingredients.getMolecules().getAge();
+		return;
+	}
+
 	//output for the equilibrated positions 
 	std::vector< std::vector<double> > CrossLinkPositions=CollectAveragePositions() ;
 	std::stringstream commentAveragePosition;
@@ -206,12 +370,7 @@ void AnalyzerEquilbratedPosition<IngredientsType>::dumpData()
 	outAvPos << "_" << outAvPosBasename;
 	
 
-	ResultFormattingTools::writeResultFile(
-		outAvPos.str(),
-		ingredients,
-		CrossLinkPositions,
-		commentAveragePosition.str()
-	);
+	writeResultFile(outAvPos.str(), CrossLinkPositions, commentAveragePosition.str());
 			
 	// chain stretching distribution 
 	std::vector< std::vector<double> >  dist=CalculateDistance();
@@ -226,12 +385,23 @@ void AnalyzerEquilbratedPosition<IngredientsType>::dumpData()
 	outDist<<  std::setprecision(3) <<   "C" << conversion;
 	outDist << "_" << outDistBasename;
 
-	ResultFormattingTools::writeResultFile(
-		outDist.str(),
-		ingredients,
-		dist,
-		commentDistribution.str()
-	);
+	writeResultFile(outDist.str(), dist, commentDistribution.str());
+}
+
+/**
+ * @details The asynchronous output gets an immutable snapshot of the table 
+ * and of the meta data of the ingredients, the solver can go on immediately.
+ * */
+template<class IngredientsType>
+void AnalyzerEquilbratedPosition<IngredientsType>::writeResultFile(const std::string& filename, std::vector< std::vector<double> >& data, const std::string& comment)
+{
+	if( asyncWriter == NULL ){
+		ResultFormattingTools::writeResultFile(filename, ingredients, data, comment);
+		return;
+	}
+	std::shared_ptr<TableSnapshot> table(new TableSnapshot(filename, ingredients, comment));
+	table->data.swap(data);
+	asyncWriter->submit(std::bind(&AnalyzerEquilbratedPosition<IngredientsType>::writeTable, table));
 }
 
 #endif /*LEMONADE_PM_ANALYZER_ANALYZEREQUILIBRATEPOSITON_H*/
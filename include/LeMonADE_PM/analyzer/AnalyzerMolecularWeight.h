@@ -37,6 +37,8 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE/utility/DepthIterator.h>
 #include <LeMonADE/analyzer/AnalyzerAbstractDump.h>
 
+#include <LeMonADE_PM/utility/UnionFind.h>
+
 
 /*************************************************************************
  * definition of AnalyzerMolecularWeight class
@@ -49,7 +51,10 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  *
  * @tparam IngredientsType Ingredients class storing all system information( e.g. monomers, bonds, etc).
  * 
- * @details Calculates the number and weight averaged molecular weight.
+ * @details Calculates the molecular weight distribution, the number and weight
+ * averaged molecular weight and the gel fraction (largest molecule) with a 
+ * union-find over the bonds. The distribution is written to the file, the 
+ * averages to its comment.
  *
  */
 template < class IngredientsType > 
@@ -76,6 +81,13 @@ public:
 	//! calculate the moleculare weight distribution
 	virtual void initialize();
   virtual bool execute();
+
+  //! union-find of the last call of execute
+  const UnionFind& getClusters() const {return clusters;}
+
+private:
+  //! clusters of the bonded monomers
+  UnionFind clusters;
 };
 
 /*************************************************************************
@@ -103,18 +115,20 @@ template< class IngredientsType >
 bool AnalyzerMolecularWeight<IngredientsType>::execute()
 {
     double conversion = ingredients.getConversion();
+
+    //calculate the molecular weight distribution 
+    clusters.reset(ingredients.getMolecules().size());
+    clusters.uniteBonds(ingredients.getMolecules());
     std::stringstream comment;
     comment << "Created by AnalyzerMolecularWeight\n"
-            << "conversion=" << conversion << "%";
+            << "conversion=" << conversion << "%\n"
+            << "Mn=" << clusters.getNumberAverage() << "\n"
+            << "Mw=" << clusters.getWeightAverage() << "\n"
+            << "gel fraction=" << clusters.getLargestClusterFraction();
     BaseClass::setComment(comment.str());
 
-    //calculate the molecular weight distribution 
-    std::vector<MonomerGroup<molecules_type> > groups;
-    fill_connected_groups(ingredients.getMolecules(), groups, MonomerGroup<molecules_type>(ingredients.getMolecules()), alwaysTrue());
     //key is the size of the molecule and the value is the number of occurence 
-    std::map<uint32_t,uint32_t> dist;
-    for (auto it=groups.begin(); it!=groups.end();it++ )
-      dist[it->size()]++;
+    std::map<uint32_t,uint32_t> dist(clusters.getSizeDistribution());
     for ( auto&  it : dist )
     {
       Data[0].push_back(it.second);
@@ -125,5 +139,6 @@ bool AnalyzerMolecularWeight<IngredientsType>::execute()
     BaseClass::resetIsFirstFileDump();
     BaseClass::setOutputFilename(output.str());
     dumpTimeSeries();
+    return true;
 }
 #endif
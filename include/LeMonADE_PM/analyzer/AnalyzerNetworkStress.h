@@ -0,0 +1,240 @@
+/******************************************************************************
+ * based on LeMonADE: https://github.com/LeMonADE-project/LeMonADE/
+ * author: Toni Müller
+ * email: mueller-toni@ipfdd.de
+ * project: Phantom modulus
+ *****************************************************************************/
+
+#ifndef LEMONADE_PM_ANALYZER_ANALYZERNETWORKSTRESS_H
+#define LEMONADE_PM_ANALYZER_ANALYZERNETWORKSTRESS_H
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <sstream>
+
+#include <LeMonADE/utility/Vector3D.h>
+#include <LeMonADE/analyzer/AbstractAnalyzer.h>
+#include <LeMonADE/utility/ResultFormattingTools.h>
+
+#include <LeMonADE_PM/utility/neighborX.h>
+#include <LeMonADE_PM/utility/NetworkConversion.h>
+#include <LeMonADE_PM/utility/NetworkStress.h>
+#include <LeMonADE_PM/updater/moves/ForceExtensionPolicies.h>
+
+/*************************************************************************
+ * definition of AnalyzerNetworkStress class
+ * ***********************************************************************/
+
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @class AnalyzerNetworkStress
+ *
+ * @brief Summary of the stress and the phantom modulus of the equilibrated network
+ *
+ * @details Evaluates the strand table of FeatureCrosslinkConnectionsLookUp in one
+ * pass and writes one row per call of execute (i.e. per conversion or strain)
+ * instead of the strand vectors written by AnalyzerEquilbratedPosition:
+ * - conversion (NetworkConversion, same definition as AnalyzerEquilbratedPosition)
+ * - number of strands and of elastically effective strands (R>minExtension)
+ * - sum_strands R^2 and <R^2/(N b^2)> averaged over the effective strands
+ * - virial stress sum_strands f_a R_b / V with the force of ForcePolicy
+ * - phantom modulus G=sum_strands R^2/(N b^2) / V in kT per lattice volume
+ *
+ * UpdaterAffineDeformation does not change the box, thus V is the box volume
+ * times the prestrain factors (setPrestrain).
+ *
+ * Strands between two crosslinks are seen from both ends and get the weight 1/2.
+ * The loop over the crosslinks is an OpenMP reduction, the force policies are
+ * stateless and thus thread safe.
+ *
+ * @tparam IngredientsType Ingredients class storing all system information( e.g. monomers, bonds, etc).
+ * @tparam ForcePolicy force-extension relation of the strands (see ForceExtensionPolicies.h)
+ */
+template < class IngredientsType, class ForcePolicy=GaussianForcePolicy > class AnalyzerNetworkStress : public AbstractAnalyzer
+{
+public:
+	//! number of columns of the summary row
+	enum {NCOLUMNS=16};
+private:
+	//! reference to the complete system
+	const IngredientsType& ingredients;
+	//! name of the output file
+	std::string outputFile;
+	//! average bond length of the strands
+	double bondlength;
+	//! strands with an extension larger than this are elastically effective
+	double minExtension;
+	//! factors of the prestrain of the system, see setPrestrain
+	double prestrainX,prestrainY,prestrainZ;
+	//! true after the header was written
+	bool headerWritten;
+	//! values of the last call of execute
+	std::vector<double> summary;
+public:
+	//! constructor
+	AnalyzerNetworkStress(const IngredientsType& ingredients_, std::string outputFile_="NetworkStress.dat");
+
+	//! destructor. does nothing
+	virtual ~AnalyzerNetworkStress(){}
+
+	//! Initializes data structures. Called by TaskManager::initialize()
+	virtual void initialize();
+
+	//! Evaluates the strands and appends the row to the output file. Called by TaskManager::execute()
+	virtual bool execute();
+
+	//! does nothing, every row is written in execute
+	virtual void cleanup(){}
+
+	//! evaluates the strand table and returns the summary row (see getSummary)
+	std::vector<double> calculateSummary() const;
+
+	//! MCS conversion Lx Ly Lz nStrands nEffective R2 R2/(Nb2) s_xx s_yy s_zz s_xy s_xz s_yz G
+	const std::vector<double>& getSummary() const {return summary;}
+
+	//! setter for the average bond length (default 2.68)
+	void setBondlength(double bondlength_){bondlength=bondlength_;}
+	//! getter for the average bond length
+	double getBondlength() const {return bondlength;}
+	//! setter for the minimum extension of an effective strand (default 0)
+	void setMinExtension(double minExtension_){minExtension=minExtension_;}
+	//! getter for the minimum extension of an effective strand
+	double getMinExtension() const {return minExtension;}
+	//! setter for the factors of the prestrain applied by UpdaterAffineDeformation (default 1)
+	void setPrestrain(double prestrainX_, double prestrainY_, double prestrainZ_){
+		prestrainX=prestrainX_; prestrainY=prestrainY_; prestrainZ=prestrainZ_;
+	}
+	//! setter for the output filename
+	void setFilename(std::string outputFile_){outputFile=outputFile_; headerWritten=false;}
+	//! getter for the output filename
+	std::string getFilename() const {return outputFile;}
+};
+
+/*************************************************************************
+ * implementation of memebers
+ * ***********************************************************************/
+
+/**
+ * @param ing reference to the object holding all information of the system
+ * @param outputFile_ name of the summary file, an empty name disables the output
+ * */
+template<class IngredientsType, class ForcePolicy>
+AnalyzerNetworkStress<IngredientsType,ForcePolicy>::AnalyzerNetworkStress(
+	const IngredientsType& ingredients_, std::string outputFile_)
+:ingredients(ingredients_)
+,outputFile(outputFile_)
+,bondlength(2.68)
+,minExtension(0.0)
+,prestrainX(1.0),prestrainY(1.0),prestrainZ(1.0)
+,headerWritten(false)
+,summary(NCOLUMNS,0.0)
+{}
+
+template<class IngredientsType, class ForcePolicy>
+void AnalyzerNetworkStress<IngredientsType,ForcePolicy>::initialize(){
+	headerWritten=false;
+}
+
+/**
+ * @details The crosslinks are distributed over the threads, every thread
+ * accumulates its strands in private scalars which are summed at the end.
+ * */
+template<class IngredientsType, class ForcePolicy>
+std::vector<double> AnalyzerNetworkStress<IngredientsType,ForcePolicy>::calculateSummary() const {
+	const std::vector<uint32_t>& CrossLinkIDs(ingredients.getCrosslinkIDs());
+	const int64_t nCrossLinks(CrossLinkIDs.size());
+	std::vector<uint8_t> isCrossLink(ingredients.getMolecules().size(),0);
+	for (int64_t i = 0; i < nCrossLinks; i++)
+		isCrossLink[CrossLinkIDs[i]]=1;
+	const double minExtension2(minExtension*minExtension);
+	const auto& molecules(ingredients.getMolecules());
+
+	double nStrands(0.0), nEffective(0.0), sumR2(0.0), sumReducedR2(0.0);
+	double sxx(0.0), syy(0.0), szz(0.0), sxy(0.0), sxz(0.0), syz(0.0);
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic,256) reduction(+:nStrands,nEffective,sumR2,sumReducedR2,sxx,syy,szz,sxy,sxz,syz)
+#endif
+	for (int64_t i = 0; i < nCrossLinks; i++){
+		uint32_t IDx(CrossLinkIDs[i]);
+		std::vector<neighborX> neighbors(ingredients.getCrossLinkNeighborIDs(IDx));
+		VectorDouble3 position(molecules[IDx].getVector3D());
+		for (size_t j = 0; j < neighbors.size(); j++){
+			VectorDouble3 R(molecules[neighbors[j].ID].getVector3D()-position-neighbors[j].jump);
+			double weight( isCrossLink[neighbors[j].ID] ? 0.5 : 1.0 );
+			double R2(R*R);
+			double N(neighbors[j].segDistance);
+			nStrands+=weight;
+			if( R2 <= minExtension2 ) continue;
+			nEffective+=weight;
+			sumR2+=weight*R2;
+			sumReducedR2+=weight*R2/(N*bondlength*bondlength);
+			double k(weight*ForcePolicy::secantStiffness(std::sqrt(R2),N,bondlength));
+			sxx+=k*R.getX()*R.getX();
+			syy+=k*R.getY()*R.getY();
+			szz+=k*R.getZ()*R.getZ();
+			sxy+=k*R.getX()*R.getY();
+			sxz+=k*R.getX()*R.getZ();
+			syz+=k*R.getY()*R.getZ();
+		}
+	}
+	double volume(NetworkStress::volume(ingredients,prestrainX,prestrainY,prestrainZ));
+
+	std::vector<double> row(NCOLUMNS,0.0);
+	row[0]=ingredients.getMolecules().getAge();
+	row[1]=NetworkConversion::calculate(ingredients);
+	row[2]=ingredients.getBoxX();
+	row[3]=ingredients.getBoxY();
+	row[4]=ingredients.getBoxZ();
+	row[5]=nStrands;
+	row[6]=nEffective;
+	row[7]=sumR2;
+	row[8]=(nEffective > 0 ) ? sumReducedR2/nEffective : 0.0;
+	row[9] =sxx/volume;
+	row[10]=syy/volume;
+	row[11]=szz/volume;
+	row[12]=sxy/volume;
+	row[13]=sxz/volume;
+	row[14]=syz/volume;
+	row[15]=sumReducedR2/volume;
+	return row;
+}
+
+/**
+ * @details The first row creates the file with the header of the ingredients,
+ * all further rows are appended.
+ * */
+template<class IngredientsType, class ForcePolicy>
+bool AnalyzerNetworkStress<IngredientsType,ForcePolicy>::execute()
+{
+	summary=calculateSummary();
+	std::cout << "AnalyzerNetworkStress :"<<std::endl;
+	std::cout << "conversion         =" << summary[1] <<std::endl;
+	std::cout << "nEffective/nStrands=" << summary[6] << "/" << summary[5] <<std::endl;
+	std::cout << "<R2/(Nb2)>         =" << summary[8] <<std::endl;
+	std::cout << "G                  =" << summary[15] <<std::endl;
+	std::cout << "////////////////////////////////////"<<std::endl;
+	if( outputFile.empty() ) return true;
+
+	std::vector< std::vector<double> > row(NCOLUMNS);
+	for (size_t c = 0; c < NCOLUMNS; c++)
+		row[c].push_back(summary[c]);
+	if( headerWritten ){
+		ResultFormattingTools::appendToResultFile(outputFile, row);
+	}else{
+		std::stringstream comment;
+		comment << "Created by AnalyzerNetworkStress with the " << ForcePolicy::name() << " force-extension relation\n";
+		comment << "strands between two crosslinks have the weight 1/2, effective strands have R>" << minExtension << "\n";
+		comment << "stress in kT per lattice volume, phantom modulus G=sum R^2/(N b^2)/V with b=" << bondlength << "\n";
+		comment << "MCS conversion Lx Ly Lz nStrands nEffective R2 R2/(Nb2) sigma_xx sigma_yy sigma_zz sigma_xy sigma_xz sigma_yz G\n";
+		ResultFormattingTools::writeResultFile(outputFile, ingredients, row, comment.str());
+		headerWritten=true;
+	}
+	return true;
+}
+
+#endif /*LEMONADE_PM_ANALYZER_ANALYZERNETWORKSTRESS_H*/
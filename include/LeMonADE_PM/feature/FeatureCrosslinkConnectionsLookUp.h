@@ -35,6 +35,8 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE/utility/Vector3D.h>
 #include <LeMonADE_PM/updater/moves/MoveForceEquilibrium.h>
 #include <LeMonADE_PM/utility/neighborX.h>
+#include <LeMonADE_PM/utility/NetworkReduction.h>
+#include <LeMonADE_PM/utility/RunReport.h>
 
 
 /*****************************************************************************/
@@ -69,6 +71,7 @@ public:
 	//! synchronize lookup table
 	template<class IngredientsType>
 	void synchronize(IngredientsType& ingredients) {
+		reduction.clear();
 	  	fillTables(ingredients);
 	};
     //! set the jump vector 
@@ -95,6 +98,18 @@ public:
 	//!get the ID of crosslinks (determined by nConnections>3 and connected to another crosslink)
 	const std::vector<uint32_t>& getCrosslinkIDs() const {return crosslinkIDs;}
 
+	//! reduce the lookup to the elastically active crosslinks, optionally collapse crosslinks with two strands (see NetworkReduction)
+	template<class IngredientsType>
+	void reduceToBackbone(const IngredientsType& ingredients, bool collapseSeries) {
+		reduction.reduce(ingredients, crosslinkIDs, CrossLinkNeighbors, collapseSeries);
+	}
+
+	//! place the crosslinks removed by reduceToBackbone and restore the complete lookup
+	template<class IngredientsType>
+	void restoreFromBackbone(IngredientsType& ingredients) {
+		reduction.restore(ingredients, crosslinkIDs, CrossLinkNeighbors);
+	}
+
 private:
   //! convinience function to fill all tables 
   template<class IngredientsType>
@@ -103,6 +118,8 @@ private:
   std::map<uint32_t,std::vector< neighborX > > CrossLinkNeighbors;
   //!ID for crosslinks
   std::vector<uint32_t> crosslinkIDs;
+  //!removed crosslinks and the complete tables while the lookup is reduced
+  NetworkReduction reduction;
 };
 /**
  *@details  Create look up table 
@@ -112,6 +129,7 @@ void FeatureCrosslinkConnectionsLookUp::fillTables(IngredientsType& ingredients)
 
 	const typename IngredientsType::molecules_type& molecules=ingredients.getMolecules();
 	std::cout << "FeatureCrosslinkConnectionsLookUp::fillTables" <<std::endl;
+	LEMONADE_PM_PHASE("lookup");
 	crosslinkIDs.resize(0);
 	CrossLinkNeighbors.clear();
 	auto nChainMonomers(ingredients.getNumOfMonomersPerChain()*ingredients.getNumOfChains() );
@@ -37,28 +37,41 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  *
  * @details This abstract class provides the three basic functions to create systems: add a single monomer, add a connected monomer and move the system to find some free space.
  * This Updater requires FeatureAttributes.
+ * If the ingredients have a lattice (excluded volume), the updater keeps a bitset
+ * of the lattice sites covered by the monomers (2x2x2 cubes). New monomers are
+ * placed at a position chosen uniformly among the free candidates, i.e. the bond
+ * vectors of the bond set leading to a free cube, instead of retrying random bond
+ * vectors. MoveAddMonomerSc::check is applied to the chosen candidate only, thus 
+ * other features still may reject it. If no candidate is left, the system is moved 
+ * at most maxSystemMoves times (see setMaxSystemMoves) before the placement fails.
+ * Without a lattice all sites are free and every bond vector is a candidate.
  *
  * @tparam IngredientsType
  *
  **/
 
 #include <LeMonADE/updater/AbstractUpdater.h>
-#include <LeMonADE/utility/MonomerGroup.h>
-#include <LeMonADE/utility/DepthIterator.h>
 #include <LeMonADE/utility/Vector3D.h>
 #include <LeMonADE/updater/moves/MoveLocalSc.h>
 #include <LeMonADE/updater/moves/MoveAddMonomerSc.h>
 
+#include <LeMonADE_PM/utility/MonomerReordering.h>
+
 template<class IngredientsType>
 class UpdaterAbstractCreateAllBonds:public AbstractUpdater
 {
 public:
-  UpdaterAbstractCreateAllBonds(IngredientsType& ingredients_):ingredients(ingredients_),lookupFilled(false){}
+  UpdaterAbstractCreateAllBonds(IngredientsType& ingredients_):ingredients(ingredients_),lookupFilled(false),
+  occupancyValid(false),occupancyMonomers(0),occupancyAge(0),maxSystemMoves(10){}
 
   virtual void initialize();
   virtual bool execute();
   virtual void cleanup();
 
+  //! number of moveSystem calls before a placement without free candidates fails
+  void setMaxSystemMoves(uint32_t maxSystemMoves_){maxSystemMoves=maxSystemMoves_;}
+  uint32_t getMaxSystemMoves() const {return maxSystemMoves;}
+
 protected:
   IngredientsType& ingredients;
 
@@ -89,6 +102,9 @@ protected:
   //! function to get a random bondvector of length 2
   VectorInt3 randomBondvector();
 
+  //! true if the cube of a new monomer at pos does not overlap with a monomer (always true without a lattice)
+  bool isFree(const VectorInt3& pos);
+
 private:
 	  RandomNumberGenerators rng;
 
@@ -96,7 +112,34 @@ private:
 	bool lookupFilled;
 	//!set of vectors which are valid for the conformations 
   	std::vector<VectorInt3> bondvectorSet;
-
+	//! fill bondvectorSet from the bond set of the ingredients
+	void fillBondvectorSet();
+
+	//! occupied lattice sites, bit x+X*(y+Y*z) of the folded position
+	std::vector<uint64_t> occupancy;
+	//! false after moveSystem, the occupancy is built again before the next placement
+	bool occupancyValid;
+	//! number of monomers and age of the molecules the occupancy belongs to
+	size_t occupancyMonomers;
+	uint64_t occupancyAge;
+	//! maximum number of moveSystem calls for one placement
+	uint32_t maxSystemMoves;
+
+	//! lattice detection: FeatureLattice provides getLatticeEntry
+	template<class I> static auto hasLattice(const I& ing, int) -> decltype(ing.getLatticeEntry(VectorInt3()), bool()) {return true;}
+	template<class I> static bool hasLattice(const I&, long){return false;}
+	//! index of the folded site or -1 outside of a non periodic box
+	int64_t siteIndex(int32_t x, int32_t y, int32_t z) const;
+	//! build the occupancy if the molecules changed since the last placement
+	void updateOccupancy();
+	//! mark the cube of the monomer at pos as occupied
+	void occupy(const VectorInt3& pos);
+	//! positions origin+b of the bond vectors b which are free and fulfill the condition
+	template<class Condition> void findCandidates(const VectorInt3& origin, Condition condition, std::vector<VectorInt3>& candidates);
+	//! tries the candidates in random order until the add move is accepted, which is then applied
+	bool placeAtCandidate(MoveAddMonomerSc<>& addmove, std::vector<VectorInt3>& candidates);
+	//! add move at pos if it is accepted, the occupancy is updated
+	bool tryPosition(MoveAddMonomerSc<>& addmove, const VectorInt3& pos);
 };
 
 /**
@@ -142,19 +185,27 @@ bool UpdaterAbstractCreateAllBonds<IngredientsType>::addSingleMonomer(int32_t ty
   addmove.init(ingredients);
   addmove.setTag(type);
 
+  updateOccupancy();
   int32_t counter(0);
   while(counter<10000){
     VectorInt3 newPosition((rng.r250_rand32() % (ingredients.getBoxX()-1)),
 				  (rng.r250_rand32() % (ingredients.getBoxY()-1)),
 				  (rng.r250_rand32() % (ingredients.getBoxZ()-1)));
-    addmove.setPosition(newPosition);
-    if(addmove.check(ingredients)==true){
-      addmove.apply(ingredients);
+    if( isFree(newPosition) && tryPosition(addmove,newPosition) )
       return true;
-    }
     counter++;
   }
-  return false;
+  // the box is almost full: draw one of all free positions uniformly (reservoir sampling)
+  VectorInt3 chosen;
+  uint64_t nFree(0);
+  for(int32_t z=0; z<int32_t(ingredients.getBoxZ())-1; z++)
+    for(int32_t y=0; y<int32_t(ingredients.getBoxY())-1; y++)
+      for(int32_t x=0; x<int32_t(ingredients.getBoxX())-1; x++){
+	VectorInt3 position(x,y,z);
+	if( isFree(position) && (rng.r250_rand32() % (++nFree)) == 0 )
+	  chosen=position;
+      }
+  return nFree > 0 && tryPosition(addmove,chosen);
 }
 
 /******************************************************************************/
@@ -171,27 +222,17 @@ bool UpdaterAbstractCreateAllBonds<IngredientsType>::addMonomerToParent(uint32_t
   addmove.init(ingredients);
   addmove.setTag(type);
 
-  int32_t counter(0);
-
-  while(counter<10000){
-    //try at most 30 random bondvectors to find a new monomer position
-    for(uint i=0;i<30;i++){
-      VectorInt3 bondvector(randomBondvector());
-      // set position of new monomer
-      addmove.setPosition(ingredients.getMolecules()[parent_id]+bondvector);
-
-      // check new position (excluded volume)
-      if(addmove.check(ingredients)==true){
-	addmove.apply(ingredients);
-	ingredients.modifyMolecules().connect( parent_id, (ingredients.getMolecules().size()-1) );
-	return true;
-      }
+  std::vector<VectorInt3> candidates;
+  for(uint32_t counter=0; ; counter++){
+    findCandidates(VectorInt3(ingredients.getMolecules()[parent_id]),[](const VectorInt3&){return true;},candidates);
+    if( placeAtCandidate(addmove,candidates) ){
+      ingredients.modifyMolecules().connect( parent_id, (ingredients.getMolecules().size()-1) );
+      return true;
     }
+    if( counter >= maxSystemMoves ) return false;
     // if no position matches, we need to move the system a bit
     moveSystem(2);
-    counter++;
   }
-  return false;
 }
 
 /******************************************************************************/
@@ -207,13 +248,7 @@ bool UpdaterAbstractCreateAllBonds<IngredientsType>::addMonomerAtPosition(Vector
   addmove.init(ingredients);
   addmove.setTag(type);
 
-  addmove.setPosition(position);
-  if(addmove.check(ingredients)==true){
-    addmove.apply(ingredients);
-    return true;
-  }else{
-    return false;
-  }
+  return isFree(position) && tryPosition(addmove,position);
 }
 
 /******************************************************************************/
@@ -234,34 +269,24 @@ bool UpdaterAbstractCreateAllBonds<IngredientsType>::addMonomerInsideConnectedPa
   addmove.init(ingredients);
   addmove.setTag(type);
 
-  int32_t counter(0);
-
-  while(counter<10000){
-    //try at most 30 random bondvectors to find a new monomer position
-    for(uint i=0;i<30;i++){
-      // get a random bondvector
-      VectorInt3 bondvector(randomBondvector());
-      // set position of new monomer
-      addmove.setPosition(ingredients.getMolecules()[indexA]+bondvector);
-
-      // check new position (excluded volume, other features)
-      if(addmove.check(ingredients)==true){
-	//check the new bondvector bewten the new monomer and indexB
-	VectorInt3 checkBV(addmove.getPosition()-ingredients.getMolecules()[indexB]);
-	if( (checkBV.getLength() < 3) && (ingredients.getBondset().isValidStrongCheck(checkBV)) ){
-	  addmove.apply(ingredients);
-	  ingredients.modifyMolecules().connect( indexA, (ingredients.getMolecules().size()-1) );
-	  ingredients.modifyMolecules().connect( indexB, (ingredients.getMolecules().size()-1) );
-	  ingredients.modifyMolecules().disconnect( indexA, indexB );
-	  return true;
-	}
-      }
+  std::vector<VectorInt3> candidates;
+  for(uint32_t counter=0; ; counter++){
+    //the new bondvector between the new monomer and indexB has to be valid, too
+    const VectorInt3 positionB(ingredients.getMolecules()[indexB]);
+    findCandidates(VectorInt3(ingredients.getMolecules()[indexA]),[&](const VectorInt3& position){
+      VectorInt3 checkBV(position-positionB);
+      return (checkBV.getLength() < 3) && (ingredients.getBondset().isValidStrongCheck(checkBV));
+    },candidates);
+    if( placeAtCandidate(addmove,candidates) ){
+      ingredients.modifyMolecules().connect( indexA, (ingredients.getMolecules().size()-1) );
+      ingredients.modifyMolecules().connect( indexB, (ingredients.getMolecules().size()-1) );
+      ingredients.modifyMolecules().disconnect( indexA, indexB );
+      return true;
     }
+    if( counter >= maxSystemMoves ) return false;
     // if no position matches, we need to move the system a bit
     moveSystem(2);
-    counter++;
   }
-  return false;
 }
 /******************************************************************************/
 /**
@@ -281,33 +306,23 @@ bool UpdaterAbstractCreateAllBonds<IngredientsType>::addMonomerAtConnectedPair(u
   addmove.init(ingredients);
   addmove.setTag(type);
 
-  int32_t counter(0);
-
-  while(counter<10000){
-    //try at most 30 random bondvectors to find a new monomer position
-    for(uint i=0;i<30;i++){
-      // get a random bondvector
-      VectorInt3 bondvector(randomBondvector());
-      // set position of new monomer
-      addmove.setPosition(ingredients.getMolecules()[indexA]+bondvector);
-
-      // check new position (excluded volume, other features)
-      if(addmove.check(ingredients)==true){
-	//check the new bondvector between the new monomer and indexB
-	VectorInt3 checkBV(addmove.getPosition()-ingredients.getMolecules()[indexB]);
-	if( (checkBV.getLength() < 3) && (ingredients.getBondset().isValidStrongCheck(checkBV)) ){
-	  addmove.apply(ingredients);
-	  ingredients.modifyMolecules().connect( indexA, (ingredients.getMolecules().size()-1) );
-	  ingredients.modifyMolecules().connect( indexB, (ingredients.getMolecules().size()-1) );
-	  return true;
-	}
-      }
+  std::vector<VectorInt3> candidates;
+  for(uint32_t counter=0; ; counter++){
+    //the new bondvector between the new monomer and indexB has to be valid, too
+    const VectorInt3 positionB(ingredients.getMolecules()[indexB]);
+    findCandidates(VectorInt3(ingredients.getMolecules()[indexA]),[&](const VectorInt3& position){
+      VectorInt3 checkBV(position-positionB);
+      return (checkBV.getLength() < 3) && (ingredients.getBondset().isValidStrongCheck(checkBV));
+    },candidates);
+    if( placeAtCandidate(addmove,candidates) ){
+      ingredients.modifyMolecules().connect( indexA, (ingredients.getMolecules().size()-1) );
+      ingredients.modifyMolecules().connect( indexB, (ingredients.getMolecules().size()-1) );
+      return true;
     }
+    if( counter >= maxSystemMoves ) return false;
     // if no position matches, we need to move the system a bit
     moveSystem(2);
-    counter++;
   }
-  return false;
 }
 /**
  * @brief add a ring threaded on a chain at position of parent monomer
@@ -416,7 +431,7 @@ bool UpdaterAbstractCreateAllBonds<IngredientsType>::addRing(uint32_t parent, in
 			  MoveAddMonomerSc<> addmove;
 			  addmove.init(ingredients);
 			  addmove.setPosition(PotentialPositions[i]);
-			  if(addmove.check(ingredients)==false){PositionsFit=false;}
+			  if(!isFree(PotentialPositions[i]) || addmove.check(ingredients)==false){PositionsFit=false;}
 			}
 			// add ring to system
 			if (PositionsFit)
@@ -480,35 +495,21 @@ void UpdaterAbstractCreateAllBonds<IngredientsType>::moveSystem(int32_t nsteps){
       }
     }
   }
+  occupancyValid=false;
 }
 
 /******************************************************************************/
 /**
  * @brief function to find groups of connected monomers and resort ingredients
  * to write out longest possible bondvector series
+ * @details The groups are stored one after another in depth first order. The 
+ * monomers are renumbered in place (see MonomerReordering), thus no second copy
+ * of the system is created.
  */
 
 template<class IngredientsType>
 void UpdaterAbstractCreateAllBonds<IngredientsType>::linearizeSystem(){
-  //call ingredients copy constructor
-  IngredientsType newIngredients(ingredients);
-
-  //delete all the informations in molecules
-  newIngredients.modifyMolecules().clear();
-
-  std::vector < MonomerGroup<typename IngredientsType::molecules_type> > LinearMonomerGroupsVector;
-
-  fill_connected_groups( ingredients.getMolecules(), LinearMonomerGroupsVector, MonomerGroup<typename IngredientsType::molecules_type>(ingredients.getMolecules()), alwaysTrue() );
-
-  for(size_t groups=0; groups < LinearMonomerGroupsVector.size(); ++groups){
-    if(groups==0)
-      newIngredients.modifyMolecules() = LinearMonomerGroupsVector[groups].copyGroup();
-    else
-      newIngredients.modifyMolecules() += LinearMonomerGroupsVector[groups].copyGroup();
-  }
-
-  ingredients=newIngredients;
-
+  MonomerReordering::apply(ingredients.modifyMolecules(), MonomerReordering::depthFirstOrder(ingredients.getMolecules()));
 }
 
 /******************************************************************************/
@@ -518,6 +519,13 @@ void UpdaterAbstractCreateAllBonds<IngredientsType>::linearizeSystem(){
  */
 template<class IngredientsType>
 VectorInt3 UpdaterAbstractCreateAllBonds<IngredientsType>::randomBondvector(){
+	fillBondvectorSet();
+  	//get a random direction for the bondvector of length 2
+	return bondvectorSet[ rng.r250_rand32() % bondvectorSet.size()] ; 
+}
+
+template<class IngredientsType>
+void UpdaterAbstractCreateAllBonds<IngredientsType>::fillBondvectorSet(){
     if ( lookupFilled == false ){
 		
 		for (auto it=ingredients.getBondset().begin(); it!= ingredients.getBondset().end();it++){
@@ -527,7 +535,109 @@ VectorInt3 UpdaterAbstractCreateAllBonds<IngredientsType>::randomBondvector(){
 		}
 		lookupFilled=true;
     }
-  	//get a random direction for the bondvector of length 2
-	return bondvectorSet[ rng.r250_rand32() % bondvectorSet.size()] ; 
+}
+
+/******************************************************************************/
+/**
+ * @brief index of the lattice site in the occupancy bitset
+ * @details The position is folded into periodic boxes. Sites outside of a 
+ * non periodic box have no index.
+ */
+template<class IngredientsType>
+int64_t UpdaterAbstractCreateAllBonds<IngredientsType>::siteIndex(int32_t x, int32_t y, int32_t z) const{
+  const int64_t boxX(ingredients.getBoxX()), boxY(ingredients.getBoxY()), boxZ(ingredients.getBoxZ());
+  int64_t fx(x), fy(y), fz(z);
+  if( ingredients.isPeriodicX() ) fx=((fx%boxX)+boxX)%boxX; else if( fx < 0 || fx >= boxX ) return -1;
+  if( ingredients.isPeriodicY() ) fy=((fy%boxY)+boxY)%boxY; else if( fy < 0 || fy >= boxY ) return -1;
+  if( ingredients.isPeriodicZ() ) fz=((fz%boxZ)+boxZ)%boxZ; else if( fz < 0 || fz >= boxZ ) return -1;
+  return fx+boxX*(fy+boxY*fz);
+}
+
+/******************************************************************************/
+/**
+ * @brief build the occupancy from all monomers if it does not belong to the current molecules
+ * @details The occupancy is valid as long as monomers are only added by this 
+ * updater. Moves of the system (moveSystem, other updaters) change the age 
+ * or invalidate it explicitly.
+ */
+template<class IngredientsType>
+void UpdaterAbstractCreateAllBonds<IngredientsType>::updateOccupancy(){
+  if( !hasLattice(ingredients,0) ) return;
+  const auto& molecules(ingredients.getMolecules());
+  if( occupancyValid && occupancyMonomers == molecules.size() && occupancyAge == molecules.getAge() ) return;
+  const uint64_t nSites(uint64_t(ingredients.getBoxX())*ingredients.getBoxY()*ingredients.getBoxZ());
+  occupancy.assign((nSites+63)/64,0);
+  occupancyMonomers=0;
+  occupancyValid=true;
+  for(size_t i=0; i<molecules.size(); i++)
+    occupy(VectorInt3(molecules[i]));
+  occupancyAge=molecules.getAge();
+}
+
+template<class IngredientsType>
+void UpdaterAbstractCreateAllBonds<IngredientsType>::occupy(const VectorInt3& pos){
+  occupancyMonomers++;
+  if( !hasLattice(ingredients,0) ) return;
+  for(int32_t dz=0; dz<2; dz++)
+    for(int32_t dy=0; dy<2; dy++)
+      for(int32_t dx=0; dx<2; dx++){
+	const int64_t site(siteIndex(pos.getX()+dx,pos.getY()+dy,pos.getZ()+dz));
+	if( site >= 0 ) occupancy[site/64]|=(uint64_t(1) << (site%64));
+      }
+}
+
+/******************************************************************************/
+/**
+ * @brief true if the 2x2x2 cube at pos is free and inside of the box
+ */
+template<class IngredientsType>
+bool UpdaterAbstractCreateAllBonds<IngredientsType>::isFree(const VectorInt3& pos){
+  if( !hasLattice(ingredients,0) ) return true;
+  updateOccupancy();
+  for(int32_t dz=0; dz<2; dz++)
+    for(int32_t dy=0; dy<2; dy++)
+      for(int32_t dx=0; dx<2; dx++){
+	const int64_t site(siteIndex(pos.getX()+dx,pos.getY()+dy,pos.getZ()+dz));
+	if( site < 0 || ((occupancy[site/64] >> (site%64)) & 1) ) return false;
+      }
+  return true;
+}
+
+template<class IngredientsType>
+template<class Condition>
+void UpdaterAbstractCreateAllBonds<IngredientsType>::findCandidates(const VectorInt3& origin, Condition condition, std::vector<VectorInt3>& candidates){
+  fillBondvectorSet();
+  candidates.clear();
+  for(size_t i=0; i<bondvectorSet.size(); i++){
+    const VectorInt3 position(origin+bondvectorSet[i]);
+    if( isFree(position) && condition(position) )
+      candidates.push_back(position);
+  }
+}
+
+/******************************************************************************/
+/**
+ * @details Rejected candidates are removed, thus at most all candidates are checked once.
+ */
+template<class IngredientsType>
+bool UpdaterAbstractCreateAllBonds<IngredientsType>::placeAtCandidate(MoveAddMonomerSc<>& addmove, std::vector<VectorInt3>& candidates){
+  while( !candidates.empty() ){
+    const size_t k(rng.r250_rand32() % candidates.size());
+    if( tryPosition(addmove,candidates[k]) )
+      return true;
+    candidates[k]=candidates.back();
+    candidates.pop_back();
+  }
+  return false;
+}
+
+template<class IngredientsType>
+bool UpdaterAbstractCreateAllBonds<IngredientsType>::tryPosition(MoveAddMonomerSc<>& addmove, const VectorInt3& pos){
+  addmove.setPosition(pos);
+  if( addmove.check(ingredients) == false ) return false;
+  updateOccupancy();
+  addmove.apply(ingredients);
+  occupy(pos);
+  return true;
 }
 #endif /* LEMONADE_UPDATER_ABSTRACT_CREATE_H */
@@ -49,13 +49,21 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  * @param NBranchPerStar_ number of branches in each star
  * @param type1_ attribute tag of "even" monomers
  * @param type2_ attribute tag of "odd" monomers
+ *
+ * The lengths of the main chain and the branches are drawn from the distribution
+ * of the number of segments between a crosslink and a fixed monomer (see 
+ * calculateSegmentDistribution) by a std::mt19937, which is seeded from the
+ * LeMonADE random number generators at construction.
  **/
 
 // #include <LeMonADE/updater/UpdaterAbstractCreate.h>
 #include <LeMonADE/utility/Vector3D.h>
+#include <algorithm>
 #include <cmath>
+#include <random>
 
 #include <LeMonADE_PM/updater/UpdaterAbstractCreateAllBondVectors.h>
+#include <LeMonADE_PM/utility/DiscreteDistribution.h>
 
 template<class IngredientsType>
 class UpdaterAddTMDoubleStars: public UpdaterAbstractCreateAllBonds<IngredientsType>
@@ -82,13 +90,22 @@ public:
   //! getter function for calculated density
   const double getDensity() const {return density;}
 
+  //! distribution of the branch lengths (filled by initialize)
+  const DiscreteDistribution& getSegmentDistribution() const {return segmentDistribution;}
+
+  //! use the distribution of a previous updater with the same parameters, initialize does not recalculate it
+  void setSegmentDistribution(const DiscreteDistribution& segmentDistribution_);
+
+  //! distribution of the number of segments between a crosslink and a fixed monomer (as used by initialize)
+  static DiscreteDistribution calculateSegmentDistribution(uint32_t NMonoPerBranch, uint32_t nRings);
+
 private:
   // provide access to functions of UpdaterAbstractCreate used in this updater
   using BaseClass::ingredients;
   using BaseClass::addMonomerToParent;
   using BaseClass::addSingleMonomer;
   using BaseClass::linearizeSystem;
-  double prob_q(double n, double N, double m) {
+  static double prob_q(double n, double N, double m) {
         return (m+1.)/(N-n-1.);
     }
     //! number of rings 
@@ -108,17 +125,18 @@ private:
     //! bool for execution
     bool wasExecuted;
 
+    //! true if segmentDistribution was set by setSegmentDistribution
+    bool hasSegmentDistribution;
+
     // adds a chain of with nMonomers monomers to the parentID 
     void createChain(uint parentID, uint32_t nMonomers);
     // add a chain to the system at a random positions 
     void createChain(uint32_t nMonomers);
 
-    //! 
-    const uint32_t steps;
-    //! 
-    std::vector<uint32_t> invCPF;
-    // random number generator (globally seeded)
-    RandomNumberGenerators rng;
+    //! number of segments between a crosslink and a fixed monomer
+    DiscreteDistribution segmentDistribution;
+    //! random number generator for the lengths (seeded by the global r250)
+    std::mt19937 engine;
 };
 
 /**
@@ -140,10 +158,45 @@ UpdaterAddTMDoubleStars<IngredientsType>::UpdaterAddTMDoubleStars(
     uint32_t NBranchPerStar_
     ):
     BaseClass(ingredients_), NStar(NStar_), NMonoPerBranch(NMonoPerBranch_), nRings(nRings_), NBranchPerStar(NBranchPerStar_), 
-    density(0.0), wasExecuted(false),steps(50000)
+    density(0.0), wasExecuted(false), hasSegmentDistribution(false)
     {
-        invCPF.resize(steps-1,0);
+        RandomNumberGenerators rngLeMonADE;
+        engine.seed(rngLeMonADE.r250_rand32());
+    }
+
+template < class IngredientsType >
+void UpdaterAddTMDoubleStars<IngredientsType>::setSegmentDistribution(const DiscreteDistribution& segmentDistribution_){
+    if( segmentDistribution_.empty() )
+        throw std::runtime_error("UpdaterAddTMDoubleStars::setSegmentDistribution: the distribution is empty.");
+    segmentDistribution=segmentDistribution_;
+    hasSegmentDistribution=true;
+}
+
+/**
+* @details The ring of a branch sits at monomer i with probability 
+* q_i*(1-sum_{j<i} p_j), q_i=(nRings+1)/(NMonoPerBranch-i-1). The number of monomers 
+* between the crosslink and the fixed monomer is the sum of two ring positions,
+* thus its distribution is the (exact) convolution of the ring position distribution 
+* with itself.
+*/
+template < class IngredientsType >
+DiscreteDistribution UpdaterAddTMDoubleStars<IngredientsType>::calculateSegmentDistribution(uint32_t NMonoPerBranch, uint32_t nRings){
+    if( NMonoPerBranch < nRings+2 ){
+        std::stringstream errormessage;
+        errormessage << "UpdaterAddTMDoubleStars::calculateSegmentDistribution: " << NMonoPerBranch << " monomers per branch are too few for " << nRings << " rings.";
+        throw std::runtime_error(errormessage.str());
     }
+    //probability distribution function of the ring position
+    std::vector<double> PF((NMonoPerBranch-nRings),0.);
+    double sum(0.);
+    for (uint32_t i = 1; i < (NMonoPerBranch- nRings); i++ ){
+        //q reaches one at the last possible position, the rest stays zero
+        PF[i]=std::min(1.,prob_q(i,NMonoPerBranch,nRings))*std::max(0.,1.-sum);
+        sum+=PF[i];
+    }
+    DiscreteDistribution ringPosition(PF);
+    return DiscreteDistribution::convolve(ringPosition,ringPosition);
+}
 
 /**
 * @brief initialise function, calculate the target density to compare with at the end.
@@ -153,44 +206,8 @@ UpdaterAddTMDoubleStars<IngredientsType>::UpdaterAddTMDoubleStars(
 template < class IngredientsType >
 void UpdaterAddTMDoubleStars<IngredientsType>::initialize(){
   std::cout << "initialize UpdaterAddTMDoubleStars" << std::endl;
-
-
-		//probability distribution function 
-        std::cout << "Calculate PDF" << std::endl;
-		std::vector<double>  PF((NMonoPerBranch-nRings),0);
-        double  sum(0.);
-		for (auto i = 1; i < (NMonoPerBranch- nRings); i++ ){
-            PF[i]=prob_q(i,NMonoPerBranch,nRings)*(1.-sum);
-            // std::cout << "probabilityDisti "<<i<< " "<< PF[i]<< std::endl; 
-            sum+=PF[i];
-		}
-        //calculate convolution of the probability distributions 
-        //convolution distribution function 
-        std::cout << "Calculate convoluted PDF" << std::endl;
-		std::vector<double>  convPF((NMonoPerBranch- nRings)*2,0);
-        for (auto i=0; i < 2*(NMonoPerBranch-nRings);i++){
-            for(auto j=0; j < i ; j++){
-                convPF[i]+=PF[j]*PF[i-j];
-            }
-            // std::cout << "ConvprobabilityDisti "<<i<< " "<< convPF[i]<< std::endl;
-        }
-        //calculate the cummulative distribution function 
-        //cummulative distribution function 
-        std::cout << "Calculate cummulative convoluted PDF" << std::endl;
-		std::vector<double> CPF((NMonoPerBranch- nRings)*2,0);
-		 for (auto i=1; i < 2*(NMonoPerBranch-nRings);i++){
-            CPF[i]+=CPF[i-1]+convPF[i];
-        }
-        //calculate the inverse cummulative convoluted probability distribution 
-        std::cout << "Calculate inverse cummulative convoluted PDF" << std::endl;
-		for (auto i =1 ; i < steps-1; i++) {
-			uint32_t n=0 ;
-			auto prob=static_cast<double> (i) / static_cast<double>(steps ); 
-			while (  prob > CPF [ n ]  ){ n++;}
-			invCPF[i]=(n-1) + static_cast<uint32_t>(round( (n-(n-1)) *(  prob- CPF[n-1] )/(CPF[n]-CPF[n-1]) ));
-			// std::cout << "invCPF: " <<  prob << " " << invCPF[i] <<" "<< n-1 <<" "<<CPF [ n-1 ]<<" "<< n <<" "<<CPF [ n ]<< std::endl;
-		}
-
+  if( !hasSegmentDistribution )
+    segmentDistribution=calculateSegmentDistribution(NMonoPerBranch,nRings);
   execute();
 }
 
@@ -223,7 +240,7 @@ bool UpdaterAddTMDoubleStars<IngredientsType>::execute(){
     //keeps track on the monomers which are added during the procedure 
     auto nAddedMonomers(0);
     for(uint32_t i=0;i<NStar;i++){
-        auto mainChainLength(invCPF[rng.r250_rand32() % steps ]);
+        auto mainChainLength(segmentDistribution(engine));
         nAddedMonomers+=mainChainLength;
         std::cout << "UpdaterAddTMDoubleStars: mainChainLength " << mainChainLength <<std::endl;
         //the next two variables are needed for adding NBranchPerStar-1 chains to this monomers 
@@ -237,13 +254,13 @@ bool UpdaterAddTMDoubleStars<IngredientsType>::execute(){
         auto end(ingredients.getMolecules().size()-1);
         std::cout << "End: " <<  end <<std::endl; 
         for (uint32_t j=0; j < NBranchPerStar-1; j++){
-            auto chainLength(invCPF[rng.r250_rand32() % steps ]+1);
+            auto chainLength(segmentDistribution(engine)+1);
             nAddedMonomers+=chainLength;
             createChain(start,chainLength);
             ingredients.modifyMolecules()[ ingredients.getMolecules().size()-1 ].setMovableTag(false);  
         }
         for (uint32_t j=0; j < NBranchPerStar-1; j++){
-            auto chainLength(invCPF[rng.r250_rand32() % steps ]+1);
+            auto chainLength(segmentDistribution(engine)+1);
             nAddedMonomers+=chainLength;
             createChain(end,chainLength);
             ingredients.modifyMolecules()[ ingredients.getMolecules().size()-1 ].setMovableTag(false);  
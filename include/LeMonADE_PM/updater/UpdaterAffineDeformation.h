@@ -31,6 +31,7 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE/updater/AbstractUpdater.h>
 #include <LeMonADE/utility/Vector3D.h>
 #include <LeMonADE_PM/utility/neighborX.h>
+#include <LeMonADE_PM/utility/RunReport.h>
 #include <vector>
 #include <cmath>
  /**
@@ -90,6 +91,7 @@ private:
 template <class IngredientsType>
 bool UpdaterAffineDeformation<IngredientsType>::execute(){
     std::cout << "UpdaterAffineDeformation<IngredientsType>::initialize():"<< std::endl;
+    LEMONADE_PM_PHASE("deformation");
     //adjusting the box size is not neccessary, because it is used only once in the FeatureCrosslinkConnections*
     //there the jump vectors are calculated
     
@@ -119,5 +121,6 @@ bool UpdaterAffineDeformation<IngredientsType>::execute(){
             std::cout << " deformed position " << ing.getMolecules()[i].getVector3D() << "\n";  
     }
     std::cout << "UpdaterAffineDeformation<IngredientsType>::initialize():done.\n";
+    return true;
 }
 #endif /*LEMONADE_PM_UPDATER_UPDATERAFFINEDEFORMATION_H*/
\ No newline at end of file
@@ -0,0 +1,406 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+#ifndef LEMONADE_PM_UPDATER_UPDATERCYCLERANKCURVE_H
+#define LEMONADE_PM_UPDATER_UPDATERCYCLERANKCURVE_H
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <LeMonADE/updater/AbstractUpdater.h>
+#include <LeMonADE/utility/ResultFormattingTools.h>
+#include <LeMonADE/utility/Vector3D.h>
+
+/**
+ * @class UpdaterCycleRankCurve
+ * @brief cycle rank and gaussian phantom modulus versus conversion from the connection history
+ * 
+ * @details Replays the connection file (same format as for UpdaterReadCrosslinkConnections:
+ *     #Time, ChainID, MonID1, P1X, P1Y, P1Z, MonID2, P2X, P2Y, P2Z)
+ * once, like UpdaterGelationCurve, instead of rebuilding the partial networks.
+ * The ingredients contain the final network, all bonds between reactive monomers
+ * are the reactions of the file. A strand between two crosslinks is formed by the
+ * reaction of the second end of a chain. The crosslinks are kept in a union-find
+ * which stores the periodic image of every crosslink relative to its root, the
+ * image shift of a strand is taken from the positions of the final network along
+ * the chain (minimum image of every bond). A component wraps the periodic box as
+ * soon as a strand closes a cycle with an image shift. 
+ * 
+ * The cycle rank is xi = sum (strands - crosslinks + 1) over the wrapping components, 
+ * which equals the cycle rank of the percolating backbone of AnalyzerCycleRank: 
+ * dangling crosslinks and strands do not change xi and finite components are left out. 
+ * Only cycles which hang at a wrapping component by a single strand are counted
+ * here and not by AnalyzerCycleRank. G=xi/V is the phantom modulus in kT per lattice volume.
+ * A row is written for every conversion bin of width stepwidth (0: every reaction):
+ *     MCS conversion nCrossLinks nStrands nComponents xi G nu-mu
+ * where nCrossLinks, nStrands and nComponents belong to the wrapping components 
+ * and nu-mu=nStrands-nCrossLinks.
+ */
+template <class IngredientsType>
+class UpdaterCycleRankCurve : public AbstractUpdater
+{
+public:
+    UpdaterCycleRankCurve(
+        const IngredientsType& ing_, 
+        const std::string input_, 
+        const std::string output_="CycleRank.dat", 
+        const double stepwidth_=0.0): 
+        ing(ing_), 
+        input(input_), 
+        output(output_), 
+        stepwidth(stepwidth_),
+        NMaxConnection(0),
+        NMonomerPerChain(1),
+        nWrappingCrossLinks(0),
+        nWrappingStrands(0),
+        nWrappingComponents(0),
+        results(8,std::vector<double>()){};
+    virtual void initialize();
+    //! replays the complete file, thus returns always false
+    virtual bool execute();
+    virtual void cleanup(){};
+
+    //! MCS conversion nCrossLinks nStrands nComponents xi G nu-mu
+    const std::vector< std::vector<double> >& getResults() const {return results;}
+    //! cycle rank after the last reaction
+    int64_t getCycleRank() const {return nWrappingStrands-nWrappingCrossLinks+nWrappingComponents;}
+
+private:
+  //! crosslink and chain monomer of a reacted chain end
+  struct ChainEnd{
+    uint32_t crossLink;
+    uint32_t monomer;
+  };
+
+  //! container storing system information about monomers
+  const IngredientsType& ing;
+
+  //! connection file 
+  const std::string input;
+
+  //! output file 
+  const std::string output;
+
+  //! width of the conversion bins
+  const double stepwidth;
+
+  //!number of maximum connections for a cross link
+  uint32_t NMaxConnection;
+
+  //!numbe of monomers per chain 
+  uint32_t NMonomerPerChain;
+
+  //!bond Table: key is crosslink and chainID, value the chain monomers bonded to the crosslink 
+  std::map<std::pair<uint32_t,uint32_t>,std::vector<uint32_t> > bondTable;
+
+  //! number of the used entries of the bond table
+  std::map<std::pair<uint32_t,uint32_t>,uint32_t > usedBonds;
+
+  //! first reacted end of every chain, the crosslink is NO_CROSSLINK before
+  std::vector<ChainEnd> firstEnds;
+
+  //! node of the union-find for a monomer ID, -1 for crosslinks without reaction
+  std::vector<int32_t> nodeIndex;
+  //! parent node in the union-find
+  std::vector<uint32_t> parent;
+  //! periodic image of the node relative to its parent
+  std::vector<VectorInt3> image;
+  //! crosslinks, strands and the wrapping flag of the roots
+  std::vector<uint32_t> nCrossLinks;
+  std::vector<uint32_t> nStrands;
+  std::vector<bool> wraps;
+
+  //! sums over the wrapping components
+  int64_t nWrappingCrossLinks, nWrappingStrands, nWrappingComponents;
+
+  //! result table
+  std::vector< std::vector<double> > results;
+
+  enum {NO_CROSSLINK=0xFFFFFFFFu};
+
+  //! chain monomer bonded by the reaction of the cross link with the chain, NO_CROSSLINK if there is none
+  uint32_t ConnectCrossLinkToChain(uint32_t MonID, uint32_t chainID);
+
+  //! node of the crosslink, a new single node at its first reaction
+  uint32_t getNode(uint32_t MonID);
+  //! root of the node, image becomes the periodic image of the node relative to the root
+  uint32_t find(uint32_t node, VectorInt3& nodeImage);
+  //! adds the strand between the crosslinks crossing shift periodic images
+  void addStrand(uint32_t MonID1, uint32_t MonID2, const VectorInt3& shift);
+  //! adds or removes the root to the sums of the wrapping components
+  void count(uint32_t root, int64_t sign);
+
+  //! periodic images crossed by the strand from the crosslink of end1 along the chain to the crosslink of end2
+  VectorInt3 getImageShift(const ChainEnd& end1, const ChainEnd& end2) const;
+
+  //! stores the current state as a row
+  void addRow(uint32_t Time, double conversion);
+};
+
+/**
+ * @details Same choice of the chain monomer as UpdaterReadCrosslinkConnections: 
+ * the first bond of the table and for the second reaction with the same chain
+ * the second bond.
+ * */
+template <class IngredientsType>
+uint32_t UpdaterCycleRankCurve<IngredientsType>::ConnectCrossLinkToChain(uint32_t MonID, uint32_t chainID){
+    std::pair<uint32_t,uint32_t> key(MonID,chainID);
+    auto entry(bondTable.find(key));
+    if ( entry == bondTable.end() ) 
+        return NO_CROSSLINK;
+    uint32_t& used(usedBonds[key]);
+    if ( used >= entry->second.size() ) 
+        return NO_CROSSLINK;
+    used++;
+    return entry->second[used-1];
+}
+
+template <class IngredientsType>
+uint32_t UpdaterCycleRankCurve<IngredientsType>::getNode(uint32_t MonID){
+    if ( nodeIndex[MonID] < 0 ){
+        nodeIndex[MonID]=parent.size();
+        parent.push_back(parent.size());
+        image.push_back(VectorInt3(0,0,0));
+        nCrossLinks.push_back(1);
+        nStrands.push_back(0);
+        wraps.push_back(false);
+    }
+    return nodeIndex[MonID];
+}
+
+/**
+ * @details Path halving, the images along the path are added up.
+ * */
+template <class IngredientsType>
+uint32_t UpdaterCycleRankCurve<IngredientsType>::find(uint32_t node, VectorInt3& nodeImage){
+    nodeImage=VectorInt3(0,0,0);
+    while ( parent[node] != node ){
+        uint32_t next(parent[node]);
+        if ( parent[next] != next ){
+            image[node]=image[node]+image[next];
+            parent[node]=parent[next];
+        }
+        nodeImage=nodeImage+image[node];
+        node=parent[node];
+    }
+    return node;
+}
+
+template <class IngredientsType>
+void UpdaterCycleRankCurve<IngredientsType>::count(uint32_t root, int64_t sign){
+    if ( !wraps[root] ) return;
+    nWrappingCrossLinks+=sign*nCrossLinks[root];
+    nWrappingStrands+=sign*nStrands[root];
+    nWrappingComponents+=sign;
+}
+
+/**
+ * @details The strand puts the crosslink 2 at the image of the crosslink 1 plus shift. 
+ * Within one component a cycle wraps if this differs from the stored image.
+ * */
+template <class IngredientsType>
+void UpdaterCycleRankCurve<IngredientsType>::addStrand(uint32_t MonID1, uint32_t MonID2, const VectorInt3& shift){
+    VectorInt3 image1, image2;
+    uint32_t root1(find(getNode(MonID1),image1));
+    uint32_t root2(find(getNode(MonID2),image2));
+    count(root1,-1);
+    if ( root1 == root2 ){
+        nStrands[root1]++;
+        if ( !(image1+shift == image2) )
+            wraps[root1]=true;
+    }else{
+        count(root2,-1);
+        //union by size, the image of the new child is relative to the new root
+        VectorInt3 childImage(image1+shift-image2);
+        if ( nCrossLinks[root1] < nCrossLinks[root2] ){
+            std::swap(root1,root2);
+            childImage=VectorInt3(0,0,0)-childImage;
+        }
+        parent[root2]=root1;
+        image[root2]=childImage;
+        nCrossLinks[root1]+=nCrossLinks[root2];
+        nStrands[root1]+=nStrands[root2]+1;
+        wraps[root1]=wraps[root1] || wraps[root2];
+    }
+    count(root1,1);
+}
+
+/**
+ * @details The bonds are short compared to the box, thus their minimum images are 
+ * the bond vectors. The difference of the end of this path to the position of the 
+ * second crosslink are whole boxes.
+ * */
+template <class IngredientsType>
+VectorInt3 UpdaterCycleRankCurve<IngredientsType>::getImageShift(const ChainEnd& end1, const ChainEnd& end2) const {
+    const auto& molecules(ing.getMolecules());
+    const double boxX(ing.getBoxX()), boxY(ing.getBoxY()), boxZ(ing.getBoxZ());
+    std::vector<uint32_t> path;
+    path.push_back(end1.crossLink);
+    if ( end1.monomer <= end2.monomer )
+        for (uint32_t m=end1.monomer; m<=end2.monomer; m++) path.push_back(m);
+    else
+        for (uint32_t m=end1.monomer+1; m-- > end2.monomer; ) path.push_back(m);
+    path.push_back(end2.crossLink);
+    //minimum image of a bond component and whole boxes of a distance
+    auto minImage=[](double bond, double box){return bond-box*std::floor(bond/box+0.5);};
+    auto nImages=[](double distance, double box){return static_cast<int32_t>(std::floor(distance/box+0.5));};
+    VectorDouble3 position(molecules[end1.crossLink].getVector3D());
+    for (size_t k=1; k<path.size(); k++){
+        VectorDouble3 bond(molecules[path[k]].getVector3D()-molecules[path[k-1]].getVector3D());
+        position+=VectorDouble3(minImage(bond.getX(),boxX),minImage(bond.getY(),boxY),minImage(bond.getZ(),boxZ));
+    }
+    VectorDouble3 distance(position-molecules[end2.crossLink].getVector3D());
+    return VectorInt3(nImages(distance.getX(),boxX),nImages(distance.getY(),boxY),nImages(distance.getZ(),boxZ));
+}
+
+template <class IngredientsType>
+void UpdaterCycleRankCurve<IngredientsType>::addRow(uint32_t Time, double conversion){
+    const double volume(static_cast<double>(ing.getBoxX())*ing.getBoxY()*ing.getBoxZ());
+    results[0].push_back(Time);
+    results[1].push_back(conversion);
+    results[2].push_back(nWrappingCrossLinks);
+    results[3].push_back(nWrappingStrands);
+    results[4].push_back(nWrappingComponents);
+    results[5].push_back(getCycleRank());
+    results[6].push_back(getCycleRank()/volume);
+    results[7].push_back(nWrappingStrands-nWrappingCrossLinks);
+}
+
+/**
+ * @brief tabulates the bonds which are created by the reactions
+ * */
+template <class IngredientsType>
+void UpdaterCycleRankCurve<IngredientsType>::initialize(){
+    //assume a stochiometric mixture
+    NMaxConnection=ing.getFunctionality()*ing.getNumOfCrosslinks();
+    NMonomerPerChain = ing.getNumOfMonomersPerChain();
+    if ( NMaxConnection == 0 || NMonomerPerChain == 0 ){
+        std::stringstream errormessage;
+        errormessage << "UpdaterCycleRankCurve: the system information is missing: " 
+                     << NMaxConnection << " maximum connections and " << NMonomerPerChain << " monomers per chain.\n";
+        throw std::runtime_error(errormessage.str());
+    }
+    const auto& molecules(ing.getMolecules());
+    bondTable.clear();
+    usedBonds.clear();
+    for (uint32_t i =0 ; i <  molecules.size(); i++)
+        for(size_t j=0; j < molecules.getNumLinks(i);j++){
+            uint32_t neighbor(molecules.getNeighborIdx(i,j));
+            if ( neighbor < i ) continue;
+            if ( molecules[i].isReactive() && molecules[neighbor].isReactive() ){
+                uint32_t chainMonomer(i);
+                uint32_t chainID( (chainMonomer-chainMonomer%NMonomerPerChain)/NMonomerPerChain);
+                bondTable[std::pair<uint32_t,uint32_t>(neighbor,chainID) ].push_back(chainMonomer) ;
+            }
+        }
+    ChainEnd unreacted={NO_CROSSLINK,0};
+    firstEnds.assign(ing.getNumOfChains(),unreacted);
+    nodeIndex.assign(molecules.size(),-1);
+    parent.clear();
+    image.clear();
+    nCrossLinks.clear();
+    nStrands.clear();
+    wraps.clear();
+    nWrappingCrossLinks=0;
+    nWrappingStrands=0;
+    nWrappingComponents=0;
+    std::cout << "UpdaterCycleRankCurve: " << bondTable.size() << " crosslink-chain pairs are created by reactions." <<std::endl;
+}
+
+/**
+ * @brief reads the connection file once and writes the cycle rank curve
+ * */
+template <class IngredientsType>
+bool UpdaterCycleRankCurve<IngredientsType>::execute(){
+    std::ifstream stream;
+    stream.open(input);
+    if (stream.fail())
+      throw std::runtime_error(std::string("error opening input file ") + input + std::string("\n"));
+    for (size_t c = 0; c < results.size(); c++)
+        results[c].clear();
+    addRow(0,0.0);
+    uint32_t NewConnections(0), Time(0);
+    double nextConversion(stepwidth);
+    bool lastStored(true);
+    std::string line;
+    while ( std::getline(stream, line) ){
+        if (line.empty() || line.at(0) == '#')
+            continue;
+        std::stringstream ss(line);
+        uint32_t ChainID, MonID1, P1X, P1Y, P1Z, MonID2, P2X, P2Y, P2Z;
+        ss >> Time >> ChainID >> MonID1 >> P1X >> P1Y >> P1Z >> MonID2 >> P2X >> P2Y >> P2Z;
+        if ( ss.fail() || ChainID >= firstEnds.size() ){
+            std::stringstream errormessage;
+            errormessage << "UpdaterCycleRankCurve: cannot read the line \"" << line << "\" of " << input << "\n";
+            throw std::runtime_error(errormessage.str());
+        }
+        ChainEnd end={MonID1,ConnectCrossLinkToChain(MonID1, ChainID)};
+        if ( end.monomer == NO_CROSSLINK ){
+            end.crossLink=MonID2;
+            end.monomer=ConnectCrossLinkToChain(MonID2, ChainID);
+        }
+        if ( end.monomer == NO_CROSSLINK ) {
+            std::stringstream errormessage;
+            errormessage << "There was no such a connection in the bfm file for monomer ID= " << MonID1  <<" with ID=" << MonID2 <<  " with chainID=" << ChainID<< "\n";
+            throw std::runtime_error(errormessage.str());
+        }
+        getNode(end.crossLink);
+        if ( firstEnds[ChainID].crossLink == NO_CROSSLINK )
+            firstEnds[ChainID]=end;
+        else
+            addStrand(firstEnds[ChainID].crossLink,end.crossLink,getImageShift(firstEnds[ChainID],end));
+        NewConnections++;
+        double conversion(static_cast<double>(NewConnections)/NMaxConnection);
+        lastStored=false;
+        if ( stepwidth <= 0.0 || conversion >= nextConversion ){
+            addRow(Time,conversion);
+            lastStored=true;
+            while ( stepwidth > 0.0 && nextConversion <= conversion ) 
+                nextConversion += stepwidth;
+        }
+    }
+    if ( !lastStored )
+        addRow(Time,static_cast<double>(NewConnections)/NMaxConnection);
+    stream.close();
+    std::cout << "UpdaterCycleRankCurve: " << NewConnections << "/" << NMaxConnection 
+              << " reactions, cycle rank " << getCycleRank() << " in " << nWrappingComponents << " wrapping components" << std::endl;
+
+    if ( !output.empty() ){
+        std::stringstream comment;
+        comment << "Created by UpdaterCycleRankCurve from " << input << "\n";
+        comment << "cycle rank xi=strands-crosslinks+components of the components wrapping the periodic box\n";
+        comment << "phantom modulus G=xi/V in kT per lattice volume, nu-mu is the cycle rank per box of the periodic network\n";
+        comment << "MCS conversion nCrossLinks nStrands nComponents xi G nu-mu\n";
+        ResultFormattingTools::writeResultFile(output, ing, results, comment.str());
+    }
+    return false;
+}
+
+#endif /*LEMONADE_PM_UPDATER_UPDATERCYCLERANKCURVE_H*/
@@ -29,10 +29,30 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 
 
 #include <LeMonADE/updater/AbstractUpdater.h>
+#include <LeMonADE/utility/RandomNumberGenerators.h>
+#include <LeMonADE_PM/utility/ForceEquilibriumCheckpoint.h>
+#include <LeMonADE_PM/utility/RunReport.h>
 #include <vector>
+#include <random>
+#include <sstream>
+#include <stdexcept>
  /**
  * @class UpdaterForceBalancedPosition
+ * @brief Moves the crosslinks until the average shift per sweep drops below the threshold.
+ * @details The crosslinks are picked by a std::mt19937, which is seeded from the
+ * LeMonADE random number generators at construction. In contrast to the r250 its
+ * state can be serialized, such that a checkpoint (see setCheckpoint) contains
+ * everything needed to continue the equilibration with setRestart.
+ * Each call of execute is counted as one conversion (or strain) step.
+ * With setPruning the crosslink lookup is reduced to the elastically active
+ * backbone before the equilibration and the removed crosslinks are placed
+ * afterwards (see NetworkReduction). The lookup feature has to provide
+ * reduceToBackbone and restoreFromBackbone.
+ * With LEMONADE_PM_INSTRUMENTATION the equilibration and every sweep are timed,
+ * the moves are counted and the sum of the shifts per sweep is reported as
+ * residual (see RunReport).
  * @tparam IngredientsType
+ * @tparam moveType
  */
 
  template <class IngredientsType, class moveType >
@@ -41,7 +61,20 @@ class UpdaterForceBalancedPosition:public AbstractUpdater
 public:
     //! constructor for UpdaterForceBalancedPosition
     UpdaterForceBalancedPosition(IngredientsType& ing_, double threshold_ , double decreaseFactor_=1.0):
-    ing(ing_),threshold(threshold_),decreaseFactor(decreaseFactor_){};
+    ing(ing_),threshold(threshold_),decreaseFactor(decreaseFactor_),
+    checkpointInterval(0),conversionIndex(0),prune(false),collapseSeries(false)
+    {
+        RandomNumberGenerators rngLeMonADE;
+        rng.seed(rngLeMonADE.r250_rand32());
+    };
+    //! constructor using a copy of move_, e.g. with an already read force-extension curve
+    UpdaterForceBalancedPosition(IngredientsType& ing_, const moveType& move_, double threshold_ , double decreaseFactor_=1.0):
+    ing(ing_),threshold(threshold_),move(move_),decreaseFactor(decreaseFactor_),
+    checkpointInterval(0),conversionIndex(0),prune(false),collapseSeries(false)
+    {
+        RandomNumberGenerators rngLeMonADE;
+        rng.seed(rngLeMonADE.r250_rand32());
+    };
     
     virtual void initialize(){};
     bool execute();
@@ -49,6 +82,27 @@ public:
 
     void setFilename(const std::string filename) {move.setFilename(filename); }
     void setRelaxationParameter( const double relax ) {move.setRelaxationParameter(relax);}
+    //! curves per segment count by the scaling rule f_N(R)=f_ref(R*Nref/N) (only MoveNonLinearForceEquilibrium)
+    void setReferenceSegments( const uint32_t referenceSegments ) {move.setReferenceSegments(referenceSegments);}
+    //! curve files per segment count, "{N}" is replaced by the segment count (only MoveNonLinearForceEquilibrium)
+    void setSegmentFilenamePattern( const std::string pattern ) {move.setSegmentFilenamePattern(pattern);}
+    //! force of a strand with nSegments segments for the extension vector given by the move 
+    VectorDouble3 getStrandForce( const VectorDouble3& extension, uint32_t nSegments ) {return move.getStrandForce(extension,nSegments);}
+
+    //! write a checkpoint to filename every interval MCS and after each finished equilibration
+    void setCheckpoint(const std::string filename, uint32_t interval){checkpointFile=filename; checkpointInterval=interval;}
+    //! continue from the checkpoint in filename at the next call of execute
+    void setRestart(const std::string filename){restartFile=filename;}
+    //! index of the current conversion (or strain) step 
+    uint32_t getConversionIndex() const {return conversionIndex;}
+    //! set the index of the next conversion (or strain) step, e.g. when a sweep is resumed 
+    void setConversionIndex(uint32_t index){conversionIndex=index;}
+    //! seed the crosslink selection, e.g. with an independent stream per realization
+    void setSeed(uint32_t seed){rng.seed(seed);}
+    //! equilibrate only the active backbone, collapseSeries_ merges crosslinks with two strands (exact for gaussian strands only)
+    void setPruning(bool prune_, bool collapseSeries_=false){prune=prune_; collapseSeries=collapseSeries_;}
+    //! true if only the active backbone is equilibrated
+    bool getPruning() const {return prune;}
 private:
     //!copy of the main container for the system informations 
     IngredientsType& ing;
@@ -59,27 +113,103 @@ private:
     //! move to equilibrate the cross links by force equilibrium
     moveType move;
     
-    //! random number generator 
-    RandomNumberGenerators rng;
+    //! random number generator for the crosslink selection
+    std::mt19937 rng;
 
     //! 
     double decreaseFactor; 
+
+    //! filename for the checkpoints (empty: no checkpoints)
+    std::string checkpointFile;
+    //! MCS in between two checkpoints (0: only after each finished equilibration)
+    uint32_t checkpointInterval;
+    //! filename of the checkpoint used for the restart (cleared after use)
+    std::string restartFile;
+    //! index of the conversion (or strain) step
+    uint32_t conversionIndex;
+    //! equilibrate only the active backbone
+    bool prune;
+    //! collapse crosslinks with two strands of the backbone
+    bool collapseSeries;
+
+    //! write the current state to checkpointFile
+    void writeCheckpoint(const std::vector<uint32_t>& CrossLinkIDs, uint64_t StartMCS, bool completed);
+
+    //! reduce the lookup if the feature supports it
+    template<class Ing>
+    auto reduceLookUp(Ing& ingredients, int) -> decltype(ingredients.reduceToBackbone(ingredients,true), void()){
+        ingredients.reduceToBackbone(ingredients,collapseSeries);
+    }
+    template<class Ing>
+    void reduceLookUp(Ing& ingredients, long){
+        throw std::runtime_error("UpdaterForceBalancedPosition: the crosslink lookup of the ingredients does not support the pruning.");
+    }
+    //! place the removed crosslinks and restore the lookup
+    template<class Ing>
+    auto restoreLookUp(Ing& ingredients, int) -> decltype(ingredients.restoreFromBackbone(ingredients), void()){
+        ingredients.restoreFromBackbone(ingredients);
+    }
+    template<class Ing>
+    void restoreLookUp(Ing& ingredients, long){}
     
 };
+
+template <class IngredientsType, class moveType>
+void UpdaterForceBalancedPosition<IngredientsType,moveType>::writeCheckpoint(const std::vector<uint32_t>& CrossLinkIDs, uint64_t StartMCS, bool completed){
+    ForceEquilibriumCheckpoint checkpoint;
+    checkpoint.setConversionIndex(conversionIndex);
+    checkpoint.setCompleted(completed);
+    checkpoint.setStartAge(StartMCS);
+    checkpoint.setAge(ing.getMolecules().getAge());
+    checkpoint.setRelaxationParameter(move.getRelaxationParameter());
+    std::stringstream state;
+    state << rng;
+    checkpoint.setRngState(state.str());
+    checkpoint.store(ing,CrossLinkIDs);
+    checkpoint.write(checkpointFile);
+}
+
 template <class IngredientsType, class moveType>
 bool UpdaterForceBalancedPosition<IngredientsType,moveType>::execute(){
     std::cout << "UpdaterForceBalancedPosition::execute(): Start equilibration" <<std::endl;
+    LEMONADE_PM_PHASE("equilibration");
+    LEMONADE_PM_RATE("movesPerSecond","movesAttempted","sweep");
     double avShift(threshold*1.1);
-    uint32_t StartMCS(ing.getMolecules().getAge());
+    uint64_t StartMCS(ing.getMolecules().getAge());
+    if( prune )
+        reduceLookUp(ing,0);
     //! get look up table for the cross link ids to monomer ids
     auto CrossLinkIDs(ing.getCrosslinkIDs());
     //! number of cross links 
     auto NCrossLinks(CrossLinkIDs.size());
+    if( !restartFile.empty() ){
+        ForceEquilibriumCheckpoint checkpoint;
+        checkpoint.read(restartFile);
+        restartFile.clear();
+        if( checkpoint.getConversionIndex() == conversionIndex ){
+            checkpoint.restore(ing);
+            move.setRelaxationParameter(checkpoint.getRelaxationParameter());
+            std::stringstream state(checkpoint.getRngState());
+            state >> rng;
+            StartMCS=checkpoint.getStartAge();
+            ing.modifyMolecules().setAge(checkpoint.getAge());
+            std::cout << "UpdaterForceBalancedPosition::execute(): restart conversion index " << conversionIndex 
+                      << " at MCS " << checkpoint.getAge() << std::endl;
+            if( checkpoint.isCompleted() ){
+                std::cout << "UpdaterForceBalancedPosition::execute(): equilibration was already finished" <<std::endl;
+                avShift=0.;
+            }
+        }else{
+            std::cout << "UpdaterForceBalancedPosition::execute(): checkpoint belongs to conversion index " << checkpoint.getConversionIndex()
+                      << " and not to " << conversionIndex << ", start from the current positions" << std::endl;
+        }
+    }
     while (avShift > threshold  ){
+        LEMONADE_PM_PHASE("sweep");
         double NSuccessfulMoves(0.);
         avShift=0.0;
         for (uint32_t i =0 ; i<NCrossLinks ; i++){
-            uint32_t RandomMonomer(CrossLinkIDs[ rng.r250_rand32() % NCrossLinks]);
+            uint32_t RandomMonomer(CrossLinkIDs[ rng() % NCrossLinks]);
             move.init(ing, RandomMonomer);
             if(move.check(ing)){
                 move.apply(ing);
@@ -87,6 +217,9 @@ bool UpdaterForceBalancedPosition<IngredientsType,moveType>::execute(){
                 NSuccessfulMoves++;
             }
         }
+        LEMONADE_PM_COUNT("movesAttempted",NCrossLinks);
+        LEMONADE_PM_COUNT("movesApplied",NSuccessfulMoves);
+        LEMONADE_PM_SERIES("residual",avShift);
         ing.modifyMolecules().setAge(ing.getMolecules().getAge()+1);
         if (ing.getMolecules().getAge() %1000 == 0 ){
             std::cout << "MCS: " << ing.getMolecules().getAge() << "  and average shift: " << avShift << std::endl;
@@ -96,9 +229,16 @@ bool UpdaterForceBalancedPosition<IngredientsType,moveType>::execute(){
             setRelaxationParameter(move.getRelaxationParameter()*decreaseFactor);
             // threshold*=decreaseFactor;
         }
+        if ( !checkpointFile.empty() && checkpointInterval > 0 && (ing.getMolecules().getAge()-StartMCS) % checkpointInterval == 0 )
+            writeCheckpoint(CrossLinkIDs,StartMCS,false);
     }
     std::cout << "Finish equilibration with average shift per cross link < " << avShift << " after " << ing.getMolecules().getAge()-StartMCS <<std::endl;
+    if ( !checkpointFile.empty() )
+        writeCheckpoint(CrossLinkIDs,StartMCS,true);
+    if( prune )
+        restoreLookUp(ing,0);
+    conversionIndex++;
     ing.modifyMolecules().setAge(StartMCS);
     return false;
 }
-#endif /* LEMONADE_PM_UPDATER_UPDATERFORCEBALANCEPOSITION_H*/
\ No newline at end of file
+#endif /* LEMONADE_PM_UPDATER_UPDATERFORCEBALANCEPOSITION_H*/
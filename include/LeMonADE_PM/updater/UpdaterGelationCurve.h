@@ -0,0 +1,253 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+#ifndef LEMONADE_PM_UPDATER_UPDATERGELATIONCURVE_H
+#define LEMONADE_PM_UPDATER_UPDATERGELATIONCURVE_H
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <LeMonADE/updater/AbstractUpdater.h>
+#include <LeMonADE/utility/ResultFormattingTools.h>
+
+#include <LeMonADE_PM/utility/UnionFind.h>
+
+/**
+ * @class UpdaterGelationCurve
+ * @brief molecular weight and gel fraction versus conversion from the connection history
+ * 
+ * @details Replays the connection file (same format as for UpdaterReadCrosslinkConnections:
+ *     #Time, ChainID, MonID1, P1X, P1Y, P1Z, MonID2, P2X, P2Y, P2Z)
+ * once with an incremental union-find, instead of rebuilding the partial networks.
+ * The ingredients contain the final network, all bonds between reactive monomers
+ * are the reactions of the file, all other bonds exist from the start.
+ * A row is written for every conversion bin of width stepwidth (0: every reaction):
+ *     MCS conversion nClusters Mn Mw Mw_reduced largestFraction
+ * Mw_reduced is the weight average without the largest cluster, its maximum
+ * estimates the gel point.
+ */
+template <class IngredientsType>
+class UpdaterGelationCurve : public AbstractUpdater
+{
+public:
+    UpdaterGelationCurve(
+        const IngredientsType& ing_, 
+        const std::string input_, 
+        const std::string output_="GelationCurve.dat", 
+        const double stepwidth_=0.0): 
+        ing(ing_), 
+        input(input_), 
+        output(output_), 
+        stepwidth(stepwidth_),
+        NMaxConnection(0),
+        NMonomerPerChain(1),
+        gelPoint(0.0),
+        results(7,std::vector<double>()){};
+    virtual void initialize();
+    //! replays the complete file, thus returns always false
+    virtual bool execute();
+    virtual void cleanup(){};
+
+    //! MCS conversion nClusters Mn Mw Mw_reduced largestFraction
+    const std::vector< std::vector<double> >& getResults() const {return results;}
+    //! conversion of the maximum of the reduced weight average
+    double getGelPoint() const {return gelPoint;}
+    //! clusters after the last reaction
+    const UnionFind& getClusters() const {return clusters;}
+
+private:
+  //! container storing system information about monomers
+  const IngredientsType& ing;
+
+  //! connection file 
+  const std::string input;
+
+  //! output file 
+  const std::string output;
+
+  //! width of the conversion bins
+  const double stepwidth;
+
+  //!number of maximum connections for a cross link
+  uint32_t NMaxConnection;
+
+  //!numbe of monomers per chain 
+  uint32_t NMonomerPerChain;
+
+  //! conversion of the maximum of the reduced weight average
+  double gelPoint;
+
+  //! clusters of the monomers
+  UnionFind clusters;
+
+  //!bond Table: key is crosslink and chainID, value the chain monomers bonded to the crosslink 
+  std::map<std::pair<uint32_t,uint32_t>,std::vector<uint32_t> > bondTable;
+
+  //! number of the used entries of the bond table
+  std::map<std::pair<uint32_t,uint32_t>,uint32_t > usedBonds;
+
+  //! result table
+  std::vector< std::vector<double> > results;
+
+  //! unites the cross link with the next chain monomer of the bond table
+  bool ConnectCrossLinkToChain(uint32_t MonID, uint32_t chainID);
+
+  //! stores the current state as a row
+  void addRow(uint32_t Time, double conversion);
+};
+
+/**
+ * @details Same choice of the chain monomer as UpdaterReadCrosslinkConnections: 
+ * the first bond of the table and for the second reaction with the same chain
+ * the second bond.
+ * */
+template <class IngredientsType>
+bool UpdaterGelationCurve<IngredientsType>::ConnectCrossLinkToChain(uint32_t MonID, uint32_t chainID){
+    std::pair<uint32_t,uint32_t> key(MonID,chainID);
+    auto entry(bondTable.find(key));
+    if ( entry == bondTable.end() ) 
+        return false;
+    uint32_t& used(usedBonds[key]);
+    if ( used >= entry->second.size() ) 
+        return false;
+    clusters.unite(MonID,entry->second[used]);
+    used++;
+    return true;
+}
+
+template <class IngredientsType>
+void UpdaterGelationCurve<IngredientsType>::addRow(uint32_t Time, double conversion){
+    results[0].push_back(Time);
+    results[1].push_back(conversion);
+    results[2].push_back(clusters.getNumClusters());
+    results[3].push_back(clusters.getNumberAverage());
+    results[4].push_back(clusters.getWeightAverage());
+    results[5].push_back(clusters.getReducedWeightAverage());
+    results[6].push_back(clusters.getLargestClusterFraction());
+}
+
+/**
+ * @brief unites all bonds which are not created by the reactions
+ * */
+template <class IngredientsType>
+void UpdaterGelationCurve<IngredientsType>::initialize(){
+    //assume a stochiometric mixture
+    NMaxConnection=ing.getFunctionality()*ing.getNumOfCrosslinks();
+    NMonomerPerChain = ing.getNumOfMonomersPerChain();
+    if ( NMaxConnection == 0 || NMonomerPerChain == 0 ){
+        std::stringstream errormessage;
+        errormessage << "UpdaterGelationCurve: the system information is missing: " 
+                     << NMaxConnection << " maximum connections and " << NMonomerPerChain << " monomers per chain.\n";
+        throw std::runtime_error(errormessage.str());
+    }
+    const auto& molecules(ing.getMolecules());
+    clusters.reset(molecules.size());
+    bondTable.clear();
+    usedBonds.clear();
+    for (uint32_t i =0 ; i <  molecules.size(); i++)
+        for(size_t j=0; j < molecules.getNumLinks(i);j++){
+            uint32_t neighbor(molecules.getNeighborIdx(i,j));
+            if ( neighbor < i ) continue;
+            if ( molecules[i].isReactive() && molecules[neighbor].isReactive() ){
+                uint32_t chainMonomer(i);
+                uint32_t chainID( (chainMonomer-chainMonomer%NMonomerPerChain)/NMonomerPerChain);
+                bondTable[std::pair<uint32_t,uint32_t>(neighbor,chainID) ].push_back(chainMonomer) ;
+            }else{
+                clusters.unite(i,neighbor);
+            }
+        }
+    std::cout << "UpdaterGelationCurve: " << bondTable.size() << " crosslink-chain pairs are created by reactions, " 
+              << clusters.getNumClusters() << " molecules at the start." <<std::endl;
+}
+
+/**
+ * @brief reads the connection file once and writes the gelation curve
+ * */
+template <class IngredientsType>
+bool UpdaterGelationCurve<IngredientsType>::execute(){
+    std::ifstream stream;
+    stream.open(input);
+    if (stream.fail())
+      throw std::runtime_error(std::string("error opening input file ") + input + std::string("\n"));
+    for (size_t c = 0; c < results.size(); c++)
+        results[c].clear();
+    addRow(0,0.0);
+    uint32_t NewConnections(0), Time(0);
+    double nextConversion(stepwidth);
+    bool lastStored(true);
+    std::string line;
+    while ( std::getline(stream, line) ){
+        if (line.empty() || line.at(0) == '#')
+            continue;
+        std::stringstream ss(line);
+        uint32_t ChainID, MonID1, P1X, P1Y, P1Z, MonID2, P2X, P2Y, P2Z;
+        ss >> Time >> ChainID >> MonID1 >> P1X >> P1Y >> P1Z >> MonID2 >> P2X >> P2Y >> P2Z;
+        if ( ss.fail() ){
+            std::stringstream errormessage;
+            errormessage << "UpdaterGelationCurve: cannot read the line \"" << line << "\" of " << input << "\n";
+            throw std::runtime_error(errormessage.str());
+        }
+        if ( !ConnectCrossLinkToChain(MonID1, ChainID) && !ConnectCrossLinkToChain(MonID2, ChainID) ) {
+            std::stringstream errormessage;
+            errormessage << "There was no such a connection in the bfm file for monomer ID= " << MonID1  <<" with ID=" << MonID2 <<  " with chainID=" << ChainID<< "\n";
+            throw std::runtime_error(errormessage.str());
+        }
+        NewConnections++;
+        double conversion(static_cast<double>(NewConnections)/NMaxConnection);
+        lastStored=false;
+        if ( stepwidth <= 0.0 || conversion >= nextConversion ){
+            addRow(Time,conversion);
+            lastStored=true;
+            while ( stepwidth > 0.0 && nextConversion <= conversion ) 
+                nextConversion += stepwidth;
+        }
+    }
+    if ( !lastStored )
+        addRow(Time,static_cast<double>(NewConnections)/NMaxConnection);
+    stream.close();
+
+    //maximum of the reduced weight average
+    size_t maxRow(std::max_element(results[5].begin(),results[5].end())-results[5].begin());
+    gelPoint=results[1][maxRow];
+    std::cout << "UpdaterGelationCurve: " << NewConnections << "/" << NMaxConnection 
+              << " reactions, estimated gel point at conversion " << gelPoint << std::endl;
+
+    if ( !output.empty() ){
+        std::stringstream comment;
+        comment << "Created by UpdaterGelationCurve from " << input << "\n";
+        comment << "Mw_reduced is the weight average without the largest molecule\n";
+        comment << "gel point (maximum of Mw_reduced) at conversion " << gelPoint << "\n";
+        comment << "MCS conversion nClusters Mn Mw Mw_reduced largestFraction\n";
+        ResultFormattingTools::writeResultFile(output, ing, results, comment.str());
+    }
+    return false;
+}
+
+#endif /*LEMONADE_PM_UPDATER_UPDATERGELATIONCURVE_H*/
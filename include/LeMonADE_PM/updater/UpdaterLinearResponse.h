@@ -0,0 +1,184 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UPDATER_UPDATERLINEARRESPONSE_H
+#define LEMONADE_PM_UPDATER_UPDATERLINEARRESPONSE_H
+
+#include <vector>
+#include <sstream>
+
+#include <LeMonADE/updater/AbstractUpdater.h>
+#include <LeMonADE/utility/Vector3D.h>
+#include <LeMonADE/utility/ResultFormattingTools.h>
+#include <LeMonADE_PM/updater/UpdaterForceBalancedPosition.h>
+#include <LeMonADE_PM/updater/moves/MoveForceEquilibrium.h>
+#include <LeMonADE_PM/utility/DeformationTensor.h>
+#include <LeMonADE_PM/utility/NetworkStress.h>
+#include <LeMonADE_PM/utility/neighborX.h>
+
+/**
+ * @class UpdaterLinearResponse
+ * @brief Equilibrium positions, stress and modulus of a Gaussian network for arbitrary 
+ * deformation tensors from a single equilibration.
+ * @details For Gaussian strands the force balance is linear in the positions and the 
+ * same for each Cartesian component. A deformation F of the jump vectors and of the 
+ * fixed monomers therefore moves the equilibrium to x(F)=F x(1), and the strand vectors 
+ * to R(F)=F R(1). The network is equilibrated once in the undeformed state (the basis 
+ * response) and the virial M=sum w f R^T is stored. Afterwards every deformation costs 
+ * only a vector combination:
+ *  - positions x(F)=F x(1) and jumps J(F)=F J(1) (applyDeformation)
+ *  - stress sigma(F)=F M F^T/(V det F), V is the box volume times the factors 
+ *    of a prestrain applied before (setPrestrain)
+ *  - modulus according to the kind of the deformation (see DeformationTensor::modulus)
+ * 
+ * The results are written one row per deformation: index, type, parameter, 
+ * sigma_xx, sigma_yy, sigma_zz, sigma_xy, sigma_xz, sigma_yz, G. At the end the system 
+ * is left in the last deformation of the list.
+ * @tparam IngredientsType
+ */
+template <class IngredientsType>
+class UpdaterLinearResponse:public AbstractUpdater
+{
+public:
+    //! constructor for UpdaterLinearResponse
+    UpdaterLinearResponse(IngredientsType& ing_, std::vector<DeformationTensor> deformations_, double threshold_, std::string outputFile_="LinearResponse.dat"):
+    ing(ing_),deformations(deformations_),outputFile(outputFile_),
+    forceUpdater(ing_,threshold_),virial(6,0.),referenceVolume(0.),
+    prestrainX(1.),prestrainY(1.),prestrainZ(1.)
+    {};
+
+    virtual void initialize(){};
+    bool execute();
+    virtual void cleanup(){};
+
+    //! the underlying force updater, e.g. to set a checkpoint
+    UpdaterForceBalancedPosition<IngredientsType,MoveForceEquilibrium>& getForceUpdater(){return forceUpdater;}
+    //! factors of the prestrain applied to the system before, they change the reference volume
+    void setPrestrain(double prestrainX_, double prestrainY_, double prestrainZ_){
+        prestrainX=prestrainX_; prestrainY=prestrainY_; prestrainZ=prestrainZ_;
+    }
+
+    //! equilibrate the undeformed system and store the basis response
+    void solveReference();
+    //! stress (xx,yy,zz,xy,xz,yz) for the deformation 
+    std::vector<double> getStress(const DeformationTensor& F) const {
+        std::vector<double> stress(F.transform(virial));
+        double volume(referenceVolume*F.determinant());
+        for (size_t a = 0; a < stress.size(); a++)
+            stress[a]/=volume;
+        return stress;
+    }
+    //! equilibrium position of monomer i for the deformation 
+    VectorDouble3 getPosition(const DeformationTensor& F, uint32_t i) const {return F.apply(referencePositions[i]);}
+    //! set the positions and jump vectors of the system to the equilibrium of the deformation 
+    void applyDeformation(const DeformationTensor& F);
+    //! results of all deformations, see the class description
+    const std::vector< std::vector<double> >& getResults() const {return results;}
+
+private:
+    //! reference to the main container for the system informations 
+    IngredientsType& ing;
+    //! deformations to be evaluated 
+    std::vector<DeformationTensor> deformations;
+    //! filename for the results 
+    std::string outputFile;
+    //! equilibration of the undeformed network 
+    UpdaterForceBalancedPosition<IngredientsType,MoveForceEquilibrium> forceUpdater;
+    //! virial of the undeformed equilibrium (xx,yy,zz,xy,xz,yz)
+    std::vector<double> virial;
+    //! volume of the undeformed (prestrained) system 
+    double referenceVolume;
+    //! factors of the prestrain, see setPrestrain
+    double prestrainX,prestrainY,prestrainZ;
+    //! undeformed equilibrium positions of all monomers 
+    std::vector<VectorDouble3> referencePositions;
+    //! undeformed jump vectors of the crosslink neighbors 
+    std::vector< std::vector<VectorDouble3> > referenceJumps;
+    //! results in columns, see getResults
+    std::vector< std::vector<double> > results;
+};
+
+template <class IngredientsType>
+void UpdaterLinearResponse<IngredientsType>::solveReference(){
+    forceUpdater.execute();
+    referencePositions.resize(ing.getMolecules().size());
+    for (size_t i = 0; i < referencePositions.size(); i++)
+        referencePositions[i]=ing.getMolecules()[i].getVector3D();
+    const std::vector<uint32_t>& CrossLinkIDs(ing.getCrosslinkIDs());
+    referenceJumps.assign(CrossLinkIDs.size(),std::vector<VectorDouble3>());
+    for (size_t i = 0; i < CrossLinkIDs.size(); i++){
+        std::vector<neighborX> Neighbors(ing.getCrossLinkNeighborIDs(CrossLinkIDs[i]));
+        for (size_t j = 0; j < Neighbors.size(); j++)
+            referenceJumps[i].push_back(Neighbors[j].jump);
+    }
+    virial=NetworkStress::calculateVirial(ing,forceUpdater);
+    referenceVolume=NetworkStress::volume(ing,prestrainX,prestrainY,prestrainZ);
+}
+
+template <class IngredientsType>
+void UpdaterLinearResponse<IngredientsType>::applyDeformation(const DeformationTensor& F){
+    for (size_t i = 0; i < referencePositions.size(); i++)
+        ing.modifyMolecules()[i].modifyVector3D()=F.apply(referencePositions[i]);
+    const std::vector<uint32_t>& CrossLinkIDs(ing.getCrosslinkIDs());
+    for (size_t i = 0; i < CrossLinkIDs.size(); i++)
+        for (size_t j = 0; j < referenceJumps[i].size(); j++)
+            ing.setCrossLinkNeighborJump(CrossLinkIDs[i],j,F.apply(referenceJumps[i][j]));
+}
+
+template <class IngredientsType>
+bool UpdaterLinearResponse<IngredientsType>::execute(){
+    std::cout << "UpdaterLinearResponse::execute(): equilibrate the undeformed network" << std::endl;
+    solveReference();
+    results.assign(10,std::vector<double>());
+    std::stringstream comment;
+    comment << "Created by UpdaterLinearResponse\n";
+    comment << "stress in kT per lattice volume, type 0=general 1=uniaxial 2=biaxial 3=shear\n";
+    for (size_t k = 0; k < deformations.size(); k++){
+        const DeformationTensor& F(deformations[k]);
+        std::vector<double> stress(getStress(F));
+        double G(F.modulus(stress));
+        results[0].push_back(k);
+        results[1].push_back(F.getType());
+        results[2].push_back(F.getParameter());
+        for (size_t a = 0; a < stress.size(); a++)
+            results[a+3].push_back(stress[a]);
+        results[9].push_back(G);
+        comment << "deformation " << k << ": F=(" 
+                << F(0,0) << " " << F(0,1) << " " << F(0,2) << "; "
+                << F(1,0) << " " << F(1,1) << " " << F(1,2) << "; "
+                << F(2,0) << " " << F(2,1) << " " << F(2,2) << ")\n";
+        std::cout << "UpdaterLinearResponse::execute(): deformation " << k << " sigma_xx=" << stress[0] 
+                  << " sigma_yy=" << stress[1] << " sigma_zz=" << stress[2] << " sigma_xy=" << stress[3] << " G=" << G << std::endl;
+    }
+    comment << "index type parameter sigma_xx sigma_yy sigma_zz sigma_xy sigma_xz sigma_yz G\n";
+    ResultFormattingTools::writeResultFile(outputFile, ing, results, comment.str());
+    if( !deformations.empty() )
+        applyDeformation(deformations.back());
+    return false;
+}
+
+#endif /*LEMONADE_PM_UPDATER_UPDATERLINEARRESPONSE_H*/
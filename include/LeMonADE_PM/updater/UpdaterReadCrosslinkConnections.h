@@ -136,10 +136,10 @@ void UpdaterReadCrosslinkConnections<IngredientsType>::initialize(){
     NMaxConnection=ing.getFunctionality()*ing.getNumOfCrosslinks();
     NMonomerPerChain = ing.getNumOfMonomersPerChain();
     std::cout << "Number of maximum connection: " << NMaxConnection << std::endl;
-    //erase bonds between reactive monomers
+    //erase bonds between reactive monomers (backwards, disconnect removes the link j)
     for (uint32_t i =0 ; i <  ing.getMolecules().size(); i++)
         if (ing.getMolecules()[i].isReactive() )
-            for(size_t j=0; j < ing.getMolecules().getNumLinks(i);j++){
+            for(size_t j=ing.getMolecules().getNumLinks(i); j-- > 0; ){
                 uint32_t neighbor(ing.getMolecules().getNeighborIdx(i,j));
                 if (ing.getMolecules()[neighbor].isReactive()){
                     ing.modifyMolecules().disconnect(i, neighbor );
@@ -0,0 +1,263 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UPDATER_UPDATERSTRAINSWEEP_H
+#define LEMONADE_PM_UPDATER_UPDATERSTRAINSWEEP_H
+
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+#include <LeMonADE/updater/AbstractUpdater.h>
+#include <LeMonADE/utility/Vector3D.h>
+#include <LeMonADE/utility/ResultFormattingTools.h>
+#include <LeMonADE_PM/updater/UpdaterAffineDeformation.h>
+#include <LeMonADE_PM/updater/UpdaterForceBalancedPosition.h>
+#include <LeMonADE_PM/utility/ForceEquilibriumCheckpoint.h>
+#include <LeMonADE_PM/utility/DeformationTensor.h>
+#include <LeMonADE_PM/utility/NetworkStress.h>
+#include <LeMonADE_PM/utility/neighborX.h>
+
+/**
+ * @class UpdaterStrainSweep
+ * @brief Equilibrates the network for a list of uniaxial stretching factors and 
+ * writes the stress and the modulus for each of them.
+ * @details The deformation is applied incrementally with the ratio of two successive
+ * stretching factors to the previous equilibrium (positions and jump vectors, see 
+ * UpdaterAffineDeformation). After the second step the crosslinks start from a predictor, 
+ * which extrapolates the last two equilibrium positions linearly in the stretching 
+ * factor in the undeformed frame. The equilibration is done by UpdaterForceBalancedPosition.
+ * 
+ * The stress is sigma_ab = 1/V sum_strands f_a R_b with the strand force of the move. 
+ * Every strand between two crosslinks is seen from both of them and gets the weight 1/2. 
+ * The uniaxial deformation conserves the volume, thus V is the box volume times 
+ * the factors of a prestrain applied before the sweep (setPrestrain). 
+ * The modulus is G=(sigma_xx-(sigma_yy+sigma_zz)/2)/(lambda^2-1/lambda) and NaN for lambda=1.
+ * 
+ * Each stretching factor is one conversion index of the force updater. With setRestart
+ * the sweep continues at the stretching factor of the checkpoint (or at the next one if
+ * the checkpoint is completed) and appends to the output.
+ * @tparam IngredientsType
+ * @tparam moveType
+ */
+template <class IngredientsType, class moveType >
+class UpdaterStrainSweep:public AbstractUpdater
+{
+public:
+    //! constructor for UpdaterStrainSweep
+    UpdaterStrainSweep(IngredientsType& ing_, std::vector<double> lambdas_, double threshold_, double decreaseFactor_=1.0, std::string outputFile_="StressStrain.dat"):
+    ing(ing_),lambdas(lambdas_),outputFile(outputFile_),
+    forceUpdater(ing_,threshold_,decreaseFactor_),
+    deformation(ing_,1.0),
+    currentLambda(1.0),
+    prestrainX(1.0),prestrainY(1.0),prestrainZ(1.0)
+    {
+        if( lambdas.empty() )
+            throw std::runtime_error("UpdaterStrainSweep: no stretching factors given");
+        for (size_t i = 0; i < lambdas.size(); i++){
+            if( lambdas[i] <= 0. ){
+                std::stringstream errormessage;
+                errormessage << "UpdaterStrainSweep: stretching factor " << lambdas[i] << " has to be positive";
+                throw std::runtime_error(errormessage.str());
+            }
+        }
+    };
+
+    virtual void initialize(){};
+    bool execute();
+    virtual void cleanup(){};
+
+    //! the underlying force updater, e.g. to set the force-extension curve
+    UpdaterForceBalancedPosition<IngredientsType,moveType>& getForceUpdater(){return forceUpdater;}
+    //! write a checkpoint to filename every interval MCS and after each stretching factor
+    void setCheckpoint(const std::string filename, uint32_t interval){forceUpdater.setCheckpoint(filename,interval);}
+    //! continue the sweep from the checkpoint in filename 
+    void setRestart(const std::string filename){restartFile=filename;}
+    //! factors of the prestrain applied to the system before the sweep, they change the volume
+    void setPrestrain(double prestrainX_, double prestrainY_, double prestrainZ_){
+        prestrainX=prestrainX_; prestrainY=prestrainY_; prestrainZ=prestrainZ_;
+    }
+
+    //! stress tensor (xx,yy,zz,xy,xz,yz) of the current configuration
+    std::vector<double> calculateStress();
+    //! modulus from the stress tensor (xx,yy,zz,...) for the uniaxial stretching factor lambda 
+    static double calculateModulus(const std::vector<double>& stress, double lambda){
+        return DeformationTensor::uniaxial(lambda).modulus(stress);
+    }
+    //! results of the sweep: lambda, sigma_xx, sigma_yy, sigma_zz, sigma_xy, sigma_xz, sigma_yz, G
+    const std::vector< std::vector<double> >& getResults() const {return results;}
+
+private:
+    //! reference to the main container for the system informations 
+    IngredientsType& ing;
+    //! stretching factors of the sweep 
+    std::vector<double> lambdas;
+    //! filename for the stress-strain data 
+    std::string outputFile;
+    //! equilibration of the crosslinks 
+    UpdaterForceBalancedPosition<IngredientsType,moveType> forceUpdater;
+    //! incremental affine deformation
+    UpdaterAffineDeformation<IngredientsType> deformation;
+    //! filename of the checkpoint used for the restart (cleared after use)
+    std::string restartFile;
+    //! stretching factor of the current configuration 
+    double currentLambda;
+    //! factors of the prestrain, see setPrestrain
+    double prestrainX,prestrainY,prestrainZ;
+    //! results in columns, see getResults
+    std::vector< std::vector<double> > results;
+    //! stretching factors and crosslink positions in the undeformed frame of the last two steps 
+    std::vector<double> previousLambdas;
+    std::vector< std::vector<VectorDouble3> > previousPositions;
+
+    //! deform the system from currentLambda to lambda 
+    void deformTo(double lambda){
+        deformation.setStretchingFactor(lambda/currentLambda);
+        deformation.execute();
+        currentLambda=lambda;
+    }
+    //! linear extrapolation of the last two equilibrium positions to lambda 
+    void predict(const std::vector<uint32_t>& CrossLinkIDs, double lambda);
+    //! store the current crosslink positions in the undeformed frame 
+    void storeSolution(const std::vector<uint32_t>& CrossLinkIDs);
+    //! write the row of the last step to the output file 
+    void writeRow(bool append);
+};
+
+template <class IngredientsType, class moveType>
+std::vector<double> UpdaterStrainSweep<IngredientsType,moveType>::calculateStress(){
+    std::vector<double> stress(NetworkStress::calculateVirial(ing,forceUpdater));
+    double volume(NetworkStress::volume(ing,prestrainX,prestrainY,prestrainZ));
+    for (size_t a = 0; a < stress.size(); a++)
+        stress[a]/=volume;
+    return stress;
+}
+
+template <class IngredientsType, class moveType>
+void UpdaterStrainSweep<IngredientsType,moveType>::storeSolution(const std::vector<uint32_t>& CrossLinkIDs){
+    std::vector<VectorDouble3> positions(CrossLinkIDs.size());
+    double lateral(std::sqrt(currentLambda));
+    for (size_t i = 0; i < CrossLinkIDs.size(); i++){
+        VectorDouble3 pos(ing.getMolecules()[CrossLinkIDs[i]].getVector3D());
+        positions[i]=VectorDouble3(pos.getX()/currentLambda, pos.getY()*lateral, pos.getZ()*lateral);
+    }
+    if( previousLambdas.size() == 2 ){
+        previousLambdas.erase(previousLambdas.begin());
+        previousPositions.erase(previousPositions.begin());
+    }
+    previousLambdas.push_back(currentLambda);
+    previousPositions.push_back(positions);
+}
+
+template <class IngredientsType, class moveType>
+void UpdaterStrainSweep<IngredientsType,moveType>::predict(const std::vector<uint32_t>& CrossLinkIDs, double lambda){
+    if( previousLambdas.size() < 2 || previousLambdas[1] == previousLambdas[0] ) 
+        return;
+    double t((lambda-previousLambdas[1])/(previousLambdas[1]-previousLambdas[0]));
+    double lateral(1./std::sqrt(lambda));
+    for (size_t i = 0; i < CrossLinkIDs.size(); i++){
+        const VectorDouble3& x0(previousPositions[0][i]);
+        const VectorDouble3& x1(previousPositions[1][i]);
+        VectorDouble3 x(x1+(x1-x0)*t);
+        ing.modifyMolecules()[CrossLinkIDs[i]].modifyVector3D()=VectorDouble3(x.getX()*lambda, x.getY()*lateral, x.getZ()*lateral);
+    }
+}
+
+template <class IngredientsType, class moveType>
+void UpdaterStrainSweep<IngredientsType,moveType>::writeRow(bool append){
+    std::vector< std::vector<double> > row(results.size());
+    for (size_t c = 0; c < results.size(); c++)
+        row[c].push_back(results[c].back());
+    if( append ){
+        ResultFormattingTools::appendToResultFile(outputFile, row);
+    }else{
+        std::stringstream comment;
+        comment << "Created by UpdaterStrainSweep\n";
+        comment << "stress in kT per lattice volume, modulus G=(sigma_xx-(sigma_yy+sigma_zz)/2)/(lambda^2-1/lambda)\n";
+        comment << "lambda sigma_xx sigma_yy sigma_zz sigma_xy sigma_xz sigma_yz G\n";
+        ResultFormattingTools::writeResultFile(outputFile, ing, row, comment.str());
+    }
+}
+
+template <class IngredientsType, class moveType>
+bool UpdaterStrainSweep<IngredientsType,moveType>::execute(){
+    std::cout << "UpdaterStrainSweep::execute(): sweep over " << lambdas.size() << " stretching factors" << std::endl;
+    auto CrossLinkIDs(ing.getCrosslinkIDs());
+    results.assign(8,std::vector<double>());
+    size_t start(0);
+    bool append(false);
+    if( !restartFile.empty() ){
+        ForceEquilibriumCheckpoint checkpoint;
+        checkpoint.read(restartFile);
+        start=checkpoint.getConversionIndex();
+        if( start >= lambdas.size() ){
+            std::stringstream errormessage;
+            errormessage << "UpdaterStrainSweep::execute(): checkpoint " << restartFile << " belongs to step " << start 
+                         << ", but the sweep has only " << lambdas.size() << " stretching factors";
+            throw std::runtime_error(errormessage.str());
+        }
+        if( checkpoint.isCompleted() ){
+            //the row of this step is already written, continue from its equilibrium
+            deformTo(lambdas[start]);
+            checkpoint.restore(ing);
+            storeSolution(CrossLinkIDs);
+            start++;
+            forceUpdater.setConversionIndex(start);
+        }else{
+            forceUpdater.setConversionIndex(start);
+            forceUpdater.setRestart(restartFile);
+        }
+        restartFile.clear();
+        //the rows of the steps before start are in the output file
+        append=(start > 0);
+        if( start < lambdas.size() )
+            std::cout << "UpdaterStrainSweep::execute(): continue at lambda=" << lambdas[start] << std::endl;
+        else
+            std::cout << "UpdaterStrainSweep::execute(): the sweep was already finished" << std::endl;
+    }
+    for (size_t k = start; k < lambdas.size(); k++){
+        std::cout << "UpdaterStrainSweep::execute(): lambda=" << lambdas[k] << std::endl;
+        deformTo(lambdas[k]);
+        predict(CrossLinkIDs,lambdas[k]);
+        forceUpdater.execute();
+        storeSolution(CrossLinkIDs);
+        std::vector<double> stress(calculateStress());
+        double G(calculateModulus(stress,lambdas[k]));
+        results[0].push_back(lambdas[k]);
+        for (size_t a = 0; a < stress.size(); a++)
+            results[a+1].push_back(stress[a]);
+        results[7].push_back(G);
+        std::cout << "UpdaterStrainSweep::execute(): lambda=" << lambdas[k] << " sigma_xx=" << stress[0] 
+                  << " sigma_yy=" << stress[1] << " sigma_zz=" << stress[2] << " G=" << G << std::endl;
+        writeRow(append || k > start);
+    }
+    return false;
+}
+
+#endif /*LEMONADE_PM_UPDATER_UPDATERSTRAINSWEEP_H*/
@@ -0,0 +1,117 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UPDATER_MOVES_FORCEEXTENSIONPOLICIES_H
+#define LEMONADE_PM_UPDATER_MOVES_FORCEEXTENSIONPOLICIES_H
+
+/*****************************************************************************/
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @brief Closed-form force-extension relations for MoveAnalyticForceEquilibrium.
+ * @details Every policy provides the secant stiffness k(R)=f(R)/R of a strand
+ * with nSegments segments and the average bond length bondlength (kT=1).
+ * The relative extension x=R/(nSegments*bondlength) is clamped to maxExtension()
+ * to keep the diverging relations finite for overstretched strands.
+ * All policies reduce to the Gaussian stiffness 3/(N b^2) for x->0.
+ **/
+/*****************************************************************************/
+
+/**
+ * @class ForceExtensionPolicyBase
+ * @brief Common helpers of the force-extension policies.
+ **/
+struct ForceExtensionPolicyBase
+{
+  //! upper bound of the relative extension used by the finite extensible relations
+  static double maxExtension(){return 0.99;}
+  //! relative extension x=R/(N*b) clamped to [0,maxExtension()]
+  static double relativeExtension(double R, double nSegments, double bondlength)
+  {
+    double x(R/(nSegments*bondlength));
+    return x < maxExtension() ? x : maxExtension();
+  }
+};
+
+/**
+ * @class GaussianForcePolicy
+ * @brief f=3R/(N b^2)
+ **/
+struct GaussianForcePolicy:public ForceExtensionPolicyBase
+{
+  static const char* name(){return "gauss";}
+  static double secantStiffness(double R, double nSegments, double bondlength)
+  {
+    return 3./(nSegments*bondlength*bondlength);
+  }
+};
+
+/**
+ * @class FENEForcePolicy
+ * @brief f=3R/(N b^2) / (1-x^2) with the maximum extension R_max=N b
+ **/
+struct FENEForcePolicy:public ForceExtensionPolicyBase
+{
+  static const char* name(){return "fene";}
+  static double secantStiffness(double R, double nSegments, double bondlength)
+  {
+    double x(relativeExtension(R,nSegments,bondlength));
+    return 3./(nSegments*bondlength*bondlength*(1.-x*x));
+  }
+};
+
+/**
+ * @class InverseLangevinForcePolicy
+ * @brief f=L^{-1}(x)/b with Cohens Pade approximation L^{-1}(x)=x(3-x^2)/(1-x^2)
+ **/
+struct InverseLangevinForcePolicy:public ForceExtensionPolicyBase
+{
+  static const char* name(){return "langevin";}
+  static double secantStiffness(double R, double nSegments, double bondlength)
+  {
+    double x(relativeExtension(R,nSegments,bondlength));
+    return (3.-x*x)/((1.-x*x)*nSegments*bondlength*bondlength);
+  }
+};
+
+/**
+ * @class WormLikeChainForcePolicy
+ * @brief Marko-Siggia interpolation f P=x+1/(4(1-x)^2)-1/4 with the persistence length P=b/2
+ **/
+struct WormLikeChainForcePolicy:public ForceExtensionPolicyBase
+{
+  static const char* name(){return "wlc";}
+  static double secantStiffness(double R, double nSegments, double bondlength)
+  {
+    double x(relativeExtension(R,nSegments,bondlength));
+    return 2./(nSegments*bondlength*bondlength)*(1.+(2.-x)/(4.*(1.-x)*(1.-x)));
+  }
+};
+
+#endif /*LEMONADE_PM_UPDATER_MOVES_FORCEEXTENSIONPOLICIES_H*/
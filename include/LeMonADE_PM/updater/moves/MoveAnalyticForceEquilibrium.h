@@ -0,0 +1,217 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UPDATER_MOVES_MOVEANALYTICFORCEEQUILIBRIUM_H
+#define LEMONADE_PM_UPDATER_MOVES_MOVEANALYTICFORCEEQUILIBRIUM_H
+#include <string>
+#include <stdexcept>
+#include <LeMonADE_PM/updater/moves/MoveForceEquilibriumBase.h>
+#include <LeMonADE_PM/updater/moves/ForceExtensionPolicies.h>
+#include <LeMonADE/utility/DistanceCalculation.h>
+#include <LeMonADE_PM/utility/neighborX.h>
+
+/*****************************************************************************/
+/**
+ * @file
+ *
+ * @class MoveAnalyticForceEquilibrium
+ *
+ * @brief Force equilibration move with a closed-form force-extension relation.
+ *
+ * @details The force-extension relation is given by the template parameter
+ * (see ForceExtensionPolicies.h) and is inlined at compile time, thus no
+ * table has to be read and no lookup is done in the hot path.
+ * The crosslink is shifted to the stiffness weighted mean of its strand ends,
+ * shift = sum_i k_i R_i / sum_i k_i with the secant stiffness k_i=f(R_i)/R_i.
+ * This is the exact force balance for the Gaussian policy (identical to
+ * MoveForceEquilibrium) and a fixed point iteration for the nonlinear ones.
+ *
+ * @tparam <ForcePolicy> force-extension relation, e.g. FENEForcePolicy
+ **/
+/*****************************************************************************/
+template<class ForcePolicy>
+class MoveAnalyticForceEquilibrium:public MoveForceEquilibriumBase<MoveAnalyticForceEquilibrium<ForcePolicy> >{
+public:
+    MoveAnalyticForceEquilibrium():bondlength(2.68){
+      std::cout << "Use the MoveAnalyticForceEquilibrium with the force-extension relation " << ForcePolicy::name() << "\n";
+    };
+
+    // overload initialise function to be able to set the moves index and direction if neccessary
+    template <class IngredientsType> void init(const IngredientsType& ing);
+    template <class IngredientsType> void init(const IngredientsType& ing, uint32_t index);
+    template <class IngredientsType> void init(const IngredientsType& ing, uint32_t index, VectorDouble3 dir );
+
+    template <class IngredientsType> bool check(IngredientsType& ing);
+    template< class IngredientsType> void apply(IngredientsType& ing);
+
+    void setFilename(std::string filename_){}
+    //! get the filename for the force extension data (the analytic relations need none)
+    std::string const getFilename(){return std::string();}
+
+    //! set the relaxation parameter for the cross link
+    void setRelaxationParameter(double relaxationChain_){}
+    //! get the relaxation parameter for the cross link (the analytic shift needs none)
+    double getRelaxationParameter(){return 1.;}
+    //! force of a strand with nSegments segments for the extension vector 
+    VectorDouble3 getStrandForce(const VectorDouble3& extension, uint32_t nSegments){return FE(extension,nSegments);}
+
+    //! force f(R) of a strand with nSegs segments and the extension vector
+    VectorDouble3 FE(VectorDouble3 extensionVector, double nSegs) const {
+        return extensionVector*ForcePolicy::secantStiffness(extensionVector.getLength(),nSegs,bondlength);
+    }
+private:
+    //average bond length
+    const double bondlength;
+
+    //calculate the shift for the cross link
+    template< class IngredientsType >
+    VectorDouble3 CalculateShift(IngredientsType& ing ){
+        std::vector<neighborX> Neighbors(ing.getCrossLinkNeighborIDs(this->getIndex()) );
+        VectorDouble3 shift(0.,0.,0.);
+        double sumStiffness(0.);
+        if (Neighbors.size() > 0) {
+            VectorDouble3 Position(ing.getMolecules()[this->getIndex()].getVector3D());
+            for (size_t i = 0; i < Neighbors.size(); i++){
+                VectorDouble3 vec(ing.getMolecules()[Neighbors[i].ID].getVector3D()-Position-Neighbors[i].jump);
+                double k(ForcePolicy::secantStiffness(vec.getLength(),Neighbors[i].segDistance,bondlength));
+                sumStiffness+=k;
+                shift+=vec*k;
+            }
+            shift=shift/sumStiffness;
+        }
+        return shift;
+    };
+
+};
+/////////////////////////////////////////////////////////////////////////////
+/////////// implementation of the members ///////////////////////////////////
+
+/*****************************************************************************/
+/**
+ * @brief Initialize the move.
+ *
+ * @details Resets the move probability to unity. Dice a new random direction and
+ * Vertex (monomer) index inside the graph.
+ *
+ * @param ing A reference to the IngredientsType - mainly the system
+ **/
+template<class ForcePolicy>
+template <class IngredientsType>
+void MoveAnalyticForceEquilibrium<ForcePolicy>::init(const IngredientsType& ing)
+{
+    this->resetProbability();
+
+    //draw index
+    this->setIndex( (this->randomNumbers.r250_rand32()) %(ing.getMolecules().size()) );
+
+    //calculate the shift of the cross link
+    this->setShiftVector(CalculateShift(ing));
+}
+
+/*****************************************************************************/
+/**
+ * @brief Initialize the move with a given monomer index.
+ *
+ * @param ing A reference to the IngredientsType - mainly the system
+ * @param index index of the monomer to be moved
+ **/
+template<class ForcePolicy>
+template <class IngredientsType>
+void MoveAnalyticForceEquilibrium<ForcePolicy>::init(const IngredientsType& ing, uint32_t index)
+{
+  this->resetProbability();
+
+  //set index
+  if( (index >= 0) && (index <= (ing.getMolecules().size()-1)) )
+    this->setIndex( index );
+  else
+    throw std::runtime_error("MoveAnalyticForceEquilibrium::init(ing, index): index out of range!");
+
+  //calculate the shift of the cross link
+  this->setShiftVector(CalculateShift(ing));
+}
+
+/*****************************************************************************/
+/**
+ * @brief Initialize the move with a given monomer index and shift.
+ *
+ * @param ing A reference to the IngredientsType - mainly the system
+ * @param index index of the monomer to be moved
+ * @param dir shift of the monomer
+ **/
+template<class ForcePolicy>
+template <class IngredientsType>
+void MoveAnalyticForceEquilibrium<ForcePolicy>::init(const IngredientsType& ing, uint32_t index, VectorDouble3 dir )
+{
+  this->resetProbability();
+
+  //set index
+  if( (index >= 0) && (index <= (ing.getMolecules().size()-1)) )
+    this->setIndex( index );
+  else
+    throw std::runtime_error("MoveAnalyticForceEquilibrium::init(ing, index, dir): index out of range!");
+
+  this->setShiftVector(dir);
+}
+
+/*****************************************************************************/
+/**
+ * @brief Check if the move is accepted by the system.
+ *
+ * @details This function delegates the checking to the Feature.
+ *
+ * @param ing A reference to the IngredientsType - mainly the system
+ * @return True if move is valid. False, otherwise.
+ **/
+template<class ForcePolicy>
+template <class IngredientsType>
+bool MoveAnalyticForceEquilibrium<ForcePolicy>::check(IngredientsType& ing)
+{
+  //send the move to the Features to be checked
+  return ing.checkMove(ing,*this);
+}
+
+/*****************************************************************************/
+/**
+ * @brief Apply the move to the system , e.g. add the displacement to Vertex (monomer) position.
+ *
+ * @details As first step: all Feature should apply the move using applyMove().\n
+ * Second: Modify the positions etc. of the Vertex etc.
+ *
+ * @param ing A reference to the IngredientsType - mainly the system
+ **/
+template<class ForcePolicy>
+template< class IngredientsType>
+void MoveAnalyticForceEquilibrium<ForcePolicy>::apply(IngredientsType& ing)
+{
+	//move must FIRST be applied to the features
+	ing.applyMove(ing,*this);
+	//THEN the position can be modified
+	ing.modifyMolecules()[this->getIndex()]+=this->getShiftVector();
+}
+
+#endif /*LEMONADE_PM_UPDATER_MOVES_MOVEANALYTICFORCEEQUILIBRIUM_H*/
@@ -61,12 +61,14 @@ public:
 
     void setFilename(std::string filename_){}
     //! get the filename for the force extension data 
-    std::string const getFilename(){}
+    std::string const getFilename(){return std::string();}
     
     //! set the relaxation parameter for the cross link
     void setRelaxationParameter(double relaxationChain_){}
-    //! get the relaxation parameter for the cross link 
-    double getRelaxationParameter(){}
+    //! get the relaxation parameter for the cross link (the gaussian shift needs none)
+    double getRelaxationParameter(){return 1.;}
+    //! force of a strand with nSegments segments for the extension vector (gaussian)
+    VectorDouble3 getStrandForce(const VectorDouble3& extension, uint32_t nSegments){return FE(extension,nSegments);}
 private:
     //average square bond length 
     const double bondlength2;
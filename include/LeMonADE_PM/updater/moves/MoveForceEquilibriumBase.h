@@ -91,12 +91,14 @@ class MoveForceEquilibriumBase:public MoveBase
 public:
     void setFilename(std::string filename_){static_cast<SpecializedMove*>(this)->setFilename(filename_);}
     //! get the filename for the force extension data 
-    std::string const getFilename(){static_cast<SpecializedMove*>(this)->getFilename();}
+    std::string const getFilename(){return static_cast<SpecializedMove*>(this)->getFilename();}
     
     //! set the relaxation parameter for the cross link
     void setRelaxationParameter(double relaxationChain_){static_cast<SpecializedMove*>(this)->setRelaxationParameter(relaxationChain_);}
     //! get the relaxation parameter for the cross link 
-    double getRelaxationParameter(){static_cast<SpecializedMove*>(this)->getRelaxationParameter();} 
+    double getRelaxationParameter(){return static_cast<SpecializedMove*>(this)->getRelaxationParameter();} 
+    //! force of a strand with nSegments segments for the extension vector 
+    VectorDouble3 getStrandForce(const VectorDouble3& extension, uint32_t nSegments){return static_cast<SpecializedMove*>(this)->getStrandForce(extension,nSegments);}
 
 
 	//! Random Number Generator (RNG)
@@ -29,6 +29,10 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #define LEMONADE_PM_UPDATER_MOVES_MOVENONLINEARFORCEEQUILIBRIUM_H
 #include <limits>
 #include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
 #include <sys/stat.h>
 #include <LeMonADE_PM/updater/moves/MoveForceEquilibriumBase.h>
 #include <LeMonADE/utility/DistanceCalculation.h>
@@ -44,6 +48,21 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  *
  * @details The class is a specialization of MoveLocalBase using the (CRTP) to avoid virtual functions.
  * Here implemented for networks made of monodisperse chains.
+ * The force extension curve from the file is interpolated by a monotone cubic 
+ * (Fritsch-Carlson) spline and sampled once on a uniform grid with spacing 
+ * accuracy. The grid has a guard cell, such that the linear interpolation in 
+ * EFBlock never reads behind the table. Extensions larger than the maximum 
+ * extension of the file use the gaussian relation (EFGauss).
+ * 
+ * The curve of the file (reference curve) is used for all strands by default. 
+ * With setReferenceSegments(Nref) the curves for strands of N segments are 
+ * derived by the scaling rule f_N(R)=f_ref(R*Nref/N), and with 
+ * setSegmentFilenamePattern(pattern) an own curve file per segment count 
+ * is read ("{N}" in the pattern is replaced by the segment count). The 
+ * tables are build lazily at the first strand with a new segment count and 
+ * are stored one after another in the same contiguous array. A table row only 
+ * stores its offset, grid spacing and maximum extension, such that scaled rows 
+ * share the data of the reference curve and a lookup stays O(1).
  **/
 /*****************************************************************************/
 
@@ -51,7 +70,8 @@ class MoveNonLinearForceEquilibrium:public MoveForceEquilibriumBase<MoveNonLinea
 public:
     //! constructor for the class MoveNonLinearForceEquilibrium taking the filename of the force extension relation and the realaxation parameter for the chain 
     MoveNonLinearForceEquilibrium(std::string filename_="", double relaxationChain_=1.):
-        filename(filename_),bondlength(2.68), accuracy(.1) {
+        filename(filename_),bondlength(2.68), max_extension(0.), accuracy(.1), inverseAccuracy(1./accuracy), force_extension(2,0.), 
+        rows(1,TableRow(0,inverseAccuracy,0.,0.)), referenceSegments(0) {
             if( !filename.empty() ) createTable();
             setRelaxationParameter(relaxationChain_);
         };
@@ -69,6 +89,34 @@ public:
     void setFilename(std::string filename_){filename=filename_;createTable();}
     //! get the filename for the force extension data 
     std::string const getFilename(){return filename;}
+    //! scale the reference curve for strands with N segments by f_N(R)=f_ref(R*Nref/N) (0: no scaling)
+    void setReferenceSegments(uint32_t referenceSegments_){referenceSegments=referenceSegments_; resetSegmentTables();}
+    //! get the number of segments of the reference curve 
+    uint32_t getReferenceSegments() const {return referenceSegments;}
+    //! read own curves per segment count from files, "{N}" in the pattern is replaced by the segment count (missing files need setReferenceSegments)
+    void setSegmentFilenamePattern(std::string pattern){segmentFilenamePattern=pattern; resetSegmentTables();}
+    //! get the pattern of the filenames for the curves per segment count 
+    std::string getSegmentFilenamePattern() const {return segmentFilenamePattern;}
+    //! true if the strands use other curves than the reference curve 
+    bool hasSegmentTables() const {return referenceSegments > 0 || !segmentFilenamePattern.empty();}
+    //! reference curve sampled at i/getInverseAccuracy() including the guard cell 
+    std::vector<double> getReferenceTable() const {
+        return std::vector<double>(force_extension.begin(),force_extension.begin()+static_cast<size_t>(rows[0].lastCell)+2);
+    }
+    //! inverse of the grid spacing of the reference curve 
+    double getInverseAccuracy() const {return rows[0].inverseAccuracy;}
+    //! largest extension of the reference curve, beyond it the force is extension/springConstant 
+    double getMaxExtension() const {return rows[0].maxExtension;}
+    //! spring constant of the current relaxation parameter 
+    double getSpringConstant() const {return springConstant;}
+    //! index of the table row for strands with nSegments segments (the row is build at the first call)
+    uint32_t getTableRow(uint32_t nSegments){
+        if( (referenceSegments == 0 && segmentFilenamePattern.empty()) || nSegments == 0 )
+            return 0;
+        if( nSegments < rowOfSegments.size() && rowOfSegments[nSegments] >= 0 )
+            return rowOfSegments[nSegments];
+        return createTableRow(nSegments);
+    }
     
     //! set the relaxation parameter for the cross link
     void setRelaxationParameter(double relaxationChain_){
@@ -78,39 +126,50 @@ public:
     }
     //! get the relaxation parameter for the cross link 
     double getRelaxationParameter(){return relaxationChain;} 
+    //! force of a strand with nSegments segments for the extension vector (table of the segment count)
+    VectorDouble3 getStrandForce(const VectorDouble3& extension, uint32_t nSegments){return EF(extension,nSegments);}
 
     //uses the read force extension relation 
-    VectorDouble3 EF(VectorDouble3 extensionVector){
-        if (extensionVector == VectorDouble3(0.,0.,0.) )
-            return VectorDouble3(0.,0.,0.);
-        double length( extensionVector.getLength() );
-        if ( max_extension < length  ){
-            return EFGauss(extensionVector); 
-        }
-        #ifdef DEBUG
-        if ( max_extension < length  ){
-            std::stringstream errormessage; 
-            errormessage << "The length of the extension vector is greater than the maximum given in the file: \n"
-                         << "length is  " << length 
-                         << " maximum is " << max_extension << "\n";
-            throw std::runtime_error(errormessage.str());
+    VectorDouble3 EF(VectorDouble3 extensionVector) const {
+        double x(extensionVector.getX()), y(extensionVector.getY()), z(extensionVector.getZ());
+        double fx, fy, fz;
+        EFBlock(&x,&y,&z,&fx,&fy,&fz,1);
+        return VectorDouble3(fx,fy,fz);
+    }
+    //uses the force extension relation for strands with nSegments segments 
+    VectorDouble3 EF(VectorDouble3 extensionVector, uint32_t nSegments) {
+        double x(extensionVector.getX()), y(extensionVector.getY()), z(extensionVector.getZ());
+        double fx, fy, fz;
+        uint32_t row(getTableRow(nSegments));
+        EFBlock(&x,&y,&z,&fx,&fy,&fz,1,&row);
+        return VectorDouble3(fx,fy,fz);
+    }
+    /**
+     * @brief force vectors for a block of extension vectors given as structure of arrays 
+     * @details Magnitude and direction are evaluated in one go: the force is 
+     * the extension vector scaled by amplitude/length. The loop body has no 
+     * data dependent branches (the selects compile to blends), thus it can be 
+     * vectorized. Out and in arrays may not overlap. The optional tableRows 
+     * (see getTableRow) select the curve per element, the reference curve is 
+     * used without.
+     */
+    void EFBlock(const double* rx, const double* ry, const double* rz, double* fx, double* fy, double* fz, uint32_t n, const uint32_t* tableRows=NULL) const {
+        const double* table(&force_extension[0]);
+        const TableRow* rowData(&rows[0]);
+        const double inverseSpringConstant(1./springConstant);
+        for (uint32_t i = 0; i < n; i++){
+            const TableRow& row(rowData[tableRows ? tableRows[i] : 0]);
+            const double* rowTable(table+row.offset);
+            double length(std::sqrt(rx[i]*rx[i]+ry[i]*ry[i]+rz[i]*rz[i]));
+            double x(std::min(length*row.inverseAccuracy,row.lastCell));
+            uint32_t down(static_cast<uint32_t>(x));
+            double tableAmplitude(rowTable[down]+(rowTable[down+1]-rowTable[down])*(x-down));
+            double amplitude( (length > row.maxExtension) ? length*inverseSpringConstant : tableAmplitude );
+            double scale( (length > 0.) ? amplitude/length : 0. );
+            fx[i]=rx[i]*scale;
+            fy[i]=ry[i]*scale;
+            fz[i]=rz[i]*scale;
         }
-        if (length == 0 )
-            return VectorDouble3(0.,0.,0.);
-        #endif
-        #ifdef DEBUG
-        std::cout <<length << "\t" << force_extension[static_cast<uint32_t>(round(length/accuracy))] << "\t" << EFGauss(extensionVector).getLength() << "\t" 
-         << extensionVector << "\t" 
-         <<  EFGauss(extensionVector) << "\t"<< extensionVector.normalize()*(force_extension[static_cast<uint32_t>(round(length/accuracy))])<<"\t"  
-        << "\n"; 
-        #endif 
-        if (length == 0)
-            return VectorDouble3(0.,0.,0.);
-        auto x(length/accuracy);
-        auto down(static_cast<uint32_t>(floor(x)));
-        auto up (down+1);
-        auto amplitude=force_extension[down] + (force_extension[up]-force_extension[down])/static_cast<double>(up-down)*(x-down)/static_cast<double>(up-down);
-        return extensionVector.normalize()*(amplitude);
     }
     //Gaussina force extension relation 
     //f=R*3/(N*b^2)
@@ -129,30 +188,40 @@ private:
     //filename filename for the force extension curve 
     std::string filename;
     
-    //minimum force in the file 
-    double min_force;
-    //maximum force in the file 
-    double max_force;
-    //force steps 
-    double force_steps;
-   
-    //min_extension in the file 
-    double min_extension;
     //maximum extensions in the file 
     double max_extension;
-    //extension steps 
-    double extension_steps;
 
     //the accuracy is the steps in which the extensions vector grows
     const double accuracy; 
+    //inverse of the accuracy 
+    const double inverseAccuracy;
 
     //spring constant for the equivalent chain used for the relaxation of the cross links 
     double springConstant;
    
-    //force extension mapping       
-    std::map<double, double> extension_force;
-    //extension force mapping index=extension rounded to int 
+    //! position and grid of one force extension curve in force_extension
+    struct TableRow{
+        TableRow(size_t offset_, double inverseAccuracy_, double maxExtension_, double lastCell_):
+            offset(offset_),inverseAccuracy(inverseAccuracy_),maxExtension(maxExtension_),lastCell(lastCell_){};
+        //first entry of the row in force_extension
+        size_t offset;
+        //inverse grid spacing of the row 
+        double inverseAccuracy;
+        //largest extension covered by the row 
+        double maxExtension;
+        //last cell which can be interpolated (the next entry is the guard cell)
+        double lastCell;
+    };
+    //force at the extensions i*accuracy, the last entry is a guard cell, the rows of all curves are stored one after another 
     std::vector<double> force_extension;
+    //rows of the table, the first row is the reference curve 
+    std::vector<TableRow> rows;
+    //row index for each segment count, -1 if the row is not build yet 
+    std::vector<int32_t> rowOfSegments;
+    //number of segments of the reference curve used for the scaling rule (0: no scaling)
+    uint32_t referenceSegments;
+    //pattern for the curve files per segment count 
+    std::string segmentFilenamePattern;
     //an equivalent chain which relaxes the cross link
     double relaxationChain;
     //calculate the shift for the cross link
@@ -161,21 +230,44 @@ private:
         std::vector<neighborX> Neighbors(ing.getCrossLinkNeighborIDs(this->getIndex()) );
         VectorDouble3 force(0.,0.,0.);
         VectorDouble3 shift(0.,0.,0.);
-        double avNSegments(0.);
-        int32_t number_of_neighbors(Neighbors.size());
+        uint32_t number_of_neighbors(Neighbors.size());
         if (number_of_neighbors > 0) {
-            VectorDouble3 Position(ing.getMolecules()[this->getIndex()].getVector3D());      
-            for (size_t i = 0; i < number_of_neighbors; i++){
-                VectorDouble3 vec(ing.getMolecules()[Neighbors[i].ID].getVector3D()-Neighbors[i].jump-Position);
-                // std::cout <<"MoveNLFE " <<  ing.getMolecules()[Neighbors[i].ID].getVector3D() << " " << Neighbors[i].jump<< " " << Position <<std::endl;
-                force+=EF(vec);
-                //std::cout << this->getIndex()<<" "<< Neighbors[i].ID<< " " <<EF(vec) <<" " << Position << " " << ing.getMolecules()[Neighbors[i].ID].getVector3D()<< std::endl;
+            VectorDouble3 Position(ing.getMolecules()[this->getIndex()].getVector3D());
+            //the extension vectors are evaluated in blocks 
+            const uint32_t blockSize(8);
+            double rx[blockSize], ry[blockSize], rz[blockSize];
+            double fx[blockSize], fy[blockSize], fz[blockSize];
+            uint32_t tableRows[blockSize];
+            for (uint32_t start = 0; start < number_of_neighbors; start+=blockSize){
+                uint32_t n(std::min(blockSize,number_of_neighbors-start));
+                for (uint32_t i = 0; i < n; i++){
+                    const neighborX& neighbor(Neighbors[start+i]);
+                    VectorDouble3 vec(ing.getMolecules()[neighbor.ID].getVector3D()-neighbor.jump-Position);
+                    rx[i]=vec.getX(); ry[i]=vec.getY(); rz[i]=vec.getZ();
+                    tableRows[i]=getTableRow(neighbor.segDistance);
+                }
+                EFBlock(rx,ry,rz,fx,fy,fz,n,tableRows);
+                for (uint32_t i = 0; i < n; i++)
+                    force+=VectorDouble3(fx[i],fy[i],fz[i]);
             }
             shift=FE(force/(static_cast<double>(number_of_neighbors) ));
         }
         return shift;
     };
 
+    //! read the pairs of extension and force from a file (sorted, unique extensions, starting at the origin)
+    static void readCurve(const std::string& name, std::vector<double>& x, std::vector<double>& y);
+    //! sample the monotone cubic spline through x,y at r*accuracy for r=0..nCells and set the guard cell 
+    static void sampleCurve(const std::vector<double>& x, const std::vector<double>& y, double accuracy, size_t nCells, double* table);
+    //! build the row for strands with nSegments segments 
+    uint32_t createTableRow(uint32_t nSegments);
+    //! remove all rows except the reference curve 
+    void resetSegmentTables(){
+        rows.erase(rows.begin()+1,rows.end());
+        force_extension.resize(rows[0].offset+static_cast<size_t>(rows[0].lastCell)+2);
+        rowOfSegments.clear();
+    }
+
     //! check is file exists:
     inline bool fileExists (const std::string& name) {
         struct stat buffer;   
@@ -184,69 +276,141 @@ private:
 };
 /////////////////////////////////////////////////////////////////////////////
 /////////// implementation of the members ///////////////////////////////////
-void MoveNonLinearForceEquilibrium::createTable(){
-    if (fileExists(filename )){
-        std::ifstream in(filename);
-        uint32_t counter(0);
-        extension_force.insert(extension_force.end(),std::pair<double,double>(0., 0.));
-        min_force=0.;
-        min_extension=0.;
-        while(in.good() && in.peek()!=EOF){
-            std::string line;
-            getline(in, line);
-            //ignore comments and blank lines 
-            if (line.at(0) == '#' || line.empty() ) //go to next line
+inline void MoveNonLinearForceEquilibrium::readCurve(const std::string& name, std::vector<double>& x, std::vector<double>& y){
+    std::ifstream in(name);
+    //pairs of extension and force 
+    std::vector<std::pair<double,double> > curve;
+    curve.push_back(std::pair<double,double>(0., 0.));
+    while(in.good() && in.peek()!=EOF){
+        std::string line;
+        getline(in, line);
+        //ignore comments and blank lines 
+        if (line.empty() || line.at(0) == '#' ) //go to next line
+            continue;
+        //read data 
+        double force, extension;
+        std::stringstream ss ;
+        ss<< line;
+        ss>>force >> extension; 
+        if( ss.fail() || extension < 0. )
+            continue;
+        curve.push_back(std::pair<double,double>(extension, force));
+    }
+    in.close();
+    std::sort(curve.begin(),curve.end());
+    //keep the first force for equal extensions 
+    x.clear(); y.clear();
+    for (size_t i = 0; i < curve.size(); i++){
+        if( !x.empty() && curve[i].first == x.back() ) continue;
+        x.push_back(curve[i].first);
+        y.push_back(curve[i].second);
+    }
+}
+
+inline void MoveNonLinearForceEquilibrium::sampleCurve(const std::vector<double>& x, const std::vector<double>& y, double accuracy, size_t nCells, double* table){
+    //monotone cubic interpolation (Fritsch-Carlson) 
+    size_t nPoints(x.size());
+    std::vector<double> slope(nPoints,0.);
+    if( nPoints > 1 ){
+        std::vector<double> secant(nPoints-1);
+        for (size_t k = 0; k < nPoints-1; k++)
+            secant[k]=(y[k+1]-y[k])/(x[k+1]-x[k]);
+        slope[0]=secant[0];
+        slope[nPoints-1]=secant[nPoints-2];
+        for (size_t k = 1; k < nPoints-1; k++)
+            slope[k]= (secant[k-1]*secant[k] <= 0.) ? 0. : 0.5*(secant[k-1]+secant[k]);
+        for (size_t k = 0; k < nPoints-1; k++){
+            if( secant[k] == 0. ){
+                slope[k]=0.; slope[k+1]=0.;
                 continue;
-            //read data 
-            double force, extension;
-            std::stringstream ss ;
-            ss<< line;
-            ss>>force >> extension; 
-            if(min_force > force ) min_force=force; 
-            if(max_force < force ) max_force=force; 
-            if(min_extension > extension ) min_extension=extension; 
-            if(max_extension < extension ) max_extension=extension; 
-            extension_force.insert(extension_force.end(),std::pair<double,double>(force, extension));
-            if(counter==1){
-                force_steps=max_force-min_force;
-            }else if(counter>1)
-            counter++;
-        }
-        in.close();
-        //make lookup for the extension force relation 
-        //make a entry from 0 to max_extension in steps of 1 
-        auto it_last=extension_force.begin();
-        for ( auto r=0;r<static_cast<uint32_t>(max_extension/accuracy); r++   ){
-            if(r==0)
-                force_extension.push_back(0.);
-            else{
-                for (auto it=it_last; it !=extension_force.end();it++){
-                    if(it->second > static_cast<double>(r*accuracy)){
-                        //at the force linear interpolated in between the two current forces
-                        auto deltaForce(it->first-it_last->first);
-                        auto deltaExtension(it->second-it_last->second);
-                        auto factor( (static_cast<double>(r*accuracy)-it_last->second)/deltaExtension );
-                        //at interpolated force
-                        force_extension.push_back(it_last->first+deltaForce*factor);
-                        break;
-                    }
-                    it_last=it;
-                }
             }
+            double a(slope[k]/secant[k]), b(slope[k+1]/secant[k]);
+            double norm(a*a+b*b);
+            if( norm > 9. ){
+                double tau(3./std::sqrt(norm));
+                slope[k]  =tau*a*secant[k];
+                slope[k+1]=tau*b*secant[k];
+            }
+        }
+    }
+    //sample the spline on the uniform grid: nodes 0..nCells and one guard cell 
+    size_t k(0);
+    for (size_t r = 0; r <= nCells; r++ ){
+        double ext(std::min(r*accuracy,x.back()));
+        while( k+2 < nPoints && x[k+1] < ext ) k++;
+        if( nPoints < 2 ){
+            table[r]=y[0];
+            continue;
         }
+        double h(x[k+1]-x[k]);
+        double t((ext-x[k])/h);
+        double t2(t*t), t3(t2*t);
+        table[r]= (2.*t3-3.*t2+1.)*y[k] + (t3-2.*t2+t)*h*slope[k] 
+                + (-2.*t3+3.*t2)*y[k+1] + (t3-t2)*h*slope[k+1];
+    }
+    table[nCells+1]=table[nCells];
+}
+
+inline void MoveNonLinearForceEquilibrium::createTable(){
+    if (fileExists(filename )){
+        std::vector<double> x, y;
+        readCurve(filename,x,y);
+        max_extension=x.back();
+        size_t nCells(static_cast<size_t>(std::ceil(max_extension*inverseAccuracy)));
+        //the reference curve is the first row, all other rows are build again on demand 
+        force_extension.assign(nCells+2,0.);
+        sampleCurve(x,y,accuracy,nCells,&force_extension[0]);
+        rows.assign(1,TableRow(0,inverseAccuracy,max_extension,static_cast<double>(nCells)));
+        rowOfSegments.clear();
+
         std::cout << "MoveNonLinearForceEquilibrium::createTable() force extension" <<std::endl;
-        for (auto i=0; i<40; i++ )
+        for (size_t i=0; i<std::min<size_t>(40,force_extension.size()); i++ )
             std::cout << "FECurve: " << i << "\t" << i*accuracy<< "\t" << force_extension[i]<<std::endl;
 
         std::cout << "MoveNonLinearForceEquilibrium::createTable(): \n" 
-                << "min_force=" << min_force <<"\n"
-                << "max_force=" << max_force <<"\n"
-                << "min_extension=" << min_extension <<"\n"
-                << "max_extension=" << max_extension <<"\n";
+                << "number of points=" << x.size() <<"\n"
+                << "max_extension=" << max_extension <<"\n"
+                << "number of cells=" << nCells <<"\n";
     }else{
         std::cerr<< "Provide a filename for the MoveNonLinearForceEquilibrium!\n" ;
     }
 }
+
+inline uint32_t MoveNonLinearForceEquilibrium::createTableRow(uint32_t nSegments){
+    std::string segmentFilename(segmentFilenamePattern);
+    size_t placeholder(segmentFilename.find("{N}"));
+    if( placeholder != std::string::npos ){
+        std::stringstream ss;
+        ss << nSegments;
+        segmentFilename.replace(placeholder,3,ss.str());
+    }
+    if( !segmentFilenamePattern.empty() && fileExists(segmentFilename) ){
+        //own curve for this segment count, appended behind the other rows 
+        std::vector<double> x, y;
+        readCurve(segmentFilename,x,y);
+        size_t nCells(static_cast<size_t>(std::ceil(x.back()*inverseAccuracy)));
+        size_t offset(force_extension.size());
+        force_extension.resize(offset+nCells+2,0.);
+        sampleCurve(x,y,accuracy,nCells,&force_extension[offset]);
+        rows.push_back(TableRow(offset,inverseAccuracy,x.back(),static_cast<double>(nCells)));
+        std::cout << "MoveNonLinearForceEquilibrium::createTableRow(): read " << segmentFilename 
+                  << " for strands with " << nSegments << " segments" << std::endl;
+    }else if( referenceSegments > 0 ){
+        //scaling rule: the reference data is read with a stretched grid 
+        double scale(static_cast<double>(referenceSegments)/nSegments);
+        rows.push_back(TableRow(rows[0].offset,rows[0].inverseAccuracy*scale,rows[0].maxExtension/scale,rows[0].lastCell));
+    }else{
+        //the reference curve belongs to another segment count
+        std::stringstream errormessage;
+        errormessage << "MoveNonLinearForceEquilibrium::createTableRow(): no force-extension curve " << segmentFilename
+                     << " for strands with " << nSegments << " segments, set the reference segments to scale the reference curve.";
+        throw std::runtime_error(errormessage.str());
+    }
+    if( rowOfSegments.size() <= nSegments )
+        rowOfSegments.resize(nSegments+1,-1);
+    rowOfSegments[nSegments]=rows.size()-1;
+    return rows.size()-1;
+}
 /*****************************************************************************/
 /**
  * @brief Initialize the move.
@@ -0,0 +1,186 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UTILITY_ASYNCWRITER_H
+#define LEMONADE_PM_UTILITY_ASYNCWRITER_H
+
+#include <stddef.h>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+/*****************************************************************************/
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @class AsyncWriter
+ * @brief Executes output jobs in a background thread.
+ * @details The jobs must only use data owned by themselves (a snapshot of the 
+ * results), never the ingredients, because the simulation goes on meanwhile.
+ * At most maxQueued jobs wait for the writer, submit() blocks if the queue is 
+ * full, thus the memory for the snapshots is bounded. The first exception 
+ * thrown by a job is rethrown by the next call of submit() or flush().
+ * The destructor finishes all queued jobs.
+ **/
+/*****************************************************************************/
+class AsyncWriter
+{
+public:
+  explicit AsyncWriter(size_t maxQueued_=2);
+  ~AsyncWriter();
+
+  //! queue the job, blocks while maxQueued jobs are waiting
+  void submit(std::function<void()> job);
+  //! wait until all jobs are done
+  void flush();
+
+  size_t getMaxQueued() const {return maxQueued;}
+
+private:
+  AsyncWriter(const AsyncWriter&);
+  AsyncWriter& operator=(const AsyncWriter&);
+
+  //! loop of the background thread
+  void run();
+  //! rethrow the exception of a job (call with locked mutex)
+  void rethrow(std::unique_lock<std::mutex>& lock);
+
+  size_t maxQueued;
+  std::deque< std::function<void()> > jobs;
+  //! true while the background thread executes a job
+  bool busy;
+  bool stop;
+  std::exception_ptr error;
+  std::mutex mutex;
+  std::condition_variable jobAvailable;
+  std::condition_variable jobDone;
+  std::thread worker;
+};
+
+/**
+ * @class MetaDataSnapshot
+ * @brief Meta data of the ingredients rendered on the calling thread.
+ * @details Replaces the ingredients for ResultFormattingTools::writeResultFile 
+ * in an asynchronous job, which only calls printMetaData.
+ **/
+class MetaDataSnapshot
+{
+public:
+  template<class IngredientsType>
+  explicit MetaDataSnapshot(const IngredientsType& ing){
+    std::stringstream stream;
+    ing.printMetaData(stream);
+    metaData=stream.str();
+  }
+  void printMetaData(std::ostream& stream) const {stream << metaData;}
+private:
+  std::string metaData;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+/////////// implementation of the members ///////////////////////////////////
+
+inline AsyncWriter::AsyncWriter(size_t maxQueued_):
+  maxQueued(maxQueued_ > 0 ? maxQueued_ : 1),busy(false),stop(false)
+{
+  worker=std::thread(&AsyncWriter::run,this);
+}
+
+inline AsyncWriter::~AsyncWriter()
+{
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    stop=true;
+  }
+  jobAvailable.notify_all();
+  worker.join();
+}
+
+inline void AsyncWriter::rethrow(std::unique_lock<std::mutex>& lock)
+{
+  if( error ){
+    std::exception_ptr e(error);
+    error=std::exception_ptr();
+    lock.unlock();
+    std::rethrow_exception(e);
+  }
+}
+
+inline void AsyncWriter::submit(std::function<void()> job)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  jobDone.wait(lock, [this]{ return jobs.size() < maxQueued || error; });
+  rethrow(lock);
+  jobs.push_back(std::move(job));
+  lock.unlock();
+  jobAvailable.notify_one();
+}
+
+inline void AsyncWriter::flush()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  jobDone.wait(lock, [this]{ return jobs.empty() && !busy; });
+  rethrow(lock);
+}
+
+/**
+ * @details Remaining jobs are executed before the thread stops. After an 
+ * exception the queued jobs are dropped, their output would be incomplete.
+ **/
+inline void AsyncWriter::run()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  while( true ){
+    jobAvailable.wait(lock, [this]{ return !jobs.empty() || stop; });
+    if( jobs.empty() ) break;
+    std::function<void()> job(std::move(jobs.front()));
+    jobs.pop_front();
+    busy=true;
+    lock.unlock();
+    std::exception_ptr jobError;
+    try{ job(); }catch(...){ jobError=std::current_exception(); }
+    lock.lock();
+    busy=false;
+    if( jobError ){
+      if( !error ) error=jobError;
+      jobs.clear();
+    }
+    jobDone.notify_all();
+  }
+}
+
+#endif /*LEMONADE_PM_UTILITY_ASYNCWRITER_H*/
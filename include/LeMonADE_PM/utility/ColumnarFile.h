@@ -0,0 +1,619 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UTILITY_COLUMNARFILE_H
+#define LEMONADE_PM_UTILITY_COLUMNARFILE_H
+
+#include <stdint.h>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef LEMONADE_PM_USE_ZLIB
+#include <zlib.h>
+#endif
+
+/*****************************************************************************/
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @brief Chunked binary container for typed columns of several frames.
+ * @details One file stores e.g. all conversions of a sweep. Every frame has a
+ * key (conversion or stretching factor) and the MCS and consists of named
+ * columns grouped in tables ("strands", "positions"). Columns are stored with
+ * their own type (uint16, uint32, uint64, float, double) in chunks of at most
+ * chunkRows rows, each chunk optionally compressed with zlib (only if the
+ * project is build with LEMONADE_PM_USE_ZLIB).
+ *
+ * Layout (native byte order, checked with a byte order mark):
+ * - header: "LPMCOLS1", version, byte order mark
+ * - frame:  tag, key, MCS, number of columns
+ * - column: tag, table, name, type, rows, chunk rows, number of chunks and for
+ *           each chunk: encoding, raw bytes, stored bytes, data
+ * - index:  number of frames and key, MCS, offset for each frame
+ * - footer: offset of the index, "LPMCOLIX"
+ *
+ * The index is written by close(). Files without index (e.g. after a crash)
+ * are read by scanning the complete frames.
+ **/
+/*****************************************************************************/
+namespace ColumnarFile
+{
+  //! type codes of the columns
+  enum ColumnType {UINT16=1, UINT32=2, UINT64=3, FLOAT32=4, FLOAT64=5};
+  //! encoding of a chunk
+  enum ChunkEncoding {RAW=0, ZLIB=1};
+
+  //! type code of a C++ type
+  template<class T> struct TypeCode;
+  template<> struct TypeCode<uint16_t>{ static ColumnType value(){return UINT16;} };
+  template<> struct TypeCode<uint32_t>{ static ColumnType value(){return UINT32;} };
+  template<> struct TypeCode<uint64_t>{ static ColumnType value(){return UINT64;} };
+  template<> struct TypeCode<float>   { static ColumnType value(){return FLOAT32;} };
+  template<> struct TypeCode<double>  { static ColumnType value(){return FLOAT64;} };
+
+  //! size of a value of the type code in bytes
+  inline size_t typeSize(uint8_t type){
+    switch(type){
+      case UINT16:  return 2;
+      case UINT32:  return 4;
+      case UINT64:  return 8;
+      case FLOAT32: return 4;
+      case FLOAT64: return 8;
+      default:{
+        std::stringstream errormessage;
+        errormessage << "ColumnarFile: unknown column type " << static_cast<int>(type);
+        throw std::runtime_error(errormessage.str());
+      }
+    }
+  }
+
+  //! true if the project is build with zlib
+  inline bool compressionAvailable(){
+#ifdef LEMONADE_PM_USE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  inline const char* magic() {return "LPMCOLS1";}
+  inline const char* indexMagic() {return "LPMCOLIX";}
+  inline uint32_t version() {return 1;}
+  inline uint32_t byteOrderMark() {return 0x01020304;}
+  inline uint32_t frameTag() {return 0x4D415246;}  // "FRAM"
+  inline uint32_t columnTag() {return 0x4D4C4F43;} // "COLM"
+
+  template<class T> void writeValue(std::ostream& out, const T& value){
+    out.write(reinterpret_cast<const char*>(&value),sizeof(T));
+  }
+  template<class T> void readValue(std::istream& in, T& value){
+    in.read(reinterpret_cast<char*>(&value),sizeof(T));
+  }
+  inline void writeString(std::ostream& out, const std::string& s){
+    uint16_t length(s.size());
+    writeValue(out,length);
+    out.write(s.data(),length);
+  }
+  inline std::string readString(std::istream& in){
+    uint16_t length(0);
+    readValue(in,length);
+    std::string s(length,' ');
+    if(length > 0)
+      in.read(&s[0],length);
+    return s;
+  }
+}
+
+/**
+ * @class ColumnarFileWriter
+ * @brief Streams typed columns frame by frame into a ColumnarFile.
+ * @details Usage: beginFrame(key,mcs), writeColumn(...) for every column,
+ * endFrame(), and close() after the last frame (also done by the destructor).
+ **/
+class ColumnarFileWriter
+{
+public:
+  ColumnarFileWriter(const std::string& filename_, bool compress_=false, uint32_t chunkRows_=65536);
+  ~ColumnarFileWriter();
+
+  //! start a new frame with the key (e.g. conversion) and the MCS
+  void beginFrame(double key, uint64_t mcs);
+  //! write the column name of the table in the current frame
+  template<class T>
+  void writeColumn(const std::string& table, const std::string& name, const T* data, uint64_t nRows);
+  template<class T>
+  void writeColumn(const std::string& table, const std::string& name, const std::vector<T>& data){
+    writeColumn(table,name,data.empty() ? NULL : &data[0],data.size());
+  }
+  //! finish the current frame
+  void endFrame();
+  //! write the index and close the file
+  void close();
+
+  std::string getFilename() const {return filename;}
+  bool isCompressed() const {return compress;}
+  uint32_t getChunkRows() const {return chunkRows;}
+  size_t getNumFrames() const {return frameKeys.size();}
+
+private:
+  std::string filename;
+  std::ofstream out;
+  bool compress;
+  uint32_t chunkRows;
+  //! true between beginFrame and endFrame
+  bool inFrame;
+  //! file position of the column count of the current frame
+  uint64_t columnCountPosition;
+  uint32_t nColumns;
+  //! index entries
+  std::vector<double> frameKeys;
+  std::vector<uint64_t> frameMCS;
+  std::vector<uint64_t> frameOffsets;
+  //! buffer for the compressed chunks
+  std::vector<unsigned char> compressed;
+
+  void writeChunk(const char* data, uint64_t rawBytes);
+  void checkStream(const char* where);
+};
+
+/**
+ * @class ColumnarFileReader
+ * @brief Reads frames and columns of a ColumnarFile.
+ * @details Columns are converted to the requested type, e.g. a float column
+ * can be read as std::vector<double>.
+ **/
+class ColumnarFileReader
+{
+public:
+  explicit ColumnarFileReader(const std::string& filename_);
+
+  size_t getNumFrames() const {return frames.size();}
+  double getKey(size_t frame) const {return getFrame(frame).key;}
+  uint64_t getMCS(size_t frame) const {return getFrame(frame).mcs;}
+  //! true if the file has an index (written by ColumnarFileWriter::close())
+  bool isIndexed() const {return indexed;}
+  //! true if the frame contains the column
+  bool hasColumn(size_t frame, const std::string& table, const std::string& name);
+  //! type code of the column
+  uint8_t getColumnType(size_t frame, const std::string& table, const std::string& name);
+  //! read the column converted to T
+  template<class T>
+  std::vector<T> readColumn(size_t frame, const std::string& table, const std::string& name);
+
+private:
+  struct ColumnInfo{
+    std::string table;
+    std::string name;
+    uint8_t type;
+    uint64_t nRows;
+    uint32_t nChunks;
+    //! file position of the first chunk
+    uint64_t offset;
+  };
+  struct FrameInfo{
+    double key;
+    uint64_t mcs;
+    uint64_t offset;
+    bool parsed;
+    std::vector<ColumnInfo> columns;
+  };
+
+  std::string filename;
+  std::ifstream in;
+  uint64_t fileSize;
+  bool indexed;
+  std::vector<FrameInfo> frames;
+
+  const FrameInfo& getFrame(size_t frame) const;
+  //! read the column headers of the frame, returns false for an incomplete frame
+  bool parseFrame(FrameInfo& frame);
+  const ColumnInfo& findColumn(size_t frame, const std::string& table, const std::string& name);
+  bool readIndex();
+  void scanFrames();
+  void readChunks(const ColumnInfo& column, std::vector<char>& raw);
+  [[noreturn]] void fail(const std::string& message) const;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+/////////// implementation of ColumnarFileWriter ////////////////////////////
+
+inline ColumnarFileWriter::ColumnarFileWriter(const std::string& filename_, bool compress_, uint32_t chunkRows_):
+  filename(filename_),compress(compress_),chunkRows(chunkRows_),inFrame(false),columnCountPosition(0),nColumns(0)
+{
+  if( compress && !ColumnarFile::compressionAvailable() ){
+    std::stringstream errormessage;
+    errormessage << "ColumnarFileWriter: compression of " << filename << " requested, but the project is build without zlib.";
+    throw std::runtime_error(errormessage.str());
+  }
+  if( chunkRows == 0 )
+    throw std::runtime_error("ColumnarFileWriter: the number of rows per chunk must be positive.");
+  out.open(filename.c_str(), std::ios::binary | std::ios::trunc);
+  if( !out.is_open() ){
+    std::stringstream errormessage;
+    errormessage << "ColumnarFileWriter: cannot open " << filename;
+    throw std::runtime_error(errormessage.str());
+  }
+  out.write(ColumnarFile::magic(),8);
+  ColumnarFile::writeValue(out,ColumnarFile::version());
+  ColumnarFile::writeValue(out,ColumnarFile::byteOrderMark());
+  checkStream("header");
+}
+
+inline ColumnarFileWriter::~ColumnarFileWriter()
+{
+  //no exceptions from the destructor, an unindexed file can still be scanned
+  try{ close(); }catch(...){}
+}
+
+inline void ColumnarFileWriter::checkStream(const char* where)
+{
+  if( out.fail() ){
+    std::stringstream errormessage;
+    errormessage << "ColumnarFileWriter: writing the " << where << " of " << filename << " failed.";
+    throw std::runtime_error(errormessage.str());
+  }
+}
+
+inline void ColumnarFileWriter::beginFrame(double key, uint64_t mcs)
+{
+  if( !out.is_open() || inFrame ){
+    std::stringstream errormessage;
+    errormessage << "ColumnarFileWriter::beginFrame: " << filename << (inFrame ? " has an unfinished frame." : " is closed.");
+    throw std::runtime_error(errormessage.str());
+  }
+  frameKeys.push_back(key);
+  frameMCS.push_back(mcs);
+  frameOffsets.push_back(out.tellp());
+  ColumnarFile::writeValue(out,ColumnarFile::frameTag());
+  ColumnarFile::writeValue(out,key);
+  ColumnarFile::writeValue(out,mcs);
+  columnCountPosition=out.tellp();
+  nColumns=0;
+  ColumnarFile::writeValue(out,nColumns);
+  checkStream("frame header");
+  inFrame=true;
+}
+
+template<class T>
+void ColumnarFileWriter::writeColumn(const std::string& table, const std::string& name, const T* data, uint64_t nRows)
+{
+  if( !inFrame ){
+    std::stringstream errormessage;
+    errormessage << "ColumnarFileWriter::writeColumn: column " << table << "/" << name << " outside of a frame in " << filename;
+    throw std::runtime_error(errormessage.str());
+  }
+  uint8_t type(ColumnarFile::TypeCode<T>::value());
+  uint32_t nChunks((nRows+chunkRows-1)/chunkRows);
+  ColumnarFile::writeValue(out,ColumnarFile::columnTag());
+  ColumnarFile::writeString(out,table);
+  ColumnarFile::writeString(out,name);
+  ColumnarFile::writeValue(out,type);
+  ColumnarFile::writeValue(out,nRows);
+  ColumnarFile::writeValue(out,chunkRows);
+  ColumnarFile::writeValue(out,nChunks);
+  for(uint64_t row=0; row < nRows; row+=chunkRows){
+    uint64_t n( nRows-row < chunkRows ? nRows-row : chunkRows );
+    writeChunk(reinterpret_cast<const char*>(data+row),n*sizeof(T));
+  }
+  checkStream("column");
+  nColumns++;
+}
+
+inline void ColumnarFileWriter::writeChunk(const char* data, uint64_t rawBytes)
+{
+#ifdef LEMONADE_PM_USE_ZLIB
+  if( compress ){
+    uLongf storedBytes(compressBound(rawBytes));
+    compressed.resize(storedBytes);
+    if( ::compress2(&compressed[0],&storedBytes,reinterpret_cast<const Bytef*>(data),rawBytes,Z_DEFAULT_COMPRESSION) != Z_OK ){
+      std::stringstream errormessage;
+      errormessage << "ColumnarFileWriter: zlib compression failed for " << filename;
+      throw std::runtime_error(errormessage.str());
+    }
+    uint8_t encoding(ColumnarFile::ZLIB);
+    uint64_t stored(storedBytes);
+    ColumnarFile::writeValue(out,encoding);
+    ColumnarFile::writeValue(out,rawBytes);
+    ColumnarFile::writeValue(out,stored);
+    out.write(reinterpret_cast<const char*>(&compressed[0]),stored);
+    return;
+  }
+#endif
+  uint8_t encoding(ColumnarFile::RAW);
+  ColumnarFile::writeValue(out,encoding);
+  ColumnarFile::writeValue(out,rawBytes);
+  ColumnarFile::writeValue(out,rawBytes);
+  out.write(data,rawBytes);
+}
+
+inline void ColumnarFileWriter::endFrame()
+{
+  if( !inFrame ){
+    std::stringstream errormessage;
+    errormessage << "ColumnarFileWriter::endFrame: no frame started in " << filename;
+    throw std::runtime_error(errormessage.str());
+  }
+  uint64_t end(out.tellp());
+  out.seekp(columnCountPosition);
+  ColumnarFile::writeValue(out,nColumns);
+  out.seekp(end);
+  out.flush();
+  checkStream("frame");
+  inFrame=false;
+}
+
+inline void ColumnarFileWriter::close()
+{
+  if( !out.is_open() ) return;
+  if( inFrame ) endFrame();
+  uint64_t indexOffset(out.tellp());
+  uint64_t nFrames(frameKeys.size());
+  ColumnarFile::writeValue(out,nFrames);
+  for(size_t i=0; i<frameKeys.size(); i++){
+    ColumnarFile::writeValue(out,frameKeys[i]);
+    ColumnarFile::writeValue(out,frameMCS[i]);
+    ColumnarFile::writeValue(out,frameOffsets[i]);
+  }
+  ColumnarFile::writeValue(out,indexOffset);
+  out.write(ColumnarFile::indexMagic(),8);
+  out.close();
+  checkStream("index");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////// implementation of ColumnarFileReader ////////////////////////////
+
+inline ColumnarFileReader::ColumnarFileReader(const std::string& filename_):
+  filename(filename_),fileSize(0),indexed(false)
+{
+  in.open(filename.c_str(), std::ios::binary);
+  char fileMagic[8];
+  uint32_t fileVersion(0), fileByteOrder(0);
+  in.read(fileMagic,sizeof(fileMagic));
+  ColumnarFile::readValue(in,fileVersion);
+  ColumnarFile::readValue(in,fileByteOrder);
+  if( !in.good() || std::memcmp(fileMagic,ColumnarFile::magic(),8) != 0 || fileVersion != ColumnarFile::version() )
+    fail("is not a columnar file of version 1");
+  if( fileByteOrder != ColumnarFile::byteOrderMark() )
+    fail("was written with a different byte order");
+  in.seekg(0,std::ios::end);
+  fileSize=in.tellg();
+  indexed=readIndex();
+  if( !indexed )
+    scanFrames();
+}
+
+inline void ColumnarFileReader::fail(const std::string& message) const
+{
+  std::stringstream errormessage;
+  errormessage << "ColumnarFileReader: " << filename << " " << message;
+  throw std::runtime_error(errormessage.str());
+}
+
+inline bool ColumnarFileReader::readIndex()
+{
+  const uint64_t headerSize(16);
+  if( fileSize < headerSize+24 ) return false;
+  char footerMagic[8];
+  uint64_t indexOffset(0);
+  in.clear();
+  in.seekg(fileSize-16);
+  ColumnarFile::readValue(in,indexOffset);
+  in.read(footerMagic,8);
+  if( !in.good() || std::memcmp(footerMagic,ColumnarFile::indexMagic(),8) != 0 || indexOffset < headerSize || indexOffset > fileSize-24 )
+    return false;
+  in.seekg(indexOffset);
+  uint64_t nFrames(0);
+  ColumnarFile::readValue(in,nFrames);
+  if( !in.good() || indexOffset+8+nFrames*24+16 != fileSize )
+    return false;
+  frames.resize(nFrames);
+  for(size_t i=0; i<nFrames; i++){
+    ColumnarFile::readValue(in,frames[i].key);
+    ColumnarFile::readValue(in,frames[i].mcs);
+    ColumnarFile::readValue(in,frames[i].offset);
+    frames[i].parsed=false;
+  }
+  return in.good();
+}
+
+/**
+ * @details Used for files without index: all complete frames are taken,
+ * a truncated last frame is ignored.
+ **/
+inline void ColumnarFileReader::scanFrames()
+{
+  frames.clear();
+  uint64_t offset(16);
+  while( offset < fileSize ){
+    FrameInfo frame;
+    frame.offset=offset;
+    frame.parsed=false;
+    if( !parseFrame(frame) ) break;
+    frames.push_back(frame);
+    in.clear();
+    offset=in.tellg();
+  }
+  in.clear();
+}
+
+/**
+ * @details Reads the frame header and the headers of all columns, the chunk
+ * data is skipped. Leaves the stream at the end of the frame.
+ **/
+inline bool ColumnarFileReader::parseFrame(FrameInfo& frame)
+{
+  in.clear();
+  in.seekg(frame.offset);
+  uint32_t tag(0), nColumns(0);
+  ColumnarFile::readValue(in,tag);
+  ColumnarFile::readValue(in,frame.key);
+  ColumnarFile::readValue(in,frame.mcs);
+  ColumnarFile::readValue(in,nColumns);
+  if( !in.good() || tag != ColumnarFile::frameTag() ) return false;
+  frame.columns.clear();
+  for(uint32_t c=0; c<nColumns; c++){
+    ColumnInfo column;
+    uint32_t chunkRows(0);
+    ColumnarFile::readValue(in,tag);
+    column.table=ColumnarFile::readString(in);
+    column.name=ColumnarFile::readString(in);
+    ColumnarFile::readValue(in,column.type);
+    ColumnarFile::readValue(in,column.nRows);
+    ColumnarFile::readValue(in,chunkRows);
+    ColumnarFile::readValue(in,column.nChunks);
+    if( !in.good() || tag != ColumnarFile::columnTag() ) return false;
+    column.offset=in.tellg();
+    for(uint32_t k=0; k<column.nChunks; k++){
+      uint8_t encoding(0);
+      uint64_t rawBytes(0), storedBytes(0);
+      ColumnarFile::readValue(in,encoding);
+      ColumnarFile::readValue(in,rawBytes);
+      ColumnarFile::readValue(in,storedBytes);
+      if( !in.good() || static_cast<uint64_t>(in.tellg())+storedBytes > fileSize ) return false;
+      in.seekg(storedBytes,std::ios::cur);
+    }
+    frame.columns.push_back(column);
+  }
+  //a frame interrupted during the writing has a too small column count
+  if( in.peek() != std::char_traits<char>::eof() ){
+    uint32_t next(0);
+    uint64_t position(in.tellg());
+    ColumnarFile::readValue(in,next);
+    in.clear();
+    in.seekg(position);
+    if( next == ColumnarFile::columnTag() ) return false;
+  }
+  in.clear();
+  frame.parsed=true;
+  return true;
+}
+
+inline const ColumnarFileReader::FrameInfo& ColumnarFileReader::getFrame(size_t frame) const
+{
+  if( frame >= frames.size() ){
+    std::stringstream errormessage;
+    errormessage << "frame " << frame << " does not exist, the file has " << frames.size() << " frames";
+    fail(errormessage.str());
+  }
+  return frames[frame];
+}
+
+inline const ColumnarFileReader::ColumnInfo& ColumnarFileReader::findColumn(size_t frame, const std::string& table, const std::string& name)
+{
+  getFrame(frame);
+  if( !frames[frame].parsed && !parseFrame(frames[frame]) ){
+    std::stringstream errormessage;
+    errormessage << "has a corrupted frame " << frame;
+    fail(errormessage.str());
+  }
+  const std::vector<ColumnInfo>& columns(frames[frame].columns);
+  for(size_t c=0; c<columns.size(); c++)
+    if( columns[c].table == table && columns[c].name == name )
+      return columns[c];
+  std::stringstream errormessage;
+  errormessage << "has no column " << table << "/" << name << " in frame " << frame;
+  fail(errormessage.str());
+}
+
+inline bool ColumnarFileReader::hasColumn(size_t frame, const std::string& table, const std::string& name)
+{
+  try{ findColumn(frame,table,name); }catch(std::runtime_error&){ return false; }
+  return true;
+}
+
+inline uint8_t ColumnarFileReader::getColumnType(size_t frame, const std::string& table, const std::string& name)
+{
+  return findColumn(frame,table,name).type;
+}
+
+inline void ColumnarFileReader::readChunks(const ColumnInfo& column, std::vector<char>& raw)
+{
+  raw.resize(column.nRows*ColumnarFile::typeSize(column.type));
+  std::vector<char> stored;
+  uint64_t position(0);
+  in.clear();
+  in.seekg(column.offset);
+  for(uint32_t k=0; k<column.nChunks; k++){
+    uint8_t encoding(0);
+    uint64_t rawBytes(0), storedBytes(0);
+    ColumnarFile::readValue(in,encoding);
+    ColumnarFile::readValue(in,rawBytes);
+    ColumnarFile::readValue(in,storedBytes);
+    if( !in.good() || position+rawBytes > raw.size() )
+      fail("has a corrupted chunk header");
+    if( encoding == ColumnarFile::RAW ){
+      in.read(&raw[position],rawBytes);
+    }else if( encoding == ColumnarFile::ZLIB ){
+#ifdef LEMONADE_PM_USE_ZLIB
+      stored.resize(storedBytes);
+      in.read(&stored[0],storedBytes);
+      uLongf length(rawBytes);
+      if( ::uncompress(reinterpret_cast<Bytef*>(&raw[position]),&length,reinterpret_cast<const Bytef*>(&stored[0]),storedBytes) != Z_OK || length != rawBytes )
+        fail("has a corrupted compressed chunk");
+#else
+      fail("contains compressed chunks, but the project is build without zlib");
+#endif
+    }else{
+      fail("has an unknown chunk encoding");
+    }
+    if( in.fail() ) fail("is truncated");
+    position+=rawBytes;
+  }
+  if( position != raw.size() ) fail("has a column with missing chunks");
+}
+
+template<class T>
+std::vector<T> ColumnarFileReader::readColumn(size_t frame, const std::string& table, const std::string& name)
+{
+  const ColumnInfo& column(findColumn(frame,table,name));
+  std::vector<char> raw;
+  readChunks(column,raw);
+  std::vector<T> values(column.nRows);
+  if( column.type == ColumnarFile::TypeCode<T>::value() ){
+    if( column.nRows > 0 ) std::memcpy(&values[0],&raw[0],raw.size());
+    return values;
+  }
+  for(uint64_t i=0; i<column.nRows; i++){
+    switch(column.type){
+      case ColumnarFile::UINT16:  { uint16_t v; std::memcpy(&v,&raw[2*i],2); values[i]=static_cast<T>(v); break; }
+      case ColumnarFile::UINT32:  { uint32_t v; std::memcpy(&v,&raw[4*i],4); values[i]=static_cast<T>(v); break; }
+      case ColumnarFile::UINT64:  { uint64_t v; std::memcpy(&v,&raw[8*i],8); values[i]=static_cast<T>(v); break; }
+      case ColumnarFile::FLOAT32: { float    v; std::memcpy(&v,&raw[4*i],4); values[i]=static_cast<T>(v); break; }
+      case ColumnarFile::FLOAT64: { double   v; std::memcpy(&v,&raw[8*i],8); values[i]=static_cast<T>(v); break; }
+    }
+  }
+  return values;
+}
+
+#endif /*LEMONADE_PM_UTILITY_COLUMNARFILE_H*/
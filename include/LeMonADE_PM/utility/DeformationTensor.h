@@ -0,0 +1,233 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UTILITY_DEFORMATIONTENSOR_H
+#define LEMONADE_PM_UTILITY_DEFORMATIONTENSOR_H
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <LeMonADE/utility/Vector3D.h>
+
+/*****************************************************************************/
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @class DeformationTensor
+ * @brief Deformation gradient F (3x3) acting on positions and jump vectors: x'=F x.
+ * @details Besides the matrix the tensor remembers how it was created (uniaxial, 
+ * equibiaxial, simple shear or a general/prestrain tensor) and the parameter, 
+ * such that the matching modulus can be calculated from the stress:
+ *  - uniaxial  F=diag(l,1/sqrt(l),1/sqrt(l)): G=(s_xx-(s_yy+s_zz)/2)/(l^2-1/l)
+ *  - biaxial   F=diag(l,l,1/l^2):             G=(s_xx-s_zz)/(l^2-1/l^4)
+ *  - shear     F=1+g e_x e_y:                 G=s_xy/g
+ *  - general (e.g. a prestrain or a product): no modulus (NaN)
+ *
+ * A tensor can be read from a string "uniaxial:l", "biaxial:l", "shear:g" or 
+ * "prestrain:px:py:pz".
+ **/
+/*****************************************************************************/
+class DeformationTensor
+{
+public:
+  //! kind of the deformation 
+  enum Type {GENERAL=0, UNIAXIAL=1, BIAXIAL=2, SHEAR=3};
+
+  //! identity 
+  DeformationTensor():type(GENERAL),parameter(0.){
+    for(int a=0;a<3;a++) for(int b=0;b<3;b++) F[a][b]=(a==b)?1.:0.;
+  }
+
+  //! volume conserving uniaxial deformation along x 
+  static DeformationTensor uniaxial(double lambda){
+    checkPositive(lambda,"uniaxial");
+    DeformationTensor tensor(diagonal(lambda,1./std::sqrt(lambda),1./std::sqrt(lambda)));
+    tensor.type=UNIAXIAL; tensor.parameter=lambda;
+    return tensor;
+  }
+  //! volume conserving equibiaxial deformation in the xy-plane 
+  static DeformationTensor biaxial(double lambda){
+    checkPositive(lambda,"biaxial");
+    DeformationTensor tensor(diagonal(lambda,lambda,1./(lambda*lambda)));
+    tensor.type=BIAXIAL; tensor.parameter=lambda;
+    return tensor;
+  }
+  //! simple shear: x is displaced by gamma*y 
+  static DeformationTensor shear(double gamma){
+    DeformationTensor tensor;
+    tensor.F[0][1]=gamma;
+    tensor.type=SHEAR; tensor.parameter=gamma;
+    return tensor;
+  }
+  //! diagonal tensor, e.g. the prestrain factors of UpdaterAffineDeformation 
+  static DeformationTensor diagonal(double fx, double fy, double fz){
+    DeformationTensor tensor;
+    tensor.F[0][0]=fx; tensor.F[1][1]=fy; tensor.F[2][2]=fz;
+    return tensor;
+  }
+  //! read a tensor from "uniaxial:l", "biaxial:l", "shear:g" or "prestrain:px:py:pz"
+  static DeformationTensor parse(const std::string& spec);
+
+  //! element F_ab
+  double operator()(int a, int b) const {return F[a][b];}
+  //! set element F_ab, the tensor becomes a general one 
+  void set(int a, int b, double value){F[a][b]=value; type=GENERAL; parameter=0.;}
+  //! kind of the deformation 
+  Type getType() const {return type;}
+  //! stretching factor or shear of the deformation 
+  double getParameter() const {return parameter;}
+
+  //! deformed vector F v
+  VectorDouble3 apply(const VectorDouble3& v) const {
+    return VectorDouble3(F[0][0]*v.getX()+F[0][1]*v.getY()+F[0][2]*v.getZ(),
+                         F[1][0]*v.getX()+F[1][1]*v.getY()+F[1][2]*v.getZ(),
+                         F[2][0]*v.getX()+F[2][1]*v.getY()+F[2][2]*v.getZ());
+  }
+  //! product F G (first G, then F), the result is a general tensor
+  DeformationTensor operator*(const DeformationTensor& other) const {
+    DeformationTensor product;
+    for(int a=0;a<3;a++) for(int b=0;b<3;b++){
+      product.F[a][b]=0.;
+      for(int c=0;c<3;c++) product.F[a][b]+=F[a][c]*other.F[c][b];
+    }
+    return product;
+  }
+  //! determinant, i.e. the relative volume 
+  double determinant() const {
+    return F[0][0]*(F[1][1]*F[2][2]-F[1][2]*F[2][1])
+          -F[0][1]*(F[1][0]*F[2][2]-F[1][2]*F[2][0])
+          +F[0][2]*(F[1][0]*F[2][1]-F[1][1]*F[2][0]);
+  }
+  /**
+   * @brief F M F^T for a symmetric tensor M
+   * @param M tensor as (xx,yy,zz,xy,xz,yz)
+   * @return the transformed tensor as (xx,yy,zz,xy,xz,yz)
+   */
+  std::vector<double> transform(const std::vector<double>& M) const;
+  //! modulus for the stress (xx,yy,zz,xy,xz,yz) according to the kind of the deformation 
+  double modulus(const std::vector<double>& stress) const;
+
+private:
+  //! matrix elements 
+  double F[3][3];
+  //! kind of the deformation 
+  Type type;
+  //! stretching factor or shear 
+  double parameter;
+
+  static void checkPositive(double lambda, const char* name){
+    if( lambda <= 0. ){
+      std::stringstream errormessage;
+      errormessage << "DeformationTensor::" << name << ": stretching factor " << lambda << " has to be positive";
+      throw std::runtime_error(errormessage.str());
+    }
+  }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+/////////// implementation of the members ///////////////////////////////////
+
+inline DeformationTensor DeformationTensor::parse(const std::string& spec){
+  std::vector<std::string> items;
+  std::stringstream ss(spec);
+  std::string item;
+  while( std::getline(ss,item,':') )
+    items.push_back(item);
+  std::vector<double> values;
+  for (size_t i = 1; i < items.size(); i++){
+    std::stringstream value(items[i]);
+    double v;
+    value >> v;
+    if( value.fail() ){
+      std::stringstream errormessage;
+      errormessage << "DeformationTensor::parse: cannot read " << items[i] << " in " << spec;
+      throw std::runtime_error(errormessage.str());
+    }
+    values.push_back(v);
+  }
+  if( !items.empty() && values.size() == 1 ){
+    if( items[0] == "uniaxial" ) return uniaxial(values[0]);
+    if( items[0] == "biaxial"  ) return biaxial(values[0]);
+    if( items[0] == "shear"    ) return shear(values[0]);
+  }
+  if( !items.empty() && items[0] == "prestrain" && values.size() == 3 )
+    return diagonal(values[0],values[1],values[2]);
+  std::stringstream errormessage;
+  errormessage << "DeformationTensor::parse: unknown deformation " << spec 
+               << " (use uniaxial:l, biaxial:l, shear:g or prestrain:px:py:pz)";
+  throw std::runtime_error(errormessage.str());
+}
+
+inline std::vector<double> DeformationTensor::transform(const std::vector<double>& M) const{
+  //full symmetric matrix 
+  double m[3][3]={{M[0],M[3],M[4]},{M[3],M[1],M[5]},{M[4],M[5],M[2]}};
+  double FM[3][3];
+  for(int a=0;a<3;a++) for(int b=0;b<3;b++){
+    FM[a][b]=0.;
+    for(int c=0;c<3;c++) FM[a][b]+=F[a][c]*m[c][b];
+  }
+  double result[3][3];
+  for(int a=0;a<3;a++) for(int b=0;b<3;b++){
+    result[a][b]=0.;
+    for(int c=0;c<3;c++) result[a][b]+=FM[a][c]*F[b][c];
+  }
+  std::vector<double> transformed(6);
+  transformed[0]=result[0][0]; transformed[1]=result[1][1]; transformed[2]=result[2][2];
+  transformed[3]=result[0][1]; transformed[4]=result[0][2]; transformed[5]=result[1][2];
+  return transformed;
+}
+
+inline double DeformationTensor::modulus(const std::vector<double>& stress) const{
+  double strain(0.), stressDifference(0.);
+  switch(type){
+    case UNIAXIAL: 
+      strain=parameter*parameter-1./parameter;
+      stressDifference=stress[0]-0.5*(stress[1]+stress[2]);
+      break;
+    case BIAXIAL: 
+      strain=parameter*parameter-1./(parameter*parameter*parameter*parameter);
+      stressDifference=stress[0]-stress[2];
+      break;
+    case SHEAR: 
+      strain=parameter;
+      stressDifference=stress[3];
+      break;
+    default: 
+      break;
+  }
+  if( std::abs(strain) < 1.E-12 )
+    return std::numeric_limits<double>::quiet_NaN();
+  return stressDifference/strain;
+}
+
+#endif /*LEMONADE_PM_UTILITY_DEFORMATIONTENSOR_H*/
@@ -0,0 +1,167 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UTILITY_DISCRETEDISTRIBUTION_H
+#define LEMONADE_PM_UTILITY_DISCRETEDISTRIBUTION_H
+
+#include <stdint.h>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+/*****************************************************************************/
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @class DiscreteDistribution
+ * @brief Distribution of the values 0..size()-1 with O(1) sampling.
+ * @details The reference systems of the tendomer networks draw the number of
+ * segments between a crosslink and a fixed monomer (a convolution of the
+ * ring position distributions) millions of times. The weights are stored as 
+ * Walker alias table (Vose's construction): a value is drawn by one uniform 
+ * index and one uniform real number. In contrast to a tabulated inverse 
+ * cumulative distribution, the draw is exact (no quantization and no bias 
+ * by a modulo) and the table has only size() entries.
+ *
+ * The sampling is const, thus several threads may share one distribution if
+ * every thread uses its own random number engine.
+ **/
+/*****************************************************************************/
+class DiscreteDistribution
+{
+public:
+  DiscreteDistribution(){}
+  //! normalizes the weights and builds the alias table
+  explicit DiscreteDistribution(const std::vector<double>& weights){setWeights(weights);}
+
+  //! normalizes the weights and builds the alias table, the weights must be finite, non-negative and not all zero
+  void setWeights(const std::vector<double>& weights);
+
+  //! number of values
+  uint32_t size() const {return probabilities.size();}
+  bool empty() const {return probabilities.empty();}
+  //! probability of value k
+  double getProbability(uint32_t k) const {return k < probabilities.size() ? probabilities[k] : 0.0;}
+  const std::vector<double>& getProbabilities() const {return probabilities;}
+  //! expectation value
+  double getMean() const;
+
+  //! draws a value with a std random number engine
+  template<class URNG>
+  uint32_t operator()(URNG& engine) const;
+
+  //! distribution of the sum of two independent values (exact, O(a.size()*b.size()))
+  static DiscreteDistribution convolve(const DiscreteDistribution& a, const DiscreteDistribution& b);
+
+private:
+  //! normalized weights
+  std::vector<double> probabilities;
+  //! probability to keep the drawn index
+  std::vector<double> keep;
+  //! value returned if the drawn index is not kept
+  std::vector<uint32_t> alias;
+};
+
+/**
+ * @details The construction splits the indices with a scaled probability 
+ * p*size() below and above one. Every small entry is filled up by a large one,
+ * which is then reduced accordingly. Remaining entries keep their index.
+ */
+inline void DiscreteDistribution::setWeights(const std::vector<double>& weights){
+  double total(0.0);
+  for(size_t k=0; k<weights.size(); k++){
+    if( !std::isfinite(weights[k]) || weights[k] < 0.0 ){
+      std::stringstream errormessage;
+      errormessage << "DiscreteDistribution::setWeights: weight " << k << " is " << weights[k] << ".";
+      throw std::runtime_error(errormessage.str());
+    }
+    total+=weights[k];
+  }
+  if( weights.empty() || total <= 0.0 )
+    throw std::runtime_error("DiscreteDistribution::setWeights: the weights are empty or all zero.");
+
+  const uint32_t n(weights.size());
+  probabilities.resize(n);
+  keep.resize(n);
+  alias.resize(n);
+  std::vector<uint32_t> small, large;
+  for(uint32_t k=0; k<n; k++){
+    probabilities[k]=weights[k]/total;
+    keep[k]=probabilities[k]*n;
+    alias[k]=k;
+    if( keep[k] < 1.0 ) small.push_back(k);
+    else                large.push_back(k);
+  }
+  while( !small.empty() && !large.empty() ){
+    const uint32_t s(small.back()), l(large.back());
+    small.pop_back();
+    alias[s]=l;
+    keep[l]=(keep[l]+keep[s])-1.0;
+    if( keep[l] < 1.0 ){
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  //only rounding errors are left
+  for(size_t k=0; k<large.size(); k++) keep[large[k]]=1.0;
+  for(size_t k=0; k<small.size(); k++) keep[small[k]]=1.0;
+}
+
+inline double DiscreteDistribution::getMean() const {
+  double mean(0.0);
+  for(size_t k=0; k<probabilities.size(); k++)
+    mean+=k*probabilities[k];
+  return mean;
+}
+
+template<class URNG>
+uint32_t DiscreteDistribution::operator()(URNG& engine) const {
+  if( probabilities.empty() )
+    throw std::runtime_error("DiscreteDistribution: no weights are set.");
+  std::uniform_int_distribution<uint32_t> drawIndex(0, probabilities.size()-1);
+  std::uniform_real_distribution<double> drawKeep(0.0, 1.0);
+  const uint32_t k(drawIndex(engine));
+  return drawKeep(engine) < keep[k] ? k : alias[k];
+}
+
+inline DiscreteDistribution DiscreteDistribution::convolve(const DiscreteDistribution& a, const DiscreteDistribution& b){
+  if( a.empty() || b.empty() )
+    throw std::runtime_error("DiscreteDistribution::convolve: no weights are set.");
+  std::vector<double> sum(a.size()+b.size()-1, 0.0);
+  for(uint32_t i=0; i<a.size(); i++){
+    if( a.probabilities[i] == 0.0 ) continue;
+    for(uint32_t j=0; j<b.size(); j++)
+      sum[i+j]+=a.probabilities[i]*b.probabilities[j];
+  }
+  return DiscreteDistribution(sum);
+}
+
+#endif /*LEMONADE_PM_UTILITY_DISCRETEDISTRIBUTION_H*/
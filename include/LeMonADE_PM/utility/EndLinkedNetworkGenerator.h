@@ -0,0 +1,515 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UTILITY_ENDLINKEDNETWORKGENERATOR_H
+#define LEMONADE_PM_UTILITY_ENDLINKEDNETWORKGENERATOR_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <LeMonADE/utility/Vector3D.h>
+
+#include <LeMonADE_PM/utility/PhantomReferenceBuilder.h>
+#include <LeMonADE_PM/utility/WorkerPool.h>
+
+/*****************************************************************************/
+/**
+ * @file
+ * @date   2021/06/21
+ * @author Toni
+ *
+ * @class EndLinkedNetworkGenerator
+ * @brief Ideal end-linked model networks of linear chains and crosslinks on the lattice.
+ * @details The network is stoichiometric: nCrosslinks crosslinks of the
+ * functionality f and nCrosslinks*f/2 chains of nMonomersPerChain monomers in
+ * a periodic box. generate(seed) works in four steps:
+ *  - the crosslinks are placed at random lattice sites,
+ *  - the chains are formed between neighboring crosslinks, the partner of a
+ *    crosslink is drawn with the gaussian weight of an ideal strand of
+ *    nMonomersPerChain+1 bonds (cell list, sequential),
+ *  - the chains are random bridges of bond vectors of the classic BFM bond
+ *    set between the two crosslinks (blocks of chains on several threads),
+ *  - the connection history orders the reacted chain ends: RANDOM_HISTORY
+ *    in random order, LOCAL_HISTORY with the distance of the crosslink from
+ *    a random point, thus the network grows as a front through the box.
+ *
+ * Chain ends which find no partner stay unreacted, their chains are random
+ * walks at random positions (sol), see getConversion(). The network is
+ * phantom: there is no excluded volume, but all bonds are valid BFM bond
+ * vectors in the minimum image convention (the chain positions are unfolded
+ * from the first crosslink, the crosslinks lie in the box), thus the files
+ * are read with FeatureMoleculesIOUnsaveCheck like the other inputs. As in
+ * the bfm files of the curing simulations the chains come first, the chain
+ * ends and the crosslinks are reactive. The same parameters and seed give the
+ * same network for any number of threads.
+ **/
+/*****************************************************************************/
+class EndLinkedNetworkGenerator
+{
+public:
+  //! order of the reacted chain ends in the connection table
+  enum History{RANDOM_HISTORY, LOCAL_HISTORY};
+  //! crosslink of an unreacted chain end
+  enum {NO_CROSSLINK=0xFFFFFFFFu};
+
+  EndLinkedNetworkGenerator(uint32_t nCrosslinks_, uint32_t functionality_, uint32_t nMonomersPerChain_);
+
+  //! edge of the cubic box, 0 (default) chooses the BFM melt density of 1/16 monomers per site
+  void setBoxSize(uint32_t boxSize_){boxSize=boxSize_;}
+  uint32_t getBoxSize() const;
+  void setHistory(History history_){history=history_;}
+  History getHistory() const {return history;}
+  //! nThreads_=0 uses the number of hardware threads
+  void setNumThreads(uint32_t nThreads_){nThreads=nThreads_;}
+  uint32_t getNumThreads() const {return nThreads;}
+
+  //! creates the network
+  void generate(uint64_t seed);
+
+  uint32_t getNumOfCrosslinks() const {return nCrosslinks;}
+  uint32_t getFunctionality() const {return functionality;}
+  uint32_t getNumOfMonomersPerChain() const {return nMonomersPerChain;}
+  uint32_t getNumOfChains() const {return nChains;}
+  uint32_t getNumOfMonomers() const {return nChains*nMonomersPerChain+nCrosslinks;}
+  //! ID of the first crosslink, the chains come first
+  uint32_t getFirstCrosslink() const {return nChains*nMonomersPerChain;}
+
+  //! position of a monomer (chains are unfolded, crosslinks are in the box)
+  const VectorInt3& getPosition(uint32_t monomer) const {return positions[monomer];}
+  //! crosslink (counted from 0) bonded to end 0 (first monomer) or 1 (last monomer) of the chain, NO_CROSSLINK if unreacted
+  uint32_t getCrosslink(uint32_t chain, uint32_t end) const {return strandEnds[2*static_cast<size_t>(chain)+end];}
+  //! reacted chain ends (2*chain+end) in the order of the connection history
+  const std::vector<uint32_t>& getConnections() const {return connections;}
+  //! fraction of reacted chain ends
+  double getConversion() const {return static_cast<double>(connections.size())/strandEnds.size();}
+
+  /**
+   * @brief copies the network into empty ingredients
+   * @details The ingredients need FeatureSystemInformationLinearMeltWithCrosslinker
+   * and the reactivity of the monomers (FeatureReactiveBonds). The bond set is
+   * not touched.
+   */
+  template<class IngredientsType>
+  void copyTo(IngredientsType& ingredients) const;
+
+  /**
+   * @brief connection table in the format of UpdaterReadCrosslinkConnections
+   * @details One line "Time ChainID MonID1 P1X P1Y P1Z MonID2 P2X P2Y P2Z"
+   * per reacted chain end in the order of the history (Time counts from 1,
+   * there is no header, UpdaterReadCrosslinkConnections stops at a comment):
+   * MonID1 is the crosslink, MonID2 the crosslink at the other end of the
+   * chain if it has reacted before (otherwise 0), P1 and P2 are their positions.
+   */
+  void writeConnectionTable(const std::string& filename) const;
+
+  //! true if nBonds bond vectors of the classic BFM bond set can add up to (dx,dy,dz)
+  static bool isBridgeable(int32_t dx, int32_t dy, int32_t dz, uint32_t nBonds);
+
+private:
+  const uint32_t nCrosslinks;
+  const uint32_t functionality;
+  const uint32_t nMonomersPerChain;
+  const uint32_t nChains;
+  uint32_t boxSize;
+  History history;
+  uint32_t nThreads;
+
+  std::vector<VectorInt3> bondVectors;
+  //! mean squared bond length of the bond set
+  double bondLength2;
+
+  std::vector<VectorInt3> positions;
+  std::vector<uint32_t> strandEnds;
+  std::vector<uint32_t> connections;
+
+  //! minimum image of a difference of positions in the box
+  static int32_t minImage(int32_t d, int32_t box){
+    d%=box;
+    if( 2*d >  box ) d-=box;
+    if( 2*d < -box ) d+=box;
+    return d;
+  }
+  VectorInt3 minImage(const VectorInt3& a, const VectorInt3& b, int32_t box) const {
+    return VectorInt3(minImage(b.getX()-a.getX(),box),minImage(b.getY()-a.getY(),box),minImage(b.getZ()-a.getZ(),box));
+  }
+  static bool isBondVector(int32_t dx, int32_t dy, int32_t dz);
+
+  void connectChains(std::mt19937_64& engine, int32_t box);
+  template<class RNG>
+  void buildChain(uint32_t chain, int32_t box, RNG& engine);
+  void orderHistory(std::mt19937_64& engine, int32_t box);
+};
+
+/////////////////////////////////////////////////////////////////////////////
+/////////// implementation of the members ///////////////////////////////////
+
+inline EndLinkedNetworkGenerator::EndLinkedNetworkGenerator(uint32_t nCrosslinks_, uint32_t functionality_, uint32_t nMonomersPerChain_)
+:nCrosslinks(nCrosslinks_),functionality(functionality_),nMonomersPerChain(nMonomersPerChain_)
+,nChains(static_cast<uint32_t>(static_cast<uint64_t>(nCrosslinks_)*functionality_/2))
+,boxSize(0),history(RANDOM_HISTORY),nThreads(0),bondLength2(0.)
+{
+  if( nCrosslinks < 2 || functionality < 3 || (static_cast<uint64_t>(nCrosslinks)*functionality) % 2 != 0 ){
+    std::stringstream errormessage;
+    errormessage << "EndLinkedNetworkGenerator: " << nCrosslinks << " crosslinks of functionality " << functionality
+                 << " cannot be connected (at least 2 crosslinks, f>2 and an even number of chain ends)";
+    throw std::runtime_error(errormessage.str());
+  }
+  //two monomers are both chain ends, UpdaterReadCrosslinkConnections would erase the bond in between
+  if( nMonomersPerChain == 0 || nMonomersPerChain == 2 ){
+    std::stringstream errormessage;
+    errormessage << "EndLinkedNetworkGenerator: chains of " << nMonomersPerChain << " monomers are not supported";
+    throw std::runtime_error(errormessage.str());
+  }
+  if( static_cast<uint64_t>(nCrosslinks)*functionality/2*nMonomersPerChain+nCrosslinks > 0xFFFFFFFFu ){
+    std::stringstream errormessage;
+    errormessage << "EndLinkedNetworkGenerator: the monomers exceed the range of the IDs";
+    throw std::runtime_error(errormessage.str());
+  }
+  PhantomReferenceBuilder builder;
+  for(size_t i=0; i<builder.getBondVectors().size(); i++){
+    const VectorDouble3& b(builder.getBondVectors()[i]);
+    bondVectors.push_back(VectorInt3(static_cast<int32_t>(b.getX()),static_cast<int32_t>(b.getY()),static_cast<int32_t>(b.getZ())));
+    bondLength2+=b*b;
+  }
+  bondLength2/=bondVectors.size();
+}
+
+inline uint32_t EndLinkedNetworkGenerator::getBoxSize() const {
+  if( boxSize > 0 ) return boxSize;
+  //even edge, thus the minimum image is symmetric
+  uint32_t edge(static_cast<uint32_t>(std::ceil(std::cbrt(16.*getNumOfMonomers()))));
+  return edge+edge%2;
+}
+
+inline bool EndLinkedNetworkGenerator::isBondVector(int32_t dx, int32_t dy, int32_t dz){
+  int32_t a(std::abs(dx)), b(std::abs(dy)), c(std::abs(dz));
+  if( a < b ) std::swap(a,b);
+  if( b < c ) std::swap(b,c);
+  if( a < b ) std::swap(a,b);
+  if( a == 2 ) return (b == 0 && c == 0) || (b == 1 && c <= 1) || (b == 2 && c == 1);
+  if( a == 3 ) return b <= 1 && c == 0;
+  return false;
+}
+
+/**
+ * @details One bond has to be a bond vector. For two and more bonds the
+ * reachable displacements are max(|d|) <= 2*nBonds and |dx|+|dy|+|dz| <= 4*nBonds-1.
+ * Every displacement of this set for n bonds has a bond vector which leads
+ * into the set for n-1 bonds (checked by enumeration), thus a chain can be
+ * grown bond by bond without getting stuck.
+ **/
+inline bool EndLinkedNetworkGenerator::isBridgeable(int32_t dx, int32_t dy, int32_t dz, uint32_t nBonds){
+  if( nBonds == 0 ) return dx == 0 && dy == 0 && dz == 0;
+  if( nBonds == 1 ) return isBondVector(dx,dy,dz);
+  int64_t a(std::abs(dx)), b(std::abs(dy)), c(std::abs(dz));
+  return std::max(a,std::max(b,c)) <= 2*static_cast<int64_t>(nBonds) && a+b+c <= 4*static_cast<int64_t>(nBonds)-1;
+}
+
+inline void EndLinkedNetworkGenerator::generate(uint64_t seed){
+  const int32_t box(static_cast<int32_t>(getBoxSize()));
+  std::mt19937_64 engine(seed);
+  positions.assign(getNumOfMonomers(),VectorInt3(0,0,0));
+  std::uniform_int_distribution<int32_t> coordinate(0,box-1);
+  for(uint32_t i=0; i<nCrosslinks; i++){
+    const int32_t x(coordinate(engine)), y(coordinate(engine));
+    positions[getFirstCrosslink()+i]=VectorInt3(x,y,coordinate(engine));
+  }
+  connectChains(engine,box);
+  //the chains are built in blocks with own generators, thus the result does not depend on the threads
+  const uint32_t blockSize(4096);
+  const uint32_t nBlocks((nChains+blockSize-1)/blockSize);
+  const uint64_t blockSeed(engine());
+  WorkerPool pool(nThreads);
+  pool.run(nBlocks,[&](uint32_t block, uint32_t){
+    std::seed_seq sequence{static_cast<uint32_t>(blockSeed),static_cast<uint32_t>(blockSeed>>32),block};
+    std::mt19937_64 blockEngine(sequence);
+    const uint32_t last(std::min(nChains,(block+1)*blockSize));
+    for(uint32_t chain=block*blockSize; chain<last; chain++)
+      buildChain(chain,box,blockEngine);
+  });
+  orderHistory(engine,box);
+}
+
+/**
+ * @details In every round the crosslinks with free sites try to react once in
+ * random order. The partner is drawn from the crosslinks with free sites in
+ * the neighboring cells (edge about the size of an ideal strand) with the
+ * weight exp(-3r^2/(2(N+1)b^2)) of an ideal strand, as far as a chain can
+ * bridge the distance. Without any reaction in a round, the search extends
+ * to the next shell of cells once.
+ **/
+inline void EndLinkedNetworkGenerator::connectChains(std::mt19937_64& engine, int32_t box){
+  const uint32_t nBonds(nMonomersPerChain+1);
+  const double strandSize2(nBonds*bondLength2);
+  const int32_t cellSize(std::max<int32_t>(1,static_cast<int32_t>(std::ceil(std::sqrt(strandSize2)))));
+  const int32_t nCells(std::max<int32_t>(1,box/cellSize));
+  const uint32_t firstCrosslink(getFirstCrosslink());
+  //crosslinks with free sites per cell
+  std::vector< std::vector<uint32_t> > cells(static_cast<size_t>(nCells)*nCells*nCells);
+  std::vector<uint32_t> cellOf(nCrosslinks), slotOf(nCrosslinks), freeSites(nCrosslinks,functionality);
+  for(uint32_t i=0; i<nCrosslinks; i++){
+    const VectorInt3& p(positions[firstCrosslink+i]);
+    int64_t cx(static_cast<int64_t>(p.getX())*nCells/box), cy(static_cast<int64_t>(p.getY())*nCells/box), cz(static_cast<int64_t>(p.getZ())*nCells/box);
+    cellOf[i]=static_cast<uint32_t>((cx*nCells+cy)*nCells+cz);
+    slotOf[i]=cells[cellOf[i]].size();
+    cells[cellOf[i]].push_back(i);
+  }
+  auto react=[&](uint32_t i){
+    if( --freeSites[i] > 0 ) return;
+    std::vector<uint32_t>& cell(cells[cellOf[i]]);
+    cell[slotOf[i]]=cell.back();
+    slotOf[cell.back()]=slotOf[i];
+    cell.pop_back();
+  };
+
+  strandEnds.assign(2*static_cast<size_t>(nChains),NO_CROSSLINK);
+  uint32_t nConnected(0);
+  std::vector<uint32_t> order(nCrosslinks);
+  std::vector<uint32_t> candidates;
+  std::vector<double> weights;
+  for(int32_t shell=1; shell<=2 && nConnected<nChains; ){
+    order.clear();
+    for(uint32_t i=0; i<nCrosslinks; i++)
+      if( freeSites[i] > 0 ) order.push_back(i);
+    std::shuffle(order.begin(),order.end(),engine);
+    const int32_t span(std::min(2*shell+1,nCells));
+    uint32_t nReactions(0);
+    for(size_t k=0; k<order.size() && nConnected<nChains; k++){
+      const uint32_t i(order[k]);
+      if( freeSites[i] == 0 ) continue;
+      const VectorInt3& p(positions[firstCrosslink+i]);
+      const int32_t cx(cellOf[i]/(nCells*nCells)), cy((cellOf[i]/nCells)%nCells), cz(cellOf[i]%nCells);
+      const int32_t start( (span == nCells) ? 0 : -shell );
+      candidates.clear();
+      weights.clear();
+      double sum(0.);
+      for(int32_t ox=0; ox<span; ox++)
+        for(int32_t oy=0; oy<span; oy++)
+          for(int32_t oz=0; oz<span; oz++){
+            const int32_t x(((cx+start+ox)%nCells+nCells)%nCells);
+            const int32_t y(((cy+start+oy)%nCells+nCells)%nCells);
+            const int32_t z(((cz+start+oz)%nCells+nCells)%nCells);
+            const std::vector<uint32_t>& cell(cells[(static_cast<size_t>(x)*nCells+y)*nCells+z]);
+            for(size_t n=0; n<cell.size(); n++){
+              const uint32_t j(cell[n]);
+              if( j == i ) continue;
+              VectorInt3 d(minImage(p,positions[firstCrosslink+j],box));
+              if( !isBridgeable(d.getX(),d.getY(),d.getZ(),nBonds) ) continue;
+              sum+=std::exp(-1.5*(d*d)/strandSize2);
+              candidates.push_back(j);
+              weights.push_back(sum);
+            }
+          }
+      if( candidates.empty() ) continue;
+      const double u(std::uniform_real_distribution<double>(0.,sum)(engine));
+      const size_t n(std::min<size_t>(std::upper_bound(weights.begin(),weights.end(),u)-weights.begin(),candidates.size()-1));
+      strandEnds[2*static_cast<size_t>(nConnected)]=i;
+      strandEnds[2*static_cast<size_t>(nConnected)+1]=candidates[n];
+      nConnected++;
+      nReactions++;
+      react(i);
+      react(candidates[n]);
+    }
+    if( nReactions == 0 ) shell++;
+  }
+}
+
+/**
+ * @details A reacted chain is a random bridge: every bond vector is drawn
+ * from those which leave a displacement to the second crosslink that the
+ * remaining bonds can bridge (isBridgeable). Far from that limit all bond
+ * vectors are allowed. An unreacted chain is a random walk from a random site.
+ **/
+template<class RNG>
+void EndLinkedNetworkGenerator::buildChain(uint32_t chain, int32_t box, RNG& engine){
+  const uint32_t first(chain*nMonomersPerChain);
+  const uint32_t firstCrosslink(getFirstCrosslink());
+  std::uniform_int_distribution<size_t> drawBond(0,bondVectors.size()-1);
+  const uint32_t a(strandEnds[2*static_cast<size_t>(chain)]), b(strandEnds[2*static_cast<size_t>(chain)+1]);
+  if( a == NO_CROSSLINK ){
+    std::uniform_int_distribution<int32_t> coordinate(0,box-1);
+    const int32_t x(coordinate(engine)), y(coordinate(engine));
+    positions[first]=VectorInt3(x,y,coordinate(engine));
+    for(uint32_t k=1; k<nMonomersPerChain; k++)
+      positions[first+k]=positions[first+k-1]+bondVectors[drawBond(engine)];
+    return;
+  }
+  VectorInt3 current(positions[firstCrosslink+a]);
+  VectorInt3 rest(minImage(current,positions[firstCrosslink+b],box));
+  std::vector<uint32_t> allowed;
+  allowed.reserve(bondVectors.size());
+  for(uint32_t k=0; k<nMonomersPerChain; k++){
+    //bonds left after this one
+    const int64_t left(nMonomersPerChain-k);
+    const int64_t ax(std::abs(rest.getX())), ay(std::abs(rest.getY())), az(std::abs(rest.getZ()));
+    size_t n;
+    if( left >= 2 && std::max(ax,std::max(ay,az))+3 <= 2*left && ax+ay+az+5 <= 4*left-1 ){
+      n=drawBond(engine);
+    }else{
+      allowed.clear();
+      for(size_t m=0; m<bondVectors.size(); m++){
+        const VectorInt3 next(rest-bondVectors[m]);
+        if( isBridgeable(next.getX(),next.getY(),next.getZ(),static_cast<uint32_t>(left)) )
+          allowed.push_back(static_cast<uint32_t>(m));
+      }
+      if( allowed.empty() ){
+        std::stringstream errormessage;
+        errormessage << "EndLinkedNetworkGenerator: chain " << chain << " cannot bridge " << rest << " with " << left+1 << " bonds";
+        throw std::runtime_error(errormessage.str());
+      }
+      n=allowed[std::uniform_int_distribution<size_t>(0,allowed.size()-1)(engine)];
+    }
+    current+=bondVectors[n];
+    rest-=bondVectors[n];
+    positions[first+k]=current;
+  }
+}
+
+inline void EndLinkedNetworkGenerator::orderHistory(std::mt19937_64& engine, int32_t box){
+  connections.clear();
+  for(uint32_t end=0; end<strandEnds.size(); end++)
+    if( strandEnds[end] != NO_CROSSLINK )
+      connections.push_back(end);
+  std::shuffle(connections.begin(),connections.end(),engine);
+  if( history == LOCAL_HISTORY ){
+    std::uniform_int_distribution<int32_t> coordinate(0,box-1);
+    const int32_t x(coordinate(engine)), y(coordinate(engine));
+    const VectorInt3 center(x,y,coordinate(engine));
+    const uint32_t firstCrosslink(getFirstCrosslink());
+    std::vector<int64_t> distance(nCrosslinks);
+    for(uint32_t i=0; i<nCrosslinks; i++){
+      VectorInt3 d(minImage(center,positions[firstCrosslink+i],box));
+      distance[i]=static_cast<int64_t>(d.getX())*d.getX()+static_cast<int64_t>(d.getY())*d.getY()+static_cast<int64_t>(d.getZ())*d.getZ();
+    }
+    //the shuffle gives the random order of equal distances
+    std::stable_sort(connections.begin(),connections.end(),[&](uint32_t a, uint32_t b){
+      return distance[strandEnds[a]] < distance[strandEnds[b]];
+    });
+  }
+}
+
+template<class IngredientsType>
+void EndLinkedNetworkGenerator::copyTo(IngredientsType& ingredients) const {
+  if( positions.empty() )
+    throw std::runtime_error("EndLinkedNetworkGenerator::copyTo: call generate() first");
+  const uint32_t box(getBoxSize());
+  ingredients.setBoxX(box);
+  ingredients.setBoxY(box);
+  ingredients.setBoxZ(box);
+  ingredients.setPeriodicX(true);
+  ingredients.setPeriodicY(true);
+  ingredients.setPeriodicZ(true);
+  ingredients.setNumOfChains(nChains);
+  ingredients.setNumOfCrosslinks(nCrosslinks);
+  ingredients.setNumOfMonomersPerChain(nMonomersPerChain);
+  ingredients.setNumOfMonomersPerCrosslink(1);
+  ingredients.setFunctionality(functionality);
+
+  auto& molecules(ingredients.modifyMolecules());
+  const uint32_t firstCrosslink(getFirstCrosslink());
+  molecules.resize(getNumOfMonomers());
+  //positions and reactivity of distinct monomers are independent
+  const uint32_t blockSize(1<<16);
+  WorkerPool pool(nThreads);
+  pool.run((getNumOfMonomers()+blockSize-1)/blockSize,[&](uint32_t block, uint32_t){
+    const uint32_t last(std::min(getNumOfMonomers(),(block+1)*blockSize));
+    for(uint32_t i=block*blockSize; i<last; i++){
+      molecules[i].modifyVector3D()=positions[i];
+      if( i >= firstCrosslink ){
+        molecules[i].setReactive(true);
+        molecules[i].setNumMaxLinks(functionality);
+      }else if( i % nMonomersPerChain == 0 || i % nMonomersPerChain == nMonomersPerChain-1 ){
+        molecules[i].setReactive(true);
+        molecules[i].setNumMaxLinks(2);
+      }
+    }
+  });
+  //bonds along the chains, then the reacted chain ends
+  for(uint32_t chain=0; chain<nChains; chain++){
+    const uint32_t first(chain*nMonomersPerChain);
+    for(uint32_t k=first+1; k<first+nMonomersPerChain; k++)
+      molecules.connect(k-1,k);
+  }
+  for(uint32_t chain=0; chain<nChains; chain++){
+    const uint32_t first(chain*nMonomersPerChain);
+    if( getCrosslink(chain,0) != NO_CROSSLINK )
+      molecules.connect(first,firstCrosslink+getCrosslink(chain,0));
+    if( getCrosslink(chain,1) != NO_CROSSLINK )
+      molecules.connect(first+nMonomersPerChain-1,firstCrosslink+getCrosslink(chain,1));
+  }
+}
+
+/**
+ * @details The lines are formatted in blocks on several threads and written
+ * in order.
+ **/
+inline void EndLinkedNetworkGenerator::writeConnectionTable(const std::string& filename) const {
+  std::ofstream out(filename.c_str());
+  if( !out.good() )
+    throw std::runtime_error("EndLinkedNetworkGenerator::writeConnectionTable: cannot open " + filename);
+  const uint32_t firstCrosslink(getFirstCrosslink());
+  //time of the reaction of every chain end
+  std::vector<uint32_t> time(strandEnds.size(),NO_CROSSLINK);
+  for(uint32_t t=0; t<connections.size(); t++)
+    time[connections[t]]=t;
+  const uint32_t blockSize(1<<16);
+  const uint32_t nBlocks((connections.size()+blockSize-1)/blockSize);
+  std::vector<std::string> blocks(nBlocks);
+  WorkerPool pool(nThreads);
+  pool.run(nBlocks,[&](uint32_t block, uint32_t){
+    std::stringstream lines;
+    const uint32_t last(std::min<uint32_t>(connections.size(),(block+1)*blockSize));
+    for(uint32_t t=block*blockSize; t<last; t++){
+      const uint32_t end(connections[t]), other(end ^ 1);
+      const VectorInt3& p1(positions[firstCrosslink+strandEnds[end]]);
+      lines << t+1 << " " << end/2 << " " << firstCrosslink+strandEnds[end] << " "
+            << p1.getX() << " " << p1.getY() << " " << p1.getZ() << " ";
+      if( time[other] < t ){
+        const VectorInt3& p2(positions[firstCrosslink+strandEnds[other]]);
+        lines << firstCrosslink+strandEnds[other] << " " << p2.getX() << " " << p2.getY() << " " << p2.getZ() << "\n";
+      }else
+        lines << "0 0 0 0\n";
+    }
+    blocks[block]=lines.str();
+  });
+  for(uint32_t block=0; block<nBlocks; block++){
+    out << blocks[block];
+    std::string().swap(blocks[block]);
+  }
+  if( !out.good() )
+    throw std::runtime_error("EndLinkedNetworkGenerator::writeConnectionTable: cannot write " + filename);
+}
+
+#endif /*LEMONADE_PM_UTILITY_ENDLINKEDNETWORKGENERATOR_H*/
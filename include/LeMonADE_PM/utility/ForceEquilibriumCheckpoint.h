@@ -0,0 +1,270 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UTILITY_FORCEEQUILIBRIUMCHECKPOINT_H
+#define LEMONADE_PM_UTILITY_FORCEEQUILIBRIUMCHECKPOINT_H
+
+#include <stdint.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <LeMonADE/utility/Vector3D.h>
+#include <LeMonADE_PM/utility/neighborX.h>
+
+/*****************************************************************************/
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @class ForceEquilibriumCheckpoint
+ * @brief Binary snapshot of the state of a force equilibration.
+ * @details The checkpoint contains the crosslink positions, the relaxation
+ * parameter of the move, the state of the random number generator used to
+ * pick the crosslinks, the molecules age and the index of the conversion (or
+ * strain) step of a sweep. A topology fingerprint (number of monomers and a
+ * hash over the crosslink neighbor IDs and segment distances) guards against
+ * restarting with a different network.
+ * Files are written to "<filename>.tmp" first and renamed afterwards, thus an
+ * interrupted write never destroys the last valid checkpoint.
+ **/
+/*****************************************************************************/
+class ForceEquilibriumCheckpoint
+{
+public:
+  ForceEquilibriumCheckpoint():
+    conversionIndex(0),completed(false),startAge(0),age(0),
+    relaxationParameter(1.0),nMonomers(0),topologyHash(0){};
+
+  //! store positions and the topology fingerprint of the crosslinks IDs
+  template<class IngredientsType>
+  void store(const IngredientsType& ing, const std::vector<uint32_t>& IDs);
+  //! check the topology fingerprint and set the crosslink positions
+  template<class IngredientsType>
+  void restore(IngredientsType& ing) const;
+  //! hash over the crosslink neighbor tables (IDs and segment distances)
+  template<class IngredientsType>
+  static uint64_t computeTopologyHash(const IngredientsType& ing, const std::vector<uint32_t>& IDs);
+
+  //! write the checkpoint atomically (temporary file + rename)
+  void write(const std::string& filename) const;
+  //! read a checkpoint written by write()
+  void read(const std::string& filename);
+
+  uint32_t getConversionIndex() const {return conversionIndex;}
+  void setConversionIndex(uint32_t index) {conversionIndex=index;}
+  //! true if the equilibration of the stored conversion index was finished
+  bool isCompleted() const {return completed;}
+  void setCompleted(bool completed_) {completed=completed_;}
+  uint64_t getStartAge() const {return startAge;}
+  void setStartAge(uint64_t age_) {startAge=age_;}
+  uint64_t getAge() const {return age;}
+  void setAge(uint64_t age_) {age=age_;}
+  double getRelaxationParameter() const {return relaxationParameter;}
+  void setRelaxationParameter(double relax) {relaxationParameter=relax;}
+  //! serialized state of the random number generator
+  const std::string& getRngState() const {return rngState;}
+  void setRngState(const std::string& state) {rngState=state;}
+  uint32_t getNumCrosslinks() const {return crosslinkIDs.size();}
+
+private:
+  //! index of the conversion or strain step
+  uint32_t conversionIndex;
+  //! equilibration of conversionIndex finished
+  bool completed;
+  //! molecules age at the start of the equilibration
+  uint64_t startAge;
+  //! molecules age at the checkpoint
+  uint64_t age;
+  //! relaxation parameter of the move
+  double relaxationParameter;
+  //! serialized random number generator
+  std::string rngState;
+  //! number of monomers in the system (fingerprint)
+  uint64_t nMonomers;
+  //! hash of the crosslink neighbor tables (fingerprint)
+  uint64_t topologyHash;
+  //! IDs of the stored crosslinks
+  std::vector<uint32_t> crosslinkIDs;
+  //! positions of the stored crosslinks: x,y,z for each entry in crosslinkIDs
+  std::vector<double> positions;
+
+  //! first bytes of each checkpoint file
+  static const char* magic() {return "LPMCKPT1";}
+  //! version of the file layout
+  static uint32_t version() {return 1;}
+
+  template<class T> static void writeValue(std::ostream& out, const T& value){
+    out.write(reinterpret_cast<const char*>(&value),sizeof(T));
+  }
+  template<class T> static void readValue(std::istream& in, T& value){
+    in.read(reinterpret_cast<char*>(&value),sizeof(T));
+  }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+/////////// implementation of the members ///////////////////////////////////
+
+template<class IngredientsType>
+void ForceEquilibriumCheckpoint::store(const IngredientsType& ing, const std::vector<uint32_t>& IDs)
+{
+  nMonomers=ing.getMolecules().size();
+  topologyHash=computeTopologyHash(ing,IDs);
+  crosslinkIDs=IDs;
+  positions.resize(3*IDs.size());
+  for(size_t i=0; i<IDs.size(); i++){
+    VectorDouble3 pos(ing.getMolecules()[IDs[i]].getVector3D());
+    positions[3*i  ]=pos.getX();
+    positions[3*i+1]=pos.getY();
+    positions[3*i+2]=pos.getZ();
+  }
+}
+
+template<class IngredientsType>
+void ForceEquilibriumCheckpoint::restore(IngredientsType& ing) const
+{
+  if( nMonomers != ing.getMolecules().size() || topologyHash != computeTopologyHash(ing,crosslinkIDs) ){
+    std::stringstream errormessage;
+    errormessage << "ForceEquilibriumCheckpoint::restore: the checkpoint does not fit to the system: "
+                 << nMonomers << " monomers in the checkpoint and "
+                 << ing.getMolecules().size() << " in the system or the crosslink topology differs.";
+    throw std::runtime_error(errormessage.str());
+  }
+  for(size_t i=0; i<crosslinkIDs.size(); i++)
+    ing.modifyMolecules()[crosslinkIDs[i]].modifyVector3D()=VectorDouble3(positions[3*i],positions[3*i+1],positions[3*i+2]);
+}
+
+template<class IngredientsType>
+uint64_t ForceEquilibriumCheckpoint::computeTopologyHash(const IngredientsType& ing, const std::vector<uint32_t>& IDs)
+{
+  //FNV-1a
+  uint64_t hash(14695981039346656037ULL);
+  const uint64_t prime(1099511628211ULL);
+  for(size_t i=0; i<IDs.size(); i++){
+    hash=(hash^IDs[i])*prime;
+    std::vector<neighborX> neighbors(ing.getCrossLinkNeighborIDs(IDs[i]));
+    for(size_t j=0; j<neighbors.size(); j++){
+      hash=(hash^static_cast<uint32_t>(neighbors[j].ID))*prime;
+      hash=(hash^neighbors[j].segDistance)*prime;
+    }
+  }
+  return hash;
+}
+
+inline void ForceEquilibriumCheckpoint::write(const std::string& filename) const
+{
+  const std::string tmpname(filename+".tmp");
+  std::ofstream out(tmpname.c_str(), std::ios::binary | std::ios::trunc);
+  if( !out.is_open() ){
+    std::stringstream errormessage;
+    errormessage << "ForceEquilibriumCheckpoint::write: cannot open " << tmpname;
+    throw std::runtime_error(errormessage.str());
+  }
+  out.write(magic(),8);
+  writeValue(out,version());
+  writeValue(out,conversionIndex);
+  uint8_t completedFlag(completed ? 1 : 0);
+  writeValue(out,completedFlag);
+  writeValue(out,startAge);
+  writeValue(out,age);
+  writeValue(out,relaxationParameter);
+  writeValue(out,nMonomers);
+  writeValue(out,topologyHash);
+  uint64_t stateLength(rngState.size());
+  writeValue(out,stateLength);
+  out.write(rngState.data(),stateLength);
+  uint64_t nCrosslinks(crosslinkIDs.size());
+  writeValue(out,nCrosslinks);
+  if(nCrosslinks > 0){
+    out.write(reinterpret_cast<const char*>(&crosslinkIDs[0]),nCrosslinks*sizeof(uint32_t));
+    out.write(reinterpret_cast<const char*>(&positions[0]),3*nCrosslinks*sizeof(double));
+  }
+  out.close();
+  if( out.fail() ){
+    std::stringstream errormessage;
+    errormessage << "ForceEquilibriumCheckpoint::write: writing " << tmpname << " failed.";
+    throw std::runtime_error(errormessage.str());
+  }
+  if( std::rename(tmpname.c_str(),filename.c_str()) != 0 ){
+    std::stringstream errormessage;
+    errormessage << "ForceEquilibriumCheckpoint::write: cannot rename " << tmpname << " to " << filename;
+    throw std::runtime_error(errormessage.str());
+  }
+}
+
+inline void ForceEquilibriumCheckpoint::read(const std::string& filename)
+{
+  std::ifstream in(filename.c_str(), std::ios::binary);
+  char fileMagic[8];
+  uint32_t fileVersion(0);
+  in.read(fileMagic,sizeof(fileMagic));
+  readValue(in,fileVersion);
+  if( !in.good() || std::memcmp(fileMagic,magic(),8) != 0 || fileVersion != version() ){
+    std::stringstream errormessage;
+    errormessage << "ForceEquilibriumCheckpoint::read: " << filename << " is not a checkpoint file of version " << version();
+    throw std::runtime_error(errormessage.str());
+  }
+  readValue(in,conversionIndex);
+  uint8_t completedFlag(0);
+  readValue(in,completedFlag);
+  completed=(completedFlag != 0);
+  readValue(in,startAge);
+  readValue(in,age);
+  readValue(in,relaxationParameter);
+  readValue(in,nMonomers);
+  readValue(in,topologyHash);
+  uint64_t stateLength(0);
+  readValue(in,stateLength);
+  rngState.resize(stateLength);
+  if(stateLength > 0)
+    in.read(&rngState[0],stateLength);
+  uint64_t nCrosslinks(0);
+  readValue(in,nCrosslinks);
+  if( !in.good() || nCrosslinks > nMonomers ){
+    std::stringstream errormessage;
+    errormessage << "ForceEquilibriumCheckpoint::read: corrupted header in " << filename;
+    throw std::runtime_error(errormessage.str());
+  }
+  crosslinkIDs.resize(nCrosslinks);
+  positions.resize(3*nCrosslinks);
+  if(nCrosslinks > 0){
+    in.read(reinterpret_cast<char*>(&crosslinkIDs[0]),nCrosslinks*sizeof(uint32_t));
+    in.read(reinterpret_cast<char*>(&positions[0]),3*nCrosslinks*sizeof(double));
+  }
+  if( in.fail() ){
+    std::stringstream errormessage;
+    errormessage << "ForceEquilibriumCheckpoint::read: " << filename << " is truncated.";
+    throw std::runtime_error(errormessage.str());
+  }
+}
+
+#endif /*LEMONADE_PM_UTILITY_FORCEEQUILIBRIUMCHECKPOINT_H*/
@@ -0,0 +1,135 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UTILITY_INGREDIENTSCONVERSION_H
+#define LEMONADE_PM_UTILITY_INGREDIENTSCONVERSION_H
+
+#include <stdint.h>
+
+#include <LeMonADE_PM/utility/RunReport.h>
+
+/*****************************************************************************/
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @brief Bulk copy of a (lattice) system into the off-lattice system used for
+ * the force equilibration.
+ * @details All force equilibration programs read or build a system with integer
+ * positions and hand it over to an Ingredients with VectorDouble3 positions.
+ * IngredientsConversion::copy does this in one pass:
+ *  - box and periodicity and the molecules age are copied,
+ *  - the target molecules are resized once, such that the adjacency is allocated
+ *    before any bond is inserted,
+ *  - positions and the monomer extensions known to both systems (reactivity,
+ *    number of max links and the movable tag) are copied in parallel over the
+ *    monomer range (if compiled with OpenMP),
+ *  - every undirected bond is inserted exactly once (from the monomer with the
+ *    lower index), thus no areConnected check is needed.
+ *
+ * The system information features (e.g. number of chains or tendomers) are not
+ * copied, because they differ between the programs.
+ * The source is not modified. Keep the source Ingredients in a scope which ends
+ * after the copy, such that its memory is released before the equilibration starts.
+ **/
+/*****************************************************************************/
+namespace IngredientsConversion
+{
+  namespace detail
+  {
+    //! copy reactivity and the number of max links if both monomer types have it
+    template<class SourceMonomer, class TargetMonomer>
+    auto copyReactivity(const SourceMonomer& source, TargetMonomer& target, int)
+      -> decltype(target.setReactive(source.isReactive()), target.setNumMaxLinks(source.getNumMaxLinks()), void())
+    {
+      target.setReactive(source.isReactive());
+      target.setNumMaxLinks(source.getNumMaxLinks());
+    }
+    //! fallback: one of the monomer types has no reactivity
+    template<class SourceMonomer, class TargetMonomer>
+    void copyReactivity(const SourceMonomer& source, TargetMonomer& target, long){}
+
+    //! copy the movable tag if both monomer types have it
+    template<class SourceMonomer, class TargetMonomer>
+    auto copyMovableTag(const SourceMonomer& source, TargetMonomer& target, int)
+      -> decltype(target.setMovableTag(source.getMovableTag()), void())
+    {
+      target.setMovableTag(source.getMovableTag());
+    }
+    //! fallback: one of the monomer types has no movable tag
+    template<class SourceMonomer, class TargetMonomer>
+    void copyMovableTag(const SourceMonomer& source, TargetMonomer& target, long){}
+  }
+
+  /**
+   * @brief copy box, positions, monomer extensions and bonds from source to target
+   * @details The target molecules are overwritten. Call target.synchronize()
+   * afterwards to build the lookup tables of the target features.
+   * @param source system with the (integer) positions
+   * @param target (empty) off-lattice system
+   */
+  template<class SourceIngredients, class TargetIngredients>
+  void copy(const SourceIngredients& source, TargetIngredients& target)
+  {
+    LEMONADE_PM_PHASE("copyIngredients");
+    target.setBoxX(source.getBoxX());
+    target.setBoxY(source.getBoxY());
+    target.setBoxZ(source.getBoxZ());
+    target.setPeriodicX(source.isPeriodicX());
+    target.setPeriodicY(source.isPeriodicY());
+    target.setPeriodicZ(source.isPeriodicZ());
+
+    const auto& sourceMolecules(source.getMolecules());
+    auto& targetMolecules(target.modifyMolecules());
+    const int64_t nMonomers(sourceMolecules.size());
+
+    targetMolecules.resize(nMonomers);
+    targetMolecules.setAge(sourceMolecules.getAge());
+
+    //vertex data is independent for each monomer
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for(int64_t i = 0; i < nMonomers; i++){
+      targetMolecules[i].modifyVector3D()=sourceMolecules[i].getVector3D();
+      detail::copyReactivity(sourceMolecules[i], targetMolecules[i], 0);
+      detail::copyMovableTag(sourceMolecules[i], targetMolecules[i], 0);
+    }
+
+    //the edge container is shared, thus the bonds are inserted serially
+    for(int64_t i = 0; i < nMonomers; i++){
+      for(uint32_t j = 0; j < sourceMolecules.getNumLinks(i); j++){
+        uint32_t neighbor(sourceMolecules.getNeighborIdx(i,j));
+        if( neighbor > i )
+          targetMolecules.connect(i,neighbor);
+      }
+    }
+  }
+}
+
+#endif /*LEMONADE_PM_UTILITY_INGREDIENTSCONVERSION_H*/
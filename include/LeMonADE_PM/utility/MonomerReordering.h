@@ -0,0 +1,188 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UTILITY_MONOMERREORDERING_H
+#define LEMONADE_PM_UTILITY_MONOMERREORDERING_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*****************************************************************************/
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @brief In-place renumbering of the monomers.
+ * @details The creation updaters sort the monomers such that every connected
+ * group is stored as one block in depth first order (linearizeSystem). Copying
+ * every group into a new Ingredients doubles the memory, thus here the order is
+ * computed as a permutation in one pass over the bonds and applied in place:
+ *  - the monomers (position and all extensions) are moved along the cycles of
+ *    the permutation, the cycles are distributed over the threads (if compiled
+ *    with OpenMP),
+ *  - the bonds are stored once as a list of renumbered pairs, removed and
+ *    inserted again (serially, because the edge container is shared).
+ *
+ * Only an index vector and the bond list are allocated. Lookups of the 
+ * features which use monomer indices have to be rebuilt by synchronize().
+ **/
+/*****************************************************************************/
+namespace MonomerReordering
+{
+  namespace detail
+  {
+    //! bond with the renumbered monomers and the link information if the molecules have it
+    template<class Info>
+    struct Bond{
+      uint32_t a, b;
+      Info info;
+      bool operator<(const Bond& other) const {return a < other.a || (a == other.a && b < other.b);}
+    };
+    //! placeholder for molecules without link information
+    struct NoInfo{};
+
+    template<class MoleculesType>
+    auto linkInfo(const MoleculesType& molecules, uint32_t a, uint32_t b, int) -> decltype(molecules.getLinkInfo(a,b)) {return molecules.getLinkInfo(a,b);}
+    template<class MoleculesType>
+    NoInfo linkInfo(const MoleculesType&, uint32_t, uint32_t, long){return NoInfo();}
+
+    template<class MoleculesType, class Info>
+    void connect(MoleculesType& molecules, uint32_t a, uint32_t b, const Info& info){molecules.connect(a,b,info);}
+    template<class MoleculesType>
+    void connect(MoleculesType& molecules, uint32_t a, uint32_t b, const NoInfo&){molecules.connect(a,b);}
+  }
+
+  /**
+   * @brief depth first order of all connected groups
+   * @details The groups start at their monomer with the lowest index and the 
+   * neighbors are visited in the order of the links, as the DepthIterator of
+   * linearizeSystem does. Thus, a branch of a star is stored in one block.
+   * @return order[new index]=old index
+   */
+  template<class MoleculesType>
+  std::vector<uint32_t> depthFirstOrder(const MoleculesType& molecules)
+  {
+    const uint32_t nMonomers(molecules.size());
+    std::vector<uint32_t> order;
+    order.reserve(nMonomers);
+    std::vector<bool> visited(nMonomers,false);
+    //monomer and the next link to follow
+    std::vector< std::pair<uint32_t,uint32_t> > stack;
+    for(uint32_t start=0; start<nMonomers; start++){
+      if( visited[start] ) continue;
+      visited[start]=true;
+      order.push_back(start);
+      stack.push_back(std::make_pair(start,0u));
+      while( !stack.empty() ){
+        std::pair<uint32_t,uint32_t>& top(stack.back());
+        if( top.second == molecules.getNumLinks(top.first) ){
+          stack.pop_back();
+          continue;
+        }
+        const uint32_t neighbor(molecules.getNeighborIdx(top.first,top.second++));
+        if( visited[neighbor] ) continue;
+        visited[neighbor]=true;
+        order.push_back(neighbor);
+        stack.push_back(std::make_pair(neighbor,0u));
+      }
+    }
+    return order;
+  }
+
+  /**
+   * @brief moves monomer order[i] to index i for all i
+   * @details The links of every monomer are sorted by the new index afterwards.
+   * @param order permutation of 0..size-1 (e.g. from depthFirstOrder)
+   */
+  template<class MoleculesType>
+  void apply(MoleculesType& molecules, const std::vector<uint32_t>& order)
+  {
+    const uint32_t nMonomers(molecules.size());
+    if( order.size() != nMonomers ){
+      std::stringstream errormessage;
+      errormessage << "MonomerReordering::apply: order has " << order.size() << " entries for " << nMonomers << " monomers.";
+      throw std::runtime_error(errormessage.str());
+    }
+    std::vector<uint32_t> newIndex(nMonomers,nMonomers);
+    for(uint32_t i=0; i<nMonomers; i++){
+      if( order[i] >= nMonomers || newIndex[order[i]] != nMonomers )
+        throw std::runtime_error("MonomerReordering::apply: order is not a permutation.");
+      newIndex[order[i]]=i;
+    }
+
+    //renumbered bonds, each once
+    typedef typename std::decay<decltype(detail::linkInfo(molecules,0,0,0))>::type Info;
+    std::vector< detail::Bond<Info> > bonds;
+    for(uint32_t i=0; i<nMonomers; i++)
+      for(uint32_t j=0; j<molecules.getNumLinks(i); j++){
+        const uint32_t neighbor(molecules.getNeighborIdx(i,j));
+        if( neighbor <= i ) continue;
+        detail::Bond<Info> bond={std::min(newIndex[i],newIndex[neighbor]),std::max(newIndex[i],newIndex[neighbor]),detail::linkInfo(molecules,i,neighbor,0)};
+        bonds.push_back(bond);
+      }
+    for(uint32_t i=0; i<nMonomers; i++)
+      while( molecules.getNumLinks(i) > 0 )
+        molecules.disconnect(i,molecules.getNeighborIdx(i,0));
+
+    //one leader per cycle, found without touching the monomers
+    std::vector<uint32_t> leaders;
+    std::vector<bool> done(nMonomers,false);
+    for(uint32_t i=0; i<nMonomers; i++){
+      if( done[i] || order[i] == i ) continue;
+      leaders.push_back(i);
+      for(uint32_t j=i; !done[j]; j=order[j])
+        done[j]=true;
+    }
+    //the cycles are disjoint
+    const int64_t nCycles(leaders.size());
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic,64)
+#endif
+    for(int64_t c=0; c<nCycles; c++){
+      const uint32_t leader(leaders[c]);
+      const auto first(molecules[leader]);
+      uint32_t j(leader);
+      while( order[j] != leader ){
+        molecules[j]=molecules[order[j]];
+        j=order[j];
+      }
+      molecules[j]=first;
+    }
+
+    std::sort(bonds.begin(),bonds.end());
+    for(size_t k=0; k<bonds.size(); k++)
+      detail::connect(molecules,bonds[k].a,bonds[k].b,bonds[k].info);
+  }
+}
+
+#endif /*LEMONADE_PM_UTILITY_MONOMERREORDERING_H*/
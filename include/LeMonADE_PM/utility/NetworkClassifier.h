@@ -0,0 +1,528 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UTILITY_NETWORKCLASSIFIER_H
+#define LEMONADE_PM_UTILITY_NETWORKCLASSIFIER_H
+
+#include <stdint.h>
+#include <cmath>
+#include <vector>
+#include <sstream>
+#include <stdexcept>
+
+#include <LeMonADE_PM/utility/UnionFind.h>
+
+/*****************************************************************************/
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @class NetworkClassifier
+ * @brief Sol, gel and elastically active part of the crosslink graph.
+ * @details The nodes are the crosslinks, the edges the strands between them
+ * together with the number of periodic images the strand crosses. The tags
+ * are the same as in the active component files: 0-sol, 1-gel/pending,
+ * 2-active. The gel is the largest connected component. A strand is active
+ * if both of its ends are connected to a cycle wrapping the periodic box
+ * without using the strand itself, which is decided in linear time:
+ * - bridges by an iterative Tarjan depth first search (parallel strands allowed)
+ * - contraction of the 2-edge-connected components to the bridge forest
+ * - a component wraps if the image shifts of its strands are not consistent
+ * - a bridge is active if both sides of the bridge forest contain a wrapping
+ *   component, a component is active if it wraps or connects two active bridges
+ *
+ * Closed loops (self-loops without image shift) are never active. Cycles
+ * that are attached to the active part at one single crosslink are counted
+ * as active, because only 2-edge connectivity is checked.
+ **/
+/*****************************************************************************/
+class NetworkClassifier
+{
+public:
+  enum {SOL=0, GEL=1, ACTIVE=2};
+
+  NetworkClassifier():classified(false){}
+
+  //! remove all crosslinks and strands
+  void clear();
+  //! add a crosslink with the monomer ID, returns its node index
+  uint32_t addCrossLink(uint32_t ID);
+  //! add a strand between two crosslinks crossing (sx,sy,sz) periodic images
+  void addStrand(uint32_t ID1, uint32_t ID2, int32_t sx=0, int32_t sy=0, int32_t sz=0);
+  //! classify the graph
+  void classify();
+
+  //! fill the graph from the crosslink lookup of the ingredients and classify it
+  template<class IngredientsType>
+  void classify(const IngredientsType& ingredients);
+
+  //! tag of a crosslink: active if at least one of its strands is active
+  uint32_t getCrossLinkTag(uint32_t ID) const;
+  //! highest tag of the strands between two crosslinks, sol if there is none
+  uint32_t getStrandTag(uint32_t ID1, uint32_t ID2) const;
+  //! true if the crosslink is part of the graph
+  bool hasCrossLink(uint32_t ID) const {return ID < nodeIndex.size() && nodeIndex[ID] >= 0;}
+
+  //! number of crosslinks
+  uint32_t getNumCrossLinks() const {return nodeID.size();}
+  //! number of strands
+  uint32_t getNumStrands() const {return edges.size();}
+  //! number of crosslinks in the gel
+  uint32_t getNumGelCrossLinks() const {return nGelCrossLinks;}
+  //! number of active crosslinks
+  uint32_t getNumActiveCrossLinks() const {return nActiveCrossLinks;}
+  //! number of active strands
+  uint32_t getNumActiveStrands() const {return nActiveStrands;}
+  //! number of connected components of the active crosslinks and strands
+  uint32_t getNumActiveComponents() const {return nActiveComponents;}
+  //! number of bridges of the crosslink graph
+  uint32_t getNumBridges() const {return nBridges;}
+  //! true if the gel wraps the periodic box
+  bool isGelPercolating() const {return gelPercolating;}
+
+private:
+  struct Edge{
+    uint32_t u,v;
+    int32_t shift[3];
+  };
+  //! monomer ID of the node
+  std::vector<uint32_t> nodeID;
+  //! node index of the monomer ID, -1 for monomers which are no crosslinks
+  std::vector<int32_t> nodeIndex;
+  std::vector<Edge> edges;
+  std::vector<uint8_t> nodeTag;
+  std::vector<uint8_t> edgeTag;
+  //! incident edges of the nodes in compressed row storage
+  std::vector<uint32_t> adjacencyStart;
+  std::vector<uint32_t> adjacency;
+
+  bool classified;
+  bool gelPercolating;
+  uint32_t nGelCrossLinks, nActiveCrossLinks, nActiveStrands, nActiveComponents, nBridges;
+
+  //! node index of a crosslink, throws if the ID is unknown
+  uint32_t getNode(uint32_t ID) const;
+  //! other end of the edge e seen from node n
+  uint32_t otherEnd(uint32_t e, uint32_t n) const {return edges[e].u == n ? edges[e].v : edges[e].u;}
+  //! build the compressed adjacency lists
+  void buildAdjacency();
+  //! marks all bridges by an iterative Tarjan search
+  void findBridges(std::vector<uint8_t>& isBridge) const;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+/////////// implementation of the members ///////////////////////////////////
+
+inline void NetworkClassifier::clear()
+{
+  nodeID.clear();
+  nodeIndex.clear();
+  edges.clear();
+  nodeTag.clear();
+  edgeTag.clear();
+  classified=false;
+}
+
+inline uint32_t NetworkClassifier::addCrossLink(uint32_t ID)
+{
+  if( ID >= nodeIndex.size() )
+    nodeIndex.resize(ID+1,-1);
+  if( nodeIndex[ID] < 0 ){
+    nodeIndex[ID]=nodeID.size();
+    nodeID.push_back(ID);
+  }
+  classified=false;
+  return nodeIndex[ID];
+}
+
+inline uint32_t NetworkClassifier::getNode(uint32_t ID) const
+{
+  if( !hasCrossLink(ID) ){
+    std::stringstream errormessage;
+    errormessage << "NetworkClassifier: Cross Link ID " << ID << " does not exist.";
+    throw std::runtime_error(errormessage.str());
+  }
+  return nodeIndex[ID];
+}
+
+inline void NetworkClassifier::addStrand(uint32_t ID1, uint32_t ID2, int32_t sx, int32_t sy, int32_t sz)
+{
+  Edge edge;
+  edge.u=getNode(ID1);
+  edge.v=getNode(ID2);
+  edge.shift[0]=sx; edge.shift[1]=sy; edge.shift[2]=sz;
+  edges.push_back(edge);
+  classified=false;
+}
+
+/**
+ * @details Every strand is listed by the lookup at both of its crosslinks. It
+ * is added once from the crosslink with the smaller ID, the jump vector is
+ * converted to multiples of the box. Self-loops are listed twice at the same
+ * crosslink and every second entry is skipped.
+ **/
+template<class IngredientsType>
+void NetworkClassifier::classify(const IngredientsType& ingredients)
+{
+  clear();
+  const std::vector<uint32_t>& CrossLinkIDs(ingredients.getCrosslinkIDs());
+  for (size_t i = 0; i < CrossLinkIDs.size(); i++)
+    addCrossLink(CrossLinkIDs[i]);
+  const double box[3]={double(ingredients.getBoxX()),double(ingredients.getBoxY()),double(ingredients.getBoxZ())};
+  for (size_t i = 0; i < CrossLinkIDs.size(); i++){
+    const uint32_t IDx(CrossLinkIDs[i]);
+    auto neighbors(ingredients.getCrossLinkNeighborIDs(IDx));
+    bool skipSelfLoop(false);
+    for (size_t j = 0; j < neighbors.size(); j++){
+      const uint32_t IDy(neighbors[j].ID);
+      if( IDy < IDx ) continue;
+      if( IDy == IDx ){
+        skipSelfLoop=!skipSelfLoop;
+        if( !skipSelfLoop ) continue;
+      }
+      addStrand(IDx, IDy,
+        static_cast<int32_t>(std::floor(neighbors[j].jump.getX()/box[0]+0.5)),
+        static_cast<int32_t>(std::floor(neighbors[j].jump.getY()/box[1]+0.5)),
+        static_cast<int32_t>(std::floor(neighbors[j].jump.getZ()/box[2]+0.5)));
+    }
+  }
+  classify();
+}
+
+inline void NetworkClassifier::buildAdjacency()
+{
+  const uint32_t nNodes(nodeID.size());
+  adjacencyStart.assign(nNodes+1,0);
+  for(size_t e=0; e<edges.size(); e++){
+    adjacencyStart[edges[e].u+1]++;
+    adjacencyStart[edges[e].v+1]++;
+  }
+  for(uint32_t n=0; n<nNodes; n++)
+    adjacencyStart[n+1]+=adjacencyStart[n];
+  adjacency.resize(adjacencyStart[nNodes]);
+  std::vector<uint32_t> fill(adjacencyStart.begin(),adjacencyStart.end()-1);
+  for(uint32_t e=0; e<edges.size(); e++){
+    adjacency[fill[edges[e].u]++]=e;
+    adjacency[fill[edges[e].v]++]=e;
+  }
+}
+
+/**
+ * @details The depth first search keeps its own stack of (node, incoming edge,
+ * position in the adjacency list), thus large networks do not overflow the
+ * call stack. The incoming edge is skipped by its index and not by the parent
+ * node, such that parallel strands are no bridges.
+ **/
+inline void NetworkClassifier::findBridges(std::vector<uint8_t>& isBridge) const
+{
+  const uint32_t nNodes(nodeID.size());
+  const uint32_t none(static_cast<uint32_t>(-1));
+  isBridge.assign(edges.size(),0);
+  std::vector<uint32_t> discovery(nNodes,none), low(nNodes,0);
+  struct Frame{ uint32_t node, edge, next; };
+  std::vector<Frame> stack;
+  uint32_t time(0);
+  for(uint32_t root=0; root<nNodes; root++){
+    if( discovery[root] != none ) continue;
+    discovery[root]=low[root]=time++;
+    Frame start={root,none,adjacencyStart[root]};
+    stack.push_back(start);
+    while( !stack.empty() ){
+      Frame& frame(stack.back());
+      if( frame.next < adjacencyStart[frame.node+1] ){
+        const uint32_t e(adjacency[frame.next++]);
+        if( e == frame.edge ) continue;
+        const uint32_t w(otherEnd(e,frame.node));
+        if( discovery[w] == none ){
+          discovery[w]=low[w]=time++;
+          Frame child={w,e,adjacencyStart[w]};
+          stack.push_back(child);
+        }else if( discovery[w] < low[frame.node] ){
+          low[frame.node]=discovery[w];
+        }
+      }else{
+        const Frame finished(frame);
+        stack.pop_back();
+        if( stack.empty() ) break;
+        const uint32_t parent(stack.back().node);
+        if( low[finished.node] < low[parent] ) low[parent]=low[finished.node];
+        if( low[finished.node] > discovery[parent] ) isBridge[finished.edge]=1;
+      }
+    }
+  }
+}
+
+inline void NetworkClassifier::classify()
+{
+  const uint32_t nNodes(nodeID.size());
+  const uint32_t nEdges(edges.size());
+  const uint32_t none(static_cast<uint32_t>(-1));
+  buildAdjacency();
+
+  //connected components, the largest one is the gel
+  UnionFind components(nNodes);
+  for(uint32_t e=0; e<nEdges; e++)
+    components.unite(edges[e].u,edges[e].v);
+  uint32_t gelRoot(none);
+  for(uint32_t n=0; n<nNodes; n++){
+    uint32_t root(components.find(n));
+    if( gelRoot == none || components.getClusterSize(root) > components.getClusterSize(gelRoot) )
+      gelRoot=root;
+  }
+
+  std::vector<uint8_t> isBridge;
+  findBridges(isBridge);
+  nBridges=0;
+  for(uint32_t e=0; e<nEdges; e++)
+    nBridges+=isBridge[e];
+
+  //2-edge-connected components by a flood fill over the non-bridge strands.
+  //every node gets its periodic image relative to the first node of the
+  //component, an inconsistent strand closes a cycle wrapping the box
+  std::vector<uint32_t> block(nNodes,none);
+  std::vector<int32_t> image(3*nNodes,0);
+  std::vector<uint8_t> blockWraps;
+  std::vector<uint32_t> queue;
+  queue.reserve(nNodes);
+  for(uint32_t root=0; root<nNodes; root++){
+    if( block[root] != none ) continue;
+    const uint32_t b(blockWraps.size());
+    blockWraps.push_back(0);
+    block[root]=b;
+    queue.clear();
+    queue.push_back(root);
+    for(size_t q=0; q<queue.size(); q++){
+      const uint32_t n(queue[q]);
+      for(uint32_t a=adjacencyStart[n]; a<adjacencyStart[n+1]; a++){
+        const uint32_t e(adjacency[a]);
+        if( isBridge[e] ) continue;
+        const uint32_t w(otherEnd(e,n));
+        const int32_t sign( edges[e].u == n ? 1 : -1 );
+        if( block[w] == none ){
+          block[w]=b;
+          for(int d=0; d<3; d++) image[3*w+d]=image[3*n+d]+sign*edges[e].shift[d];
+          queue.push_back(w);
+        }else{
+          for(int d=0; d<3; d++)
+            if( image[3*w+d] != image[3*n+d]+sign*edges[e].shift[d] ) blockWraps[b]=1;
+        }
+      }
+    }
+  }
+
+  //bridge forest: the blocks are the nodes and the bridges the edges. The number
+  //of wrapping blocks in every subtree decides on both sides of a bridge at once
+  const uint32_t nBlocks(blockWraps.size());
+  std::vector< std::vector<uint32_t> > blockBridges(nBlocks);
+  for(uint32_t e=0; e<nEdges; e++)
+    if( isBridge[e] ){
+      blockBridges[block[edges[e].u]].push_back(e);
+      blockBridges[block[edges[e].v]].push_back(e);
+    }
+  std::vector<uint32_t> parentBridge(nBlocks,none), treeRoot(nBlocks,none), order;
+  std::vector<uint32_t> nWrapping(nBlocks,0);
+  order.reserve(nBlocks);
+  for(uint32_t r=0; r<nBlocks; r++){
+    if( treeRoot[r] != none ) continue;
+    treeRoot[r]=r;
+    size_t first(order.size());
+    order.push_back(r);
+    for(size_t q=first; q<order.size(); q++){
+      const uint32_t b(order[q]);
+      for(size_t k=0; k<blockBridges[b].size(); k++){
+        const uint32_t e(blockBridges[b][k]);
+        if( e == parentBridge[b] ) continue;
+        const uint32_t c( block[edges[e].u] == b ? block[edges[e].v] : block[edges[e].u] );
+        treeRoot[c]=r;
+        parentBridge[c]=e;
+        order.push_back(c);
+      }
+    }
+  }
+  for(uint32_t b=0; b<nBlocks; b++)
+    nWrapping[b]=blockWraps[b];
+  for(size_t q=order.size(); q-- > 0; ){
+    const uint32_t b(order[q]);
+    if( parentBridge[b] == none ) continue;
+    const Edge& bridge(edges[parentBridge[b]]);
+    const uint32_t p( block[bridge.u] == b ? block[bridge.v] : block[bridge.u] );
+    nWrapping[p]+=nWrapping[b];
+  }
+
+  edgeTag.assign(nEdges,SOL);
+  std::vector<uint32_t> nActiveBridges(nBlocks,0);
+  for(uint32_t e=0; e<nEdges; e++){
+    if( !isBridge[e] ) continue;
+    const uint32_t bu(block[edges[e].u]), bv(block[edges[e].v]);
+    const uint32_t child( parentBridge[bu] == e ? bu : bv );
+    const uint32_t inSubtree(nWrapping[child]);
+    const uint32_t inTree(nWrapping[treeRoot[child]]);
+    if( inSubtree > 0 && inTree-inSubtree > 0 ){
+      edgeTag[e]=ACTIVE;
+      nActiveBridges[bu]++;
+      nActiveBridges[bv]++;
+    }
+  }
+  for(uint32_t e=0; e<nEdges; e++){
+    if( isBridge[e] ) continue;
+    const Edge& edge(edges[e]);
+    if( edge.u == edge.v && edge.shift[0] == 0 && edge.shift[1] == 0 && edge.shift[2] == 0 ) continue;
+    const uint32_t b(block[edge.u]);
+    if( blockWraps[b] || nActiveBridges[b] >= 2 )
+      edgeTag[e]=ACTIVE;
+  }
+
+  //tags of the crosslinks and of the non-active strands in the gel
+  nodeTag.assign(nNodes,SOL);
+  nGelCrossLinks=nActiveCrossLinks=nActiveStrands=0;
+  gelPercolating=false;
+  for(uint32_t n=0; n<nNodes; n++)
+    if( components.find(n) == gelRoot ){
+      nodeTag[n]=GEL;
+      nGelCrossLinks++;
+      if( blockWraps[block[n]] ) gelPercolating=true;
+    }
+  for(uint32_t e=0; e<nEdges; e++){
+    if( edgeTag[e] == ACTIVE ){
+      nActiveStrands++;
+      nodeTag[edges[e].u]=ACTIVE;
+      nodeTag[edges[e].v]=ACTIVE;
+    }else if( nodeTag[edges[e].u] != SOL ){
+      edgeTag[e]=GEL;
+    }
+  }
+  UnionFind activeComponents(nNodes);
+  for(uint32_t e=0; e<nEdges; e++)
+    if( edgeTag[e] == ACTIVE ) activeComponents.unite(edges[e].u,edges[e].v);
+  nActiveComponents=0;
+  for(uint32_t n=0; n<nNodes; n++)
+    if( nodeTag[n] == ACTIVE ){
+      nActiveCrossLinks++;
+      if( activeComponents.find(n) == n ) nActiveComponents++;
+    }
+  classified=true;
+}
+
+inline uint32_t NetworkClassifier::getCrossLinkTag(uint32_t ID) const
+{
+  if( !classified )
+    throw std::runtime_error("NetworkClassifier::getCrossLinkTag: the network is not classified.");
+  return nodeTag[getNode(ID)];
+}
+
+inline uint32_t NetworkClassifier::getStrandTag(uint32_t ID1, uint32_t ID2) const
+{
+  if( !classified )
+    throw std::runtime_error("NetworkClassifier::getStrandTag: the network is not classified.");
+  const uint32_t n1(getNode(ID1)), n2(getNode(ID2));
+  uint32_t tag(SOL);
+  for(uint32_t a=adjacencyStart[n1]; a<adjacencyStart[n1+1]; a++){
+    const uint32_t e(adjacency[a]);
+    if( otherEnd(e,n1) == n2 && edgeTag[e] > tag ) tag=edgeTag[e];
+  }
+  return tag;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////// tendomer networks ///////////////////////////////////////////////
+
+/**
+ * @brief tags of the crosslinks and tendomers in the order of the active component files
+ * @details The tendomers are stored first, each with nSegments=2*nMonomersPerChain
+ * monomers, followed by the crosslinks. The list contains one tag per crosslink
+ * followed by one tag per tendomer. A tendomer gets the tag of its strand if both
+ * ends are connected to a crosslink, it is pending (gel) if only one end is
+ * connected to a crosslink of the gel, and sol otherwise.
+ * @param ingredients tendomer system with the number of tendomers, crosslinks and monomers per chain
+ * @param network classified crosslink graph of the same system
+ */
+template<class IngredientsType>
+std::vector<uint32_t> getTendomerTags(const IngredientsType& ingredients, const NetworkClassifier& network)
+{
+  const uint32_t nCrossLinks(ingredients.getNumCrossLinkers());
+  const uint32_t nChains(ingredients.getNumTendomers());
+  const uint32_t nMonomersPerChain(ingredients.getNumMonomersPerChain());
+  const uint32_t nSegments(nMonomersPerChain*2);
+  const uint32_t nChainMonomers(nChains*nSegments);
+  const auto& molecules(ingredients.getMolecules());
+  std::vector<uint32_t> tags;
+  tags.reserve(nCrossLinks+nChains);
+  for (uint32_t i = 0; i < nCrossLinks; i++ ){
+    const uint32_t IdX(nChainMonomers+i);
+    tags.push_back( network.hasCrossLink(IdX) ? network.getCrossLinkTag(IdX) : uint32_t(NetworkClassifier::SOL) );
+  }
+  for (uint32_t t = 0; t < nChains; t++ ){
+    std::vector<uint32_t> ends;
+    for (uint32_t end = t*nSegments; end < (t+1)*nSegments; end+=nMonomersPerChain )
+      for (uint32_t j = 0 ; j < molecules.getNumLinks(end); j++){
+        const uint32_t neighbor(molecules.getNeighborIdx(end,j));
+        if( neighbor >= nChainMonomers && network.hasCrossLink(neighbor) ) ends.push_back(neighbor);
+      }
+    uint32_t tag(NetworkClassifier::SOL);
+    if ( ends.size() == 2 )
+      tag=network.getStrandTag(ends[0],ends[1]);
+    else if ( ends.size() == 1 && network.getCrossLinkTag(ends[0]) != NetworkClassifier::SOL )
+      tag=NetworkClassifier::GEL;
+    tags.push_back(tag);
+  }
+  return tags;
+}
+
+/**
+ * @brief set the attribute tag 1 on the monomers of the crosslinks and tendomers with a tag >= minTag
+ * @details All other monomers of the listed objects get the attribute tag 0.
+ * @param ingredients tendomer system with monomer attributes
+ * @param tags one tag per crosslink followed by one tag per tendomer (see getTendomerTags)
+ * @param minTag NetworkClassifier::ACTIVE for the active part, NetworkClassifier::GEL for the gel
+ * @param nTaggedCrossLinks number of tagged crosslinks
+ * @param nTaggedTendomers number of tagged tendomers
+ */
+template<class IngredientsType>
+void tagTendomerMonomers(IngredientsType& ingredients, const std::vector<uint32_t>& tags, uint32_t minTag,
+                         uint32_t& nTaggedCrossLinks, uint32_t& nTaggedTendomers)
+{
+  const uint32_t nCrossLinks(ingredients.getNumCrossLinkers());
+  const uint32_t nSegments(ingredients.getNumMonomersPerChain()*2);
+  const uint32_t nChainMonomers(ingredients.getNumTendomers()*nSegments);
+  nTaggedCrossLinks=0;
+  nTaggedTendomers=0;
+  for (uint32_t objectID = 0; objectID < tags.size(); objectID++ ){
+    const int32_t attribute( tags[objectID] >= minTag ? 1 : 0 );
+    if( objectID < nCrossLinks ){
+      nTaggedCrossLinks+=attribute;
+      ingredients.modifyMolecules()[nChainMonomers+objectID].setAttributeTag(attribute);
+    }else{
+      nTaggedTendomers+=attribute;
+      const uint32_t IdCStart((objectID-nCrossLinks)*nSegments);
+      for (uint32_t i = IdCStart ; i < IdCStart+nSegments; i++ )
+        ingredients.modifyMolecules()[i].setAttributeTag(attribute);
+    }
+  }
+}
+
+#endif /*LEMONADE_PM_UTILITY_NETWORKCLASSIFIER_H*/
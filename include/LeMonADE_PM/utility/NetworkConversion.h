@@ -0,0 +1,101 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UTILITY_NETWORKCONVERSION_H
+#define LEMONADE_PM_UTILITY_NETWORKCONVERSION_H
+
+#include <stdint.h>
+#include <vector>
+
+/*****************************************************************************/
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @brief Conversion of the crosslinks, shared by all analyzers.
+ * @details Only reactive crosslinks are counted. For every reactive crosslink
+ *  - each bond to a reactive monomer is a reacted site,
+ *  - each bond to a non-reactive monomer is an irreversible bond, which does
+ *    not count as reactive site,
+ *  - the reactive sites are the number of max links minus the irreversible bonds.
+ * The conversion is reacted sites / reactive sites, and 0 without reactive sites.
+ **/
+/*****************************************************************************/
+namespace NetworkConversion
+{
+  //! number of reacted and of reactive sites of the crosslinks
+  struct Sites
+  {
+    Sites():reacted(0.0),reactive(0.0){}
+    double reacted;
+    double reactive;
+    //! reacted/reactive, 0 without reactive sites
+    double getConversion() const {return (reactive > 0 ) ? reacted/reactive : 0.0;}
+  };
+
+  /**
+   * @brief count the reacted and the reactive sites of the crosslinks
+   * @param ingredients system with a crosslink lookup (getCrosslinkIDs())
+   */
+  template<class IngredientsType>
+  Sites countSites(const IngredientsType& ingredients)
+  {
+    const auto& molecules(ingredients.getMolecules());
+    const std::vector<uint32_t>& CrossLinkIDs(ingredients.getCrosslinkIDs());
+    const int64_t nCrossLinks(CrossLinkIDs.size());
+    double reacted(0.0), reactive(0.0);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) reduction(+:reacted,reactive)
+#endif
+    for (int64_t i = 0; i < nCrossLinks; i++){
+      uint32_t IDx(CrossLinkIDs[i]);
+      if( !molecules[IDx].isReactive() ) continue;
+      uint32_t nIrreversibleBonds=0;
+      for (uint32_t n = 0 ; n < molecules.getNumLinks(IDx) ;n++){
+        if( molecules[molecules.getNeighborIdx(IDx,n)].isReactive() )
+          reacted++;
+        else
+          nIrreversibleBonds++;
+      }
+      reactive+=(molecules[IDx].getNumMaxLinks()-nIrreversibleBonds);
+    }
+    Sites sites;
+    sites.reacted=reacted;
+    sites.reactive=reactive;
+    return sites;
+  }
+
+  //! conversion of the crosslinks, see countSites
+  template<class IngredientsType>
+  double calculate(const IngredientsType& ingredients)
+  {
+    return countSites(ingredients).getConversion();
+  }
+}
+
+#endif /* LEMONADE_PM_UTILITY_NETWORKCONVERSION_H */
@@ -0,0 +1,463 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UTILITY_NETWORKLAPLACIAN_H
+#define LEMONADE_PM_UTILITY_NETWORKLAPLACIAN_H
+
+#include <stdint.h>
+#include <cmath>
+#include <random>
+#include <string>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include <stdexcept>
+
+#include <LeMonADE_PM/utility/UnionFind.h>
+
+/*****************************************************************************/
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @class NetworkLaplacian
+ * @brief Thermal fluctuations of the crosslinks of a gaussian phantom network.
+ * @details The nodes are the crosslinks, the edges the strands with the
+ * spring constant 3kT/(N b^2). The fluctuations around the mean positions do
+ * not depend on the mean positions, thus the periodic images are ignored.
+ * With the Laplacian L of the strand weights 1/N and its pseudoinverse L^+:
+ * - <dR_i^2> = b^2 L^+_ii is the fluctuation of a crosslink
+ * - <dR_ij^2> = b^2 (L^+_ii + L^+_jj - 2 L^+_ij) = b^2 R_ij is the fluctuation
+ *   of the strand vector, R_ij is the effective resistance of the strand
+ *
+ * Both are estimated by estimate() from the same random probes: every strand
+ * gets a random sign s_e and y=L^+ sum_e s_e sqrt(w_e)(e_i-e_j) is solved by a
+ * Jacobi preconditioned conjugate gradient. The mean of y_i^2 is L^+_ii and
+ * the mean of (y_i-y_j)^2 is R_ij, the relative error decreases as
+ * sqrt(2/nProbes). The probes are independent and distributed over the OpenMP
+ * threads, probe k always uses the same random numbers for a given seed.
+ * The pseudoinverse refers to the center of mass of every connected
+ * component, i.e. sol clusters fluctuate around their own center of mass.
+ **/
+/*****************************************************************************/
+class NetworkLaplacian
+{
+public:
+  NetworkLaplacian():nComponents(0),maxIterations(0){}
+
+  //! remove all crosslinks and strands
+  void clear();
+  //! add a crosslink with the monomer ID, returns its node index
+  uint32_t addCrossLink(uint32_t ID);
+  //! add a strand of segments segments between two crosslinks
+  void addStrand(uint32_t ID1, uint32_t ID2, double segments);
+  //! fill the graph from the crosslink lookup of the ingredients
+  template<class IngredientsType>
+  void fill(const IngredientsType& ingredients);
+
+  //! x=L^+ b, i.e. x has zero mean on every component, returns the number of iterations
+  uint32_t solve(const std::vector<double>& b, std::vector<double>& x, double tolerance=1e-8);
+  //! stochastic estimate of the diagonal of L^+ and of the effective resistances
+  void estimate(uint32_t nProbes, uint64_t seed=0, double tolerance=1e-6);
+
+  //! number of crosslinks
+  uint32_t getNumCrossLinks() const {return nodeID.size();}
+  //! number of strands
+  uint32_t getNumStrands() const {return edges.size();}
+  //! number of connected components, set by solve() and estimate()
+  uint32_t getNumComponents() const {return nComponents;}
+  //! largest number of conjugate gradient iterations of the last estimate()
+  uint32_t getMaxIterations() const {return maxIterations;}
+
+  //! monomer ID of the crosslink with index n
+  uint32_t getCrossLinkID(uint32_t n) const {return nodeID[n];}
+  //! monomer IDs of the ends of strand e
+  uint32_t getStrandID1(uint32_t e) const {return nodeID[edges[e].u];}
+  uint32_t getStrandID2(uint32_t e) const {return nodeID[edges[e].v];}
+  //! number of segments of strand e
+  double getStrandSegments(uint32_t e) const {return edges[e].segments;}
+
+  //! estimate of L^+_nn and its standard error
+  double getVariance(uint32_t n) const {return variance[n];}
+  double getVarianceError(uint32_t n) const {return varianceError[n];}
+  //! estimate of the effective resistance of strand e and its standard error
+  double getResistance(uint32_t e) const {return resistance[e];}
+  double getResistanceError(uint32_t e) const {return resistanceError[e];}
+
+private:
+  struct Edge{
+    uint32_t u,v;
+    double segments;
+  };
+  //! monomer ID of the node
+  std::vector<uint32_t> nodeID;
+  //! node index of the monomer ID, -1 for monomers which are no crosslinks
+  std::vector<int32_t> nodeIndex;
+  std::vector<Edge> edges;
+  //! neighbors and weights of the nodes in compressed row storage, self-loops are left out
+  std::vector<uint32_t> adjacencyStart;
+  std::vector<uint32_t> adjacency;
+  std::vector<double> weight;
+  //! sum of the weights of a node
+  std::vector<double> degree;
+  //! component index of the nodes and number of nodes of the components
+  std::vector<uint32_t> component;
+  std::vector<double> componentSize;
+  uint32_t nComponents;
+  uint32_t maxIterations;
+
+  std::vector<double> variance, varianceError;
+  std::vector<double> resistance, resistanceError;
+
+  //! node index of a crosslink, throws if the ID is unknown
+  uint32_t getNode(uint32_t ID) const;
+  //! build the compressed adjacency lists and the components
+  void buildMatrix();
+  //! y=L x
+  void multiply(const std::vector<double>& x, std::vector<double>& y) const;
+  //! subtract the mean of every component
+  void project(std::vector<double>& x) const;
+  //! preconditioned conjugate gradient with the given work space
+  uint32_t conjugateGradient(const std::vector<double>& b, std::vector<double>& x, double tolerance,
+                             std::vector<double>& r, std::vector<double>& z,
+                             std::vector<double>& p, std::vector<double>& q) const;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+/////////// implementation of the members ///////////////////////////////////
+
+inline void NetworkLaplacian::clear()
+{
+  nodeID.clear();
+  nodeIndex.clear();
+  edges.clear();
+  adjacencyStart.clear();
+  nComponents=0;
+  maxIterations=0;
+}
+
+inline uint32_t NetworkLaplacian::addCrossLink(uint32_t ID)
+{
+  if( ID >= nodeIndex.size() )
+    nodeIndex.resize(ID+1,-1);
+  if( nodeIndex[ID] < 0 ){
+    nodeIndex[ID]=nodeID.size();
+    nodeID.push_back(ID);
+  }
+  adjacencyStart.clear();
+  return nodeIndex[ID];
+}
+
+inline uint32_t NetworkLaplacian::getNode(uint32_t ID) const
+{
+  if( ID >= nodeIndex.size() || nodeIndex[ID] < 0 ){
+    std::stringstream errormessage;
+    errormessage << "NetworkLaplacian: Cross Link ID " << ID << " does not exist.";
+    throw std::runtime_error(errormessage.str());
+  }
+  return nodeIndex[ID];
+}
+
+inline void NetworkLaplacian::addStrand(uint32_t ID1, uint32_t ID2, double segments)
+{
+  if( !(segments > 0.0) ){
+    std::stringstream errormessage;
+    errormessage << "NetworkLaplacian: strand between " << ID1 << " and " << ID2 << " has " << segments << " segments.";
+    throw std::runtime_error(errormessage.str());
+  }
+  Edge edge;
+  edge.u=getNode(ID1);
+  edge.v=getNode(ID2);
+  edge.segments=segments;
+  edges.push_back(edge);
+  adjacencyStart.clear();
+}
+
+/**
+ * @details Every strand is listed by the lookup at both of its crosslinks. It
+ * is added once from the crosslink with the smaller ID, self-loops are listed
+ * twice at the same crosslink and every second entry is skipped.
+ **/
+template<class IngredientsType>
+void NetworkLaplacian::fill(const IngredientsType& ingredients)
+{
+  clear();
+  const std::vector<uint32_t>& CrossLinkIDs(ingredients.getCrosslinkIDs());
+  for (size_t i = 0; i < CrossLinkIDs.size(); i++)
+    addCrossLink(CrossLinkIDs[i]);
+  for (size_t i = 0; i < CrossLinkIDs.size(); i++){
+    const uint32_t IDx(CrossLinkIDs[i]);
+    auto neighbors(ingredients.getCrossLinkNeighborIDs(IDx));
+    bool skipSelfLoop(false);
+    for (size_t j = 0; j < neighbors.size(); j++){
+      const uint32_t IDy(neighbors[j].ID);
+      if( IDy < IDx ) continue;
+      if( IDy == IDx ){
+        skipSelfLoop=!skipSelfLoop;
+        if( !skipSelfLoop ) continue;
+      }
+      addStrand(IDx, IDy, neighbors[j].segDistance);
+    }
+  }
+}
+
+inline void NetworkLaplacian::buildMatrix()
+{
+  const uint32_t nNodes(nodeID.size());
+  adjacencyStart.assign(nNodes+1,0);
+  degree.assign(nNodes,0.0);
+  UnionFind components(nNodes);
+  for(size_t e=0; e<edges.size(); e++){
+    if( edges[e].u == edges[e].v ) continue;
+    adjacencyStart[edges[e].u+1]++;
+    adjacencyStart[edges[e].v+1]++;
+    components.unite(edges[e].u,edges[e].v);
+  }
+  for(uint32_t n=0; n<nNodes; n++)
+    adjacencyStart[n+1]+=adjacencyStart[n];
+  adjacency.resize(adjacencyStart[nNodes]);
+  weight.resize(adjacencyStart[nNodes]);
+  std::vector<uint32_t> next(adjacencyStart.begin(),adjacencyStart.end()-1);
+  for(size_t e=0; e<edges.size(); e++){
+    const uint32_t u(edges[e].u), v(edges[e].v);
+    if( u == v ) continue;
+    const double w(1.0/edges[e].segments);
+    adjacency[next[u]]=v; weight[next[u]++]=w;
+    adjacency[next[v]]=u; weight[next[v]++]=w;
+    degree[u]+=w;
+    degree[v]+=w;
+  }
+  //number the components by their roots
+  std::vector<uint32_t> rootIndex(nNodes,nNodes);
+  component.resize(nNodes);
+  componentSize.clear();
+  for(uint32_t n=0; n<nNodes; n++){
+    const uint32_t root(components.find(n));
+    if( rootIndex[root] == nNodes ){
+      rootIndex[root]=componentSize.size();
+      componentSize.push_back(0.0);
+    }
+    component[n]=rootIndex[root];
+    componentSize[component[n]]+=1.0;
+  }
+  nComponents=componentSize.size();
+}
+
+inline void NetworkLaplacian::multiply(const std::vector<double>& x, std::vector<double>& y) const
+{
+  const uint32_t nNodes(nodeID.size());
+  for(uint32_t n=0; n<nNodes; n++){
+    double sum(degree[n]*x[n]);
+    for(uint32_t k=adjacencyStart[n]; k<adjacencyStart[n+1]; k++)
+      sum-=weight[k]*x[adjacency[k]];
+    y[n]=sum;
+  }
+}
+
+inline void NetworkLaplacian::project(std::vector<double>& x) const
+{
+  std::vector<double> mean(nComponents,0.0);
+  for(size_t n=0; n<x.size(); n++)
+    mean[component[n]]+=x[n];
+  for(uint32_t c=0; c<nComponents; c++)
+    mean[c]/=componentSize[c];
+  for(size_t n=0; n<x.size(); n++)
+    x[n]-=mean[component[n]];
+}
+
+/**
+ * @details L is singular with the constants on every component as null space.
+ * For a right hand side orthogonal to the null space the iterates stay in the
+ * range of L, the remaining constant parts are removed by project() at the end.
+ * Crosslinks without strands get x=0.
+ **/
+inline uint32_t NetworkLaplacian::conjugateGradient(const std::vector<double>& b, std::vector<double>& x, double tolerance,
+                                                    std::vector<double>& r, std::vector<double>& z,
+                                                    std::vector<double>& p, std::vector<double>& q) const
+{
+  const uint32_t nNodes(nodeID.size());
+  x.assign(nNodes,0.0);
+  r=b;
+  double norm2B(0.0);
+  for(uint32_t n=0; n<nNodes; n++)
+    norm2B+=b[n]*b[n];
+  if( norm2B == 0.0 ) return 0;
+  const double limit(tolerance*tolerance*norm2B);
+  double rz(0.0);
+  for(uint32_t n=0; n<nNodes; n++){
+    z[n]=( degree[n] > 0.0 ) ? r[n]/degree[n] : 0.0;
+    p[n]=z[n];
+    rz+=r[n]*z[n];
+  }
+  //in exact arithmetic the conjugate gradient needs at most nNodes iterations
+  const uint32_t nMax(10*nNodes+100);
+  for(uint32_t iteration=1; iteration<=nMax; iteration++){
+    multiply(p,q);
+    double pq(0.0);
+    for(uint32_t n=0; n<nNodes; n++)
+      pq+=p[n]*q[n];
+    const double alpha(rz/pq);
+    double norm2R(0.0);
+    for(uint32_t n=0; n<nNodes; n++){
+      x[n]+=alpha*p[n];
+      r[n]-=alpha*q[n];
+      norm2R+=r[n]*r[n];
+    }
+    if( norm2R <= limit ){
+      project(x);
+      return iteration;
+    }
+    double rzNew(0.0);
+    for(uint32_t n=0; n<nNodes; n++){
+      z[n]=( degree[n] > 0.0 ) ? r[n]/degree[n] : 0.0;
+      rzNew+=r[n]*z[n];
+    }
+    const double beta(rzNew/rz);
+    rz=rzNew;
+    for(uint32_t n=0; n<nNodes; n++)
+      p[n]=z[n]+beta*p[n];
+  }
+  std::stringstream errormessage;
+  errormessage << "NetworkLaplacian: conjugate gradient did not converge in " << nMax << " iterations.";
+  throw std::runtime_error(errormessage.str());
+}
+
+/**
+ * @details The mean of b on every component is removed first, which gives
+ * the least squares solution for any b.
+ **/
+inline uint32_t NetworkLaplacian::solve(const std::vector<double>& b, std::vector<double>& x, double tolerance)
+{
+  if( b.size() != nodeID.size() )
+    throw std::runtime_error("NetworkLaplacian::solve: right hand side does not match the number of crosslinks.");
+  if( adjacencyStart.empty() )
+    buildMatrix();
+  std::vector<double> rhs(b), r(b.size()), z(b.size()), p(b.size()), q(b.size());
+  project(rhs);
+  return conjugateGradient(rhs,x,tolerance,r,z,p,q);
+}
+
+/**
+ * @details Every thread has its own work space and sums, which are added up
+ * after the loop over the probes. The random signs of probe k are drawn from
+ * a generator seeded with (seed,k), thus the estimate does not depend on the
+ * number of threads up to the order of the final summation.
+ **/
+inline void NetworkLaplacian::estimate(uint32_t nProbes, uint64_t seed, double tolerance)
+{
+  if( nProbes < 2 )
+    throw std::runtime_error("NetworkLaplacian::estimate: at least two probes are needed for the error.");
+  buildMatrix();
+  const uint32_t nNodes(nodeID.size());
+  const uint32_t nEdges(edges.size());
+  std::vector<double> sumY2(nNodes,0.0), sumY4(nNodes,0.0);
+  std::vector<double> sumD2(nEdges,0.0), sumD4(nEdges,0.0);
+  maxIterations=0;
+  //exceptions must not leave the parallel region
+  std::string error;
+
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    std::vector<double> b(nNodes), y(nNodes), r(nNodes), z(nNodes), p(nNodes), q(nNodes);
+    std::vector<double> localY2(nNodes,0.0), localY4(nNodes,0.0);
+    std::vector<double> localD2(nEdges,0.0), localD4(nEdges,0.0);
+    uint32_t localIterations(0);
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic,1)
+#endif
+    for(int64_t k=0; k<int64_t(nProbes); k++){
+      std::seed_seq sequence{uint32_t(seed), uint32_t(seed>>32), uint32_t(k)};
+      std::mt19937_64 rng(sequence);
+      b.assign(nNodes,0.0);
+      uint64_t bits(0);
+      for(uint32_t e=0; e<nEdges; e++){
+        if( e%64 == 0 ) bits=rng();
+        const double s( (bits>>(e%64))&1 ? 1.0 : -1.0 );
+        const double amplitude(s/std::sqrt(edges[e].segments));
+        b[edges[e].u]+=amplitude;
+        b[edges[e].v]-=amplitude;
+      }
+      uint32_t iterations(0);
+      try{
+        iterations=conjugateGradient(b,y,tolerance,r,z,p,q);
+      }catch(std::exception& e){
+#ifdef _OPENMP
+        #pragma omp critical
+#endif
+        error=e.what();
+        continue;
+      }
+      if( iterations > localIterations ) localIterations=iterations;
+      for(uint32_t n=0; n<nNodes; n++){
+        const double y2(y[n]*y[n]);
+        localY2[n]+=y2;
+        localY4[n]+=y2*y2;
+      }
+      for(uint32_t e=0; e<nEdges; e++){
+        const double d(y[edges[e].u]-y[edges[e].v]);
+        localD2[e]+=d*d;
+        localD4[e]+=d*d*d*d;
+      }
+    }
+#ifdef _OPENMP
+    #pragma omp critical
+#endif
+    {
+      for(uint32_t n=0; n<nNodes; n++){
+        sumY2[n]+=localY2[n];
+        sumY4[n]+=localY4[n];
+      }
+      for(uint32_t e=0; e<nEdges; e++){
+        sumD2[e]+=localD2[e];
+        sumD4[e]+=localD4[e];
+      }
+      if( localIterations > maxIterations ) maxIterations=localIterations;
+    }
+  }
+
+  if( !error.empty() )
+    throw std::runtime_error(error);
+
+  const double K(nProbes);
+  variance.resize(nNodes);
+  varianceError.resize(nNodes);
+  for(uint32_t n=0; n<nNodes; n++){
+    variance[n]=sumY2[n]/K;
+    varianceError[n]=std::sqrt(std::max(sumY4[n]/K-variance[n]*variance[n],0.0)/(K-1.0));
+  }
+  resistance.resize(nEdges);
+  resistanceError.resize(nEdges);
+  for(uint32_t e=0; e<nEdges; e++){
+    resistance[e]=sumD2[e]/K;
+    resistanceError[e]=std::sqrt(std::max(sumD4[e]/K-resistance[e]*resistance[e],0.0)/(K-1.0));
+  }
+}
+
+#endif /*LEMONADE_PM_UTILITY_NETWORKLAPLACIAN_H*/
@@ -0,0 +1,246 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UTILITY_NETWORKREDUCTION_H
+#define LEMONADE_PM_UTILITY_NETWORKREDUCTION_H
+
+#include <stdint.h>
+#include <cmath>
+#include <map>
+#include <vector>
+#include <sstream>
+#include <iostream>
+#include <stdexcept>
+
+#include <LeMonADE/utility/Vector3D.h>
+#include <LeMonADE_PM/utility/neighborX.h>
+#include <LeMonADE_PM/utility/NetworkClassifier.h>
+
+/*****************************************************************************/
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @class NetworkReduction
+ * @brief Reduces the crosslink lookup to the elastically active backbone.
+ * @details Dangling structures and sol clusters have no restoring force and
+ * slow down the force equilibration near the gel point. reduce() removes all
+ * crosslinks which are not active (see NetworkClassifier) from the tables of
+ * a crosslink lookup feature. Optionally, active crosslinks with two strands
+ * are replaced by one strand with the sum of the segments, which is exact for
+ * the gaussian force-extension relation only.
+ * restore() puts the removed crosslinks to their force free positions and
+ * brings back the complete tables:
+ * - a collapsed crosslink sits on the line between its two neighbors at the
+ *   fraction given by the segments (series of two gaussian springs)
+ * - a removed crosslink sits on the periodic image of the crosslink it hangs
+ *   on, such that the strand between both has no extension
+ * - a sol cluster keeps the position of its first crosslink
+ **/
+/*****************************************************************************/
+class NetworkReduction
+{
+public:
+  NetworkReduction():reduced(false){}
+
+  //! forget the stored tables, e.g. after the lookup was filled again
+  void clear();
+  //! true between reduce() and restore()
+  bool isReduced() const {return reduced;}
+  //! number of crosslinks removed as dangling or sol
+  uint32_t getNumPruned() const {return pruned.size();}
+  //! number of crosslinks collapsed into series strands
+  uint32_t getNumCollapsed() const {return collapsed.size();}
+
+  //! reduce the tables of the lookup of ingredients to the active backbone
+  template<class IngredientsType>
+  void reduce(const IngredientsType& ingredients, std::vector<uint32_t>& crosslinkIDs,
+              std::map<uint32_t,std::vector<neighborX> >& neighbors, bool collapseSeries);
+  //! set the positions of the removed crosslinks and restore the tables
+  template<class IngredientsType>
+  void restore(IngredientsType& ingredients, std::vector<uint32_t>& crosslinkIDs,
+               std::map<uint32_t,std::vector<neighborX> >& neighbors);
+
+private:
+  //! removed crosslink at the position of reference plus jump
+  struct PrunedCrossLink{
+    uint32_t ID, reference;
+    VectorDouble3 jump;
+  };
+  //! crosslink between a and b, the strands are given as seen from the crosslink
+  struct CollapsedCrossLink{
+    uint32_t ID, a, b;
+    double Na, Nb;
+    VectorDouble3 Ja, Jb;
+  };
+  bool reduced;
+  std::vector<PrunedCrossLink> pruned;
+  std::vector<CollapsedCrossLink> collapsed;
+  std::vector<uint32_t> completeIDs;
+  std::map<uint32_t,std::vector<neighborX> > completeNeighbors;
+
+  //! replaces the entry (ID, segDistance, jump) of the list by replacement, skips the index skip
+  static size_t replaceEntry(std::vector<neighborX>& list, uint32_t ID, uint32_t segDistance,
+                             const VectorDouble3& jump, size_t skip, const neighborX& replacement);
+};
+
+/////////////////////////////////////////////////////////////////////////////
+/////////// implementation of the members ///////////////////////////////////
+
+inline void NetworkReduction::clear()
+{
+  reduced=false;
+  pruned.clear();
+  collapsed.clear();
+  completeIDs.clear();
+  completeNeighbors.clear();
+}
+
+inline size_t NetworkReduction::replaceEntry(std::vector<neighborX>& list, uint32_t ID, uint32_t segDistance,
+                                             const VectorDouble3& jump, size_t skip, const neighborX& replacement)
+{
+  for(size_t k=0; k<list.size(); k++){
+    if( k == skip || list[k].ID != int32_t(ID) || list[k].segDistance != segDistance ) continue;
+    VectorDouble3 difference(list[k].jump-jump);
+    if( difference*difference > 1e-12 ) continue;
+    list[k]=replacement;
+    return k;
+  }
+  std::stringstream errormessage;
+  errormessage << "NetworkReduction: strand to " << ID << " with " << segDistance << " segments is missing in the lookup.";
+  throw std::runtime_error(errormessage.str());
+}
+
+/**
+ * @details The removed crosslinks are found by a breadth first search starting
+ * from all active crosslinks, such that every removed crosslink refers to one
+ * which is already placed when restore() works through the list in order.
+ * The series collapse only changes the neighbor lists of the two neighbors,
+ * thus their number of strands stays the same and one pass is sufficient.
+ **/
+template<class IngredientsType>
+void NetworkReduction::reduce(const IngredientsType& ingredients, std::vector<uint32_t>& crosslinkIDs,
+                              std::map<uint32_t,std::vector<neighborX> >& neighbors, bool collapseSeries)
+{
+  if( reduced )
+    throw std::runtime_error("NetworkReduction::reduce: the lookup is already reduced.");
+  NetworkClassifier network;
+  network.classify(ingredients);
+  completeIDs=crosslinkIDs;
+  completeNeighbors=neighbors;
+  pruned.clear();
+  collapsed.clear();
+
+  std::map<uint32_t,bool> visited;
+  std::vector<uint32_t> queue, backbone;
+  for(size_t i=0; i<crosslinkIDs.size(); i++)
+    if( network.getCrossLinkTag(crosslinkIDs[i]) == NetworkClassifier::ACTIVE ){
+      visited[crosslinkIDs[i]]=true;
+      queue.push_back(crosslinkIDs[i]);
+      backbone.push_back(crosslinkIDs[i]);
+    }
+  size_t q(0), next(0);
+  while( true ){
+    for( ; q<queue.size(); q++){
+      const std::vector<neighborX>& list(neighbors[queue[q]]);
+      for(size_t j=0; j<list.size(); j++){
+        uint32_t x(list[j].ID);
+        if( visited[x] ) continue;
+        visited[x]=true;
+        PrunedCrossLink removed={x,queue[q],list[j].jump};
+        pruned.push_back(removed);
+        queue.push_back(x);
+      }
+    }
+    while( next < crosslinkIDs.size() && visited[crosslinkIDs[next]] ) next++;
+    if( next == crosslinkIDs.size() ) break;
+    //the first crosslink of a sol cluster stays where it is
+    visited[crosslinkIDs[next]]=true;
+    queue.push_back(crosslinkIDs[next]);
+  }
+  for(size_t i=0; i<crosslinkIDs.size(); i++)
+    if( network.getCrossLinkTag(crosslinkIDs[i]) != NetworkClassifier::ACTIVE )
+      neighbors.erase(crosslinkIDs[i]);
+  for(size_t i=0; i<backbone.size(); i++){
+    std::vector<neighborX>& list(neighbors[backbone[i]]);
+    std::vector<neighborX> active;
+    for(size_t j=0; j<list.size(); j++)
+      if( network.getCrossLinkTag(list[j].ID) == NetworkClassifier::ACTIVE )
+        active.push_back(list[j]);
+    list.swap(active);
+  }
+
+  if( collapseSeries ){
+    std::vector<uint32_t> remaining;
+    for(size_t i=0; i<backbone.size(); i++){
+      const uint32_t c(backbone[i]);
+      const std::vector<neighborX> list(neighbors[c]);
+      if( list.size() != 2 || list[0].ID == int32_t(c) || list[1].ID == int32_t(c) ){
+        remaining.push_back(c);
+        continue;
+      }
+      CollapsedCrossLink series={c,uint32_t(list[0].ID),uint32_t(list[1].ID),
+        double(list[0].segDistance),double(list[1].segDistance),list[0].jump,list[1].jump};
+      const uint32_t N(list[0].segDistance+list[1].segDistance);
+      size_t first=replaceEntry(neighbors[series.a],c,list[0].segDistance,-series.Ja,size_t(-1),
+                                neighborX(series.b,N,series.Jb-series.Ja));
+      if( series.a != series.b ) first=size_t(-1);
+      replaceEntry(neighbors[series.b],c,list[1].segDistance,-series.Jb,first,
+                   neighborX(series.a,N,series.Ja-series.Jb));
+      neighbors.erase(c);
+      collapsed.push_back(series);
+    }
+    backbone.swap(remaining);
+  }
+  crosslinkIDs.swap(backbone);
+  reduced=true;
+  std::cout << "NetworkReduction::reduce: " << crosslinkIDs.size() << " of " << completeIDs.size()
+            << " crosslinks remain, " << pruned.size() << " pruned, " << collapsed.size() << " collapsed" << std::endl;
+}
+
+template<class IngredientsType>
+void NetworkReduction::restore(IngredientsType& ingredients, std::vector<uint32_t>& crosslinkIDs,
+                               std::map<uint32_t,std::vector<neighborX> >& neighbors)
+{
+  if( !reduced ) return;
+  for(size_t k=collapsed.size(); k-- > 0; ){
+    const CollapsedCrossLink& series(collapsed[k]);
+    VectorDouble3 ra(ingredients.getMolecules()[series.a].getVector3D()-series.Ja);
+    VectorDouble3 rb(ingredients.getMolecules()[series.b].getVector3D()-series.Jb);
+    ingredients.modifyMolecules()[series.ID].modifyVector3D()=(ra*series.Nb+rb*series.Na)/(series.Na+series.Nb);
+  }
+  for(size_t p=0; p<pruned.size(); p++){
+    VectorDouble3 position(ingredients.getMolecules()[pruned[p].reference].getVector3D()+pruned[p].jump);
+    ingredients.modifyMolecules()[pruned[p].ID].modifyVector3D()=position;
+  }
+  crosslinkIDs.swap(completeIDs);
+  neighbors.swap(completeNeighbors);
+  clear();
+}
+
+#endif /*LEMONADE_PM_UTILITY_NETWORKREDUCTION_H*/
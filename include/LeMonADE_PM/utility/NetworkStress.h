@@ -0,0 +1,88 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UTILITY_NETWORKSTRESS_H
+#define LEMONADE_PM_UTILITY_NETWORKSTRESS_H
+
+#include <vector>
+
+#include <LeMonADE/utility/Vector3D.h>
+#include <LeMonADE_PM/utility/neighborX.h>
+
+/*****************************************************************************/
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @brief Virial stress of the strands between crosslinks.
+ * @details sum_strands w f_a R_b for all strands of the crosslink lookup, with the 
+ * strand force f of a move (getStrandForce(R,nSegments)). Strands between two 
+ * crosslinks are seen from both ends and get the weight w=1/2. The result is 
+ * (xx,yy,zz,xy,xz,yz) and not yet divided by the volume. UpdaterAffineDeformation
+ * does not change the box, thus the volume of a prestrained system is the box
+ * volume times the prestrain factors.
+ **/
+/*****************************************************************************/
+namespace NetworkStress
+{
+  template<class IngredientsType, class ForceType>
+  std::vector<double> calculateVirial(const IngredientsType& ing, ForceType& force)
+  {
+    std::vector<double> virial(6,0.);
+    const std::vector<uint32_t>& CrossLinkIDs(ing.getCrosslinkIDs());
+    std::vector<bool> isCrossLink(ing.getMolecules().size(),false);
+    for (size_t i = 0; i < CrossLinkIDs.size(); i++)
+      isCrossLink[CrossLinkIDs[i]]=true;
+    for (size_t i = 0; i < CrossLinkIDs.size(); i++){
+      uint32_t ID(CrossLinkIDs[i]);
+      std::vector<neighborX> Neighbors(ing.getCrossLinkNeighborIDs(ID));
+      VectorDouble3 Position(ing.getMolecules()[ID].getVector3D());
+      for (size_t j = 0; j < Neighbors.size(); j++){
+        VectorDouble3 R(ing.getMolecules()[Neighbors[j].ID].getVector3D()-Position-Neighbors[j].jump);
+        VectorDouble3 f(force.getStrandForce(R,Neighbors[j].segDistance));
+        double weight( isCrossLink[Neighbors[j].ID] ? 0.5 : 1.0 );
+        virial[0]+=weight*f.getX()*R.getX();
+        virial[1]+=weight*f.getY()*R.getY();
+        virial[2]+=weight*f.getZ()*R.getZ();
+        virial[3]+=weight*f.getX()*R.getY();
+        virial[4]+=weight*f.getX()*R.getZ();
+        virial[5]+=weight*f.getY()*R.getZ();
+      }
+    }
+    return virial;
+  }
+
+  //! volume of the system: box volume times the prestrain factors 
+  template<class IngredientsType>
+  double volume(const IngredientsType& ing, double prestrainX=1., double prestrainY=1., double prestrainZ=1.)
+  {
+    return static_cast<double>(ing.getBoxX())*ing.getBoxY()*ing.getBoxZ()*prestrainX*prestrainY*prestrainZ;
+  }
+}
+
+#endif /*LEMONADE_PM_UTILITY_NETWORKSTRESS_H*/
@@ -0,0 +1,194 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UTILITY_PHANTOMREFERENCEBUILDER_H
+#define LEMONADE_PM_UTILITY_PHANTOMREFERENCEBUILDER_H
+
+#include <stdint.h>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <LeMonADE/utility/Vector3D.h>
+
+/*****************************************************************************/
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @class PhantomReferenceBuilder
+ * @brief Writes stars and tendomer double stars directly into the off-lattice system.
+ * @details The reference systems are phantom, thus there is no reason to grow
+ * them on a lattice with excluded volume (UpdaterAddStars, UpdaterAddTMDoubleStars)
+ * and to convert them afterwards. Here the molecules are resized once and every
+ * branch is a random walk of bond vectors of the classic BFM bond set, which
+ * are the bond vectors used by the lattice updaters. The monomers get the same
+ * indices as in the updaters:
+ *  - star: core, then the branches one after the other starting at the core
+ *  - double star: main chain, the branches of the first and then the branches
+ *    of the last monomer of the main chain, the last monomer of every branch is fixed
+ *
+ * Positions are drawn from the given generator only, thus several builders
+ * can be used concurrently with independent generators.
+ **/
+/*****************************************************************************/
+class PhantomReferenceBuilder
+{
+public:
+  //! uses the 108 bond vectors of the classic BFM bond set
+  PhantomReferenceBuilder();
+
+  //! bond vectors the random walks are made of
+  const std::vector<VectorDouble3>& getBondVectors() const {return bondVectors;}
+
+  /**
+   * @brief adds a star with nBranches branches of nMonoPerBranch monomers (excluding the core)
+   * @return index of the core
+   */
+  template<class IngredientsType, class RNG>
+  uint32_t addStar(IngredientsType& ingredients, uint32_t nMonoPerBranch, uint32_t nBranches, RNG& rng) const;
+
+  /**
+   * @brief adds a double star with the main chain and two sets of branches
+   * @param mainChainLength number of monomers of the main chain
+   * @param branchLengths monomers per branch, the first half is attached to the 
+   *        first monomer of the main chain and the second half to the last one
+   * @return index of the first monomer of the main chain
+   */
+  template<class IngredientsType, class RNG>
+  uint32_t addTMDoubleStar(IngredientsType& ingredients, uint32_t mainChainLength, const std::vector<uint32_t>& branchLengths, RNG& rng) const;
+
+private:
+  //! random position in the box for the first monomer
+  template<class IngredientsType, class RNG>
+  VectorDouble3 randomPosition(const IngredientsType& ingredients, RNG& rng) const;
+  //! appends a chain of nMonomers monomers starting at monomer next, the first is bonded to parent
+  template<class MoleculesType, class RNG>
+  void addChain(MoleculesType& molecules, uint32_t parent, uint32_t next, uint32_t nMonomers, RNG& rng) const;
+
+  std::vector<VectorDouble3> bondVectors;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+/////////// implementation of the members ///////////////////////////////////
+
+/**
+ * @details All permutations and signs of (2,0,0), (2,1,0), (2,1,1), (2,2,1), 
+ * (3,0,0) and (3,1,0).
+ **/
+inline PhantomReferenceBuilder::PhantomReferenceBuilder()
+{
+  const int32_t classes[6][3]={{2,0,0},{2,1,0},{2,1,1},{2,2,1},{3,0,0},{3,1,0}};
+  for(int32_t x=-3; x<=3; x++)
+    for(int32_t y=-3; y<=3; y++)
+      for(int32_t z=-3; z<=3; z++){
+        int32_t a(std::abs(x)), b(std::abs(y)), c(std::abs(z));
+        //sort descending
+        if( a < b ) std::swap(a,b);
+        if( b < c ) std::swap(b,c);
+        if( a < b ) std::swap(a,b);
+        for(uint32_t k=0; k<6; k++)
+          if( a == classes[k][0] && b == classes[k][1] && c == classes[k][2] )
+            bondVectors.push_back(VectorDouble3(x,y,z));
+      }
+}
+
+template<class IngredientsType, class RNG>
+VectorDouble3 PhantomReferenceBuilder::randomPosition(const IngredientsType& ingredients, RNG& rng) const
+{
+  std::uniform_int_distribution<int32_t> drawX(0,ingredients.getBoxX()-1);
+  std::uniform_int_distribution<int32_t> drawY(0,ingredients.getBoxY()-1);
+  std::uniform_int_distribution<int32_t> drawZ(0,ingredients.getBoxZ()-1);
+  const double x(drawX(rng)), y(drawY(rng));
+  return VectorDouble3(x,y,drawZ(rng));
+}
+
+template<class MoleculesType, class RNG>
+void PhantomReferenceBuilder::addChain(MoleculesType& molecules, uint32_t parent, uint32_t next, uint32_t nMonomers, RNG& rng) const
+{
+  std::uniform_int_distribution<size_t> drawBond(0,bondVectors.size()-1);
+  for(uint32_t i=0; i<nMonomers; i++, next++){
+    molecules[next].modifyVector3D()=molecules[parent].getVector3D()+bondVectors[drawBond(rng)];
+    molecules.connect(parent,next);
+    parent=next;
+  }
+}
+
+/**
+ * @details The ingredients need a box, the monomers are appended to the 
+ * existing ones.
+ **/
+template<class IngredientsType, class RNG>
+uint32_t PhantomReferenceBuilder::addStar(IngredientsType& ingredients, uint32_t nMonoPerBranch, uint32_t nBranches, RNG& rng) const
+{
+  auto& molecules(ingredients.modifyMolecules());
+  const uint32_t core(molecules.size());
+  molecules.resize(core+1+static_cast<size_t>(nMonoPerBranch)*nBranches);
+  molecules[core].modifyVector3D()=randomPosition(ingredients,rng);
+  for(uint32_t j=0; j<nBranches; j++)
+    addChain(molecules,core,core+1+j*nMonoPerBranch,nMonoPerBranch,rng);
+  return core;
+}
+
+/**
+ * @details The lengths are drawn by the caller, e.g. from the inverse 
+ * cumulative distribution of UpdaterAddTMDoubleStars.
+ **/
+template<class IngredientsType, class RNG>
+uint32_t PhantomReferenceBuilder::addTMDoubleStar(IngredientsType& ingredients, uint32_t mainChainLength, const std::vector<uint32_t>& branchLengths, RNG& rng) const
+{
+  if( mainChainLength == 0 || branchLengths.size() % 2 != 0 ){
+    std::stringstream errormessage;
+    errormessage << "PhantomReferenceBuilder::addTMDoubleStar: main chain of " << mainChainLength 
+                 << " monomers and " << branchLengths.size() << " branches, the main chain needs a monomer and the branches come in pairs.";
+    throw std::runtime_error(errormessage.str());
+  }
+  size_t nMonomers(mainChainLength);
+  for(size_t j=0; j<branchLengths.size(); j++){
+    if( branchLengths[j] == 0 )
+      throw std::runtime_error("PhantomReferenceBuilder::addTMDoubleStar: every branch needs a monomer.");
+    nMonomers+=branchLengths[j];
+  }
+  auto& molecules(ingredients.modifyMolecules());
+  const uint32_t start(molecules.size());
+  const uint32_t end(start+mainChainLength-1);
+  molecules.resize(start+nMonomers);
+  molecules[start].modifyVector3D()=randomPosition(ingredients,rng);
+  addChain(molecules,start,start+1,mainChainLength-1,rng);
+  uint32_t next(end+1);
+  for(size_t j=0; j<branchLengths.size(); j++){
+    addChain(molecules,(j < branchLengths.size()/2) ? start : end,next,branchLengths[j],rng);
+    next+=branchLengths[j];
+    molecules[next-1].setMovableTag(false);
+  }
+  return start;
+}
+
+#endif /*LEMONADE_PM_UTILITY_PHANTOMREFERENCEBUILDER_H*/
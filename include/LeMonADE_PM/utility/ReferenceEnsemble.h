@@ -0,0 +1,489 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UTILITY_REFERENCEENSEMBLE_H
+#define LEMONADE_PM_UTILITY_REFERENCEENSEMBLE_H
+
+#include <stdint.h>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <LeMonADE/utility/ResultFormattingTools.h>
+
+#include <LeMonADE_PM/updater/UpdaterAffineDeformation.h>
+#include <LeMonADE_PM/updater/UpdaterForceBalancedPosition.h>
+#include <LeMonADE_PM/updater/moves/MoveForceEquilibrium.h>
+#include <LeMonADE_PM/updater/moves/MoveNonLinearForceEquilibrium.h>
+#include <LeMonADE_PM/utility/AsyncWriter.h>
+#include <LeMonADE_PM/utility/ReferenceLaneSolver.h>
+#include <LeMonADE_PM/utility/WorkerPool.h>
+
+/*****************************************************************************/
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @class ReferenceEnsemble
+ * @brief Equilibrates many independent realizations of a reference system in one process.
+ * @details Each realization is created by the builder on its own ingredients,
+ * deformed affinely, brought into force equilibrium by an
+ * UpdaterForceBalancedPosition and reduced to the strand vectors between the
+ * crosslink and its neighbors (crosslinks or fixed monomers). The realizations
+ * are distributed over a WorkerPool. Realization k uses a std::mt19937 seeded
+ * by (seed,k), which is handed to the builder and seeds the crosslink
+ * selection of the equilibration. Thus, the result does not depend on the
+ * number of threads if the builder draws only from this stream (e.g. the
+ * PhantomReferenceBuilder). A builder which uses the global LeMonADE random
+ * number generators has to hold WorkerPool::getSerialMutex() and gets its
+ * numbers in the order in which the threads reach the mutex, thus its result
+ * changes with the number of threads.
+ * All moves are copies of the prototype move, i.e. a force-extension curve
+ * is read only once.
+ * Only the distribution of the strand length |R| and the moments of R are
+ * kept, no realization is stored.
+ * With setNumLanes(K) the realizations are equilibrated in batches of K by a
+ * ReferenceLaneSolver instead of the updater, which requires the same graph 
+ * of crosslinks and neighbors in all realizations and a MoveForceEquilibrium
+ * or a MoveNonLinearForceEquilibrium with the reference curve only. The 
+ * crosslinks are then visited in a fixed order instead of a random one.
+ * The lanes stop after setMaxSweeps sweeps, the realizations of lanes which
+ * are not converged by then are kept in the result and counted
+ * (getNumUnconverged, written to the output file).
+ *
+ * @tparam IngredientsType ingredients with a crosslink lookup (e.g. FeatureCrosslinkConnectionsLookUpIdealReference)
+ * @tparam MoveType move for UpdaterForceBalancedPosition
+ **/
+/*****************************************************************************/
+template<class IngredientsType, class MoveType>
+class ReferenceEnsemble
+{
+public:
+  //! creates one realization in the empty ingredients
+  typedef std::function<void(IngredientsType&, std::mt19937&)> Builder;
+
+  ReferenceEnsemble(Builder builder_, const MoveType& prototypeMove_, double threshold_, double decreaseFactor_=1.0);
+
+  //! uniaxial stretching factor applied to every realization
+  void setStretchingFactor(double stretchingFactor_){stretchingFactor=stretchingFactor_;}
+  //! number of threads, 0 uses all hardware threads
+  void setNumThreads(uint32_t nThreads_){nThreads=nThreads_;}
+  //! width of the bins of the strand length distribution
+  void setBinWidth(double binWidth_);
+  double getBinWidth() const {return binWidth;}
+  /**
+   * @brief suppress the output of the builder and the updaters during run (default)
+   * @details Without it the realizations write concurrently to std::cout, which is
+   * only safe while std::cout is synchronized with stdio (i.e. not redirected).
+   */
+  void setQuiet(bool quiet_){quiet=quiet_;}
+  //! equilibrate batches of nLanes realizations with a ReferenceLaneSolver (0: one updater per realization, default)
+  void setNumLanes(uint32_t nLanes_){nLanes=nLanes_;}
+  uint32_t getNumLanes() const {return nLanes;}
+  //! maximum number of sweeps of the lanes (default 10000000)
+  void setMaxSweeps(uint32_t maxSweeps_){maxSweeps=maxSweeps_;}
+
+  //! creates and equilibrates nRealizations realizations and accumulates their strands
+  void run(uint32_t nRealizations, uint64_t seed);
+
+  //! number of realizations of the last run
+  uint32_t getNumRealizations() const {return nRealizations;}
+  //! number of realizations of the last run which reached the maximum number of sweeps before the threshold
+  uint32_t getNumUnconverged() const {return nUnconverged;}
+  //! number of strands of all realizations
+  uint64_t getNumStrands() const {return nStrands;}
+  //! <R^2>
+  double getMeanSquaredLength() const {return average(sumR2);}
+  //! <R_x^2>, <R_y^2> and <R_z^2> for dim 0,1,2
+  double getMeanSquaredComponent(uint32_t dim) const {return average(sumComponent2.at(dim));}
+  //! <R^2/N>, N is the number of segments of the strand
+  double getMeanSquaredLengthPerSegment() const {return average(sumR2PerSegment);}
+  //! number of strands with bin*binWidth <= |R| < (bin+1)*binWidth
+  const std::vector<uint64_t>& getHistogram() const {return histogram;}
+
+  //! writes the distribution of the strand length: R count P(R)
+  void write(const std::string& filename) const;
+
+private:
+  //! sums of one realization
+  struct Moments{
+    Moments():nStrands(0),R2(0.),R2PerSegment(0.),converged(true){component2[0]=component2[1]=component2[2]=0.;}
+    uint64_t nStrands;
+    double R2, R2PerSegment, component2[3];
+    bool converged;
+  };
+  //! stream buffer discarding everything for the quiet mode
+  class NullBuffer : public std::streambuf{
+  protected:
+    virtual int overflow(int c){return traits_type::not_eof(c);}
+    virtual std::streamsize xsputn(const char*, std::streamsize n){return n;}
+  };
+
+  //! builds and deforms realization k
+  void build(uint32_t k, uint64_t seed, IngredientsType& ing, std::mt19937& rng);
+  //! adds the strands of the equilibrated realization k
+  void evaluate(uint32_t k, const IngredientsType& ing, Moments& moments, std::vector<uint64_t>& hist);
+  //! builds, equilibrates and evaluates realization k
+  void solve(uint32_t k, uint64_t seed, Moments& moments, std::vector<uint64_t>& hist);
+  //! builds, equilibrates and evaluates the realizations first..first+n-1 in lanes
+  void solveLanes(uint32_t first, uint32_t n, uint64_t seed, Moments* moments, std::vector<uint64_t>& hist);
+
+  //! calls func(IDx, neighbor) once for every strand 
+  template<class Function> static void forEachStrand(const IngredientsType& ing, Function func);
+
+  //! force law of the lanes for the move 
+  static void configureLanes(ReferenceLaneSolver& lanes, const MoveForceEquilibrium&){lanes.useGaussianStrands();}
+  static void configureLanes(ReferenceLaneSolver& lanes, const MoveNonLinearForceEquilibrium& move);
+  template<class OtherMove> static void configureLanes(ReferenceLaneSolver&, const OtherMove&){
+    throw std::runtime_error("ReferenceEnsemble: the lanes support only MoveForceEquilibrium and MoveNonLinearForceEquilibrium.");
+  }
+  //! movable tag of FeatureFixedMonomers, all monomers are movable without it 
+  template<class Monomer> static auto isMovable(const Monomer& monomer, int) -> decltype(monomer.getMovableTag()) {return monomer.getMovableTag();}
+  template<class Monomer> static bool isMovable(const Monomer&, long){return true;}
+
+  double average(double sum) const {return nStrands > 0 ? sum/static_cast<double>(nStrands) : 0.0;}
+
+  Builder builder;
+  MoveType prototypeMove;
+  double threshold;
+  double decreaseFactor;
+  double stretchingFactor;
+  uint32_t nThreads;
+  double binWidth;
+  bool quiet;
+  uint32_t nLanes;
+  uint32_t maxSweeps;
+
+  uint32_t nRealizations;
+  uint32_t nUnconverged;
+  uint64_t nStrands;
+  double sumR2, sumR2PerSegment;
+  std::vector<double> sumComponent2;
+  std::vector<uint64_t> histogram;
+  //! meta data of the first realization for the output file
+  std::shared_ptr<MetaDataSnapshot> metaData;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+/////////// implementation of the members ///////////////////////////////////
+
+/**
+ * @param builder_ creates one realization in the empty ingredients
+ * @param prototypeMove_ move (with its curve and relaxation parameter) copied for each realization
+ * @param threshold_ threshold of the average shift (see UpdaterForceBalancedPosition)
+ * @param decreaseFactor_ decrease of the relaxation parameter (see UpdaterForceBalancedPosition)
+ **/
+template<class IngredientsType, class MoveType>
+ReferenceEnsemble<IngredientsType,MoveType>::ReferenceEnsemble(Builder builder_, const MoveType& prototypeMove_, double threshold_, double decreaseFactor_):
+  builder(builder_),prototypeMove(prototypeMove_),threshold(threshold_),decreaseFactor(decreaseFactor_),
+  stretchingFactor(1.0),nThreads(0),binWidth(0.5),quiet(true),nLanes(0),maxSweeps(10000000),
+  nRealizations(0),nUnconverged(0),nStrands(0),sumR2(0.),sumR2PerSegment(0.),sumComponent2(3,0.)
+{}
+
+template<class IngredientsType, class MoveType>
+void ReferenceEnsemble<IngredientsType,MoveType>::setBinWidth(double binWidth_)
+{
+  if( !(binWidth_ > 0.) ){
+    std::stringstream errormessage;
+    errormessage << "ReferenceEnsemble::setBinWidth: bin width " << binWidth_ << " has to be positive.";
+    throw std::runtime_error(errormessage.str());
+  }
+  binWidth=binWidth_;
+}
+
+template<class IngredientsType, class MoveType>
+void ReferenceEnsemble<IngredientsType,MoveType>::build(uint32_t k, uint64_t seed, IngredientsType& ing, std::mt19937& rng)
+{
+  std::seed_seq sequence{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32), k};
+  rng.seed(sequence);
+  builder(ing,rng);
+  ing.synchronize();
+
+  UpdaterAffineDeformation<IngredientsType> deformation(ing,stretchingFactor);
+  deformation.execute();
+}
+
+/**
+ * @details Every strand is counted once: strands between two crosslinks from
+ * the crosslink with the smaller ID, loops from every second entry.
+ **/
+template<class IngredientsType, class MoveType>
+template<class Function>
+void ReferenceEnsemble<IngredientsType,MoveType>::forEachStrand(const IngredientsType& ing, Function func)
+{
+  const std::vector<uint32_t>& crosslinkIDs(ing.getCrosslinkIDs());
+  std::vector<bool> isCrossLink(ing.getMolecules().size(),false);
+  std::vector<bool> done(ing.getMolecules().size(),false);
+  for(size_t i=0; i<crosslinkIDs.size(); i++)
+    isCrossLink[crosslinkIDs[i]]=true;
+  for(size_t i=0; i<crosslinkIDs.size(); i++){
+    const uint32_t IDx(crosslinkIDs[i]);
+    if( done[IDx] ) continue;
+    done[IDx]=true;
+    const auto neighbors(ing.getCrossLinkNeighborIDs(IDx));
+    bool skipLoop(false);
+    for(size_t j=0; j<neighbors.size(); j++){
+      const uint32_t ID(neighbors[j].ID);
+      if( isCrossLink[ID] && ID < IDx ) continue;
+      if( ID == IDx ){
+        skipLoop=!skipLoop;
+        if( !skipLoop ) continue;
+      }
+      func(IDx,neighbors[j]);
+    }
+  }
+}
+
+template<class IngredientsType, class MoveType>
+void ReferenceEnsemble<IngredientsType,MoveType>::evaluate(uint32_t k, const IngredientsType& ing, Moments& moments, std::vector<uint64_t>& hist)
+{
+  const double width(binWidth);
+  forEachStrand(ing,[&](uint32_t IDx, const typename std::decay<decltype(ing.getCrossLinkNeighborIDs(0)[0])>::type& neighbor){
+    const VectorDouble3 R(ing.getMolecules()[neighbor.ID].getVector3D()-ing.getMolecules()[IDx].getVector3D()-neighbor.jump);
+    const double R2(R*R);
+    moments.nStrands++;
+    moments.R2+=R2;
+    moments.R2PerSegment+=R2/neighbor.segDistance;
+    moments.component2[0]+=R.getX()*R.getX();
+    moments.component2[1]+=R.getY()*R.getY();
+    moments.component2[2]+=R.getZ()*R.getZ();
+    const size_t bin(static_cast<size_t>(std::sqrt(R2)/width));
+    if( bin >= hist.size() ) hist.resize(bin+1,0);
+    hist[bin]++;
+  });
+  if( k == 0 )
+    metaData.reset(new MetaDataSnapshot(ing));
+}
+
+template<class IngredientsType, class MoveType>
+void ReferenceEnsemble<IngredientsType,MoveType>::solve(uint32_t k, uint64_t seed, Moments& moments, std::vector<uint64_t>& hist)
+{
+  IngredientsType ing;
+  std::mt19937 rng;
+  build(k,seed,ing,rng);
+  {
+    //the constructor draws a seed from the r250
+    std::unique_ptr< UpdaterForceBalancedPosition<IngredientsType,MoveType> > updater;
+    {
+      std::lock_guard<std::mutex> lock(WorkerPool::getSerialMutex());
+      updater.reset(new UpdaterForceBalancedPosition<IngredientsType,MoveType>(ing,prototypeMove,threshold,decreaseFactor));
+    }
+    updater->setSeed(rng());
+    updater->execute();
+  }
+  evaluate(k,ing,moments,hist);
+}
+
+/**
+ * @details The nodes of the lanes are the crosslinks and the other neighbors
+ * in the order of their first appearance in the lookup of the first 
+ * realization. Every other realization of the batch has to reproduce this 
+ * graph. The equilibrated positions are written back to the ingredients.
+ **/
+template<class IngredientsType, class MoveType>
+void ReferenceEnsemble<IngredientsType,MoveType>::solveLanes(uint32_t first, uint32_t n, uint64_t seed, Moments* moments, std::vector<uint64_t>& hist)
+{
+  std::vector< std::unique_ptr<IngredientsType> > ings(n);
+  std::mt19937 rng;
+  for(uint32_t l=0; l<n; l++){
+    ings[l].reset(new IngredientsType);
+    build(first+l,seed,*ings[l],rng);
+  }
+
+  ReferenceLaneSolver lanes(n);
+  configureLanes(lanes,prototypeMove);
+  lanes.setDecreaseFactor(decreaseFactor);
+  //monomer IDs of the nodes per lane
+  std::vector< std::vector<uint32_t> > nodeIDs(n);
+  std::vector<std::pair<uint32_t,uint32_t> > strands;
+  uint32_t nCrossLinksFirst(0);
+  for(uint32_t l=0; l<n; l++){
+    const IngredientsType& ing(*ings[l]);
+    std::vector<int32_t> nodeOfID(ing.getMolecules().size(),-1);
+    auto node=[&](uint32_t ID)->uint32_t{
+      if( nodeOfID[ID] < 0 ){
+        nodeOfID[ID]=nodeIDs[l].size();
+        nodeIDs[l].push_back(ID);
+      }
+      return nodeOfID[ID];
+    };
+    const std::vector<uint32_t>& crosslinkIDs(ing.getCrosslinkIDs());
+    for(size_t i=0; i<crosslinkIDs.size(); i++)
+      node(crosslinkIDs[i]);
+    const uint32_t nCrossLinks(nodeIDs[l].size());
+    if( l == 0 ) nCrossLinksFirst=nCrossLinks;
+    uint32_t strand(0);
+    bool sameGraph(true);
+    forEachStrand(ing,[&](uint32_t IDx, const typename std::decay<decltype(ing.getCrossLinkNeighborIDs(0)[0])>::type& neighbor){
+      const std::pair<uint32_t,uint32_t> ends(node(IDx),node(neighbor.ID));
+      if( l == 0 )
+        strands.push_back(ends);
+      else if( strand >= strands.size() || strands[strand] != ends ){
+        sameGraph=false;
+        return;
+      }
+      strand++;
+    });
+    if( !sameGraph || nCrossLinks != nCrossLinksFirst || strand != strands.size() || nodeIDs[l].size() != nodeIDs[0].size() ){
+      std::stringstream errormessage;
+      errormessage << "ReferenceEnsemble: realization " << first+l << " has another graph than realization " << first << ", the lanes need the same graph.";
+      throw std::runtime_error(errormessage.str());
+    }
+    if( l == 0 ){
+      for(uint32_t i=0; i<nodeIDs[0].size(); i++)
+        lanes.addNode(i < nCrossLinks && isMovable(ing.getMolecules()[nodeIDs[0][i]],0));
+      for(size_t e=0; e<strands.size(); e++)
+        lanes.addStrand(strands[e].first,strands[e].second);
+    }
+    for(uint32_t i=0; i<nodeIDs[l].size(); i++){
+      const VectorDouble3 r(ing.getMolecules()[nodeIDs[l][i]].getVector3D());
+      lanes.setPosition(i,l,r.getX(),r.getY(),r.getZ());
+    }
+    strand=0;
+    forEachStrand(ing,[&](uint32_t, const typename std::decay<decltype(ing.getCrossLinkNeighborIDs(0)[0])>::type& neighbor){
+      lanes.setStrand(strand++,l,neighbor.segDistance,neighbor.jump.getX(),neighbor.jump.getY(),neighbor.jump.getZ());
+    });
+  }
+
+  lanes.relax(threshold,maxSweeps);
+
+  for(uint32_t l=0; l<n; l++){
+    IngredientsType& ing(*ings[l]);
+    moments[l].converged=lanes.isConverged(l);
+    for(uint32_t i=0; i<nodeIDs[l].size(); i++)
+      ing.modifyMolecules()[nodeIDs[l][i]].modifyVector3D()=VectorDouble3(lanes.getX(i,l),lanes.getY(i,l),lanes.getZ(i,l));
+    evaluate(first+l,ing,moments[l],hist);
+  }
+}
+
+/**
+ * @details Only the reference curve can be used, because the segment counts
+ * of the strands differ between the lanes. 
+ **/
+template<class IngredientsType, class MoveType>
+void ReferenceEnsemble<IngredientsType,MoveType>::configureLanes(ReferenceLaneSolver& lanes, const MoveNonLinearForceEquilibrium& move)
+{
+  if( move.hasSegmentTables() )
+    throw std::runtime_error("ReferenceEnsemble: the lanes support only the reference curve of MoveNonLinearForceEquilibrium.");
+  lanes.useForceExtensionTable(move.getReferenceTable(),move.getInverseAccuracy(),move.getMaxExtension(),move.getSpringConstant());
+}
+
+/**
+ * @details The moments are summed up in the order of the realizations and
+ * the histograms are integer counts, thus the result is reproducible for
+ * any number of threads if the builder uses only the stream of the realization.
+ **/
+template<class IngredientsType, class MoveType>
+void ReferenceEnsemble<IngredientsType,MoveType>::run(uint32_t nRealizations_, uint64_t seed)
+{
+  WorkerPool pool(nThreads);
+  std::vector<Moments> moments(nRealizations_);
+  std::vector< std::vector<uint64_t> > histograms(pool.getNumThreads());
+  metaData.reset();
+
+  NullBuffer nullBuffer;
+  std::streambuf* coutBuffer(quiet ? std::cout.rdbuf(&nullBuffer) : NULL);
+  try{
+    if( nLanes > 0 ){
+      const uint32_t nBatches((nRealizations_+nLanes-1)/nLanes);
+      pool.run(nBatches,[&](uint32_t batch, uint32_t thread){
+        const uint32_t first(batch*nLanes);
+        solveLanes(first,std::min(nLanes,nRealizations_-first),seed,&moments[first],histograms[thread]);
+      });
+    }else{
+      pool.run(nRealizations_,[&](uint32_t k, uint32_t thread){
+        solve(k,seed,moments[k],histograms[thread]);
+      });
+    }
+  }catch(...){
+    if( quiet ) std::cout.rdbuf(coutBuffer);
+    throw;
+  }
+  if( quiet ) std::cout.rdbuf(coutBuffer);
+
+  nRealizations=nRealizations_;
+  nUnconverged=0;
+  nStrands=0; sumR2=0.; sumR2PerSegment=0.;
+  sumComponent2.assign(3,0.);
+  for(size_t k=0; k<moments.size(); k++){
+    if( !moments[k].converged ) nUnconverged++;
+    nStrands+=moments[k].nStrands;
+    sumR2+=moments[k].R2;
+    sumR2PerSegment+=moments[k].R2PerSegment;
+    for(uint32_t dim=0; dim<3; dim++)
+      sumComponent2[dim]+=moments[k].component2[dim];
+  }
+  histogram.clear();
+  for(size_t t=0; t<histograms.size(); t++){
+    if( histograms[t].size() > histogram.size() )
+      histogram.resize(histograms[t].size(),0);
+    for(size_t bin=0; bin<histograms[t].size(); bin++)
+      histogram[bin]+=histograms[t][bin];
+  }
+  std::cout << "ReferenceEnsemble: " << nRealizations << " realizations with " << nStrands << " strands on "
+            << pool.getNumThreads() << " threads, <R^2>=" << getMeanSquaredLength() << std::endl;
+  if( nUnconverged > 0 )
+    std::cout << "ReferenceEnsemble: " << nUnconverged << " realizations did not reach the threshold within " << maxSweeps << " sweeps." << std::endl;
+}
+
+/**
+ * @details P(R) is normalized such that its integral over R is one.
+ **/
+template<class IngredientsType, class MoveType>
+void ReferenceEnsemble<IngredientsType,MoveType>::write(const std::string& filename) const
+{
+  if( !metaData )
+    throw std::runtime_error("ReferenceEnsemble::write: there is no result, call run first.");
+  std::vector< std::vector<double> > data(3);
+  for(size_t bin=0; bin<histogram.size(); bin++){
+    data[0].push_back((bin+0.5)*binWidth);
+    data[1].push_back(histogram[bin]);
+    data[2].push_back(histogram[bin]/(nStrands*binWidth));
+  }
+  std::stringstream comment;
+  comment << "Created by ReferenceEnsemble\n";
+  comment << "realizations=" << nRealizations << "\n";
+  comment << "unconverged realizations=" << nUnconverged << "\n";
+  comment << "strands=" << nStrands << "\n";
+  comment << "stretching factor=" << stretchingFactor << "\n";
+  comment << "<R^2>=" << getMeanSquaredLength() << "\n";
+  comment << "<Rx^2> <Ry^2> <Rz^2>=" << getMeanSquaredComponent(0) << " " << getMeanSquaredComponent(1) << " " << getMeanSquaredComponent(2) << "\n";
+  comment << "<R^2/N>=" << getMeanSquaredLengthPerSegment() << "\n";
+  comment << "R count P(R)\n";
+  ResultFormattingTools::writeResultFile(filename, *metaData, data, comment.str());
+}
+
+#endif /*LEMONADE_PM_UTILITY_REFERENCEENSEMBLE_H*/
@@ -0,0 +1,444 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UTILITY_REFERENCELANESOLVER_H
+#define LEMONADE_PM_UTILITY_REFERENCELANESOLVER_H
+
+#include <stdint.h>
+#include <cmath>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LEMONADE_PM_LANES_AVX2
+#include <immintrin.h>
+#endif
+
+/*****************************************************************************/
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @class ReferenceLaneSolver
+ * @brief Force equilibrium of many small networks with the same topology in lockstep.
+ * @details The reference systems (stars, double stars) have only a few
+ * crosslinks, thus a single equilibration is latency bound. Here nLanes
+ * realizations of the same graph are stored as structure of arrays: every
+ * value of a node or strand is followed by its values in the other lanes. 
+ * A sweep visits the movable nodes in a fixed order (Gauss-Seidel) and 
+ * shifts a node in all lanes at once. The realizations may differ in the 
+ * positions, the jump vectors and the number of segments of the strands.
+ *
+ * The shifts are those of the moves:
+ * - gaussian strands (MoveForceEquilibrium): the weighted average of the strand 
+ *   vectors with the weights 1/N
+ * - tabulated force-extension curve (reference curve of MoveNonLinearForceEquilibrium):
+ *   springConstant times the average force, the spring constant is reduced by 
+ *   decreaseFactor every 100 sweeps
+ *
+ * The lanes are processed in blocks of four with AVX2 if the CPU supports it
+ * (checked at runtime, the binary does not need to be compiled for AVX2) and
+ * by the scalar loop otherwise.
+ **/
+/*****************************************************************************/
+class ReferenceLaneSolver
+{
+public:
+  //! kernel used by relax
+  enum InstructionSet {AUTO=0, SCALAR=1, AVX2=2};
+
+  explicit ReferenceLaneSolver(uint32_t nLanes_=4);
+
+  //! removes all nodes and strands
+  void clear();
+
+  //! number of realizations
+  uint32_t getNumLanes() const {return nLanes;}
+  //! number of values stored per node or strand (nLanes rounded up to the block size)
+  uint32_t getStride() const {return stride;}
+  uint32_t getNumNodes() const {return movable.size();}
+  uint32_t getNumStrands() const {return strandNode1.size();}
+
+  //! adds a node, which is shifted by relax if it is movable, and returns its index
+  uint32_t addNode(bool isMovable);
+  //! adds a strand from node1 to node2 and returns its index
+  uint32_t addStrand(uint32_t node1, uint32_t node2);
+
+  //! position of the node in the lane
+  void setPosition(uint32_t node, uint32_t lane, double x, double y, double z);
+  double getX(uint32_t node, uint32_t lane) const {return px[index(node,lane)];}
+  double getY(uint32_t node, uint32_t lane) const {return py[index(node,lane)];}
+  double getZ(uint32_t node, uint32_t lane) const {return pz[index(node,lane)];}
+  //! segments and jump vector of the strand in the lane, the strand vector is r2-r1-jump
+  void setStrand(uint32_t strand, uint32_t lane, double segments, double jx, double jy, double jz);
+
+  //! shift by the weighted average of the strand vectors (default)
+  void useGaussianStrands(){tabulated=false;}
+  /**
+   * @brief shift by springConstant times the average force of the tabulated curve
+   * @param table_ force at the extensions i/inverseAccuracy_ including one guard cell
+   * @param maxExtension_ beyond it the force is extension/springConstant
+   */
+  void useForceExtensionTable(const std::vector<double>& table_, double inverseAccuracy_, double maxExtension_, double springConstant_);
+  //! factor for the spring constant every 100 sweeps (only for the tabulated curve)
+  void setDecreaseFactor(double decreaseFactor_){decreaseFactor=decreaseFactor_;}
+
+  //! choose the kernel, AUTO uses AVX2 if available
+  void setInstructionSet(InstructionSet instructionSet_){instructionSet=instructionSet_;}
+  //! kernel which is used by relax
+  InstructionSet getInstructionSet() const;
+  //! true if the CPU executing the program supports AVX2
+  static bool supportsAVX2();
+
+  /**
+   * @brief sweeps until the sum of the shift lengths of the last sweep is below threshold in every lane
+   * @return number of sweeps, check isConverged() if it is maxSweeps
+   */
+  uint32_t relax(double threshold, uint32_t maxSweeps=10000000);
+  //! sum of the shift lengths in the last sweep
+  double getShift(uint32_t lane) const {return shift.at(lane);}
+  //! true if the last relax stopped because all lanes were converged, false if it reached maxSweeps
+  bool isConverged() const {return converged;}
+  //! true if the shift of the lane in the last sweep of relax was below the threshold
+  bool isConverged(uint32_t lane) const {return getShift(lane) <= lastThreshold;}
+
+private:
+  size_t index(uint32_t item, uint32_t lane) const {return static_cast<size_t>(item)*stride+lane;}
+  //! incidence list of the movable nodes (other node, strand and direction)
+  void buildIncidence();
+  //! one sweep over all movable nodes, adds the shift lengths to shift
+  void sweepScalar(double springConstant);
+#ifdef LEMONADE_PM_LANES_AVX2
+  __attribute__((target("avx2"))) void sweepAVX2(double springConstant);
+#endif
+
+  uint32_t nLanes;
+  uint32_t stride;
+  InstructionSet instructionSet;
+
+  std::vector<bool> movable;
+  std::vector<double> px, py, pz;
+  std::vector<uint32_t> strandNode1, strandNode2;
+  //! 1/N and jump vector per strand and lane
+  std::vector<double> weight, jx, jy, jz;
+
+  //! compressed incidence lists of the movable nodes
+  std::vector<uint32_t> movableNodes, incidenceStart, incidenceNode, incidenceStrand;
+  std::vector<double> incidenceSign;
+  bool incidenceValid;
+
+  bool tabulated;
+  std::vector<double> table;
+  double inverseAccuracy, maxExtension, lastCell, springConstant0, decreaseFactor;
+
+  std::vector<double> shift;
+  //! result and threshold of the last relax
+  bool converged;
+  double lastThreshold;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+/////////// implementation of the members ///////////////////////////////////
+
+inline ReferenceLaneSolver::ReferenceLaneSolver(uint32_t nLanes_):
+  nLanes(nLanes_),stride(((nLanes_+3)/4)*4),instructionSet(AUTO),incidenceValid(false),
+  tabulated(false),inverseAccuracy(1.),maxExtension(0.),lastCell(0.),springConstant0(1.),decreaseFactor(1.),
+  converged(false),lastThreshold(-1.)
+{
+  if( nLanes == 0 )
+    throw std::runtime_error("ReferenceLaneSolver: the number of lanes has to be positive.");
+  shift.assign(stride,0.);
+}
+
+inline void ReferenceLaneSolver::clear()
+{
+  movable.clear();
+  px.clear(); py.clear(); pz.clear();
+  strandNode1.clear(); strandNode2.clear();
+  weight.clear(); jx.clear(); jy.clear(); jz.clear();
+  incidenceValid=false;
+}
+
+inline uint32_t ReferenceLaneSolver::addNode(bool isMovable)
+{
+  movable.push_back(isMovable);
+  px.resize(px.size()+stride,0.);
+  py.resize(py.size()+stride,0.);
+  pz.resize(pz.size()+stride,0.);
+  incidenceValid=false;
+  return movable.size()-1;
+}
+
+inline uint32_t ReferenceLaneSolver::addStrand(uint32_t node1, uint32_t node2)
+{
+  if( node1 >= movable.size() || node2 >= movable.size() ){
+    std::stringstream errormessage;
+    errormessage << "ReferenceLaneSolver::addStrand: node " << std::max(node1,node2) << " does not exist.";
+    throw std::runtime_error(errormessage.str());
+  }
+  strandNode1.push_back(node1);
+  strandNode2.push_back(node2);
+  //the weight of the padding lanes stays zero
+  weight.resize(weight.size()+stride,0.);
+  jx.resize(jx.size()+stride,0.);
+  jy.resize(jy.size()+stride,0.);
+  jz.resize(jz.size()+stride,0.);
+  incidenceValid=false;
+  return strandNode1.size()-1;
+}
+
+inline void ReferenceLaneSolver::setPosition(uint32_t node, uint32_t lane, double x, double y, double z)
+{
+  if( node >= movable.size() || lane >= nLanes ){
+    std::stringstream errormessage;
+    errormessage << "ReferenceLaneSolver::setPosition: node " << node << " or lane " << lane << " does not exist.";
+    throw std::runtime_error(errormessage.str());
+  }
+  px[index(node,lane)]=x;
+  py[index(node,lane)]=y;
+  pz[index(node,lane)]=z;
+}
+
+inline void ReferenceLaneSolver::setStrand(uint32_t strand, uint32_t lane, double segments, double jx_, double jy_, double jz_)
+{
+  if( strand >= strandNode1.size() || lane >= nLanes || !(segments > 0.) ){
+    std::stringstream errormessage;
+    errormessage << "ReferenceLaneSolver::setStrand: strand " << strand << " or lane " << lane 
+                 << " does not exist or the number of segments " << segments << " is not positive.";
+    throw std::runtime_error(errormessage.str());
+  }
+  weight[index(strand,lane)]=1./segments;
+  jx[index(strand,lane)]=jx_;
+  jy[index(strand,lane)]=jy_;
+  jz[index(strand,lane)]=jz_;
+}
+
+/**
+ * @details The last entry of the table is the guard cell, such that the linear
+ * interpolation in the last cell never reads behind the table.
+ **/
+inline void ReferenceLaneSolver::useForceExtensionTable(const std::vector<double>& table_, double inverseAccuracy_, double maxExtension_, double springConstant_)
+{
+  if( table_.size() < 2 || !(inverseAccuracy_ > 0.) || !(springConstant_ > 0.) )
+    throw std::runtime_error("ReferenceLaneSolver::useForceExtensionTable: the table needs two entries and a positive grid and spring constant.");
+  table=table_;
+  inverseAccuracy=inverseAccuracy_;
+  maxExtension=maxExtension_;
+  lastCell=static_cast<double>(table.size()-2);
+  springConstant0=springConstant_;
+  tabulated=true;
+}
+
+inline bool ReferenceLaneSolver::supportsAVX2()
+{
+#ifdef LEMONADE_PM_LANES_AVX2
+  return __builtin_cpu_supports("avx2");
+#else
+  return false;
+#endif
+}
+
+inline ReferenceLaneSolver::InstructionSet ReferenceLaneSolver::getInstructionSet() const
+{
+  if( instructionSet == SCALAR ) return SCALAR;
+  if( instructionSet == AVX2 && !supportsAVX2() )
+    throw std::runtime_error("ReferenceLaneSolver: AVX2 is not supported by this CPU or compiler.");
+  return supportsAVX2() ? AVX2 : SCALAR;
+}
+
+/**
+ * @details A strand is listed at both of its nodes, the direction is +1 at
+ * node1 (vector r2-r1-jump) and -1 at node2 (vector r1-r2+jump).
+ **/
+inline void ReferenceLaneSolver::buildIncidence()
+{
+  std::vector< std::vector<uint32_t> > strandsOfNode(movable.size());
+  for(uint32_t e=0; e<strandNode1.size(); e++){
+    strandsOfNode[strandNode1[e]].push_back(e);
+    strandsOfNode[strandNode2[e]].push_back(e);
+  }
+  movableNodes.clear(); incidenceStart.assign(1,0);
+  incidenceNode.clear(); incidenceStrand.clear(); incidenceSign.clear();
+  for(uint32_t n=0; n<movable.size(); n++){
+    if( !movable[n] ) continue;
+    movableNodes.push_back(n);
+    for(size_t k=0; k<strandsOfNode[n].size(); k++){
+      const uint32_t e(strandsOfNode[n][k]);
+      //a loop is listed twice with both directions
+      const bool first( strandNode1[e] == n && (k == 0 || strandsOfNode[n][k-1] != e) );
+      incidenceNode.push_back(first ? strandNode2[e] : strandNode1[e]);
+      incidenceStrand.push_back(e);
+      incidenceSign.push_back(first ? 1. : -1.);
+    }
+    incidenceStart.push_back(incidenceNode.size());
+  }
+  incidenceValid=true;
+}
+
+/**
+ * @details The inner loops run over the lanes and have no data dependent 
+ * branches, thus the compiler may vectorize them for the target of the build.
+ **/
+inline void ReferenceLaneSolver::sweepScalar(double springConstant)
+{
+  const double inverseSpringConstant(1./springConstant);
+  std::vector<double> sx(stride), sy(stride), sz(stride), sw(stride);
+  for(size_t m=0; m<movableNodes.size(); m++){
+    const size_t node(index(movableNodes[m],0));
+    std::fill(sx.begin(),sx.end(),0.); std::fill(sy.begin(),sy.end(),0.);
+    std::fill(sz.begin(),sz.end(),0.); std::fill(sw.begin(),sw.end(),0.);
+    for(uint32_t k=incidenceStart[m]; k<incidenceStart[m+1]; k++){
+      const size_t other(index(incidenceNode[k],0));
+      const size_t strand(index(incidenceStrand[k],0));
+      const double sign(incidenceSign[k]);
+      for(uint32_t l=0; l<stride; l++){
+        const double rx(px[other+l]-sign*jx[strand+l]-px[node+l]);
+        const double ry(py[other+l]-sign*jy[strand+l]-py[node+l]);
+        const double rz(pz[other+l]-sign*jz[strand+l]-pz[node+l]);
+        double scale(weight[strand+l]);
+        if( tabulated ){
+          const double length(std::sqrt(rx*rx+ry*ry+rz*rz));
+          const double x(std::min(length*inverseAccuracy,lastCell));
+          const uint32_t down(static_cast<uint32_t>(x));
+          const double tableAmplitude(table[down]+(table[down+1]-table[down])*(x-down));
+          const double amplitude( (length > maxExtension) ? length*inverseSpringConstant : tableAmplitude );
+          scale=( (length > 0.) ? amplitude/length : 0. );
+        }
+        sx[l]+=rx*scale; sy[l]+=ry*scale; sz[l]+=rz*scale; sw[l]+=weight[strand+l];
+      }
+    }
+    const double degree(incidenceStart[m+1]-incidenceStart[m]);
+    for(uint32_t l=0; l<stride; l++){
+      double factor( (sw[l] > 0.) ? 1./sw[l] : 0. );
+      if( tabulated ) factor=springConstant/degree;
+      const double dx(sx[l]*factor), dy(sy[l]*factor), dz(sz[l]*factor);
+      px[node+l]+=dx; py[node+l]+=dy; pz[node+l]+=dz;
+      shift[l]+=std::sqrt(dx*dx+dy*dy+dz*dz);
+    }
+  }
+}
+
+#ifdef LEMONADE_PM_LANES_AVX2
+/**
+ * @details Same arithmetic as sweepScalar for blocks of four lanes. The table
+ * is read by gathers, the selects are blends.
+ **/
+__attribute__((target("avx2"))) inline void ReferenceLaneSolver::sweepAVX2(double springConstant)
+{
+  const __m256d zero(_mm256_setzero_pd());
+  const __m256d one(_mm256_set1_pd(1.));
+  const __m256d vInverseAccuracy(_mm256_set1_pd(inverseAccuracy));
+  const __m256d vLastCell(_mm256_set1_pd(lastCell));
+  const __m256d vMaxExtension(_mm256_set1_pd(maxExtension));
+  const __m256d vInverseSpringConstant(_mm256_set1_pd(1./springConstant));
+  const __m256d all(_mm256_castsi256_pd(_mm256_set1_epi64x(-1)));
+  const double* tableData(tabulated ? &table[0] : NULL);
+  for(size_t m=0; m<movableNodes.size(); m++){
+    const size_t node(index(movableNodes[m],0));
+    const double degree(incidenceStart[m+1]-incidenceStart[m]);
+    for(uint32_t l=0; l<stride; l+=4){
+      const __m256d x0(_mm256_loadu_pd(&px[node+l]));
+      const __m256d y0(_mm256_loadu_pd(&py[node+l]));
+      const __m256d z0(_mm256_loadu_pd(&pz[node+l]));
+      __m256d sx(zero), sy(zero), sz(zero), sw(zero);
+      for(uint32_t k=incidenceStart[m]; k<incidenceStart[m+1]; k++){
+        const size_t other(index(incidenceNode[k],l));
+        const size_t strand(index(incidenceStrand[k],l));
+        const __m256d sign(_mm256_set1_pd(incidenceSign[k]));
+        const __m256d rx(_mm256_sub_pd(_mm256_sub_pd(_mm256_loadu_pd(&px[other]),_mm256_mul_pd(sign,_mm256_loadu_pd(&jx[strand]))),x0));
+        const __m256d ry(_mm256_sub_pd(_mm256_sub_pd(_mm256_loadu_pd(&py[other]),_mm256_mul_pd(sign,_mm256_loadu_pd(&jy[strand]))),y0));
+        const __m256d rz(_mm256_sub_pd(_mm256_sub_pd(_mm256_loadu_pd(&pz[other]),_mm256_mul_pd(sign,_mm256_loadu_pd(&jz[strand]))),z0));
+        const __m256d w(_mm256_loadu_pd(&weight[strand]));
+        __m256d scale(w);
+        if( tabulated ){
+          const __m256d length(_mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(rx,rx),_mm256_mul_pd(ry,ry)),_mm256_mul_pd(rz,rz))));
+          const __m256d x(_mm256_min_pd(_mm256_mul_pd(length,vInverseAccuracy),vLastCell));
+          const __m128i down(_mm256_cvttpd_epi32(x));
+          const __m256d lower(_mm256_mask_i32gather_pd(zero,tableData,down,all,8));
+          const __m256d upper(_mm256_mask_i32gather_pd(zero,tableData+1,down,all,8));
+          const __m256d tableAmplitude(_mm256_add_pd(lower,_mm256_mul_pd(_mm256_sub_pd(upper,lower),_mm256_sub_pd(x,_mm256_cvtepi32_pd(down)))));
+          const __m256d amplitude(_mm256_blendv_pd(tableAmplitude,_mm256_mul_pd(length,vInverseSpringConstant),_mm256_cmp_pd(length,vMaxExtension,_CMP_GT_OQ)));
+          scale=_mm256_blendv_pd(zero,_mm256_div_pd(amplitude,length),_mm256_cmp_pd(length,zero,_CMP_GT_OQ));
+        }
+        sx=_mm256_add_pd(sx,_mm256_mul_pd(rx,scale));
+        sy=_mm256_add_pd(sy,_mm256_mul_pd(ry,scale));
+        sz=_mm256_add_pd(sz,_mm256_mul_pd(rz,scale));
+        sw=_mm256_add_pd(sw,w);
+      }
+      __m256d factor;
+      if( tabulated )
+        factor=_mm256_set1_pd(springConstant/degree);
+      else
+        factor=_mm256_blendv_pd(zero,_mm256_div_pd(one,sw),_mm256_cmp_pd(sw,zero,_CMP_GT_OQ));
+      const __m256d dx(_mm256_mul_pd(sx,factor)), dy(_mm256_mul_pd(sy,factor)), dz(_mm256_mul_pd(sz,factor));
+      _mm256_storeu_pd(&px[node+l],_mm256_add_pd(x0,dx));
+      _mm256_storeu_pd(&py[node+l],_mm256_add_pd(y0,dy));
+      _mm256_storeu_pd(&pz[node+l],_mm256_add_pd(z0,dz));
+      const __m256d length(_mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx,dx),_mm256_mul_pd(dy,dy)),_mm256_mul_pd(dz,dz))));
+      _mm256_storeu_pd(&shift[l],_mm256_add_pd(_mm256_loadu_pd(&shift[l]),length));
+    }
+  }
+}
+#endif
+
+/**
+ * @details As in UpdaterForceBalancedPosition the criterion is the sum of the
+ * shift lengths of one sweep. Converged lanes are swept further until the last
+ * lane is converged. If maxSweeps is reached before, isConverged() is false and
+ * isConverged(lane) tells which lanes are not converged.
+ **/
+inline uint32_t ReferenceLaneSolver::relax(double threshold, uint32_t maxSweeps)
+{
+  if( !incidenceValid ) buildIncidence();
+  const InstructionSet kernel(getInstructionSet());
+  double springConstant(springConstant0);
+  uint32_t sweeps(0);
+  converged=false;
+  lastThreshold=threshold;
+  while( sweeps < maxSweeps ){
+    std::fill(shift.begin(),shift.end(),0.);
+#ifdef LEMONADE_PM_LANES_AVX2
+    if( kernel == AVX2 )
+      sweepAVX2(springConstant);
+    else
+#endif
+      sweepScalar(springConstant);
+    sweeps++;
+    if( *std::max_element(shift.begin(),shift.begin()+nLanes) <= threshold ){
+      converged=true;
+      break;
+    }
+    if( sweeps % 100 == 0 )
+      springConstant*=decreaseFactor;
+  }
+  return sweeps;
+}
+
+#endif /*LEMONADE_PM_UTILITY_REFERENCELANESOLVER_H*/
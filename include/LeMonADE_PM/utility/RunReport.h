@@ -0,0 +1,336 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UTILITY_RUNREPORT_H
+#define LEMONADE_PM_UTILITY_RUNREPORT_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+/*****************************************************************************/
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @class RunReport
+ * @brief Timings, counters and memory high-water marks of a run as JSON.
+ * @details The hot paths are instrumented by the macros below. They are 
+ * compiled only with LEMONADE_PM_INSTRUMENTATION (cmake option of the same
+ * name), otherwise they expand to nothing and their arguments are not 
+ * evaluated. The collected data is kept by RunReport::instance() and written
+ * at exit to the file given by LEMONADE_PM_REPORT (nothing is written without):
+ *  - phases: number of calls, total and longest wall time and the peak memory
+ *    (resident set size) at the end of the phase,
+ *  - counters: sums, e.g. the attempted and applied moves,
+ *  - rates: a counter per second of a phase, evaluated at output,
+ *  - series: values per step, e.g. the residual per sweep (at most 
+ *    maxSeriesLength values per series, further values are only counted).
+ *
+ * All members are thread safe.
+ **/
+/*****************************************************************************/
+class RunReport
+{
+public:
+  //! accumulated wall time of a phase
+  struct Phase{
+    Phase():calls(0),seconds(0.0),maxSeconds(0.0),peakMemoryKB(0){}
+    uint64_t calls;
+    double seconds;
+    double maxSeconds;
+    uint64_t peakMemoryKB;
+  };
+
+  RunReport():start(std::chrono::steady_clock::now()),maxSeriesLength(1000000){}
+  //! writes the report if an output file is set
+  ~RunReport(){
+    try{
+      if( !outputFile.empty() ) write(outputFile);
+    }catch(...){}
+  }
+
+  //! the report of the program
+  static RunReport& instance(){
+    static RunReport report;
+    return report;
+  }
+
+  //! file written by the destructor (empty: no output)
+  void setOutput(const std::string& filename){std::lock_guard<std::mutex> lock(mutex); outputFile=filename;}
+  std::string getOutput() const {std::lock_guard<std::mutex> lock(mutex); return outputFile;}
+  void setMaxSeriesLength(size_t length){std::lock_guard<std::mutex> lock(mutex); maxSeriesLength=length;}
+
+  //! adds a call of the phase, which took seconds
+  void addPhase(const std::string& name, double seconds);
+  //! adds value to the counter
+  void addCount(const std::string& name, double value);
+  //! appends value to the series
+  void addValue(const std::string& name, double value);
+  //! reports counter per second of phase
+  void addRate(const std::string& name, const std::string& counter, const std::string& phase);
+
+  Phase getPhase(const std::string& name) const;
+  double getCount(const std::string& name) const;
+  std::vector<double> getSeries(const std::string& name) const;
+
+  //! removes all data except the output file
+  void clear();
+
+  //! peak resident set size of the process in kB (0 if unknown)
+  static uint64_t getPeakMemoryKB();
+
+  //! JSON document of the collected data
+  std::string toJSON() const;
+  //! writes toJSON() to filename
+  void write(const std::string& filename) const;
+
+private:
+  struct Series{
+    Series():dropped(0){}
+    std::vector<double> values;
+    uint64_t dropped;
+  };
+  struct Rate{
+    std::string counter;
+    std::string phase;
+  };
+
+  mutable std::mutex mutex;
+  std::chrono::steady_clock::time_point start;
+  std::string outputFile;
+  size_t maxSeriesLength;
+  std::map<std::string,Phase> phases;
+  std::map<std::string,double> counts;
+  std::map<std::string,Series> series;
+  std::map<std::string,Rate> rates;
+
+  static std::string quote(const std::string& text);
+  //! JSON has no inf and nan
+  static std::string number(double value);
+};
+
+/**
+ * @class ScopedPhase
+ * @brief Adds the lifetime of the object as one call of a phase to a report.
+ */
+class ScopedPhase
+{
+public:
+  explicit ScopedPhase(const char* name_, RunReport& report_=RunReport::instance())
+  :name(name_),report(report_),begin(std::chrono::steady_clock::now()){}
+  ~ScopedPhase(){
+    report.addPhase(name,std::chrono::duration<double>(std::chrono::steady_clock::now()-begin).count());
+  }
+private:
+  ScopedPhase(const ScopedPhase&);
+  ScopedPhase& operator=(const ScopedPhase&);
+  const char* name;
+  RunReport& report;
+  std::chrono::steady_clock::time_point begin;
+};
+
+#define LEMONADE_PM_CONCAT_IMPL(a,b) a##b
+#define LEMONADE_PM_CONCAT(a,b) LEMONADE_PM_CONCAT_IMPL(a,b)
+
+#ifdef LEMONADE_PM_INSTRUMENTATION
+//! times the rest of the enclosing scope as phase name
+#define LEMONADE_PM_PHASE(name) ScopedPhase LEMONADE_PM_CONCAT(lemonadePmPhase,__LINE__)(name)
+//! adds value to the counter name
+#define LEMONADE_PM_COUNT(name,value) RunReport::instance().addCount(name,value)
+//! appends value to the series name
+#define LEMONADE_PM_SERIES(name,value) RunReport::instance().addValue(name,value)
+//! reports counter per second of phase as name
+#define LEMONADE_PM_RATE(name,counter,phase) RunReport::instance().addRate(name,counter,phase)
+//! writes the report to filename at exit
+#define LEMONADE_PM_REPORT(filename) RunReport::instance().setOutput(filename)
+#else
+#define LEMONADE_PM_PHASE(name) do{}while(0)
+#define LEMONADE_PM_COUNT(name,value) do{}while(0)
+#define LEMONADE_PM_SERIES(name,value) do{}while(0)
+#define LEMONADE_PM_RATE(name,counter,phase) do{}while(0)
+#define LEMONADE_PM_REPORT(filename) do{}while(0)
+#endif
+
+/////////////////////////////////////////////////////////////////////////////
+/////////// implementation of the members ///////////////////////////////////
+
+inline void RunReport::addPhase(const std::string& name, double seconds){
+  const uint64_t memory(getPeakMemoryKB());
+  std::lock_guard<std::mutex> lock(mutex);
+  Phase& phase(phases[name]);
+  phase.calls++;
+  phase.seconds+=seconds;
+  phase.maxSeconds=std::max(phase.maxSeconds,seconds);
+  phase.peakMemoryKB=std::max(phase.peakMemoryKB,memory);
+}
+
+inline void RunReport::addCount(const std::string& name, double value){
+  std::lock_guard<std::mutex> lock(mutex);
+  counts[name]+=value;
+}
+
+inline void RunReport::addValue(const std::string& name, double value){
+  std::lock_guard<std::mutex> lock(mutex);
+  Series& entry(series[name]);
+  if( entry.values.size() < maxSeriesLength ) entry.values.push_back(value);
+  else entry.dropped++;
+}
+
+inline void RunReport::addRate(const std::string& name, const std::string& counter, const std::string& phase){
+  std::lock_guard<std::mutex> lock(mutex);
+  Rate& rate(rates[name]);
+  rate.counter=counter;
+  rate.phase=phase;
+}
+
+inline RunReport::Phase RunReport::getPhase(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  std::map<std::string,Phase>::const_iterator it(phases.find(name));
+  return it == phases.end() ? Phase() : it->second;
+}
+
+inline double RunReport::getCount(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  std::map<std::string,double>::const_iterator it(counts.find(name));
+  return it == counts.end() ? 0.0 : it->second;
+}
+
+inline std::vector<double> RunReport::getSeries(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  std::map<std::string,Series>::const_iterator it(series.find(name));
+  return it == series.end() ? std::vector<double>() : it->second.values;
+}
+
+inline void RunReport::clear(){
+  std::lock_guard<std::mutex> lock(mutex);
+  phases.clear();
+  counts.clear();
+  series.clear();
+  rates.clear();
+  start=std::chrono::steady_clock::now();
+}
+
+inline uint64_t RunReport::getPeakMemoryKB(){
+#if defined(__unix__) || defined(__APPLE__)
+  struct rusage usage;
+  if( getrusage(RUSAGE_SELF,&usage) != 0 ) return 0;
+#if defined(__APPLE__)
+  //bytes on macOS
+  return usage.ru_maxrss/1024;
+#else
+  return usage.ru_maxrss;
+#endif
+#else
+  return 0;
+#endif
+}
+
+inline std::string RunReport::quote(const std::string& text){
+  std::string quoted("\"");
+  for(size_t i=0; i<text.size(); i++){
+    const char c(text[i]);
+    if( c == '"' || c == '\\' ) { quoted+='\\'; quoted+=c; }
+    else if( c == '\n' ) quoted+="\\n";
+    else if( static_cast<unsigned char>(c) < 0x20 ) quoted+=' ';
+    else quoted+=c;
+  }
+  return quoted+"\"";
+}
+
+inline std::string RunReport::number(double value){
+  if( !std::isfinite(value) ) return "null";
+  std::stringstream text;
+  text.precision(10);
+  text << value;
+  return text.str();
+}
+
+inline std::string RunReport::toJSON() const {
+  const uint64_t memory(getPeakMemoryKB());
+  std::lock_guard<std::mutex> lock(mutex);
+  std::stringstream json;
+  json << "{\n";
+  json << "  \"wallSeconds\": " << number(std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count()) << ",\n";
+  json << "  \"peakMemoryKB\": " << memory << ",\n";
+  json << "  \"phases\": {";
+  for(std::map<std::string,Phase>::const_iterator it=phases.begin(); it!=phases.end(); ++it){
+    json << (it==phases.begin() ? "\n" : ",\n") << "    " << quote(it->first) << ": {\"calls\": " << it->second.calls
+         << ", \"seconds\": " << number(it->second.seconds) << ", \"maxSeconds\": " << number(it->second.maxSeconds) 
+         << ", \"peakMemoryKB\": " << it->second.peakMemoryKB << "}";
+  }
+  json << (phases.empty() ? "},\n" : "\n  },\n");
+  json << "  \"counters\": {";
+  for(std::map<std::string,double>::const_iterator it=counts.begin(); it!=counts.end(); ++it)
+    json << (it==counts.begin() ? "\n" : ",\n") << "    " << quote(it->first) << ": " << number(it->second);
+  json << (counts.empty() ? "},\n" : "\n  },\n");
+  json << "  \"rates\": {";
+  bool first(true);
+  for(std::map<std::string,Rate>::const_iterator it=rates.begin(); it!=rates.end(); ++it){
+    std::map<std::string,double>::const_iterator counter(counts.find(it->second.counter));
+    std::map<std::string,Phase>::const_iterator phase(phases.find(it->second.phase));
+    if( counter == counts.end() || phase == phases.end() || phase->second.seconds <= 0.0 ) continue;
+    json << (first ? "\n" : ",\n") << "    " << quote(it->first) << ": " << number(counter->second/phase->second.seconds);
+    first=false;
+  }
+  json << (first ? "},\n" : "\n  },\n");
+  json << "  \"series\": {";
+  for(std::map<std::string,Series>::const_iterator it=series.begin(); it!=series.end(); ++it){
+    json << (it==series.begin() ? "\n" : ",\n") << "    " << quote(it->first) << ": {\"dropped\": " << it->second.dropped << ", \"values\": [";
+    for(size_t i=0; i<it->second.values.size(); i++)
+      json << (i==0 ? "" : ", ") << number(it->second.values[i]);
+    json << "]}";
+  }
+  json << (series.empty() ? "}\n" : "\n  }\n");
+  json << "}\n";
+  return json.str();
+}
+
+inline void RunReport::write(const std::string& filename) const {
+  std::ofstream file(filename.c_str());
+  if( !file.is_open() ){
+    std::stringstream errormessage;
+    errormessage << "RunReport::write: could not open " << filename;
+    throw std::runtime_error(errormessage.str());
+  }
+  file << toJSON();
+}
+
+#endif /*LEMONADE_PM_UTILITY_RUNREPORT_H*/
@@ -0,0 +1,257 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UTILITY_UNIONFIND_H
+#define LEMONADE_PM_UTILITY_UNIONFIND_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <map>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*****************************************************************************/
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @class UnionFind
+ * @brief Disjoint sets of monomers for the cluster size distribution.
+ * @details Union by size and path halving, thus a sequence of unite() and 
+ * find() is almost linear in the number of elements. The memory are two 
+ * integers per element, no member lists of the clusters are stored.
+ * uniteBonds() adds all bonds of a molecules container, with OpenMP and a 
+ * fresh forest each thread builds the forest of a contiguous block of 
+ * monomers and the bonds between the blocks are merged afterwards.
+ **/
+/*****************************************************************************/
+class UnionFind
+{
+public:
+  explicit UnionFind(uint32_t nElements=0){reset(nElements);}
+
+  //! nElements single element sets
+  void reset(uint32_t nElements);
+  //! add an element as single element set, returns its index
+  uint32_t addElement();
+  //! representative of the set of i
+  uint32_t find(uint32_t i);
+  //! merge the sets of i and j, returns false if they were already merged
+  bool unite(uint32_t i, uint32_t j);
+  //! true if i and j are in the same set
+  bool connected(uint32_t i, uint32_t j){return find(i)==find(j);}
+  //! size of the set of i
+  uint32_t getClusterSize(uint32_t i){return clusterSize[find(i)];}
+  //! number of sets
+  uint32_t getNumClusters() const {return nClusters;}
+  //! number of elements
+  uint32_t getNumElements() const {return parent.size();}
+  //! size of the largest set
+  uint32_t getLargestClusterSize() const {return largest;}
+
+  //! unite all bonded monomers of the molecules container
+  template<class MoleculesType>
+  void uniteBonds(const MoleculesType& molecules);
+
+  //! key is the size of the cluster, value the number of clusters of this size
+  std::map<uint32_t,uint32_t> getSizeDistribution() const;
+  //! number average size: sum n_s s / sum n_s
+  double getNumberAverage() const;
+  //! weight average size: sum n_s s^2 / sum n_s s
+  double getWeightAverage() const;
+  //! weight average size without the largest cluster (the gel above the gel point)
+  double getReducedWeightAverage() const;
+  //! fraction of the elements in the largest set
+  double getLargestClusterFraction() const {return parent.empty() ? 0.0 : double(largest)/parent.size();}
+
+private:
+  std::vector<uint32_t> parent;
+  std::vector<uint32_t> clusterSize;
+  uint32_t nClusters;
+  uint32_t largest;
+  //! sum over the clusters of size^2, updated by unite()
+  double sumSquaredSizes;
+
+  //! link the roots ri and rj by size, no update of the statistics
+  uint32_t link(uint32_t ri, uint32_t rj);
+  //! recalculate the statistics from the roots
+  void updateStatistics();
+};
+
+/////////////////////////////////////////////////////////////////////////////
+/////////// implementation of the members ///////////////////////////////////
+
+inline void UnionFind::reset(uint32_t nElements)
+{
+  parent.resize(nElements);
+  clusterSize.assign(nElements,1);
+  for(uint32_t i=0; i<nElements; i++)
+    parent[i]=i;
+  nClusters=nElements;
+  largest=(nElements > 0) ? 1 : 0;
+  sumSquaredSizes=nElements;
+}
+
+inline uint32_t UnionFind::addElement()
+{
+  uint32_t i(parent.size());
+  parent.push_back(i);
+  clusterSize.push_back(1);
+  nClusters++;
+  sumSquaredSizes+=1.0;
+  if(largest == 0) largest=1;
+  return i;
+}
+
+inline uint32_t UnionFind::find(uint32_t i)
+{
+  while( parent[i] != i ){
+    parent[i]=parent[parent[i]];
+    i=parent[i];
+  }
+  return i;
+}
+
+inline uint32_t UnionFind::link(uint32_t ri, uint32_t rj)
+{
+  if( clusterSize[ri] < clusterSize[rj] ){
+    uint32_t tmp(ri); ri=rj; rj=tmp;
+  }
+  parent[rj]=ri;
+  clusterSize[ri]+=clusterSize[rj];
+  return ri;
+}
+
+inline bool UnionFind::unite(uint32_t i, uint32_t j)
+{
+  uint32_t ri(find(i)), rj(find(j));
+  if( ri == rj ) return false;
+  double si(clusterSize[ri]), sj(clusterSize[rj]);
+  uint32_t root(link(ri,rj));
+  nClusters--;
+  sumSquaredSizes+=2.0*si*sj;
+  if( clusterSize[root] > largest ) largest=clusterSize[root];
+  return true;
+}
+
+/**
+ * @details Every bond is visited from its smaller index. With OpenMP and a 
+ * fresh forest (no sets merged yet) the monomers are split into one block 
+ * per thread and each thread unites the bonds inside its block. The roots of 
+ * a block stay inside the block, thus the threads write disjoint parts of the 
+ * arrays. The bonds between blocks are merged serially. A forest with merged 
+ * sets may have links across the blocks and is extended serially.
+ **/
+template<class MoleculesType>
+void UnionFind::uniteBonds(const MoleculesType& molecules)
+{
+  const uint32_t nMonomers(molecules.size());
+  if( parent.size() != nMonomers )
+    reset(nMonomers);
+#ifdef _OPENMP
+  if( nClusters == nMonomers ){
+    std::vector< std::pair<uint32_t,uint32_t> > crossingBonds;
+    #pragma omp parallel
+    {
+      const uint32_t nThreads(omp_get_num_threads());
+      const uint32_t thread(omp_get_thread_num());
+      const uint32_t begin((uint64_t(nMonomers)*thread)/nThreads);
+      const uint32_t end((uint64_t(nMonomers)*(thread+1))/nThreads);
+      std::vector< std::pair<uint32_t,uint32_t> > localCrossing;
+      for(uint32_t i=begin; i<end; i++){
+        for(uint32_t n=0; n<molecules.getNumLinks(i); n++){
+          uint32_t j(molecules.getNeighborIdx(i,n));
+          if( j <= i ) continue;
+          if( j < end ){
+            uint32_t ri(find(i)), rj(find(j));
+            if( ri != rj ) link(ri,rj);
+          }else{
+            localCrossing.push_back(std::make_pair(i,j));
+          }
+        }
+      }
+      #pragma omp critical
+      crossingBonds.insert(crossingBonds.end(),localCrossing.begin(),localCrossing.end());
+    }
+    for(std::size_t b=0; b<crossingBonds.size(); b++){
+      uint32_t ri(find(crossingBonds[b].first)), rj(find(crossingBonds[b].second));
+      if( ri != rj ) link(ri,rj);
+    }
+    updateStatistics();
+    return;
+  }
+#endif
+  for(uint32_t i=0; i<nMonomers; i++)
+    for(uint32_t n=0; n<molecules.getNumLinks(i); n++){
+      uint32_t j(molecules.getNeighborIdx(i,n));
+      if( j > i ) unite(i,j);
+    }
+}
+
+inline void UnionFind::updateStatistics()
+{
+  nClusters=0;
+  largest=0;
+  sumSquaredSizes=0.0;
+  for(uint32_t i=0; i<parent.size(); i++){
+    if( parent[i] != i ) continue;
+    nClusters++;
+    sumSquaredSizes+=double(clusterSize[i])*clusterSize[i];
+    if( clusterSize[i] > largest ) largest=clusterSize[i];
+  }
+}
+
+inline std::map<uint32_t,uint32_t> UnionFind::getSizeDistribution() const
+{
+  std::map<uint32_t,uint32_t> distribution;
+  for(uint32_t i=0; i<parent.size(); i++)
+    if( parent[i] == i )
+      distribution[clusterSize[i]]++;
+  return distribution;
+}
+
+inline double UnionFind::getNumberAverage() const
+{
+  return nClusters > 0 ? double(parent.size())/nClusters : 0.0;
+}
+
+inline double UnionFind::getWeightAverage() const
+{
+  return parent.empty() ? 0.0 : sumSquaredSizes/parent.size();
+}
+
+inline double UnionFind::getReducedWeightAverage() const
+{
+  double mass(double(parent.size())-largest);
+  return mass > 0.0 ? (sumSquaredSizes-double(largest)*largest)/mass : 0.0;
+}
+
+#endif /*LEMONADE_PM_UTILITY_UNIONFIND_H*/
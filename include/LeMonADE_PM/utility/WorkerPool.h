@@ -0,0 +1,131 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_PM_UTILITY_WORKERPOOL_H
+#define LEMONADE_PM_UTILITY_WORKERPOOL_H
+
+#include <stdint.h>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*****************************************************************************/
+/**
+ * @file
+ * @date   2021/06/01
+ * @author Toni
+ *
+ * @class WorkerPool
+ * @brief Distributes independent tasks over a fixed number of threads.
+ * @details run() starts the workers, which fetch the next task index from a
+ * shared counter until all tasks are done, thus long and short tasks are
+ * balanced automatically. The job gets the task index and the index of the
+ * worker, which can be used for data owned by one worker only. After the
+ * first exception no further tasks are started and the exception is rethrown
+ * by run() when all workers have finished.
+ * Code that is not thread safe, e.g. everything using the global LeMonADE
+ * random number generators, has to hold getSerialMutex() within a job. The
+ * order in which the jobs get the mutex is not fixed, i.e. numbers drawn from
+ * a shared generator depend on the scheduling of the threads.
+ **/
+/*****************************************************************************/
+class WorkerPool
+{
+public:
+  //! nThreads_=0 uses the number of hardware threads
+  explicit WorkerPool(uint32_t nThreads_=0);
+
+  //! number of workers
+  uint32_t getNumThreads() const {return nThreads;}
+
+  //! execute job(task,worker) for all tasks 0..nTasks-1 and wait for them
+  void run(uint32_t nTasks, std::function<void(uint32_t,uint32_t)> job);
+
+  //! one mutex shared by all pools for the parts of the jobs which are not thread safe
+  static std::mutex& getSerialMutex(){
+    static std::mutex serialMutex;
+    return serialMutex;
+  }
+
+private:
+  uint32_t nThreads;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+/////////// implementation of the members ///////////////////////////////////
+
+inline WorkerPool::WorkerPool(uint32_t nThreads_):nThreads(nThreads_)
+{
+  if( nThreads == 0 )
+    nThreads=std::thread::hardware_concurrency();
+  if( nThreads == 0 )
+    nThreads=1;
+}
+
+/**
+ * @details With one worker or one task the job runs on the calling thread.
+ **/
+inline void WorkerPool::run(uint32_t nTasks, std::function<void(uint32_t,uint32_t)> job)
+{
+  if( nTasks == 0 ) return;
+  if( nThreads == 1 || nTasks == 1 ){
+    for(uint32_t task=0; task<nTasks; task++)
+      job(task,0);
+    return;
+  }
+  std::atomic<uint32_t> nextTask(0);
+  std::atomic<bool> failed(false);
+  std::exception_ptr error;
+  std::mutex errorMutex;
+  auto worker=[&](uint32_t thread){
+    while( !failed ){
+      const uint32_t task(nextTask++);
+      if( task >= nTasks ) break;
+      try{
+        job(task,thread);
+      }catch(...){
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if( !error ) error=std::current_exception();
+        failed=true;
+      }
+    }
+  };
+  const uint32_t nWorkers(nThreads < nTasks ? nThreads : nTasks);
+  std::vector<std::thread> workers;
+  for(uint32_t thread=1; thread<nWorkers; thread++)
+    workers.push_back(std::thread(worker,thread));
+  worker(0);
+  for(size_t w=0; w<workers.size(); w++)
+    workers[w].join();
+  if( error )
+    std::rethrow_exception(error);
+}
+
+#endif /*LEMONADE_PM_UTILITY_WORKERPOOL_H*/
@@ -0,0 +1,136 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+/******************************************************************************
+ * based on LeMonADE: https://github.com/LeMonADE-project/LeMonADE/
+ * author: Toni Müller
+ * email: mueller-toni@ipfdd.de
+ * project: LeMonADE-Phantom Modulus
+ *****************************************************************************/
+#include <iostream>
+#include <string>
+
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/analyzer/AnalyzerWriteBfmFile.h>
+#include <LeMonADE/feature/FeatureMoleculesIOUnsaveCheck.h>
+#include <LeMonADE/feature/FeatureReactiveBonds.h>
+#include <LeMonADE/feature/FeatureSystemInformationLinearMeltWithCrosslinker.h>
+#include <LeMonADE/utility/TaskManager.h>
+
+#include <extern/catchorg/clara/clara.hpp>
+
+#include <LeMonADE_PM/utility/EndLinkedNetworkGenerator.h>
+
+
+int main(int argc, char* argv[]){
+	try{
+		///////////////////////////////////////////////////////////////////////////////
+		///parse options///
+		std::string outputBFM("EndLinkedNetwork.bfm");
+		std::string outputConnection("BondCreationBreaking.dat");
+		std::string history("random");
+		uint32_t nCrosslinks(1000);
+		uint32_t functionality(4);
+		uint32_t nMonomersPerChain(32);
+		uint32_t boxSize(0);
+		uint32_t nThreads(0);
+		uint64_t seed(0);
+		bool showHelp = false;
+		auto parser
+			= clara::detail::Opt(           outputBFM, "outputBFM (=EndLinkedNetwork.bfm)"               ) ["-o"]["--outputBFM"       ] ("(optional) Output filename of the bfm file. Default EndLinkedNetwork.bfm."          ).optional()
+			| clara::detail::Opt(    outputConnection, "outputConnection (=BondCreationBreaking.dat)"    ) ["-c"]["--outputConnection"] ("(optional) Output filename of the connection table. Default BondCreationBreaking.dat.").optional()
+			| clara::detail::Opt(         nCrosslinks, "nCrosslinks (=1000)"                             ) ["-n"]["--crosslinks"      ] ("(optional) Number of crosslinks. Default 1000."                                      ).optional()
+			| clara::detail::Opt(       functionality, "functionality (=4)"                              ) ["-f"]["--functionality"   ] ("(optional) Functionality of the crosslinks. Default 4."                              ).optional()
+			| clara::detail::Opt(   nMonomersPerChain, "nMonomersPerChain (=32)"                         ) ["-N"]["--chainLength"     ] ("(optional) Number of monomers per chain. Default 32."                                ).optional()
+			| clara::detail::Opt(             boxSize, "boxSize (=0)"                                    ) ["-b"]["--box"             ] ("(optional) Edge of the cubic box, 0 for the melt density of 1/16. Default 0."        ).optional()
+			| clara::detail::Opt(             history, "history (=random)"                               ) ["-y"]["--history"         ] ("(optional) Order of the connections: random or local (growing front). Default random.").optional()
+			| clara::detail::Opt(            nThreads, "nThreads (=0)"                                   ) ["-t"]["--threads"         ] ("(optional) Threads, 0 uses all hardware threads. Default 0."                          ).optional()
+			| clara::detail::Opt(                seed, "seed (=0)"                                       ) ["-s"]["--seed"            ] ("(optional) Seed of the random numbers. Default 0."                                   ).optional()
+			| clara::Help( showHelp );
+
+	    auto result = parser.parse( clara::Args( argc, argv ) );
+
+	    if( !result ) {
+	      std::cerr << "Error in command line: " << result.errorMessage() << std::endl;
+	      exit(1);
+	    }else if(showHelp == true){
+	      std::cout << "Creates an ideal end-linked network of linear chains and crosslinks and the connection table of its formation."<< std::endl;
+	      std::cout << "The output can be used as input for the force equilibration of a network (e.g. for scaling tests)."<< std::endl;
+	      parser.writeToStream(std::cout);
+	      exit(0);
+	    }else{
+	      std::cout << "outputBFM             : " << outputBFM              << std::endl;
+	      std::cout << "outputConnection      : " << outputConnection       << std::endl;
+	      std::cout << "nCrosslinks           : " << nCrosslinks            << std::endl;
+	      std::cout << "functionality         : " << functionality          << std::endl;
+	      std::cout << "nMonomersPerChain     : " << nMonomersPerChain      << std::endl;
+	      std::cout << "boxSize               : " << boxSize                << std::endl;
+	      std::cout << "history               : " << history                << std::endl;
+	      std::cout << "nThreads              : " << nThreads               << std::endl;
+	      std::cout << "seed                  : " << seed                   << std::endl;
+	    }
+		///////////////////////////////////////////////////////////////////////////////
+		///end options parsing
+		///////////////////////////////////////////////////////////////////////////////
+		EndLinkedNetworkGenerator generator(nCrosslinks, functionality, nMonomersPerChain);
+		generator.setBoxSize(boxSize);
+		generator.setNumThreads(nThreads);
+		if( history == "local" )
+			generator.setHistory(EndLinkedNetworkGenerator::LOCAL_HISTORY);
+		else if( history != "random" )
+			throw std::runtime_error("unknown history " + history + " (random or local)");
+		generator.generate(seed);
+		std::cout << "Created " << generator.getNumOfMonomers() << " monomers in a box of " << generator.getBoxSize()
+		          << " with the conversion " << generator.getConversion() << std::endl;
+
+		typedef LOKI_TYPELIST_3(FeatureMoleculesIOUnsaveCheck, FeatureReactiveBonds, FeatureSystemInformationLinearMeltWithCrosslinker) Features;
+		typedef ConfigureSystem<VectorInt3,Features, 7> Config;
+		typedef Ingredients<Config> Ing;
+		Ing myIngredients;
+		myIngredients.modifyBondset().addBFMclassicBondset();
+		generator.copyTo(myIngredients);
+		myIngredients.synchronize();
+
+		TaskManager taskmanager;
+		taskmanager.addAnalyzer( new AnalyzerWriteBfmFile<Ing>(outputBFM, myIngredients, AnalyzerWriteBfmFile<Ing>::NEWFILE) );
+		taskmanager.initialize();
+		taskmanager.run(1);
+		taskmanager.cleanup();
+
+		generator.writeConnectionTable(outputConnection);
+		std::cout << "Wrote " << generator.getConnections().size() << " connections to " << outputConnection << std::endl;
+	}
+	catch(std::exception& e){
+		std::cerr<<"Error:\n"
+		<<e.what()<<std::endl;
+	}
+	catch(...){
+		std::cerr<<"Error: unknown exception\n";
+	}
+
+	return 0;
+}
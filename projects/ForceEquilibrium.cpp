@@ -32,8 +32,10 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  * project: LeMonADE-Phantom Modulus
  *****************************************************************************/
 #include <iostream>
+#include <type_traits>
 #include <vector>
 #include <bitset>
+#include <sstream>
 
 #include <LeMonADE/core/Ingredients.h>
 #include <LeMonADE/updater/UpdaterReadBfmFile.h>
@@ -50,9 +52,82 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE_PM/updater/UpdaterReadCrosslinkConnections.h>
 #include <LeMonADE_PM/updater/moves/MoveForceEquilibrium.h>
 #include <LeMonADE_PM/updater/moves/MoveNonLinearForceEquilibrium.h>
+#include <LeMonADE_PM/updater/moves/MoveAnalyticForceEquilibrium.h>
 #include <LeMonADE_PM/feature/FeatureCrosslinkConnectionsLookUp.h>
 #include <LeMonADE_PM/analyzer/AnalyzerEquilbratedPosition.h>
+#include <LeMonADE_PM/analyzer/AnalyzerNetworkStress.h>
+#include <LeMonADE_PM/analyzer/AnalyzerCrosslinkFluctuation.h>
 #include <LeMonADE_PM/updater/UpdaterAffineDeformation.h>
+#include <LeMonADE_PM/updater/UpdaterStrainSweep.h>
+#include <LeMonADE_PM/updater/UpdaterLinearResponse.h>
+#include <LeMonADE_PM/utility/DeformationTensor.h>
+#include <LeMonADE_PM/utility/IngredientsConversion.h>
+#include <LeMonADE_PM/utility/RunReport.h>
+
+//! create the force updater using an analytic force-extension relation
+template<class IngredientsType, class ForcePolicy>
+AbstractUpdater* createAnalyticForceUpdater(IngredientsType& ing, double threshold, double dampingfactor, 
+											const std::string& checkpointFile, uint32_t checkpointInterval, const std::string& restartFile, bool prune){
+	auto updater = new UpdaterForceBalancedPosition<IngredientsType,MoveAnalyticForceEquilibrium<ForcePolicy> >(ing, threshold,dampingfactor);
+	updater->setPruning(prune);
+	if( !checkpointFile.empty() )
+		updater->setCheckpoint(checkpointFile,checkpointInterval);
+	if( !restartFile.empty() )
+		updater->setRestart(restartFile);
+	return updater;
+}
+
+//! create the strain sweep for the move type
+template<class IngredientsType, class MoveType>
+UpdaterStrainSweep<IngredientsType,MoveType>* createStrainSweep(IngredientsType& ing, const std::vector<double>& lambdas, double threshold, double dampingfactor, const std::string& output,
+											const std::string& checkpointFile, uint32_t checkpointInterval, const std::string& restartFile, bool prune, const VectorDouble3& prestrain){
+	auto sweep = new UpdaterStrainSweep<IngredientsType,MoveType>(ing, lambdas, threshold, dampingfactor, output);
+	sweep->setPrestrain(prestrain.getX(),prestrain.getY(),prestrain.getZ());
+	//the series collapse is exact for the gaussian strands only
+	sweep->getForceUpdater().setPruning(prune, std::is_same<MoveType,MoveForceEquilibrium>::value);
+	if( !checkpointFile.empty() )
+		sweep->setCheckpoint(checkpointFile,checkpointInterval);
+	if( !restartFile.empty() )
+		sweep->setRestart(restartFile);
+	return sweep;
+}
+
+//! create the stress analyzer for the force policy
+template<class IngredientsType, class ForcePolicy>
+AbstractAnalyzer* createStressAnalyzer(IngredientsType& ing, const std::string& output, const VectorDouble3& prestrain){
+	auto analyzer = new AnalyzerNetworkStress<IngredientsType,ForcePolicy>(ing, output);
+	analyzer->setPrestrain(prestrain.getX(),prestrain.getY(),prestrain.getZ());
+	return analyzer;
+}
+
+//! read a comma separated list of stretching factors 
+std::vector<double> parseStretchingFactors(const std::string& list){
+	std::vector<double> lambdas;
+	std::stringstream ss(list);
+	std::string item;
+	while( std::getline(ss,item,',') ){
+		std::stringstream value(item);
+		double lambda;
+		value >> lambda;
+		if( value.fail() ){
+			std::stringstream errormessage;
+			errormessage << "parseStretchingFactors: cannot read " << item << " in " << list;
+			throw std::runtime_error(errormessage.str());
+		}
+		lambdas.push_back(lambda);
+	}
+	return lambdas;
+}
+
+//! read a comma separated list of deformations (see DeformationTensor::parse)
+std::vector<DeformationTensor> parseDeformations(const std::string& list){
+	std::vector<DeformationTensor> deformations;
+	std::stringstream ss(list);
+	std::string item;
+	while( std::getline(ss,item,',') )
+		deformations.push_back(DeformationTensor::parse(item));
+	return deformations;
+}
 
 int main(int argc, char* argv[]){
 	try{
@@ -63,6 +138,7 @@ int main(int argc, char* argv[]){
 		std::string outputDataDist("ChainExtensionDistribution.dat");
 		// std::string inputConnection("BondCreationBreaking.dat");
 		std::string feCurve;
+		std::string model("gauss");
 		double relaxationParameter(10.);
 		double threshold(0.5);
 		double stepwidth(1.0);
@@ -74,6 +150,24 @@ int main(int argc, char* argv[]){
 		double prestrainFactorY(1.0);
 		double prestrainFactorZ(1.0);
 		
+		std::string checkpointFile("");
+		uint32_t checkpointInterval(1000);
+		std::string restartFile("");
+		uint32_t referenceSegments(0);
+		std::string feCurvePattern("");
+		std::string sweep("");
+		std::string outputSweep("StressStrain.dat");
+		std::string linearResponse("");
+		std::string outputLinearResponse("LinearResponse.dat");
+		std::string outputStress("");
+		std::string outputBinary("");
+		bool compressBinary(false);
+		uint32_t asyncOutput(0);
+		bool prune(false);
+		std::string outputFluctuation("");
+		uint32_t fluctuationProbes(64);
+		std::string report("");
+		
 		bool showHelp = false;
 		auto parser
 			= clara::detail::Opt(            inputBFM, "inputBFM (=inconfig.bfm)"                        ) ["-i"]["--input"            ] ("(required)Input filename of the bfm file"                                    ).required()
@@ -85,11 +179,29 @@ int main(int argc, char* argv[]){
 			| clara::detail::Opt(           threshold, "threshold"                                       ) ["-t"]["--threshold"        ] ("(optional) Threshold of the average shift. Default 0.5 ."                    ).optional()
             | clara::detail::Opt(   stretching_factor, "stretching_factor (=1)"                          ) ["-l"]["--stretching_factor"] ("(optional) Stretching factor for uniaxial deformation. Default 1.0 ."        ).optional()
 			| clara::detail::Opt(             feCurve, "feCurve (="")"                                   ) ["-f"]["--feCurve"          ] ("(optional) Force-Extension curve. Default \"\"."                             ).optional()
+			| clara::detail::Opt(               model, "model (=gauss)"                                  ) ["-m"]["--model"            ] ("(optional) Analytic force-extension relation: gauss, fene, langevin or wlc, not together with -f. Default gauss.").optional()
 			| clara::detail::Opt( relaxationParameter, "relaxationParameter (=10)"                       ) ["-r"]["--relax"            ] ("(optional) Relaxation parameter. Default 10.0 ."                             ).optional()
             | clara::detail::Opt(       dampingfactor, "damping (=1)"                                    ) ["-d"]["--damping"          ] ("(optional) Damping factor after 1E3MCS. Default 1.0."                        ).optional()
 			| clara::detail::Opt(    prestrainFactorX, "prestrainFactorX (=1)"                           ) ["-x"]["--prestrainFactorX" ] ("(optional) Prestrain factor in X. Default 1.0."                              ).optional()
 			| clara::detail::Opt(    prestrainFactorY, "prestrainFactorY (=1)"                           ) ["-y"]["--prestrainFactorY" ] ("(optional) Prestrain factor in Y. Default 1.0."                              ).optional()
 			| clara::detail::Opt(    prestrainFactorZ, "prestrainFactorZ (=1)"                           ) ["-z"]["--prestrainFactorZ" ] ("(optional) Prestrain factor in Z. Default 1.0."                              ).optional()
+			| clara::detail::Opt(      checkpointFile, "checkpointFile (="")"                            )        ["--checkpoint"        ] ("(optional) Filename for binary checkpoints of the equilibration. Default \"\"."  ).optional()
+			| clara::detail::Opt(  checkpointInterval, "checkpointInterval (=1000)"                      )        ["--checkpointInterval"] ("(optional) MCS in between two checkpoints. Default 1000."                   ).optional()
+			| clara::detail::Opt(         restartFile, "restartFile (="")"                               )        ["--restart"           ] ("(optional) Continue the equilibration from this checkpoint. Default \"\"."    ).optional()
+			| clara::detail::Opt(   referenceSegments, "referenceSegments (=0)"                          )        ["--referenceSegments" ] ("(optional) Segments of the strands of feCurve, scales the curve to other segment counts. Default 0 (no scaling).").optional()
+			| clara::detail::Opt(      feCurvePattern, "feCurvePattern (="")"                            )        ["--feCurvePattern"    ] ("(optional) Force-Extension curves per segment count, {N} is replaced by the count. Default \"\".").optional()
+			| clara::detail::Opt(               sweep, "sweep (="")"                                     )        ["--sweep"             ] ("(optional) Comma separated stretching factors of a strain sweep, replaces -l. Default \"\".").optional()
+			| clara::detail::Opt(         outputSweep, "outputSweep (=StressStrain.dat)"                 )        ["--outputSweep"       ] ("(optional) Output filename of the stress and modulus of the sweep.").optional()
+			| clara::detail::Opt(      linearResponse, "linearResponse (="")"                            )        ["--linearResponse"    ] ("(optional) Comma separated deformations (uniaxial:l, biaxial:l, shear:g, prestrain:px:py:pz) evaluated by linear response of a gaussian network. Default \"\".").optional()
+			| clara::detail::Opt(outputLinearResponse, "outputLinearResponse (=LinearResponse.dat)"       )        ["--outputLinearResponse"] ("(optional) Output filename of the stress and modulus of the linear response.").optional()
+			| clara::detail::Opt(        outputStress, "outputStress (="")"                              )        ["--outputStress"      ] ("(optional) Output filename of the summary of stress, effective strands and phantom modulus. Default \"\" (no summary).").optional()
+			| clara::detail::Opt(        outputBinary, "outputBinary (="")"                              )        ["--outputBinary"      ] ("(optional) One binary file for positions and strands of all conversions instead of -o and -c. Default \"\".").optional()
+			| clara::detail::Opt(      compressBinary, "compressBinary (=false)"                         )        ["--compressBinary"    ] ("(optional) Compress the binary output with zlib. Default false.").optional()
+			| clara::detail::Opt(         asyncOutput, "asyncOutput (=0)"                                )        ["--asyncOutput"       ] ("(optional) Number of conversions queued for writing the ASCII output in the background. Default 0 (synchronous).").optional()
+			| clara::detail::Opt(               prune, "prune (=false)"                                  )        ["--prune"             ] ("(optional) Equilibrate only the elastically active backbone, dangling and sol crosslinks are placed force free afterwards. Default false.").optional()
+			| clara::detail::Opt(   outputFluctuation, "outputFluctuation (="")"                         )        ["--outputFluctuation" ] ("(optional) Basename of the tables of the crosslink and strand fluctuations of the phantom network. Default \"\" (no fluctuations).").optional()
+			| clara::detail::Opt(   fluctuationProbes, "fluctuationProbes (=64)"                         )        ["--fluctuationProbes" ] ("(optional) Number of random probes of the fluctuation estimate. Default 64.").optional()
+			| clara::detail::Opt(              report, "report (="")"                                    )        ["--report"            ] ("(optional) Output filename of the JSON report of timings, counters and memory (needs LEMONADE_PM_INSTRUMENTATION). Default \"\".").optional()
 			| clara::Help( showHelp );
 		
 	    auto result = parser.parse( clara::Args( argc, argv ) );
@@ -97,6 +209,15 @@ int main(int argc, char* argv[]){
 	    if( !result ) {
 	      std::cerr << "Error in command line: " << result.errorMessage() << std::endl;
 	      exit(1);
+	    }else if( model!="gauss" && model!="fene" && model!="langevin" && model!="wlc" ){
+	      std::cerr << "Error in command line: unknown model " << model << std::endl;
+	      exit(1);
+	    }else if( custom && model!="gauss" ){
+	      std::cerr << "Error in command line: the model " << model << " and the force-extension curve " << feCurve << " exclude each other" << std::endl;
+	      exit(1);
+	    }else if( !linearResponse.empty() && ( custom || model!="gauss" || !sweep.empty() ) ){
+	      std::cerr << "Error in command line: the linear response needs the gaussian relation and no sweep" << std::endl;
+	      exit(1);
 	    }else if(showHelp == true){
 	      std::cout << "Standard force equilibration for a end-linked network."<< std::endl;
 	      parser.writeToStream(std::cout);
@@ -110,7 +231,25 @@ int main(int argc, char* argv[]){
           std::cout << "dampingfactor         : " << dampingfactor          << std::endl;
 	      std::cout << "minConversion         : " << minConversion          << std::endl;
 	      std::cout << "threshold             : " << threshold              << std::endl; 
+	      std::cout << "checkpointFile        : " << checkpointFile         << std::endl;
+	      std::cout << "checkpointInterval    : " << checkpointInterval     << std::endl;
+	      std::cout << "restartFile           : " << restartFile            << std::endl;
 		  std::cout << "feCurve               : " << feCurve                << std::endl;
+		  std::cout << "referenceSegments     : " << referenceSegments      << std::endl;
+		  std::cout << "feCurvePattern        : " << feCurvePattern         << std::endl;
+		  std::cout << "model                 : " << model                  << std::endl;
+		  std::cout << "sweep                 : " << sweep                  << std::endl;
+		  std::cout << "outputSweep           : " << outputSweep            << std::endl;
+		  std::cout << "linearResponse        : " << linearResponse         << std::endl;
+		  std::cout << "outputLinearResponse  : " << outputLinearResponse   << std::endl;
+		  std::cout << "outputStress          : " << outputStress           << std::endl;
+		  std::cout << "outputBinary          : " << outputBinary           << std::endl;
+		  std::cout << "compressBinary        : " << compressBinary         << std::endl;
+		  std::cout << "asyncOutput           : " << asyncOutput            << std::endl;
+		  std::cout << "prune                 : " << prune                  << std::endl;
+		  std::cout << "outputFluctuation     : " << outputFluctuation      << std::endl;
+		  std::cout << "fluctuationProbes     : " << fluctuationProbes      << std::endl;
+		  std::cout << "report                : " << report                 << std::endl;
           std::cout << "stretching_factor     : " << stretching_factor      << std::endl;
 		  std::cout << "prestrainFactorX      : " << prestrainFactorX       << std::endl;
 		  std::cout << "prestrainFactorY      : " << prestrainFactorY       << std::endl;
@@ -119,78 +258,158 @@ int main(int argc, char* argv[]){
 		
 		
 
+		if( !report.empty() ){
+#ifndef LEMONADE_PM_INSTRUMENTATION
+			std::cout << "Warning: no report is written, compile with LEMONADE_PM_INSTRUMENTATION" << std::endl;
+#endif
+			LEMONADE_PM_REPORT(report);
+		}
 		RandomNumberGenerators rng;
 		rng.seedAll();
 		///////////////////////////////////////////////////////////////////////////////
 		///end options parsing
 		///////////////////////////////////////////////////////////////////////////////
-		//Read in th last Config 
-		typedef LOKI_TYPELIST_3(FeatureMoleculesIOUnsaveCheck, FeatureSystemInformationLinearMeltWithCrosslinker, FeatureReactiveBonds) Features;
-		typedef ConfigureSystem<VectorInt3,Features, 7> Config;
-		typedef Ingredients<Config> Ing;
-		Ing myIngredients;
-		
-		TaskManager taskmanager;
-		
-		taskmanager.addUpdater( new UpdaterReadBfmFile<Ing>(inputBFM,myIngredients, UpdaterReadBfmFile<Ing>::READ_LAST_CONFIG_SAVE),0);
-
-		//initialize and run
-		taskmanager.initialize();
-		taskmanager.run(1);
-		taskmanager.cleanup();
-		std::cout << "Read in conformation and go on to bring it into equilibrium forces..." <<std::endl;
 		//the foce equilibrium is reached off lattice ( no integer values for the positions )
 		typedef LOKI_TYPELIST_3(FeatureBox, FeatureCrosslinkConnectionsLookUp ,FeatureSystemInformationLinearMeltWithCrosslinker) Features2;
 		typedef ConfigureSystem<VectorDouble3,Features2, 7> Config2;
 		typedef Ingredients<Config2> Ing2;
 		Ing2 myIngredients2;
-		
-		myIngredients2.setBoxX(myIngredients.getBoxX());
-		myIngredients2.setBoxY(myIngredients.getBoxY());
-		myIngredients2.setBoxZ(myIngredients.getBoxZ());
-		myIngredients2.setPeriodicX(myIngredients.isPeriodicX());
-		myIngredients2.setPeriodicY(myIngredients.isPeriodicY());
-		myIngredients2.setPeriodicZ(myIngredients.isPeriodicZ());
-		myIngredients2.modifyMolecules().resize(myIngredients.getMolecules().size());
-		myIngredients2.modifyMolecules().setAge(myIngredients.getMolecules().getAge());
-		myIngredients2.setNumOfChains              (myIngredients.getNumOfChains());
-		myIngredients2.setNumOfCrosslinks          (myIngredients.getNumOfCrosslinks());
-		myIngredients2.setNumOfMonomersPerChain    (myIngredients.getNumOfMonomersPerChain());
-		myIngredients2.setNumOfMonomersPerCrosslink(myIngredients.getNumOfMonomersPerCrosslink());
-		myIngredients2.setFunctionality            (myIngredients.getFunctionality());
-		
-		for(size_t i = 0; i< myIngredients.getMolecules().size();i++){
-			myIngredients2.modifyMolecules()[i].modifyVector3D()=myIngredients.getMolecules()[i].getVector3D();
-			myIngredients2.modifyMolecules()[i].setReactive(myIngredients.getMolecules()[i].isReactive());
-			myIngredients2.modifyMolecules()[i].setNumMaxLinks(myIngredients.getMolecules()[i].getNumMaxLinks());
-			for (size_t j = 0 ; j < myIngredients.getMolecules().getNumLinks(i);j++){
-				uint32_t neighbor(myIngredients.getMolecules().getNeighborIdx(i,j));
-				if( ! myIngredients2.getMolecules().areConnected(i,neighbor) )
-					myIngredients2.modifyMolecules().connect(i,neighbor);
+		{
+			//Read in th last Config 
+			typedef LOKI_TYPELIST_3(FeatureMoleculesIOUnsaveCheck, FeatureSystemInformationLinearMeltWithCrosslinker, FeatureReactiveBonds) Features;
+			typedef ConfigureSystem<VectorInt3,Features, 7> Config;
+			typedef Ingredients<Config> Ing;
+			Ing myIngredients;
+			
+			TaskManager taskmanager;
+			
+			taskmanager.addUpdater( new UpdaterReadBfmFile<Ing>(inputBFM,myIngredients, UpdaterReadBfmFile<Ing>::READ_LAST_CONFIG_SAVE),0);
+
+			//initialize and run
+			{
+				LEMONADE_PM_PHASE("readBFM");
+				taskmanager.initialize();
+				taskmanager.run(1);
+				taskmanager.cleanup();
 			}
-		}
+			std::cout << "Read in conformation and go on to bring it into equilibrium forces..." <<std::endl;
+			
+			IngredientsConversion::copy(myIngredients,myIngredients2);
+			myIngredients2.setNumOfChains              (myIngredients.getNumOfChains());
+			myIngredients2.setNumOfCrosslinks          (myIngredients.getNumOfCrosslinks());
+			myIngredients2.setNumOfMonomersPerChain    (myIngredients.getNumOfMonomersPerChain());
+			myIngredients2.setNumOfMonomersPerCrosslink(myIngredients.getNumOfMonomersPerCrosslink());
+			myIngredients2.setFunctionality            (myIngredients.getFunctionality());
+		}//the lattice system is released here
 		myIngredients2.synchronize();
 		
         auto forceUpdater = new UpdaterForceBalancedPosition<Ing2,MoveNonLinearForceEquilibrium>(myIngredients2, threshold,dampingfactor);
         if(custom)
             forceUpdater->setFilename(feCurve);
         forceUpdater->setRelaxationParameter(relaxationParameter);	
+        forceUpdater->setReferenceSegments(referenceSegments);
+        forceUpdater->setSegmentFilenamePattern(feCurvePattern);
         auto forceUpdater2 = new UpdaterForceBalancedPosition<Ing2,MoveForceEquilibrium>(myIngredients2, threshold,dampingfactor);
+        //crosslinks with two strands are collapsed for the gaussian relation only
+        forceUpdater->setPruning(prune);
+        forceUpdater2->setPruning(prune,true);
+        if( !checkpointFile.empty() ){
+            forceUpdater->setCheckpoint(checkpointFile,checkpointInterval);
+            forceUpdater2->setCheckpoint(checkpointFile,checkpointInterval);
+        }
+        if( !restartFile.empty() ){
+            forceUpdater->setRestart(restartFile);
+            forceUpdater2->setRestart(restartFile);
+        }
+        AbstractUpdater* analyticUpdater(NULL);
+        if(model=="fene")
+            analyticUpdater=createAnalyticForceUpdater<Ing2,FENEForcePolicy>(myIngredients2,threshold,dampingfactor,checkpointFile,checkpointInterval,restartFile,prune);
+        else if(model=="langevin")
+            analyticUpdater=createAnalyticForceUpdater<Ing2,InverseLangevinForcePolicy>(myIngredients2,threshold,dampingfactor,checkpointFile,checkpointInterval,restartFile,prune);
+        else if(model=="wlc")
+            analyticUpdater=createAnalyticForceUpdater<Ing2,WormLikeChainForcePolicy>(myIngredients2,threshold,dampingfactor,checkpointFile,checkpointInterval,restartFile,prune);
+        //the affine deformation does not change the box, the stress needs the volume of the prestrained system
+        const VectorDouble3 prestrain(prestrainFactorX,prestrainFactorY,prestrainFactorZ);
+        AbstractUpdater* sweepUpdater(NULL);
+        if( !sweep.empty() ){
+            std::vector<double> lambdas(parseStretchingFactors(sweep));
+            if(custom){
+                auto customSweep=createStrainSweep<Ing2,MoveNonLinearForceEquilibrium>(myIngredients2,lambdas,threshold,dampingfactor,outputSweep,checkpointFile,checkpointInterval,restartFile,prune,prestrain);
+                customSweep->getForceUpdater().setFilename(feCurve);
+                customSweep->getForceUpdater().setRelaxationParameter(relaxationParameter);
+                customSweep->getForceUpdater().setReferenceSegments(referenceSegments);
+                customSweep->getForceUpdater().setSegmentFilenamePattern(feCurvePattern);
+                sweepUpdater=customSweep;
+            }else if(model=="fene")
+                sweepUpdater=createStrainSweep<Ing2,MoveAnalyticForceEquilibrium<FENEForcePolicy> >(myIngredients2,lambdas,threshold,dampingfactor,outputSweep,checkpointFile,checkpointInterval,restartFile,prune,prestrain);
+            else if(model=="langevin")
+                sweepUpdater=createStrainSweep<Ing2,MoveAnalyticForceEquilibrium<InverseLangevinForcePolicy> >(myIngredients2,lambdas,threshold,dampingfactor,outputSweep,checkpointFile,checkpointInterval,restartFile,prune,prestrain);
+            else if(model=="wlc")
+                sweepUpdater=createStrainSweep<Ing2,MoveAnalyticForceEquilibrium<WormLikeChainForcePolicy> >(myIngredients2,lambdas,threshold,dampingfactor,outputSweep,checkpointFile,checkpointInterval,restartFile,prune,prestrain);
+            else
+                sweepUpdater=createStrainSweep<Ing2,MoveForceEquilibrium>(myIngredients2,lambdas,threshold,dampingfactor,outputSweep,checkpointFile,checkpointInterval,restartFile,prune,prestrain);
+            //the sweep does the stretching, only the prestrain is applied in advance
+            stretching_factor=1.0;
+        }
+        AbstractUpdater* linearResponseUpdater(NULL);
+        if( !linearResponse.empty() ){
+            auto response = new UpdaterLinearResponse<Ing2>(myIngredients2, parseDeformations(linearResponse), threshold, outputLinearResponse);
+            response->setPrestrain(prestrain.getX(),prestrain.getY(),prestrain.getZ());
+            if( !checkpointFile.empty() )
+                response->getForceUpdater().setCheckpoint(checkpointFile,checkpointInterval);
+            if( !restartFile.empty() )
+                response->getForceUpdater().setRestart(restartFile);
+            response->getForceUpdater().setPruning(prune,true);
+            linearResponseUpdater=response;
+            //the deformations are applied by the linear response, only the prestrain is applied in advance
+            stretching_factor=1.0;
+        }
         auto uniaxialDeformation = new UpdaterAffineDeformation<Ing2>(myIngredients2, stretching_factor,prestrainFactorX,prestrainFactorY,prestrainFactorZ);
     
         auto analyzer = new AnalyzerEquilbratedPosition<Ing2>(myIngredients2,outputDataPos,outputDataDist);
+        if( !outputBinary.empty() )
+            analyzer->setBinaryOutput(outputBinary,compressBinary);
+        analyzer->setAsyncOutput(asyncOutput);
+        //the custom curves are tables of the move, the summary uses the gaussian stress for them
+        AbstractAnalyzer* stressAnalyzer(NULL);
+        if( !outputStress.empty() ){
+            if(model=="fene" && !custom)
+                stressAnalyzer = createStressAnalyzer<Ing2,FENEForcePolicy>(myIngredients2,outputStress,prestrain);
+            else if(model=="langevin" && !custom)
+                stressAnalyzer = createStressAnalyzer<Ing2,InverseLangevinForcePolicy>(myIngredients2,outputStress,prestrain);
+            else if(model=="wlc" && !custom)
+                stressAnalyzer = createStressAnalyzer<Ing2,WormLikeChainForcePolicy>(myIngredients2,outputStress,prestrain);
+            else
+                stressAnalyzer = createStressAnalyzer<Ing2,GaussianForcePolicy>(myIngredients2,outputStress,prestrain);
+        }
+        AbstractAnalyzer* fluctuationAnalyzer(NULL);
+        if( !outputFluctuation.empty() )
+            fluctuationAnalyzer = new AnalyzerCrosslinkFluctuation<Ing2>(myIngredients2,"Crosslink"+outputFluctuation,"Strand"+outputFluctuation,fluctuationProbes);
 		
         TaskManager taskmanager2;
         taskmanager2.addUpdater( uniaxialDeformation,0 );
         //read bonds and positions stepwise
-        if(custom){
+        if(linearResponseUpdater!=NULL){
+            std::cout << "Use linear response for " << linearResponse << "\n";
+            taskmanager2.addUpdater( linearResponseUpdater );
+        }else if(sweepUpdater!=NULL){
+            std::cout << "Use strain sweep over " << sweep << "\n";
+            taskmanager2.addUpdater( sweepUpdater );
+        }else if(custom){
             std::cout << "Use custom force-extension curve\n";
             taskmanager2.addUpdater( forceUpdater );
+        }else if(analyticUpdater!=NULL){
+            std::cout << "Use analytic force-extension relation " << model << "\n";
+            taskmanager2.addUpdater( analyticUpdater );
         }else{
             std::cout << "Use gaussian force-extension relation\n";
             taskmanager2.addUpdater( forceUpdater2 );
         }
         taskmanager2.addAnalyzer(analyzer);
+        if(stressAnalyzer!=NULL)
+            taskmanager2.addAnalyzer(stressAnalyzer);
+        if(fluctuationAnalyzer!=NULL)
+            taskmanager2.addAnalyzer(fluctuationAnalyzer);
         //initialize and run
 		taskmanager2.initialize();
 		taskmanager2.run(1);
@@ -0,0 +1,110 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+/****************************************************************************** 
+ * based on LeMonADE: https://github.com/LeMonADE-project/LeMonADE/
+ * author: Toni Müller
+ * email: mueller-toni@ipfdd.de
+ * project: LeMonADE-Phantom Modulus
+ *****************************************************************************/
+#include <iostream>
+#include <vector>
+
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/updater/UpdaterReadBfmFile.h>
+#include <LeMonADE/feature/FeatureMoleculesIOUnsaveCheck.h>
+#include <LeMonADE/feature/FeatureReactiveBonds.h>
+#include <LeMonADE/feature/FeatureSystemInformationLinearMeltWithCrosslinker.h>
+#include <LeMonADE/utility/TaskManager.h>
+
+#include <extern/catchorg/clara/clara.hpp>
+
+#include <LeMonADE_PM/updater/UpdaterGelationCurve.h>
+
+
+int main(int argc, char* argv[]){
+	try{
+		///////////////////////////////////////////////////////////////////////////////
+		///parse options///
+		std::string inputBFM("init.bfm");
+		std::string inputConnection("BondCreationBreaking.dat");
+		std::string output("GelationCurve.dat");
+		double stepwidth(0.0);
+		bool showHelp = false;
+		auto parser
+			= clara::detail::Opt(        inputBFM, "inputBFM (=inconfig.bfm)"                    ) ["-i"]["--input"          ] ("(required)Input filename of the bfm file with the final network").required()
+			| clara::detail::Opt( inputConnection, "inputConnection (=BondCreationBreaking.dat)" ) ["-d"]["--inputConnection"] ("(optional) Connection history of the network."                    ).optional()
+			| clara::detail::Opt(          output, "output (=GelationCurve.dat)"                 ) ["-o"]["--output"         ] ("(optional) Output filename of the gelation curve."                 ).optional()
+			| clara::detail::Opt(       stepwidth, "stepwidth (=0)"                              ) ["-s"]["--stepwidth"      ] ("(optional) Width of the conversion bins. Default 0 (every reaction).").optional()
+			| clara::Help( showHelp );
+		
+	    auto result = parser.parse( clara::Args( argc, argv ) );
+	    
+	    if( !result ) {
+	      std::cerr << "Error in command line: " << result.errorMessage() << std::endl;
+	      exit(1);
+	    }else if(showHelp == true){
+	      std::cout << "Molecular weight and gel fraction versus conversion from the connection history."<< std::endl;
+	      parser.writeToStream(std::cout);
+	      exit(0);
+	    }else{
+	      std::cout << "inputBFM        : " << inputBFM        << std::endl;
+	      std::cout << "inputConnection : " << inputConnection << std::endl;
+	      std::cout << "output          : " << output          << std::endl;
+	      std::cout << "stepwidth       : " << stepwidth       << std::endl;
+	    }
+		///////////////////////////////////////////////////////////////////////////////
+		///end options parsing
+		///////////////////////////////////////////////////////////////////////////////
+		typedef LOKI_TYPELIST_3(FeatureMoleculesIOUnsaveCheck, FeatureSystemInformationLinearMeltWithCrosslinker, FeatureReactiveBonds) Features;
+		typedef ConfigureSystem<VectorInt3,Features, 7> Config;
+		typedef Ingredients<Config> Ing;
+		Ing ingredients;
+		{
+			TaskManager taskmanager;
+			taskmanager.addUpdater( new UpdaterReadBfmFile<Ing>(inputBFM,ingredients, UpdaterReadBfmFile<Ing>::READ_LAST_CONFIG_SAVE),0);
+			taskmanager.initialize();
+			taskmanager.run(1);
+			taskmanager.cleanup();
+		}
+		//the connection history is replayed once 
+		TaskManager taskmanager;
+		taskmanager.addUpdater( new UpdaterGelationCurve<Ing>(ingredients, inputConnection, output, stepwidth) );
+		taskmanager.initialize();
+		taskmanager.run(1);
+		taskmanager.cleanup();
+	}
+	catch(std::exception& e){
+		std::cerr<<"Error:\n"
+		<<e.what()<<std::endl;
+	}
+	catch(...){
+		std::cerr<<"Error: unknown exception\n";
+	}
+	
+	return 0;
+}
@@ -56,15 +56,95 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE_PM/feature/FeatureCrosslinkConnectionsLookUpIdealDoubleStarReference.h>
 #include <LeMonADE_PM/analyzer/AnalyzerEquilbratedPosition.h>
 #include <LeMonADE_PM/updater/UpdaterAffineDeformation.h>
+#include <LeMonADE_PM/utility/IngredientsConversion.h>
 #include <LeMonADE_PM/updater/UpdaterAddTMDoubleStars.h>
+#include <LeMonADE_PM/utility/ReferenceEnsemble.h>
+#include <LeMonADE_PM/utility/PhantomReferenceBuilder.h>
+#include <LeMonADE_PM/utility/DiscreteDistribution.h>
+
+//the double star is created on the lattice with excluded volume
+typedef LOKI_TYPELIST_2(FeatureFixedMonomers,FeatureMoleculesIO) LatticeFeatures;
+typedef ConfigureSystem<VectorInt3,LatticeFeatures, 7> LatticeConfig;
+typedef Ingredients<LatticeConfig> LatticeIng;
+
+/**
+ * creates the double star on the lattice and copies it into the off-lattice ingredients
+ * an empty configFile skips the output, an empty segmentDistribution is filled by the 
+ * updater and reused by the following calls
+ */
+template<class Ing2>
+void createDoubleStar(Ing2& myIngredients2, uint32_t nSegments, uint32_t nRings, uint32_t functionality, 
+                      const std::string& configFile, DiscreteDistribution& segmentDistribution){
+	typedef LatticeIng Ing;
+	Ing myIngredients;
+	myIngredients.setBoxX(256);
+	myIngredients.setBoxY(256);
+	myIngredients.setBoxZ(256);
+	myIngredients.setPeriodicX(1);
+	myIngredients.setPeriodicY(1);
+	myIngredients.setPeriodicZ(1);
+	myIngredients.modifyBondset().addBFMclassicBondset();
+	myIngredients.synchronize();
+	TaskManager taskmanager;
+	auto doubleStars = new UpdaterAddTMDoubleStars<Ing>(myIngredients,1, nSegments, nRings, functionality );
+	if( !segmentDistribution.empty() )
+		doubleStars->setSegmentDistribution(segmentDistribution);
+	taskmanager.addUpdater( doubleStars,0);
+	if( !configFile.empty() )
+		taskmanager.addAnalyzer(new AnalyzerWriteBfmFile<Ing>(configFile, myIngredients, AnalyzerWriteBfmFile<Ing>::APPEND) );
+	taskmanager.initialize();
+	if( segmentDistribution.empty() )
+		segmentDistribution=doubleStars->getSegmentDistribution();
+	taskmanager.run(1);
+	taskmanager.cleanup();
+
+	std::cout << "Read in conformation and go on to bring it into equilibrium forces..." <<std::endl;
+
+	IngredientsConversion::copy(myIngredients,myIngredients2);
+}
+
+/**
+ * creates the phantom double star directly in the off-lattice ingredients with the random numbers of rng
+ * the lengths of the main chain and the branches are drawn from segmentDistribution as in UpdaterAddTMDoubleStars
+ */
+template<class Ing2>
+void createPhantomDoubleStar(Ing2& myIngredients2, uint32_t functionality, const DiscreteDistribution& segmentDistribution, 
+                             const PhantomReferenceBuilder& phantomBuilder, std::mt19937& rng){
+	myIngredients2.setBoxX(256);
+	myIngredients2.setBoxY(256);
+	myIngredients2.setBoxZ(256);
+	myIngredients2.setPeriodicX(1);
+	myIngredients2.setPeriodicY(1);
+	myIngredients2.setPeriodicZ(1);
+	const uint32_t mainChainLength(segmentDistribution(rng));
+	std::vector<uint32_t> branchLengths(2*(functionality-1));
+	for (size_t j=0; j < branchLengths.size(); j++)
+		branchLengths[j]=segmentDistribution(rng)+1;
+	phantomBuilder.addTMDoubleStar(myIngredients2, mainChainLength, branchLengths, rng);
+}
+
+//! equilibrates nEnsemble double stars in batches of nLanes (0: one updater each) on nThreads threads and writes the distribution of the strand length
+template<class Ing2, class MoveType>
+void runEnsemble(typename ReferenceEnsemble<Ing2,MoveType>::Builder builder, const MoveType& move, double threshold, double factor,
+                 double stretching_factor, uint32_t nEnsemble, uint32_t nLanes, uint32_t nThreads, uint64_t seed, const std::string& outputEnsemble){
+	ReferenceEnsemble<Ing2,MoveType> ensemble(builder, move, threshold, factor);
+	ensemble.setStretchingFactor(stretching_factor);
+	ensemble.setNumLanes(nLanes);
+	ensemble.setNumThreads(nThreads);
+	ensemble.run(nEnsemble, seed);
+	ensemble.write(outputEnsemble);
+}
 
 int main(int argc, char* argv[]){
 	try{
 		///////////////////////////////////////////////////////////////////////////////
 		///parse options///
 		// std::string inputBFM("init.bfm");
-		std::string outputDataPos("CrosslinkPosition.dat");
-		std::string outputDataDist("ChainExtensionDistribution.dat");
+		//the outputs of a single realization, the ensemble writes only outputEnsemble
+		const std::string defaultDataPos("CrosslinkPosition.dat");
+		const std::string defaultDataDist("ChainExtensionDistribution.dat");
+		std::string outputDataPos(defaultDataPos);
+		std::string outputDataDist(defaultDataDist);
 		std::string feCurve("");
 		double relaxationParameter(10.);
 		double threshold(0.5);
@@ -76,6 +156,12 @@ int main(int argc, char* argv[]){
         uint32_t functionality(4);
 		uint32_t nRings(0);
 
+		uint32_t nEnsemble(0);
+		uint32_t nLanes(0);
+		uint32_t nThreads(0);
+		uint64_t seed(0);
+		std::string outputEnsemble("EnsembleDistanceDistribution.dat");
+		
 		bool showHelp = false;
 		auto parser
 			// = clara::detail::Opt(            inputBFM, "inputBFM (=inconfig.bfm)"                        ) ["-i"]["--input"            ] ("(required)Input filename of the bfm file"                                    ).required()
@@ -89,6 +175,11 @@ int main(int argc, char* argv[]){
             | clara::detail::Opt(           nSegments, "nSegments"                                       ) ["-n"]["--nSegments"        ] ("(optional) Number of segments for the strand."                               ).optional()
             | clara::detail::Opt(       functionality, "nStrands"                                        ) ["-s"]["--nStrands"         ] ("(optional) Functionality."                                                   ).optional()
             | clara::detail::Opt(              nRings, "nRings"                                          ) ["-m"]["--nRings"           ] ("(optional) number of rings."                                                   ).optional()
+			| clara::detail::Opt(           nEnsemble, "nEnsemble (=0)"                                  )        ["--ensemble"          ] ("(optional) Number of independent double stars equilibrated in one run, 0 for a single one. Default 0.").optional()
+			| clara::detail::Opt(              nLanes, "nLanes (=0)"                                     )        ["--lanes"             ] ("(optional) Equilibrate the ensemble in SIMD lanes of this many realizations, 0 uses one updater per realization. Default 0.").optional()
+			| clara::detail::Opt(            nThreads, "nThreads (=0)"                                   )        ["--threads"           ] ("(optional) Threads for the ensemble, 0 uses all hardware threads. Default 0."    ).optional()
+			| clara::detail::Opt(                seed, "seed (=0)"                                       )        ["--seed"              ] ("(optional) Seed of the random number streams of the ensemble. Default 0."       ).optional()
+			| clara::detail::Opt(      outputEnsemble, "outputEnsemble (=EnsembleDistanceDistribution.dat)")      ["--outputEnsemble"    ] ("(optional) Output filename of the strand length distribution of the ensemble."  ).optional()
 			| clara::Help( showHelp );
 		
 	    auto result = parser.parse( clara::Args( argc, argv ) );
@@ -96,6 +187,9 @@ int main(int argc, char* argv[]){
 	    if( !result ) {
 	      std::cerr << "Error in command line: " << result.errorMessage() << std::endl;
 	      exit(1);
+	    }else if( nEnsemble > 0 && ( outputDataPos != defaultDataPos || outputDataDist != defaultDataDist ) ){
+	      std::cerr << "Error in command line: the ensemble writes only --outputEnsemble, -o and -c belong to a single realization" << std::endl;
+	      exit(1);
 	    }else if(showHelp == true){
 	      std::cout << "Force equilibration of two a double star, where each chain is replaced effectively by a tendomer."<< std::endl;
 	      parser.writeToStream(std::cout);
@@ -110,6 +204,11 @@ int main(int argc, char* argv[]){
           std::cout << "nSegments             : " << nSegments              << std::endl;
           std::cout << "functionality         : " << functionality          << std::endl;
           std::cout << "nRings                : " << nRings          << std::endl;
+          std::cout << "nEnsemble             : " << nEnsemble              << std::endl;
+          std::cout << "nLanes                : " << nLanes                 << std::endl;
+          std::cout << "nThreads              : " << nThreads               << std::endl;
+          std::cout << "seed                  : " << seed                   << std::endl;
+          std::cout << "outputEnsemble        : " << outputEnsemble         << std::endl;
 	    }
 		RandomNumberGenerators rng;
 		// rng.seedDefaultValuesAll();
@@ -117,52 +216,32 @@ int main(int argc, char* argv[]){
 		///////////////////////////////////////////////////////////////////////////////
 		///end options parsing
 		///////////////////////////////////////////////////////////////////////////////
-		//Read in th last Config 
-		typedef LOKI_TYPELIST_2(FeatureFixedMonomers,FeatureMoleculesIO) Features;
-		typedef ConfigureSystem<VectorInt3,Features, 7> Config;
-		typedef Ingredients<Config> Ing;
-		Ing myIngredients;
-        myIngredients.setBoxX(256);
-		myIngredients.setBoxY(256);
-		myIngredients.setBoxZ(256);
-		myIngredients.setPeriodicX(1);
-		myIngredients.setPeriodicY(1);
-		myIngredients.setPeriodicZ(1);
-        myIngredients.modifyBondset().addBFMclassicBondset();
-        myIngredients.synchronize();
-		TaskManager taskmanager;
-		taskmanager.addUpdater( new UpdaterAddTMDoubleStars<Ing>(myIngredients,1, nSegments, nRings, functionality ),0);
-        taskmanager.addAnalyzer(new AnalyzerWriteBfmFile<Ing>("config.bfm", myIngredients, AnalyzerWriteBfmFile<Ing>::APPEND) );
-		taskmanager.initialize();
-		taskmanager.run(1);
-		taskmanager.cleanup();
-       
-		std::cout << "Read in conformation and go on to bring it into equilibrium forces..." <<std::endl;
 		//the foce equilibrium is reached off lattice ( no integer values for the positions )
         typedef LOKI_TYPELIST_3(FeatureBox, FeatureCrosslinkConnectionsLookUpIdealDoubleStarReference ,FeatureFixedMonomers) Features2;
 		typedef ConfigureSystem<VectorDouble3,Features2, 7> Config2;
 		typedef Ingredients<Config2> Ing2;
-		Ing2 myIngredients2;
-		
-		myIngredients2.setBoxX(myIngredients.getBoxX());
-		myIngredients2.setBoxY(myIngredients.getBoxY());
-		myIngredients2.setBoxZ(myIngredients.getBoxZ());
-		myIngredients2.setPeriodicX(myIngredients.isPeriodicX());
-		myIngredients2.setPeriodicY(myIngredients.isPeriodicY());
-		myIngredients2.setPeriodicZ(myIngredients.isPeriodicZ());
-		myIngredients2.modifyMolecules().resize(myIngredients.getMolecules().size());
-		myIngredients2.modifyMolecules().setAge(myIngredients.getMolecules().getAge());
-		
-		for(size_t i = 0; i< myIngredients.getMolecules().size();i++){
-            myIngredients2.modifyMolecules()[i].setMovableTag(myIngredients.modifyMolecules()[i].getMovableTag());
-			myIngredients2.modifyMolecules()[i].modifyVector3D()=myIngredients.getMolecules()[i].getVector3D();
-			for (size_t j = 0 ; j < myIngredients.getMolecules().getNumLinks(i);j++){
-				uint32_t neighbor(myIngredients.getMolecules().getNeighborIdx(i,j));
-				if( ! myIngredients2.getMolecules().areConnected(i,neighbor) )
-					myIngredients2.modifyMolecules().connect(i,neighbor);
+		DiscreteDistribution segmentDistribution;
+
+		if( nEnsemble > 0 ){
+			//the phantom double stars use only the stream of the realization
+			segmentDistribution=UpdaterAddTMDoubleStars<LatticeIng>::calculateSegmentDistribution(nSegments, nRings);
+			PhantomReferenceBuilder phantomBuilder;
+			auto builder=[&](Ing2& ing, std::mt19937& rngRealization){
+				createPhantomDoubleStar(ing, functionality, segmentDistribution, phantomBuilder, rngRealization);
+			};
+			if ( gauss == 0 ){
+				MoveNonLinearForceEquilibrium move;
+				move.setFilename(feCurve);
+				move.setRelaxationParameter(relaxationParameter);
+				runEnsemble<Ing2,MoveNonLinearForceEquilibrium>(builder, move, threshold, 0.95, stretching_factor, nEnsemble, nLanes, nThreads, seed, outputEnsemble);
+			}else{
+				runEnsemble<Ing2,MoveForceEquilibrium>(builder, MoveForceEquilibrium(), threshold, 1.0, stretching_factor, nEnsemble, nLanes, nThreads, seed, outputEnsemble);
 			}
+			return 0;
 		}
-		
+
+		Ing2 myIngredients2;
+		createDoubleStar(myIngredients2, nSegments, nRings, functionality, "config.bfm", segmentDistribution);
 		myIngredients2.synchronize();
 
 		TaskManager taskmanager2;
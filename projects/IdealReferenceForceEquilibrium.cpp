@@ -34,6 +34,7 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <iostream>
 #include <vector>
 #include <bitset>
+#include <random>
 
 #include <LeMonADE/core/Ingredients.h>
 #include <LeMonADE/updater/UpdaterReadBfmFile.h>
@@ -56,19 +57,91 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE_PM/feature/FeatureCrosslinkConnectionsLookUpIdealReference.h>
 #include <LeMonADE_PM/analyzer/AnalyzerEquilbratedPosition.h>
 #include <LeMonADE_PM/updater/UpdaterAffineDeformation.h>
+#include <LeMonADE_PM/utility/IngredientsConversion.h>
 #include <LeMonADE_PM/updater/UpdaterAddStars.h>
+#include <LeMonADE_PM/updater/UpdaterAddTMDoubleStars.h>
+#include <LeMonADE_PM/utility/ReferenceEnsemble.h>
+#include <LeMonADE_PM/utility/PhantomReferenceBuilder.h>
+#include <LeMonADE_PM/utility/DiscreteDistribution.h>
 
 
-double prob_q(double n, double N, double m) {
-        return (m+1.)/(N-n-1.);
-    }
+//the star is created on the lattice
+typedef LOKI_TYPELIST_1(FeatureMoleculesIO) LatticeFeatures;
+typedef ConfigureSystem<VectorInt3,LatticeFeatures, 7> LatticeConfig;
+typedef Ingredients<LatticeConfig> LatticeIng;
+
+//! system information of the star used by the lookup of the crosslink connections
+template<class Ing2>
+void setStarInformation(Ing2& myIngredients2, uint32_t nSegments, uint32_t functionality){
+	myIngredients2.setNumOfChains              (functionality*1);
+	myIngredients2.setNumOfCrosslinks          (functionality+1);
+	myIngredients2.setNumOfMonomersPerChain    (2*nSegments);
+	myIngredients2.setNumOfMonomersPerCrosslink(1);
+	myIngredients2.setFunctionality            (functionality);
+}
+
+//! creates the star on the lattice and copies it into the off-lattice ingredients, an empty configFile skips the output
+template<class Ing2>
+void createStar(Ing2& myIngredients2, uint32_t nSegments, uint32_t functionality, const std::string& configFile){
+	typedef LatticeIng Ing;
+	Ing myIngredients;
+	myIngredients.setBoxX(256);
+	myIngredients.setBoxY(256);
+	myIngredients.setBoxZ(256);
+	myIngredients.setPeriodicX(1);
+	myIngredients.setPeriodicY(1);
+	myIngredients.setPeriodicZ(1);
+	myIngredients.modifyBondset().addBFMclassicBondset();
+	myIngredients.synchronize();
+	TaskManager taskmanager;
+	taskmanager.addUpdater( new UpdaterAddStars<Ing>(myIngredients,1, 2*nSegments+1 , functionality ),0);
+	if( !configFile.empty() )
+		taskmanager.addAnalyzer(new AnalyzerWriteBfmFile<Ing>(configFile, myIngredients, AnalyzerWriteBfmFile<Ing>::APPEND) );
+	taskmanager.initialize();
+	taskmanager.run(1);
+	taskmanager.cleanup();
+
+	std::cout << "Read in conformation and go on to bring it into equilibrium forces..." <<std::endl;
+
+	IngredientsConversion::copy(myIngredients,myIngredients2);
+	setStarInformation(myIngredients2, nSegments, functionality);
+}
+
+//! creates the phantom star directly in the off-lattice ingredients with the random numbers of rng
+template<class Ing2>
+void createPhantomStar(Ing2& myIngredients2, uint32_t nSegments, uint32_t functionality, const PhantomReferenceBuilder& phantomBuilder, std::mt19937& rng){
+	myIngredients2.setBoxX(256);
+	myIngredients2.setBoxY(256);
+	myIngredients2.setBoxZ(256);
+	myIngredients2.setPeriodicX(1);
+	myIngredients2.setPeriodicY(1);
+	myIngredients2.setPeriodicZ(1);
+	phantomBuilder.addStar(myIngredients2, 2*nSegments+1, functionality, rng);
+	setStarInformation(myIngredients2, nSegments, functionality);
+}
+
+//! equilibrates nEnsemble stars in batches of nLanes (0: one updater each) on nThreads threads and writes the distribution of the strand length
+template<class Ing2, class MoveType>
+void runEnsemble(typename ReferenceEnsemble<Ing2,MoveType>::Builder builder, const MoveType& move, double threshold, double factor,
+                 double stretching_factor, uint32_t nEnsemble, uint32_t nLanes, uint32_t nThreads, uint64_t seed, const std::string& outputEnsemble){
+	ReferenceEnsemble<Ing2,MoveType> ensemble(builder, move, threshold, factor);
+	ensemble.setStretchingFactor(stretching_factor);
+	ensemble.setNumLanes(nLanes);
+	ensemble.setNumThreads(nThreads);
+	ensemble.run(nEnsemble, seed);
+	ensemble.write(outputEnsemble);
+}
+
 int main(int argc, char* argv[]){
 	try{
 		///////////////////////////////////////////////////////////////////////////////
 		///parse options///
 		// std::string inputBFM("init.bfm");
-		std::string outputDataPos("CrosslinkPosition.dat");
-		std::string outputDataDist("ChainExtensionDistribution.dat");
+		//the outputs of a single realization, the ensemble writes only outputEnsemble
+		const std::string defaultDataPos("CrosslinkPosition.dat");
+		const std::string defaultDataDist("ChainExtensionDistribution.dat");
+		std::string outputDataPos(defaultDataPos);
+		std::string outputDataDist(defaultDataDist);
 		std::string feCurve("");
 		double relaxationParameter(10.);
 		double threshold(0.5);
@@ -80,6 +153,12 @@ int main(int argc, char* argv[]){
         uint32_t functionality(4);
 		uint32_t nRings(0);
 
+		uint32_t nEnsemble(0);
+		uint32_t nLanes(0);
+		uint32_t nThreads(0);
+		uint64_t seed(0);
+		std::string outputEnsemble("EnsembleDistanceDistribution.dat");
+		
 		bool showHelp = false;
 		auto parser
 			// = clara::detail::Opt(            inputBFM, "inputBFM (=inconfig.bfm)"                        ) ["-i"]["--input"            ] ("(required)Input filename of the bfm file"                                    ).required()
@@ -93,6 +172,11 @@ int main(int argc, char* argv[]){
             | clara::detail::Opt(           nSegments, "nSegments"                                       ) ["-n"]["--nSegments"        ] ("(optional) Number of segments for the strand."                               ).optional()
             | clara::detail::Opt(       functionality, "nStrands"                                        ) ["-s"]["--nStrands"         ] ("(optional) Functionality."                                                   ).optional()
             | clara::detail::Opt(              nRings, "nRings"                                          ) ["-m"]["--nRings"           ] ("(optional) number of rings."                                                   ).optional()
+			| clara::detail::Opt(           nEnsemble, "nEnsemble (=0)"                                  )        ["--ensemble"          ] ("(optional) Number of independent stars equilibrated in one run, 0 for a single star. Default 0.").optional()
+			| clara::detail::Opt(              nLanes, "nLanes (=0)"                                     )        ["--lanes"             ] ("(optional) Equilibrate the ensemble in SIMD lanes of this many realizations, 0 uses one updater per realization. Default 0.").optional()
+			| clara::detail::Opt(            nThreads, "nThreads (=0)"                                   )        ["--threads"           ] ("(optional) Threads for the ensemble, 0 uses all hardware threads. Default 0."    ).optional()
+			| clara::detail::Opt(                seed, "seed (=0)"                                       )        ["--seed"              ] ("(optional) Seed of the random number streams of the ensemble. Default 0."       ).optional()
+			| clara::detail::Opt(      outputEnsemble, "outputEnsemble (=EnsembleDistanceDistribution.dat)")      ["--outputEnsemble"    ] ("(optional) Output filename of the strand length distribution of the ensemble."  ).optional()
 			| clara::Help( showHelp );
 		
 	    auto result = parser.parse( clara::Args( argc, argv ) );
@@ -100,6 +184,9 @@ int main(int argc, char* argv[]){
 	    if( !result ) {
 			std::cerr << "Error in command line: " << result.errorMessage() << std::endl;
 			exit(1);
+	    }else if( nEnsemble > 0 && ( outputDataPos != defaultDataPos || outputDataDist != defaultDataDist ) ){
+			std::cerr << "Error in command line: the ensemble writes only --outputEnsemble, -o and -c belong to a single realization" << std::endl;
+			exit(1);
 	    }else if(showHelp == true){
 	    	std::cout << "Force equilibration of a star, where each chain is replaced effectively by a tendomer."<< std::endl;
 	      	parser.writeToStream(std::cout);
@@ -114,6 +201,11 @@ int main(int argc, char* argv[]){
 			std::cout << "nSegments             : " << nSegments              << std::endl;
 			std::cout << "functionality         : " << functionality          << std::endl;
 			std::cout << "nRings                : " << nRings          << std::endl;
+			std::cout << "nEnsemble             : " << nEnsemble              << std::endl;
+			std::cout << "nLanes                : " << nLanes                 << std::endl;
+			std::cout << "nThreads              : " << nThreads               << std::endl;
+			std::cout << "seed                  : " << seed                   << std::endl;
+			std::cout << "outputEnsemble        : " << outputEnsemble         << std::endl;
 	    }
 		RandomNumberGenerators rng;
 		// rng.seedDefaultValuesAll();
@@ -121,100 +213,46 @@ int main(int argc, char* argv[]){
 		///////////////////////////////////////////////////////////////////////////////
 		///end options parsing
 		///////////////////////////////////////////////////////////////////////////////
-		//Read in th last Config 
-		typedef LOKI_TYPELIST_1(FeatureMoleculesIO) Features;
-		typedef ConfigureSystem<VectorInt3,Features, 7> Config;
-		typedef Ingredients<Config> Ing;
-		Ing myIngredients;
-        myIngredients.setBoxX(256);
-		myIngredients.setBoxY(256);
-		myIngredients.setBoxZ(256);
-		myIngredients.setPeriodicX(1);
-		myIngredients.setPeriodicY(1);
-		myIngredients.setPeriodicZ(1);
-        myIngredients.modifyBondset().addBFMclassicBondset();
-        myIngredients.synchronize();
-		TaskManager taskmanager;
-		taskmanager.addUpdater( new UpdaterAddStars<Ing>(myIngredients,1, 2*nSegments+1 , functionality ),0);
-        taskmanager.addAnalyzer(new AnalyzerWriteBfmFile<Ing>("config.bfm", myIngredients, AnalyzerWriteBfmFile<Ing>::APPEND) );
-		taskmanager.initialize();
-		taskmanager.run(1);
-		taskmanager.cleanup();
-       
-		std::cout << "Read in conformation and go on to bring it into equilibrium forces..." <<std::endl;
 		//the foce equilibrium is reached off lattice ( no integer values for the positions )
         typedef LOKI_TYPELIST_4(FeatureBox, FeatureCrosslinkConnectionsLookUpIdealReference ,FeatureSystemInformationLinearMeltWithCrosslinker,FeatureFixedMonomers) Features2;
 		typedef ConfigureSystem<VectorDouble3,Features2, 7> Config2;
 		typedef Ingredients<Config2> Ing2;
-		Ing2 myIngredients2;
-		
-		myIngredients2.setBoxX(myIngredients.getBoxX());
-		myIngredients2.setBoxY(myIngredients.getBoxY());
-		myIngredients2.setBoxZ(myIngredients.getBoxZ());
-		myIngredients2.setPeriodicX(myIngredients.isPeriodicX());
-		myIngredients2.setPeriodicY(myIngredients.isPeriodicY());
-		myIngredients2.setPeriodicZ(myIngredients.isPeriodicZ());
-		myIngredients2.modifyMolecules().resize(myIngredients.getMolecules().size());
-		myIngredients2.modifyMolecules().setAge(myIngredients.getMolecules().getAge());
+		//number of segments between the crosslink and the fixed monomer (sum of two ring positions)
+		DiscreteDistribution segmentDistribution;
+		if( gauss == 0 )
+			segmentDistribution=UpdaterAddTMDoubleStars<LatticeIng>::calculateSegmentDistribution(nSegments, nRings);
 
-        myIngredients2.setNumOfChains              (functionality*1);
-		myIngredients2.setNumOfCrosslinks          (functionality+1);
-		myIngredients2.setNumOfMonomersPerChain    (2*nSegments);
-		myIngredients2.setNumOfMonomersPerCrosslink(1);
-		myIngredients2.setFunctionality            (functionality);
-
-		
-		for(size_t i = 0; i< myIngredients.getMolecules().size();i++){
-			myIngredients2.modifyMolecules()[i].modifyVector3D()=myIngredients.getMolecules()[i].getVector3D();
-			for (size_t j = 0 ; j < myIngredients.getMolecules().getNumLinks(i);j++){
-				uint32_t neighbor(myIngredients.getMolecules().getNeighborIdx(i,j));
-				if( ! myIngredients2.getMolecules().areConnected(i,neighbor) )
-					myIngredients2.modifyMolecules().connect(i,neighbor);
+		if( nEnsemble > 0 ){
+			//the phantom star and its fixed monomers use only the stream of the realization
+			PhantomReferenceBuilder phantomBuilder;
+			auto builder=[&](Ing2& ing, std::mt19937& rngRealization){
+				createPhantomStar(ing, nSegments, functionality, phantomBuilder, rngRealization);
+				for (auto i=0; i < functionality; i ++) { 
+					uint32_t ID(1 + (i+1)*(2*nSegments+1) -1);
+					if(gauss == 0 )
+						ID = segmentDistribution(rngRealization) +(2*nSegments +1) *i+1;
+					ing.modifyMolecules()[ ID ].setMovableTag(false);  
+				}
+			};
+			if ( gauss == 0 ){
+				MoveNonLinearForceEquilibrium move;
+				move.setFilename(feCurve);
+				move.setRelaxationParameter(relaxationParameter);
+				runEnsemble<Ing2,MoveNonLinearForceEquilibrium>(builder, move, threshold, 0.95, stretching_factor, nEnsemble, nLanes, nThreads, seed, outputEnsemble);
+			}else{
+				runEnsemble<Ing2,MoveForceEquilibrium>(builder, MoveForceEquilibrium(), threshold, 1.0, stretching_factor, nEnsemble, nLanes, nThreads, seed, outputEnsemble);
 			}
+			return 0;
 		}
-		
-		//probability distribution function 
-        std::cout << "Calculate PDF" << std::endl;
-		std::vector<double>  PF((nSegments-nRings),0);
-        double  sum(0.);
-		for (auto i = 1; i < (nSegments- nRings); i++ ){
-            PF[i]=prob_q(i,nSegments,nRings)*(1.-sum);
-            // std::cout << "probabilityDisti "<<i<< " "<< PF[i]<< std::endl; 
-            sum+=PF[i];
-		}
-        //calculate convolution of the probability distributions 
-        //convolution distribution function 
-        std::cout << "Calculate convoluted PDF" << std::endl;
-		std::vector<double>  convPF((nSegments- nRings)*2,0);
-        for (auto i=0; i < 2*(nSegments-nRings);i++){
-            for(auto j=0; j < i ; j++){
-                convPF[i]+=PF[j]*PF[i-j];
-            }
-            // std::cout << "ConvprobabilityDisti "<<i<< " "<< convPF[i]<< std::endl;
-        }
-        //calculate the cummulative distribution function 
-        //cummulative distribution function 
-        std::cout << "Calculate cummulative convoluted PDF" << std::endl;
-		std::vector<double> CPF((nSegments- nRings)*2,0);
-		 for (auto i=1; i < 2*(nSegments-nRings);i++){
-            CPF[i]+=CPF[i-1]+convPF[i];
-        }
-        //calculate the inverse cummulative convoluted probability distribution 
-        std::cout << "Calculate inverse cummulative convoluted PDF" << std::endl;
-        uint32_t steps(50000);
-		std::vector<uint32_t> invCPF(steps-1,0);
-		for (auto i =1 ; i < steps-1; i++) {
-			uint32_t n=0 ;
-			auto prob=static_cast<double> (i) / static_cast<double>(steps ); 
-			while (  prob > CPF [ n ]  ){ n++;}
-			invCPF[i]=(n-1) + static_cast<uint32_t>(round( (n-(n-1)) *(  prob- CPF[n-1] )/(CPF[n]-CPF[n-1]) ));
-			// std::cout << "invCPF: " <<  prob << " " << invCPF[i] <<" "<< n-1 <<" "<<CPF [ n-1 ]<<" "<< n <<" "<<CPF [ n ]<< std::endl;
-		}
+
+		Ing2 myIngredients2;
+		createStar(myIngredients2, nSegments, functionality, "config.bfm");
+		std::mt19937 engine(rng.r250_rand32());
 
         for (auto i=0; i < functionality; i ++) { 
             uint32_t ID(1 + (i+1)*(2*nSegments+1) -1);
             if(gauss == 0 )
-				ID = invCPF[rng.r250_rand32() % steps ] +(2*nSegments +1) *i+1;
+				ID = segmentDistribution(engine) +(2*nSegments +1) *i+1;
             std::cout  << "Fixed monomers= "<< ID <<std::endl;
             myIngredients2.modifyMolecules()[ ID ].setMovableTag(false);  
         }
@@ -55,6 +55,8 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE_PM/updater/moves/MoveNonLinearForceEquilibrium.h>
 #include <LeMonADE_PM/feature/FeatureCrosslinkConnectionsLookUpTendomers.h>
 #include <LeMonADE_PM/analyzer/AnalyzerEquilbratedPosition.h>
+#include <LeMonADE_PM/utility/IngredientsConversion.h>
+#include <LeMonADE_PM/utility/NetworkClassifier.h>
 
 
 int main(int argc, char* argv[]){
@@ -64,12 +66,12 @@ int main(int argc, char* argv[]){
 		std::string inputBFM("init.bfm");
 		std::string outputBFM("Config.bfm.dat");
 		std::string inputConnection("BondCreationBreaking.dat");
-        std::string activeComponent("active_00001.dat");		
+        std::string activeComponent("");		
 		bool showHelp = false;
 		auto parser
 			= clara::detail::Opt(            inputBFM, "inputBFM (=inconfig.bfm)"                        ) ["-i"]["--input"           ] ("(required)Input filename of the bfm file"                                    ).required()
 			| clara::detail::Opt(     inputConnection, "inputConnection (=BondCreationBreaking.dat)"     ) ["-d"]["--inputConnection" ] ("used for the time development of the topology. "                             ).required()
-            | clara::detail::Opt(     activeComponent, "activeComponents (=active_00001.dat)"            ) ["-a"]["--activeComponents"] ("sets the active components . "                                              ).required()
+            | clara::detail::Opt(     activeComponent, "activeComponents (="")"                          ) ["-a"]["--activeComponents"] ("(optional) sets the active components, if not given they are determined from the topology. Default \"\".")
 			| clara::detail::Opt(           outputBFM, "outputBFM (=Config.bfm)"                         ) ["-o"]["--outputBFM"       ] ("Output filename for the active material of the tendomer network.")
 			| clara::Help( showHelp );
 		
@@ -81,6 +83,7 @@ int main(int argc, char* argv[]){
 	    }else if(showHelp == true){
 	      std::cout << "Analyzer taking a bond table and a table specifying the activity of an object and writes the active part of the tendoemr network."<< std::endl;
           std::cout << "Important: input file for the connections and the active material must fit to each other!!!"<< std::endl;
+          std::cout << "Without the active components the gel and the elastically active part are determined from the topology."<< std::endl;
 	      parser.writeToStream(std::cout);
 	      exit(0);
 	    }else{
@@ -111,53 +114,46 @@ int main(int argc, char* argv[]){
 		taskmanager.cleanup();
 		std::cout << "Read in conformation and go on to bring it into equilibrium forces..." <<std::endl;
         // activeObjects are first all cross links and afterwards all chain: 0-sol, 1-gel/pending, 2-active 
-        std::ifstream in(activeComponent);
-        std::string line;
-
-		auto nCrossLinks(myIngredients.getNumCrossLinkers());
-		auto nChains(myIngredients.getNumTendomers());
 		auto nSegments(myIngredients.getNumMonomersPerChain()*2);
-		auto nChainMonomers(nChains*nSegments);
-		auto objectID(0);
-		auto nActiveCrossLinks(0);
-		auto nActiveTendomers(0);
-		std::cout <<"Filestart:\n" ;
-        while (in.good() &&  ! in.eof() ){
-            getline(in,line);
-            std::stringstream ss;
-            uint32_t activeTag;
-            ss << line;
-			// std::cout << line <<"\n";
-			if (! line.empty()) {
-				ss >>activeTag;
-				auto tmpAttribute(0);
-				if(objectID < nCrossLinks ){
-					auto IdX(nChainMonomers+objectID);
-					#ifdef DEBUG
-						std::cout <<  objectID << " "  << activeTag <<  " " << IdX <<  " " << IdX << std::endl;
-					#endif
-					if (activeTag == 2 || activeTag == 1 ){
-						tmpAttribute=1;	
-						nActiveCrossLinks++;
-					}
-					myIngredients.modifyMolecules()[nChainMonomers+objectID].setAttributeTag(tmpAttribute);
-				}else{
-					auto IdCStart((objectID-nCrossLinks)*nSegments);
-					auto IdCEnd( (objectID-nCrossLinks+1)*nSegments-1);
-					#ifdef DEBUG
-						std::cout << objectID << " "  << activeTag <<" " << IdCStart << " " << IdCEnd << std::endl;
-					#endif
-					if (activeTag == 2 || activeTag == 1 ) {
-						nActiveTendomers++;
-						tmpAttribute=1;
-					}
-					for (auto i =IdCStart ; i <= IdCEnd; i++ )
-						myIngredients.modifyMolecules()[i].setAttributeTag(tmpAttribute);
+		std::vector<uint32_t> activeTags;
+		if ( activeComponent.empty() ){
+			//the crosslink graph is set up in the off-lattice system with the lookup for the tendomers
+			typedef LOKI_TYPELIST_3(FeatureBox, FeatureCrosslinkConnectionsLookUpTendomers ,FeatureLabel) Features2;
+			typedef ConfigureSystem<VectorDouble3,Features2, 7> Config2;
+			typedef Ingredients<Config2> Ing2;
+			Ing2 myIngredients2;
+			IngredientsConversion::copy(myIngredients,myIngredients2);
+			myIngredients2.setNumTendomers           (myIngredients.getNumTendomers());
+			myIngredients2.setNumCrossLinkers        (myIngredients.getNumCrossLinkers());
+			myIngredients2.setNumMonomersPerChain    (myIngredients.getNumMonomersPerChain());
+			myIngredients2.setNumLabelsPerTendomerArm(myIngredients.getNumLabelsPerTendomerArm());
+			myIngredients2.synchronize();
+			NetworkClassifier network;
+			network.classify(myIngredients2);
+			std::cout << "NetworkClassifier: " << network.getNumGelCrossLinks() << " cross links in the gel, "
+			          << network.getNumActiveCrossLinks() << " active cross links, "
+			          << network.getNumActiveStrands() << "/" << network.getNumStrands() << " active strands, "
+			          << "gel percolating=" << network.isGelPercolating() << std::endl;
+			activeTags=getTendomerTags(myIngredients,network);
+		}else{
+			std::ifstream in(activeComponent);
+			std::string line;
+			std::cout <<"Filestart:\n" ;
+			while (in.good() &&  ! in.eof() ){
+				getline(in,line);
+				std::stringstream ss;
+				uint32_t activeTag;
+				ss << line;
+				if (! line.empty()) {
+					ss >>activeTag;
+					activeTags.push_back(activeTag);
 				}
-				objectID++;
 			}
-        }
-		std::cout <<"Fileend:\n" ;
+			std::cout <<"Fileend:\n" ;
+		}
+		uint32_t nActiveCrossLinks(0);
+		uint32_t nActiveTendomers(0);
+		tagTendomerMonomers(myIngredients,activeTags,NetworkClassifier::GEL,nActiveCrossLinks,nActiveTendomers);
 		// for()
 		myIngredients.setNumTendomers           (nActiveTendomers);
 		myIngredients.setNumCrossLinkers        (nActiveCrossLinks);
@@ -54,6 +54,8 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE_PM/feature/FeatureCrosslinkConnectionsLookUpTendomers.h>
 #include <LeMonADE_PM/analyzer/AnalyzerEquilbratedPosition.h>
 #include <LeMonADE_PM/updater/UpdaterAffineDeformation.h>
+#include <LeMonADE_PM/utility/IngredientsConversion.h>
+#include <LeMonADE_PM/utility/RunReport.h>
 
 
 int main(int argc, char* argv[]){
@@ -74,6 +76,14 @@ int main(int argc, char* argv[]){
 		double prestrainFactorY(1.0);
 		double prestrainFactorZ(1.0);
 		
+		std::string checkpointFile("");
+		uint32_t checkpointInterval(1000);
+		std::string restartFile("");
+		uint32_t referenceSegments(0);
+		std::string feCurvePattern("");
+		
+		bool prune(false);
+		std::string report("");
 		bool showHelp = false;
 		auto parser
 			= clara::detail::Opt(            inputBFM, "inputBFM (=inconfig.bfm)"                        ) ["-i"]["--input"            ] ("(required)Input filename of the bfm file"                                    ).required()
@@ -88,6 +98,13 @@ int main(int argc, char* argv[]){
 			| clara::detail::Opt(    prestrainFactorX, "prestrainFactorX (=1)"                           ) ["-x"]["--prestrainFactorX" ] ("(optional) Prestrain factor in X. Default 1.0."                              ).optional()
 			| clara::detail::Opt(    prestrainFactorY, "prestrainFactorY (=1)"                           ) ["-y"]["--prestrainFactorY" ] ("(optional) Prestrain factor in Y. Default 1.0."                              ).optional()
 			| clara::detail::Opt(    prestrainFactorZ, "prestrainFactorZ (=1)"                           ) ["-z"]["--prestrainFactorZ" ] ("(optional) Prestrain factor in Z. Default 1.0."                              ).optional()
+			| clara::detail::Opt(      checkpointFile, "checkpointFile (="")"                            )        ["--checkpoint"        ] ("(optional) Filename for binary checkpoints of the equilibration. Default \"\"."  ).optional()
+			| clara::detail::Opt(  checkpointInterval, "checkpointInterval (=1000)"                      )        ["--checkpointInterval"] ("(optional) MCS in between two checkpoints. Default 1000."                   ).optional()
+			| clara::detail::Opt(         restartFile, "restartFile (="")"                               )        ["--restart"           ] ("(optional) Continue the equilibration from this checkpoint. Default \"\"."    ).optional()
+			| clara::detail::Opt(   referenceSegments, "referenceSegments (=0)"                          )        ["--referenceSegments" ] ("(optional) Segments of the strands of feCurve, scales the curve to other segment counts. Default 0 (no scaling).").optional()
+			| clara::detail::Opt(      feCurvePattern, "feCurvePattern (="")"                            )        ["--feCurvePattern"    ] ("(optional) Force-Extension curves per segment count, {N} is replaced by the count. Default \"\".").optional()
+			| clara::detail::Opt(               prune, "prune (=false)"                                  )        ["--prune"             ] ("(optional) Equilibrate only the elastically active backbone, dangling and sol crosslinks are placed force free afterwards. Default false.").optional()
+			| clara::detail::Opt(              report, "report (="")"                                    )        ["--report"            ] ("(optional) Output filename of the JSON report of timings, counters and memory (needs LEMONADE_PM_INSTRUMENTATION). Default \"\".").optional()
 			| clara::Help( showHelp );
 		
 	    auto result = parser.parse( clara::Args( argc, argv ) );
@@ -104,65 +121,64 @@ int main(int argc, char* argv[]){
 	      std::cout << "outputDataDist        : " << outputDataDist         << std::endl;
 	      std::cout << "inputBFM              : " << inputBFM               << std::endl; 
 	      std::cout << "threshold             : " << threshold              << std::endl; 
+	      std::cout << "checkpointFile        : " << checkpointFile         << std::endl;
+	      std::cout << "checkpointInterval    : " << checkpointInterval     << std::endl;
+	      std::cout << "restartFile           : " << restartFile            << std::endl;
+	      std::cout << "prune                 : " << prune                  << std::endl;
+	      std::cout << "report                : " << report                 << std::endl;
           std::cout << "dampingfactor         : " << dampingfactor          << std::endl;
 		  std::cout << "feCurve               : " << feCurve                << std::endl;
+		  std::cout << "referenceSegments     : " << referenceSegments      << std::endl;
+		  std::cout << "feCurvePattern        : " << feCurvePattern         << std::endl;
 		  std::cout << "gauss                 : " << gauss                  << std::endl;
 		  std::cout << "stretching_factor     : " << stretching_factor      << std::endl;
 		  std::cout << "prestrainFactorX      : " << prestrainFactorX       << std::endl;
 		  std::cout << "prestrainFactorY      : " << prestrainFactorY       << std::endl;
 		  std::cout << "prestrainFactorZ      : " << prestrainFactorZ       << std::endl;
 	    }
+		if( !report.empty() ){
+#ifndef LEMONADE_PM_INSTRUMENTATION
+			std::cout << "Warning: no report is written, compile with LEMONADE_PM_INSTRUMENTATION" << std::endl;
+#endif
+			LEMONADE_PM_REPORT(report);
+		}
 		RandomNumberGenerators rng;
 		// rng.seedDefaultValuesAll();
 		rng.seedAll();
 		///////////////////////////////////////////////////////////////////////////////
 		///end options parsing
 		///////////////////////////////////////////////////////////////////////////////
-		//Read in th last Config 
-		typedef LOKI_TYPELIST_3(FeatureMoleculesIOUnsaveCheck, FeatureLabel, FeatureReactiveBonds) Features;
-		typedef ConfigureSystem<VectorInt3,Features, 7> Config;
-		typedef Ingredients<Config> Ing;
-		Ing myIngredients;
-		
-		TaskManager taskmanager;
-		
-		taskmanager.addUpdater( new UpdaterReadBfmFile<Ing>(inputBFM,myIngredients, UpdaterReadBfmFile<Ing>::READ_LAST_CONFIG_SAVE),0);
-
-		//initialize and run
-		taskmanager.initialize();
-		taskmanager.run(1);
-		taskmanager.cleanup();
-		std::cout << "Read in conformation and go on to bring it into equilibrium forces..." <<std::endl;
 		//the foce equilibrium is reached off lattice ( no integer values for the positions )
 		typedef LOKI_TYPELIST_3(FeatureBox, FeatureCrosslinkConnectionsLookUpTendomers ,FeatureLabel) Features2;
 		typedef ConfigureSystem<VectorDouble3,Features2, 7> Config2;
 		typedef Ingredients<Config2> Ing2;
 		Ing2 myIngredients2;
-		
-		myIngredients2.setBoxX(myIngredients.getBoxX());
-		myIngredients2.setBoxY(myIngredients.getBoxY());
-		myIngredients2.setBoxZ(myIngredients.getBoxZ());
-		myIngredients2.setPeriodicX(myIngredients.isPeriodicX());
-		myIngredients2.setPeriodicY(myIngredients.isPeriodicY());
-		myIngredients2.setPeriodicZ(myIngredients.isPeriodicZ());
-		myIngredients2.modifyMolecules().resize(myIngredients.getMolecules().size());
-		myIngredients2.modifyMolecules().setAge(myIngredients.getMolecules().getAge());
-        
-        myIngredients2.setNumTendomers           (myIngredients.getNumTendomers());
-		myIngredients2.setNumCrossLinkers        (myIngredients.getNumCrossLinkers());
-		myIngredients2.setNumMonomersPerChain    (myIngredients.getNumMonomersPerChain());
-		myIngredients2.setNumLabelsPerTendomerArm(myIngredients.getNumLabelsPerTendomerArm());
-		
-		for(size_t i = 0; i< myIngredients.getMolecules().size();i++){
-			myIngredients2.modifyMolecules()[i].modifyVector3D()=myIngredients.getMolecules()[i].getVector3D();
-			myIngredients2.modifyMolecules()[i].setReactive(myIngredients.getMolecules()[i].isReactive());
-			myIngredients2.modifyMolecules()[i].setNumMaxLinks(myIngredients.getMolecules()[i].getNumMaxLinks());
-			for (size_t j = 0 ; j < myIngredients.getMolecules().getNumLinks(i);j++){
-				uint32_t neighbor(myIngredients.getMolecules().getNeighborIdx(i,j));
-				if( ! myIngredients2.getMolecules().areConnected(i,neighbor) )
-					myIngredients2.modifyMolecules().connect(i,neighbor);
+		{
+			//Read in th last Config 
+			typedef LOKI_TYPELIST_3(FeatureMoleculesIOUnsaveCheck, FeatureLabel, FeatureReactiveBonds) Features;
+			typedef ConfigureSystem<VectorInt3,Features, 7> Config;
+			typedef Ingredients<Config> Ing;
+			Ing myIngredients;
+			
+			TaskManager taskmanager;
+			
+			taskmanager.addUpdater( new UpdaterReadBfmFile<Ing>(inputBFM,myIngredients, UpdaterReadBfmFile<Ing>::READ_LAST_CONFIG_SAVE),0);
+
+			//initialize and run
+			{
+				LEMONADE_PM_PHASE("readBFM");
+				taskmanager.initialize();
+				taskmanager.run(1);
+				taskmanager.cleanup();
 			}
-		}
+			std::cout << "Read in conformation and go on to bring it into equilibrium forces..." <<std::endl;
+			
+			IngredientsConversion::copy(myIngredients,myIngredients2);
+			myIngredients2.setNumTendomers           (myIngredients.getNumTendomers());
+			myIngredients2.setNumCrossLinkers        (myIngredients.getNumCrossLinkers());
+			myIngredients2.setNumMonomersPerChain    (myIngredients.getNumMonomersPerChain());
+			myIngredients2.setNumLabelsPerTendomerArm(myIngredients.getNumLabelsPerTendomerArm());
+		}//the lattice system is released here
 		myIngredients2.synchronize();
 
 		TaskManager taskmanager2;
@@ -170,9 +186,22 @@ int main(int argc, char* argv[]){
 		//read bonds and positions stepwise
         auto updater = new UpdaterForceBalancedPosition<Ing2,MoveNonLinearForceEquilibrium>(myIngredients2, threshold, dampingfactor) ;
         auto updater2 = new UpdaterForceBalancedPosition<Ing2,MoveForceEquilibrium>(myIngredients2, threshold,dampingfactor) ;
+        if( !checkpointFile.empty() ){
+            updater->setCheckpoint(checkpointFile,checkpointInterval);
+            updater2->setCheckpoint(checkpointFile,checkpointInterval);
+        }
+        if( !restartFile.empty() ){
+            updater->setRestart(restartFile);
+            updater2->setRestart(restartFile);
+        }
+        //crosslinks with two strands are collapsed for the gaussian relation only
+        updater->setPruning(prune);
+        updater2->setPruning(prune,true);
 		if ( gauss == 0 ){
             updater->setFilename(feCurve);
             updater->setRelaxationParameter(relaxationParameter);
+            updater->setReferenceSegments(referenceSegments);
+            updater->setSegmentFilenamePattern(feCurvePattern);
             std::cout << "TendomerNetworkForceEquilibrium: add UpdaterForceBalancedPosition<Ing2,MoveNonLinearForceEquilibrium>(myIngredients2, threshold) \n";
         	taskmanager2.addUpdater( updater );
 		}else if (gauss == 1 ){
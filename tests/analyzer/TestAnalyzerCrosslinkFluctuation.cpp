@@ -0,0 +1,119 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <iostream>
+#include <fstream>
+#include <exception>
+
+#include <LeMonADE/core/Molecules.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureBox.h>
+
+#include <LeMonADE/utility/Vector3D.h>
+#include <LeMonADE/feature/FeatureSystemInformationLinearMeltWithCrosslinker.h>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/feature/FeatureCrosslinkConnectionsLookUp.h>
+#include <LeMonADE_PM/analyzer/AnalyzerCrosslinkFluctuation.h>
+
+
+TEST_CASE( "Test class AnalyzerCrosslinkFluctuation" ) 
+{
+    typedef LOKI_TYPELIST_3(FeatureBox, FeatureCrosslinkConnectionsLookUp,FeatureSystemInformationLinearMeltWithCrosslinker ) Features;
+    typedef ConfigureSystem<VectorDouble3,Features,7> Config;
+    typedef Ingredients<Config> IngredientsType;
+
+    std::streambuf* originalBuffer;
+    std::ostringstream tempStream;
+    //redirect stdout 
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+
+    //setup system: 3x3x3 crosslinks with a spacing of 2 in a periodic box of 6, 
+    //every crosslink is directly connected to its six nearest images
+    IngredientsType ingredients;
+    ingredients.setBoxX(6);
+    ingredients.setBoxY(6);
+    ingredients.setBoxZ(6);
+    ingredients.setPeriodicX(1);
+    ingredients.setPeriodicY(1);
+    ingredients.setPeriodicZ(1);
+    for(uint32_t x=0; x < 3; x++ )
+        for(uint32_t y=0; y < 3; y++ )
+            for(uint32_t z=0; z < 3; z++ ){
+                ingredients.modifyMolecules().addMonomer(2.*x,2.*y,2.*z);
+                ingredients.modifyMolecules()[ingredients.getMolecules().size()-1].setReactive(true);
+                ingredients.modifyMolecules()[ingredients.getMolecules().size()-1].setNumMaxLinks(6);
+            }
+    for(uint32_t x=0; x < 3; x++ )
+        for(uint32_t y=0; y < 3; y++ )
+            for(uint32_t z=0; z < 3; z++ ){
+                uint32_t ID(9*x+3*y+z);
+                ingredients.modifyMolecules().connect(ID,9*((x+1)%3)+3*y+z);
+                ingredients.modifyMolecules().connect(ID,9*x+3*((y+1)%3)+z);
+                ingredients.modifyMolecules().connect(ID,9*x+3*y+(z+1)%3);
+            }
+    REQUIRE_NOTHROW(ingredients.synchronize(ingredients));
+
+    SECTION(" Check the strand fluctuations of the periodic lattice ","[AnalyzerCrosslinkFluctuation]")
+    {
+        AnalyzerCrosslinkFluctuation<IngredientsType> analyzer(ingredients,"","",1000);
+        analyzer.setBondlength(1.0);
+        REQUIRE(analyzer.execute());
+        const NetworkLaplacian& laplacian(analyzer.getLaplacian());
+        REQUIRE(laplacian.getNumCrossLinks()==27);
+        REQUIRE(laplacian.getNumStrands()==81);
+        REQUIRE(laplacian.getNumComponents()==1);
+        //all strands are equivalent and the resistances sum up to 27-1
+        double sum(0.0);
+        for(uint32_t e=0; e<laplacian.getNumStrands(); e++){
+            REQUIRE(laplacian.getResistance(e)==Approx(26./81.).epsilon(0.2));
+            sum+=laplacian.getResistance(e);
+        }
+        REQUIRE(sum==Approx(26.).epsilon(0.02));
+    }
+
+    SECTION(" Check the output ","[AnalyzerCrosslinkFluctuation]")
+    {
+        AnalyzerCrosslinkFluctuation<IngredientsType> analyzer(ingredients,"FluctuationTest.dat","StrandFluctuationTest.dat",8);
+        analyzer.initialize();
+        analyzer.execute();
+        std::ifstream crosslinks("C1_FluctuationTest.dat");
+        REQUIRE(crosslinks.good());
+        crosslinks.close();
+        std::ifstream strands("C1_StrandFluctuationTest.dat");
+        REQUIRE(strands.good());
+        strands.close();
+        remove("C1_FluctuationTest.dat");
+        remove("C1_StrandFluctuationTest.dat");
+    }
+    //restore cout 
+    std::cout.rdbuf(originalBuffer);
+
+}
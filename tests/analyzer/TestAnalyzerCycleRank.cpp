@@ -0,0 +1,144 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <iostream>
+#include <fstream>
+#include <exception>
+#include <cctype>
+
+#include <LeMonADE/core/Molecules.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureBox.h>
+
+#include <LeMonADE/utility/Vector3D.h>
+#include <LeMonADE/feature/FeatureSystemInformationLinearMeltWithCrosslinker.h>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/feature/FeatureCrosslinkConnectionsLookUp.h>
+#include <LeMonADE_PM/analyzer/AnalyzerCycleRank.h>
+
+
+TEST_CASE( "Test class AnalyzerCycleRank" ) 
+{
+    typedef LOKI_TYPELIST_3(FeatureBox, FeatureCrosslinkConnectionsLookUp,FeatureSystemInformationLinearMeltWithCrosslinker ) Features;
+    typedef ConfigureSystem<VectorDouble3,Features,7> Config;
+    typedef Ingredients<Config> IngredientsType;
+
+    std::streambuf* originalBuffer;
+    std::ostringstream tempStream;
+    //redirect stdout 
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+
+    //setup system: 3x3x3 crosslinks with a spacing of 2 in a periodic box of 6, 
+    //every crosslink is directly connected to its six nearest images
+    IngredientsType ingredients;
+    ingredients.setBoxX(6);
+    ingredients.setBoxY(6);
+    ingredients.setBoxZ(6);
+    ingredients.setPeriodicX(1);
+    ingredients.setPeriodicY(1);
+    ingredients.setPeriodicZ(1);
+    for(uint32_t x=0; x < 3; x++ )
+        for(uint32_t y=0; y < 3; y++ )
+            for(uint32_t z=0; z < 3; z++ ){
+                ingredients.modifyMolecules().addMonomer(2.*x,2.*y,2.*z);
+                ingredients.modifyMolecules()[ingredients.getMolecules().size()-1].setReactive(true);
+                ingredients.modifyMolecules()[ingredients.getMolecules().size()-1].setNumMaxLinks(6);
+            }
+    for(uint32_t x=0; x < 3; x++ )
+        for(uint32_t y=0; y < 3; y++ )
+            for(uint32_t z=0; z < 3; z++ ){
+                uint32_t ID(9*x+3*y+z);
+                ingredients.modifyMolecules().connect(ID,9*((x+1)%3)+3*y+z);
+                ingredients.modifyMolecules().connect(ID,9*x+3*((y+1)%3)+z);
+                ingredients.modifyMolecules().connect(ID,9*x+3*y+(z+1)%3);
+            }
+
+    SECTION(" Check the cycle rank of the periodic lattice ","[AnalyzerCycleRank]")
+    {
+        REQUIRE_NOTHROW(ingredients.synchronize(ingredients));
+        AnalyzerCycleRank<IngredientsType> analyzer(ingredients,"");
+        REQUIRE(analyzer.execute());
+        const std::vector<double>& summary(analyzer.getSummary());
+        REQUIRE(summary.size()==8);
+        REQUIRE(summary[1]==Approx(1.));
+        REQUIRE(summary[2]==27.);
+        REQUIRE(summary[3]==81.);
+        REQUIRE(summary[4]==1.);
+        //xi = 81 - 27 + 1
+        REQUIRE(summary[5]==55.);
+        REQUIRE(summary[6]==Approx(55./216.));
+        REQUIRE(summary[7]==54.);
+    }
+
+    SECTION(" Check that dangling crosslinks do not change the cycle rank ","[AnalyzerCycleRank]")
+    {
+        //crosslink 27 hangs on crosslink 0 and carries a dangling chain of two monomers
+        ingredients.modifyMolecules().addMonomer(0.,0.,-2.);
+        ingredients.modifyMolecules().addMonomer(0.,2.,-2.);
+        ingredients.modifyMolecules().addMonomer(2.,0.,-2.);
+        ingredients.modifyMolecules()[0].setNumMaxLinks(7);
+        ingredients.modifyMolecules()[27].setReactive(true);
+        ingredients.modifyMolecules()[27].setNumMaxLinks(4);
+        ingredients.modifyMolecules().connect(0,27);
+        ingredients.modifyMolecules().connect(27,28);
+        ingredients.modifyMolecules().connect(27,29);
+        REQUIRE_NOTHROW(ingredients.synchronize(ingredients));
+        AnalyzerCycleRank<IngredientsType> analyzer(ingredients,"");
+        analyzer.execute();
+        const std::vector<double>& summary(analyzer.getSummary());
+        //one reactive site of crosslink 27 is left
+        REQUIRE(summary[1]==Approx(164./165.));
+        REQUIRE(summary[2]==27.);
+        REQUIRE(summary[3]==81.);
+        REQUIRE(summary[5]==55.);
+    }
+
+    SECTION(" Check the output ","[AnalyzerCycleRank]")
+    {
+        REQUIRE_NOTHROW(ingredients.synchronize(ingredients));
+        AnalyzerCycleRank<IngredientsType> analyzer(ingredients,"CycleRankTest.dat");
+        analyzer.initialize();
+        analyzer.execute();
+        analyzer.execute();
+        std::ifstream file("CycleRankTest.dat");
+        REQUIRE(file.good());
+        size_t nRows(0);
+        std::string line;
+        while(std::getline(file,line))
+            if( !line.empty() && std::isdigit(line[0]) ) nRows++;
+        REQUIRE(nRows==2);
+        file.close();
+        remove("CycleRankTest.dat");
+    }
+    //restore cout 
+    std::cout.rdbuf(originalBuffer);
+
+}
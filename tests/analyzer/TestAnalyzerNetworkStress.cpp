@@ -0,0 +1,179 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <fstream>
+#include <exception>
+#include <cmath>
+#include <cctype>
+
+#include <LeMonADE/core/Molecules.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureBox.h>
+
+#include <LeMonADE/utility/Vector3D.h>
+#include <LeMonADE/feature/FeatureSystemInformationLinearMeltWithCrosslinker.h>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/feature/FeatureCrosslinkConnectionsLookUp.h>
+#include <LeMonADE_PM/updater/moves/ForceExtensionPolicies.h>
+#include <LeMonADE_PM/analyzer/AnalyzerNetworkStress.h>
+#include <LeMonADE_PM/updater/UpdaterAffineDeformation.h>
+
+
+TEST_CASE( "Test class AnalyzerNetworkStress" ) 
+{
+    typedef LOKI_TYPELIST_3(FeatureBox, FeatureCrosslinkConnectionsLookUp,FeatureSystemInformationLinearMeltWithCrosslinker ) Features;
+    typedef ConfigureSystem<VectorDouble3,Features,4> Config;
+    typedef Ingredients<Config> IngredientsType;
+
+    std::streambuf* originalBuffer;
+    std::ostringstream tempStream;
+    //redirect stdout 
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+
+    //setup system: one crosslink in the center of four crosslinks in the xy-plane
+    IngredientsType ingredients;
+    ingredients.setBoxX(16);
+    ingredients.setBoxY(16);
+    ingredients.setBoxZ(16);
+    ingredients.setPeriodicX(1);
+    ingredients.setPeriodicY(1);
+    ingredients.setPeriodicZ(1);
+    ingredients.modifyMolecules().addMonomer(6.,6.,6.);
+    ingredients.modifyMolecules().addMonomer(6.,4.,6.);
+    ingredients.modifyMolecules().addMonomer(6.,8.,6.);
+    ingredients.modifyMolecules().addMonomer(4.,6.,6.);
+    ingredients.modifyMolecules().addMonomer(8.,6.,6.);
+    for(uint32_t i=1; i < 5; i++ )
+        ingredients.modifyMolecules().connect(0,i);
+    //dangling ends give the outer crosslinks three bonds 
+    for(uint32_t i=1; i < 5; i++ ){
+        VectorDouble3 pos(ingredients.getMolecules()[i].getVector3D());
+        ingredients.modifyMolecules().addMonomer(pos.getX(),pos.getY(),pos.getZ());
+        ingredients.modifyMolecules().connect(i,ingredients.getMolecules().size()-1);
+        ingredients.modifyMolecules().addMonomer(pos.getX(),pos.getY(),pos.getZ());
+        ingredients.modifyMolecules().connect(i,ingredients.getMolecules().size()-1);
+    }
+    ingredients.modifyMolecules()[0].setReactive(true); 
+    ingredients.modifyMolecules()[0].setNumMaxLinks(4); 
+    for(uint32_t i=1; i < 5; i++ ){
+        ingredients.modifyMolecules()[i].setReactive(true); 
+        ingredients.modifyMolecules()[i].setNumMaxLinks(3); 
+    }
+    REQUIRE_NOTHROW(ingredients.synchronize(ingredients));
+
+    const double b2(2.68*2.68);
+    const double volume(16.*16.*16.);
+
+    SECTION(" Check the summary of the strands ","[AnalyzerNetworkStress]")
+    {
+        AnalyzerNetworkStress<IngredientsType> analyzer(ingredients,"");
+        REQUIRE(analyzer.execute());
+        const std::vector<double>& summary(analyzer.getSummary());
+        REQUIRE(summary.size()==16);
+        //all reactive sites of the crosslinks are used 
+        REQUIRE(summary[1]==Approx(1.));
+        REQUIRE(summary[2]==16.);
+        //four strands of length 2 and one segment, seen from both ends
+        REQUIRE(summary[5]==Approx(4.));
+        REQUIRE(summary[6]==Approx(4.));
+        REQUIRE(summary[7]==Approx(16.));
+        REQUIRE(summary[8]==Approx(4./b2));
+        REQUIRE(summary[9] ==Approx(2.*3./b2*4./volume));
+        REQUIRE(summary[10]==Approx(2.*3./b2*4./volume));
+        REQUIRE(summary[11]==Approx(0.).margin(1.E-12));
+        REQUIRE(summary[12]==Approx(0.).margin(1.E-12));
+        REQUIRE(summary[15]==Approx(16./b2/volume));
+        //the phantom modulus is the trace of the gaussian stress divided by 3
+        REQUIRE(summary[15]==Approx((summary[9]+summary[10]+summary[11])/3.));
+    }
+
+    SECTION(" Check the effective strands ","[AnalyzerNetworkStress]")
+    {
+        //collapse one strand 
+        ingredients.modifyMolecules()[4].setAllCoordinates(6.,6.,6.);
+        AnalyzerNetworkStress<IngredientsType> analyzer(ingredients,"");
+        analyzer.execute();
+        REQUIRE(analyzer.getSummary()[5]==Approx(4.));
+        REQUIRE(analyzer.getSummary()[6]==Approx(3.));
+        REQUIRE(analyzer.getSummary()[7]==Approx(12.));
+        REQUIRE(analyzer.getSummary()[9]==Approx(3./b2*4./volume));
+        //strands shorter than the minimum extension are not effective
+        analyzer.setMinExtension(2.5);
+        analyzer.execute();
+        REQUIRE(analyzer.getSummary()[6]==Approx(0.));
+        REQUIRE(analyzer.getSummary()[15]==Approx(0.));
+    }
+
+    SECTION(" Check the volume of a prestrained system ","[AnalyzerNetworkStress]")
+    {
+        //the prestrain doubles the volume, the box is not changed
+        UpdaterAffineDeformation<IngredientsType>(ingredients,1.0,2.0,1.0,1.0).execute();
+        AnalyzerNetworkStress<IngredientsType> analyzer(ingredients,"");
+        analyzer.setPrestrain(2.0,1.0,1.0);
+        analyzer.execute();
+        //two strands along x with length 4 and two along y with length 2
+        REQUIRE(analyzer.getSummary()[7]==Approx(40.));
+        REQUIRE(analyzer.getSummary()[9] ==Approx(2.*3./b2*16./(2.*volume)));
+        REQUIRE(analyzer.getSummary()[10]==Approx(2.*3./b2*4./(2.*volume)));
+        REQUIRE(analyzer.getSummary()[15]==Approx(40./b2/(2.*volume)));
+    }
+
+    SECTION(" Check the force-extension relation ","[AnalyzerNetworkStress]")
+    {
+        AnalyzerNetworkStress<IngredientsType,FENEForcePolicy> analyzer(ingredients,"");
+        analyzer.execute();
+        double x(2./2.68);
+        REQUIRE(analyzer.getSummary()[9]==Approx(2.*3./b2/(1.-x*x)*4./volume));
+        //the modulus does not depend on the force-extension relation
+        REQUIRE(analyzer.getSummary()[15]==Approx(16./b2/volume));
+    }
+
+    SECTION(" Check the output ","[AnalyzerNetworkStress]")
+    {
+        AnalyzerNetworkStress<IngredientsType> analyzer(ingredients,"NetworkStressTest.dat");
+        analyzer.initialize();
+        analyzer.execute();
+        analyzer.execute();
+        std::ifstream file("NetworkStressTest.dat");
+        REQUIRE(file.good());
+        size_t nRows(0);
+        std::string line;
+        //the rows start with the MCS, header lines with a comment sign
+        while(std::getline(file,line))
+            if( !line.empty() && std::isdigit(line[0]) ) nRows++;
+        REQUIRE(nRows==2);
+        file.close();
+        remove("NetworkStressTest.dat");
+    }
+    //restore cout 
+    std::cout.rdbuf(originalBuffer);
+
+}
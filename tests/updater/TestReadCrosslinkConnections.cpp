@@ -174,6 +174,63 @@ TEST_CASE( "Test class UpdaterReadCrosslinkConnections" )
         
         REQUIRE(0==remove(filename.c_str()));    
     }
+
+    SECTION(" Test chains of one monomer between two crosslinks ","[UpdaterReadCrosslinkConnections]")
+    {
+        //every reactive monomer has two reactive neighbors: all bonds are erased by initialize
+        const std::string filename("bondTableShortChains.dat");
+        std::ofstream out(filename); 
+        //   Time >>  ChainID >>    MonID1 >>       P1X >>     P1Y >>     P1Z >>   MonID2 >>      P2X >>     P2Y >>     P2Z
+        out << 11 << " " << 0 << " " << 2 << " " << 4 << " "<< 6 << " "<< 6 << " "<< 0 << " "<< 6 << " "<< 6 << " "<< 6 <<"\n";
+        out << 12 << " " << 1 << " " << 2 << " " << 4 << " "<< 6 << " "<< 6 << " "<< 1 << " "<< 6 << " "<< 8 << " "<< 6 <<"\n";
+        out << 13 << " " << 0 << " " << 3 << " " << 8 << " "<< 6 << " "<< 6 << " "<< 0 << " "<< 6 << " "<< 6 << " "<< 6 <<"\n";
+        out << 14 << " " << 1 << " " << 3 << " " << 8 << " "<< 6 << " "<< 6 << " "<< 1 << " "<< 6 << " "<< 8 << " "<< 6 <<"\n";
+        out.close();
+
+        IngredientsType ingredients;
+        ingredients.setBoxX(16);
+        ingredients.setBoxY(16);
+        ingredients.setBoxZ(16);
+        ingredients.setPeriodicX(1);
+        ingredients.setPeriodicY(1);
+        ingredients.setPeriodicZ(1);
+        ingredients.setNumOfChains(2);
+        ingredients.setNumOfCrosslinks(2);
+        ingredients.setFunctionality(2);
+        ingredients.setNumOfMonomersPerChain(1);
+        ingredients.setNumOfMonomersPerCrosslink(1);
+        //chains 
+        ingredients.modifyMolecules().addMonomer(6.,6.,6.);//0
+        ingredients.modifyMolecules().addMonomer(6.,8.,6.);//1
+        //crosslinks
+        ingredients.modifyMolecules().addMonomer(4.,6.,6.);//2
+        ingredients.modifyMolecules().addMonomer(8.,6.,6.);//3
+        ingredients.modifyMolecules().connect(0,2);
+        ingredients.modifyMolecules().connect(0,3);
+        ingredients.modifyMolecules().connect(1,2);
+        ingredients.modifyMolecules().connect(1,3);
+        for (uint32_t i=0; i < 2; i++){
+            ingredients.modifyMolecules()[i].setReactive(true); 
+            ingredients.modifyMolecules()[i].setNumMaxLinks(2); 
+            ingredients.modifyMolecules()[i+2].setReactive(true); 
+            ingredients.modifyMolecules()[i+2].setNumMaxLinks(4); 
+        }
+        REQUIRE_NOTHROW(ingredients.synchronize(ingredients));
+        //read the whole table in the first step
+        UpdaterReadCrosslinkConnections<IngredientsType> updater(ingredients, filename, 0., 1.);
+        updater.initialize();
+        for (uint32_t i=0; i < 4; i++)
+            REQUIRE(ingredients.getMolecules().getNumLinks(i)==0);
+
+        REQUIRE_NOTHROW(updater.execute());
+        REQUIRE(ingredients.getMolecules().getAge()==14);
+        REQUIRE(ingredients.getMolecules().areConnected(0,2) );
+        REQUIRE(ingredients.getMolecules().areConnected(0,3) );
+        REQUIRE(ingredients.getMolecules().areConnected(1,2) );
+        REQUIRE(ingredients.getMolecules().areConnected(1,3) );
+
+        REQUIRE(0==remove(filename.c_str()));    
+    }
     //restore cout 
     std::cout.rdbuf(originalBuffer);
 
@@ -0,0 +1,115 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+
+#include <LeMonADE/core/Molecules.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureAttributes.h>
+#include <LeMonADE/feature/FeatureExcludedVolumeSc.h>
+#include <LeMonADE/feature/FeatureMoleculesIO.h>
+#include <LeMonADE/utility/RandomNumberGenerators.h>
+#include <LeMonADE/utility/Vector3D.h>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/updater/UpdaterAddStars.h>
+
+TEST_CASE( "Test class UpdaterAddStars" ) 
+{
+    typedef LOKI_TYPELIST_3(FeatureMoleculesIO, FeatureAttributes<>, FeatureExcludedVolumeSc<>) Features;
+    typedef ConfigureSystem<VectorInt3,Features,7> Config;
+    typedef Ingredients<Config> IngredientsType;
+
+    std::streambuf* originalBuffer;
+    std::ostringstream tempStream;
+    //redirect stdout 
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+
+    RandomNumberGenerators rng;
+    rng.seedAll();
+
+    SECTION(" Stars in a dense box have no overlap and valid bonds ","[UpdaterAddStars]")
+    {
+        IngredientsType ingredients;
+        ingredients.setBoxX(32);
+        ingredients.setBoxY(32);
+        ingredients.setBoxZ(32);
+        ingredients.setPeriodicX(1);
+        ingredients.setPeriodicY(1);
+        ingredients.setPeriodicZ(1);
+        ingredients.modifyBondset().addBFMclassicBondset();
+        ingredients.synchronize();
+
+        //occupation density 0.3
+        UpdaterAddStars<IngredientsType> stars(ingredients,20,20,3);
+        REQUIRE(stars.getMaxSystemMoves()==10);
+        REQUIRE_NOTHROW(stars.initialize());
+        const auto& molecules(ingredients.getMolecules());
+        REQUIRE(molecules.size()==20*61);
+
+        //all bonds are in the bond set and the cubes do not overlap in the periodic box
+        for(uint32_t i=0; i<molecules.size(); i++){
+            for(uint32_t n=0; n<molecules.getNumLinks(i); n++){
+                const VectorInt3 bond(molecules[molecules.getNeighborIdx(i,n)]-molecules[i]);
+                REQUIRE(ingredients.getBondset().isValidStrongCheck(bond));
+            }
+            for(uint32_t j=i+1; j<molecules.size(); j++){
+                const int32_t dx((((molecules[j].getX()-molecules[i].getX())%32)+32)%32);
+                const int32_t dy((((molecules[j].getY()-molecules[i].getY())%32)+32)%32);
+                const int32_t dz((((molecules[j].getZ()-molecules[i].getZ())%32)+32)%32);
+                const bool overlap( (dx<2 || dx>30) && (dy<2 || dy>30) && (dz<2 || dz>30) );
+                REQUIRE(!overlap);
+            }
+        }
+    }
+
+    SECTION(" A full box fails fast ","[UpdaterAddStars]")
+    {
+        IngredientsType ingredients;
+        ingredients.setBoxX(8);
+        ingredients.setBoxY(8);
+        ingredients.setBoxZ(8);
+        ingredients.setPeriodicX(1);
+        ingredients.setPeriodicY(1);
+        ingredients.setPeriodicZ(1);
+        ingredients.modifyBondset().addBFMclassicBondset();
+        ingredients.synchronize();
+
+        //64 cubes fit into the box at most
+        UpdaterAddStars<IngredientsType> stars(ingredients,1,100,1);
+        stars.setMaxSystemMoves(0);
+        REQUIRE_THROWS_AS(stars.initialize(), std::runtime_error);
+        REQUIRE(ingredients.getMolecules().size()<=64);
+    }
+    //restore cout 
+    std::cout.rdbuf(originalBuffer);
+}
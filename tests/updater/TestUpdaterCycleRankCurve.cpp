@@ -0,0 +1,186 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <fstream>
+#include <exception>
+
+#include <LeMonADE/core/Molecules.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureBox.h>
+#include <LeMonADE/feature/FeatureSystemInformationLinearMeltWithCrosslinker.h>
+
+#include <LeMonADE/utility/Vector3D.h>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/updater/UpdaterCycleRankCurve.h>
+#include <LeMonADE_PM/feature/FeatureCrosslinkConnectionsLookUp.h>
+
+
+TEST_CASE( "Test class UpdaterCycleRankCurve" ) 
+{
+    typedef LOKI_TYPELIST_3(FeatureBox, FeatureSystemInformationLinearMeltWithCrosslinker,FeatureCrosslinkConnectionsLookUp) Features;
+    typedef ConfigureSystem<VectorDouble3,Features,4> Config;
+    typedef Ingredients<Config> IngredientsType;
+
+    std::streambuf* originalBuffer;
+    std::ostringstream tempStream;
+    //redirect stdout 
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+
+    //final network: six chains of three monomers between the crosslinks
+    //A=18 (2,6,6), B=19 (10,6,6), C=20 (2,2,2), D=21 (10,2,2) and E=22 (2,14,6)
+    //chain (first end - last end): 0 (A-B), 1 (B-A across the periodic box), 2 (A-B), 
+    //3 (C-D), 4 (D-C), 5 (E-A)
+    IngredientsType ingredients;
+    ingredients.setBoxX(16);
+    ingredients.setBoxY(16);
+    ingredients.setBoxZ(16);
+    ingredients.setPeriodicX(1);
+    ingredients.setPeriodicY(1);
+    ingredients.setPeriodicZ(1);
+    ingredients.setNumOfChains(6);
+    ingredients.setNumOfCrosslinks(5);
+    ingredients.setFunctionality(4);
+    ingredients.setNumOfMonomersPerChain(3);
+    ingredients.setNumOfMonomersPerCrosslink(1);
+    ingredients.modifyMolecules().addMonomer(4.,6.,6.);
+    ingredients.modifyMolecules().addMonomer(6.,6.,6.);
+    ingredients.modifyMolecules().addMonomer(8.,6.,6.);
+    ingredients.modifyMolecules().addMonomer(12.,6.,6.);
+    ingredients.modifyMolecules().addMonomer(14.,6.,6.);
+    ingredients.modifyMolecules().addMonomer(0.,6.,6.);
+    ingredients.modifyMolecules().addMonomer(4.,6.,6.);
+    ingredients.modifyMolecules().addMonomer(6.,6.,6.);
+    ingredients.modifyMolecules().addMonomer(8.,6.,6.);
+    ingredients.modifyMolecules().addMonomer(4.,2.,2.);
+    ingredients.modifyMolecules().addMonomer(6.,2.,2.);
+    ingredients.modifyMolecules().addMonomer(8.,2.,2.);
+    ingredients.modifyMolecules().addMonomer(8.,2.,2.);
+    ingredients.modifyMolecules().addMonomer(6.,2.,2.);
+    ingredients.modifyMolecules().addMonomer(4.,2.,2.);
+    ingredients.modifyMolecules().addMonomer(2.,12.,6.);
+    ingredients.modifyMolecules().addMonomer(2.,10.,6.);
+    ingredients.modifyMolecules().addMonomer(2.,8.,6.);
+    ingredients.modifyMolecules().addMonomer(2.,6.,6.);
+    ingredients.modifyMolecules().addMonomer(10.,6.,6.);
+    ingredients.modifyMolecules().addMonomer(2.,2.,2.);
+    ingredients.modifyMolecules().addMonomer(10.,2.,2.);
+    ingredients.modifyMolecules().addMonomer(2.,14.,6.);
+    const uint32_t firstEnd[6]={18,19,18,20,21,22};
+    const uint32_t lastEnd[6]={19,18,19,21,20,18};
+    for(uint32_t c=0; c < 6; c++){
+        ingredients.modifyMolecules().connect(3*c,3*c+1);
+        ingredients.modifyMolecules().connect(3*c+1,3*c+2);
+        ingredients.modifyMolecules()[3*c].setReactive(true);
+        ingredients.modifyMolecules()[3*c].setNumMaxLinks(2);
+        ingredients.modifyMolecules()[3*c+2].setReactive(true);
+        ingredients.modifyMolecules()[3*c+2].setNumMaxLinks(2);
+        ingredients.modifyMolecules().connect(firstEnd[c],3*c);
+        ingredients.modifyMolecules().connect(lastEnd[c],3*c+2);
+    }
+    for(uint32_t i=18; i < 23; i++){
+        ingredients.modifyMolecules()[i].setReactive(true); 
+        ingredients.modifyMolecules()[i].setNumMaxLinks(4); 
+    }
+
+    //prepare input file: the strands are formed in the order A-B, B-A, C-D, D-C, E-A, A-B
+    const std::string filename("cycleRankTable.dat");
+    const uint32_t chains[6]={0,1,3,4,5,2};
+    std::ofstream out(filename); 
+    out <<"# Time, ChainID, MonID1, P1X, P1Y, P1Z, MonID2, P2X, P2Y, P2Z\n";
+    for(uint32_t r=0; r < 6; r++){
+        out << 20*r+10 << " " << chains[r] << " " << firstEnd[chains[r]] << " 0 0 0 " << 3*chains[r] << " 0 0 0\n";
+        out << 20*r+20 << " " << chains[r] << " " << 3*chains[r]+2 << " 0 0 0 " << lastEnd[chains[r]] << " 0 0 0\n";
+    }
+    out.close();
+
+    SECTION(" Replay every reaction ","[UpdaterCycleRankCurve]")
+    {
+        UpdaterCycleRankCurve<IngredientsType> updater(ingredients, filename, "");
+        updater.initialize();
+        REQUIRE_FALSE(updater.execute());
+        const std::vector< std::vector<double> >& results(updater.getResults());
+        REQUIRE(results.size()==8);
+        REQUIRE(results[0].size()==13);
+        //no wrapping component after the first strand
+        REQUIRE(results[4][2]==0);
+        REQUIRE(results[5][2]==0);
+        //the second strand crosses the periodic box 
+        REQUIRE(results[0][4]==40);
+        REQUIRE(results[2][4]==2);
+        REQUIRE(results[3][4]==2);
+        REQUIRE(results[4][4]==1);
+        REQUIRE(results[5][4]==1);
+        //the finite cycle of C and D is left out
+        REQUIRE(results[2][8]==2);
+        REQUIRE(results[5][8]==1);
+        //the dangling crosslink E does not change the cycle rank
+        REQUIRE(results[2][10]==3);
+        REQUIRE(results[3][10]==3);
+        REQUIRE(results[5][10]==1);
+        //the last strand closes a cycle without wrapping
+        REQUIRE(results[1][12]==Approx(0.6));
+        REQUIRE(results[4][12]==1);
+        REQUIRE(results[5][12]==2);
+        REQUIRE(results[6][12]==Approx(2./4096.));
+        REQUIRE(results[7][12]==1);
+        REQUIRE(updater.getCycleRank()==2);
+    }
+
+    SECTION(" Conversion bins ","[UpdaterCycleRankCurve]")
+    {
+        UpdaterCycleRankCurve<IngredientsType> updater(ingredients, filename, "CycleRankCurveTest.dat", 0.25);
+        updater.initialize();
+        updater.execute();
+        const std::vector< std::vector<double> >& results(updater.getResults());
+        REQUIRE(results[0].size()==4);
+        REQUIRE(results[1][1]==Approx(0.25));
+        REQUIRE(results[5][1]==1);
+        REQUIRE(results[1][3]==Approx(0.6));
+        REQUIRE(results[5][3]==2);
+        REQUIRE(0==remove("CycleRankCurveTest.dat"));
+    }
+
+    SECTION(" Unknown reactions ","[UpdaterCycleRankCurve]")
+    {
+        std::ofstream wrong("cycleRankTableWrong.dat");
+        wrong << 10 << " " << 0 << " " << 20 << " 0 0 0 " << 0 << " 0 0 0\n";
+        wrong.close();
+        UpdaterCycleRankCurve<IngredientsType> updater(ingredients, "cycleRankTableWrong.dat", "");
+        updater.initialize();
+        REQUIRE_THROWS(updater.execute());
+        REQUIRE(0==remove("cycleRankTableWrong.dat"));
+    }
+    REQUIRE(0==remove(filename.c_str()));
+    //restore cout 
+    std::cout.rdbuf(originalBuffer);
+
+}
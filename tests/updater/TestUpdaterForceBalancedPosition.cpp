@@ -28,6 +28,11 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  *********************************************************************/
 #include <iostream>
 #include <exception>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <LeMonADE/core/Molecules.h>
 #include <LeMonADE/core/Ingredients.h>
@@ -44,6 +49,58 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE_PM/updater/moves/MoveForceEquilibrium.h>
 #include <LeMonADE_PM/updater/UpdaterForceBalancedPosition.h>
 
+namespace {
+  //! moves applied before InterruptedMove throws
+  uint32_t movesUntilInterrupt(0);
+  //! gaussian move which aborts the equilibration after movesUntilInterrupt moves
+  class InterruptedMove:public MoveForceEquilibrium{
+  public:
+    template<class IngredientsType> void apply(IngredientsType& ing){
+      if( movesUntilInterrupt == 0 )
+        throw std::runtime_error("InterruptedMove: interrupted");
+      movesUntilInterrupt--;
+      MoveForceEquilibrium::apply(ing);
+    }
+  };
+
+  //! cube of 8 crosslinks (f=3) joined by chains of one monomer, the crosslinks at z=0 are fixed
+  template<class IngredientsType>
+  void setupCube(IngredientsType& ingredients){
+    ingredients.setBoxX(32);
+    ingredients.setBoxY(32);
+    ingredients.setBoxZ(32);
+    ingredients.setPeriodicX(1);
+    ingredients.setPeriodicY(1);
+    ingredients.setPeriodicZ(1);
+    ingredients.setNumOfChains(12);
+    ingredients.setNumOfCrosslinks(8);
+    ingredients.setFunctionality(3);
+    ingredients.setNumOfMonomersPerChain(1);
+    ingredients.setNumOfMonomersPerCrosslink(1);
+    //chains in the middle of the edges
+    std::vector<std::pair<uint32_t,uint32_t> > edges;
+    for(uint32_t c=0; c<8; c++)
+      for(uint32_t bit=1; bit<8; bit*=2)
+        if( (c & bit) == 0 ){
+          VectorDouble3 a(8.+4.*(c&1),8.+2.*(c&2),8.+(c&4)), b(8.+4.*((c|bit)&1),8.+2.*((c|bit)&2),8.+((c|bit)&4));
+          VectorDouble3 middle((a+b)/2.);
+          ingredients.modifyMolecules().addMonomer(middle.getX(),middle.getY(),middle.getZ());
+          edges.push_back(std::make_pair(c,c|bit));
+        }
+    //crosslinks, the upper ones are displaced from the equilibrium
+    for(uint32_t c=0; c<8; c++){
+      const double shift( (c&4) ? 1. : 0. );
+      ingredients.modifyMolecules().addMonomer(8.+4.*(c&1)+shift,8.+2.*(c&2)+shift,8.+(c&4));
+      ingredients.modifyMolecules()[12+c].setReactive(true);
+      ingredients.modifyMolecules()[12+c].setNumMaxLinks(3);
+      ingredients.modifyMolecules()[12+c].setMovableTag( (c&4) != 0 );
+    }
+    for(uint32_t e=0; e<edges.size(); e++){
+      ingredients.modifyMolecules().connect(e,12+edges[e].first);
+      ingredients.modifyMolecules().connect(e,12+edges[e].second);
+    }
+  }
+}
 
 
 
@@ -134,6 +191,55 @@ TEST_CASE( "Test class UpdaterForceBalancedPosition" )
         // REQUIRE(vec2.getY() == Approx(6.375));
         // REQUIRE(vec2.getZ() == Approx(5.8125));
     }
+    SECTION(" An interrupted equilibration is continued from the checkpoint ","[UpdaterForceBalancedPosition]")
+    {
+        const std::string filename("ForceBalancedPositionRestart.ckpt");
+        const std::string finishedFile("ForceBalancedPositionFinished.ckpt");
+        IngredientsType initial;
+        setupCube(initial);
+        initial.synchronize(initial);
+        REQUIRE(initial.getCrosslinkIDs().size()==8);
+
+        //uninterrupted run
+        IngredientsType reference(initial);
+        UpdaterForceBalancedPosition<IngredientsType,MoveForceEquilibrium> updater(reference, 1e-8);
+        updater.setSeed(17);
+        updater.setCheckpoint(finishedFile, 0);
+        updater.execute();
+
+        //run aborted in between two checkpoints
+        IngredientsType interrupted(initial);
+        UpdaterForceBalancedPosition<IngredientsType,InterruptedMove> interruptedUpdater(interrupted, 1e-8);
+        interruptedUpdater.setSeed(17);
+        interruptedUpdater.setCheckpoint(filename, 3);
+        movesUntilInterrupt=30;
+        REQUIRE_THROWS_AS(interruptedUpdater.execute(), std::runtime_error);
+
+        //restart with another seed, the state of the generator is part of the checkpoint
+        IngredientsType restarted(initial);
+        UpdaterForceBalancedPosition<IngredientsType,MoveForceEquilibrium> restartedUpdater(restarted, 1e-8);
+        restartedUpdater.setSeed(4711);
+        restartedUpdater.setRestart(filename);
+        restartedUpdater.execute();
+        REQUIRE(restartedUpdater.getConversionIndex()==1);
+        REQUIRE(restarted.getMolecules().getAge()==reference.getMolecules().getAge());
+        for(uint32_t i=0; i<initial.getMolecules().size(); i++)
+            REQUIRE(restarted.getMolecules()[i].getVector3D()==reference.getMolecules()[i].getVector3D());
+        //the crosslinks were moved at all
+        REQUIRE(reference.getMolecules()[16].getVector3D()!=initial.getMolecules()[16].getVector3D());
+
+        //a finished equilibration is only restored
+        IngredientsType finished(initial);
+        UpdaterForceBalancedPosition<IngredientsType,InterruptedMove> finishedUpdater(finished, 1e-8);
+        finishedUpdater.setRestart(finishedFile);
+        movesUntilInterrupt=0;
+        REQUIRE_NOTHROW(finishedUpdater.execute());
+        for(uint32_t i=0; i<initial.getMolecules().size(); i++)
+            REQUIRE(finished.getMolecules()[i].getVector3D()==reference.getMolecules()[i].getVector3D());
+
+        REQUIRE(0==remove(filename.c_str()));
+        REQUIRE(0==remove(finishedFile.c_str()));
+    }
     //restore cout 
     std::cout.rdbuf(originalBuffer);
 
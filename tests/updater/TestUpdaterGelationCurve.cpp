@@ -0,0 +1,154 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <fstream>
+#include <exception>
+
+#include <LeMonADE/core/Molecules.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureBox.h>
+#include <LeMonADE/feature/FeatureSystemInformationLinearMeltWithCrosslinker.h>
+
+#include <LeMonADE/utility/Vector3D.h>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/updater/UpdaterGelationCurve.h>
+#include <LeMonADE_PM/feature/FeatureCrosslinkConnectionsLookUp.h>
+
+
+TEST_CASE( "Test class UpdaterGelationCurve" ) 
+{
+    typedef LOKI_TYPELIST_3(FeatureBox, FeatureSystemInformationLinearMeltWithCrosslinker,FeatureCrosslinkConnectionsLookUp) Features;
+    typedef ConfigureSystem<VectorDouble3,Features,4> Config;
+    typedef Ingredients<Config> IngredientsType;
+
+    std::streambuf* originalBuffer;
+    std::ostringstream tempStream;
+    //redirect stdout 
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+
+    //prepare input file: the crosslinks 12 and 13 react with the ends of four chains 
+    const std::string filename("gelationTable.dat");
+    std::ofstream out(filename); 
+    out <<"# Time, ChainID, MonID1, P1X, P1Y, P1Z, MonID2, P2X, P2Y, P2Z\n";
+    out << 10 << " " << 0 << " " << 12 << " 0 0 0 " << 0 << " 0 0 0\n";
+    out << 20 << " " << 1 << " " << 12 << " 0 0 0 " << 0 << " 0 0 0\n";
+    out << 30 << " " << 0 << " " << 13 << " 0 0 0 " << 0 << " 0 0 0\n";
+    out << 40 << " " << 2 << " " << 13 << " 0 0 0 " << 0 << " 0 0 0\n";
+    out << 50 << " " << 2 << " " << 0  << " 0 0 0 " << 12 << " 0 0 0\n";
+    out << 60 << " " << 3 << " " << 13 << " 0 0 0 " << 0 << " 0 0 0\n";
+    out << 70 << " " << 1 << " " << 13 << " 0 0 0 " << 0 << " 0 0 0\n";
+    out << 80 << " " << 3 << " " << 12 << " 0 0 0 " << 0 << " 0 0 0\n";
+    out.close();
+
+    //final network: four chains of three monomers, both ends bonded to the crosslinks
+    IngredientsType ingredients;
+    ingredients.setBoxX(16);
+    ingredients.setBoxY(16);
+    ingredients.setBoxZ(16);
+    ingredients.setPeriodicX(1);
+    ingredients.setPeriodicY(1);
+    ingredients.setPeriodicZ(1);
+    ingredients.setNumOfChains(4);
+    ingredients.setNumOfCrosslinks(2);
+    ingredients.setFunctionality(4);
+    ingredients.setNumOfMonomersPerChain(3);
+    ingredients.setNumOfMonomersPerCrosslink(1);
+    for(uint32_t i=0; i < 14; i++)
+        ingredients.modifyMolecules().addMonomer(6.,6.,6.);
+    for(uint32_t c=0; c < 4; c++){
+        ingredients.modifyMolecules().connect(3*c,3*c+1);
+        ingredients.modifyMolecules().connect(3*c+1,3*c+2);
+        ingredients.modifyMolecules()[3*c].setReactive(true);
+        ingredients.modifyMolecules()[3*c].setNumMaxLinks(2);
+        ingredients.modifyMolecules()[3*c+2].setReactive(true);
+        ingredients.modifyMolecules()[3*c+2].setNumMaxLinks(2);
+        ingredients.modifyMolecules().connect(12,3*c);
+        ingredients.modifyMolecules().connect(13,3*c+2);
+    }
+    for(uint32_t i=12; i < 14; i++){
+        ingredients.modifyMolecules()[i].setReactive(true); 
+        ingredients.modifyMolecules()[i].setNumMaxLinks(4); 
+    }
+
+    SECTION(" Replay every reaction ","[UpdaterGelationCurve]")
+    {
+        UpdaterGelationCurve<IngredientsType> updater(ingredients, filename, "");
+        updater.initialize();
+        REQUIRE(updater.getClusters().getNumClusters()==6);
+        REQUIRE_FALSE(updater.execute());
+        const std::vector< std::vector<double> >& results(updater.getResults());
+        REQUIRE(results.size()==7);
+        REQUIRE(results[0].size()==9);
+        REQUIRE(results[0][4]==40);
+        REQUIRE(results[1][4]==Approx(0.5));
+        //molecules of 11 and 3 monomers
+        REQUIRE(results[2][4]==2);
+        REQUIRE(results[3][4]==Approx(7.));
+        REQUIRE(results[4][4]==Approx(130./14.));
+        REQUIRE(results[5][4]==Approx(3.));
+        REQUIRE(results[6][4]==Approx(11./14.));
+        //the fifth reaction closes a loop
+        REQUIRE(results[2][5]==2);
+        REQUIRE(results[6][8]==Approx(1.));
+        //first maximum of the reduced weight average
+        REQUIRE(updater.getGelPoint()==Approx(0.375));
+    }
+
+    SECTION(" Conversion bins ","[UpdaterGelationCurve]")
+    {
+        UpdaterGelationCurve<IngredientsType> updater(ingredients, filename, "GelationCurveTest.dat", 0.25);
+        updater.initialize();
+        updater.execute();
+        const std::vector< std::vector<double> >& results(updater.getResults());
+        REQUIRE(results[0].size()==5);
+        REQUIRE(results[1][1]==Approx(0.25));
+        REQUIRE(results[1][4]==Approx(1.));
+        REQUIRE(updater.getGelPoint()==Approx(0.5));
+        REQUIRE(0==remove("GelationCurveTest.dat"));
+    }
+
+    SECTION(" Unknown reactions ","[UpdaterGelationCurve]")
+    {
+        std::ofstream wrong("gelationTableWrong.dat");
+        wrong << 10 << " " << 0 << " " << 13 << " 0 0 0 " << 0 << " 0 0 0\n";
+        wrong << 20 << " " << 0 << " " << 13 << " 0 0 0 " << 0 << " 0 0 0\n";
+        wrong.close();
+        UpdaterGelationCurve<IngredientsType> updater(ingredients, "gelationTableWrong.dat", "");
+        updater.initialize();
+        REQUIRE_THROWS(updater.execute());
+        REQUIRE(0==remove("gelationTableWrong.dat"));
+    }
+    REQUIRE(0==remove(filename.c_str()));
+    //restore cout 
+    std::cout.rdbuf(originalBuffer);
+
+}
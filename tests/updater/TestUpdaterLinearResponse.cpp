@@ -0,0 +1,173 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <exception>
+#include <cmath>
+
+#include <LeMonADE/core/Molecules.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureBox.h>
+
+#include <LeMonADE/utility/Vector3D.h>
+#include <LeMonADE/feature/FeatureSystemInformationLinearMeltWithCrosslinker.h>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/feature/FeatureCrosslinkConnectionsLookUp.h>
+#include <LeMonADE_PM/feature/FeatureFixedMonomers.h>
+#include <LeMonADE_PM/updater/moves/MoveForceEquilibrium.h>
+#include <LeMonADE_PM/updater/UpdaterStrainSweep.h>
+#include <LeMonADE_PM/updater/UpdaterLinearResponse.h>
+#include <LeMonADE_PM/utility/DeformationTensor.h>
+
+
+//! one movable crosslink connected to four fixed crosslinks 
+template<class IngredientsType>
+void setupStar(IngredientsType& ingredients)
+{
+    ingredients.setBoxX(16);
+    ingredients.setBoxY(16);
+    ingredients.setBoxZ(16);
+    ingredients.setPeriodicX(1);
+    ingredients.setPeriodicY(1);
+    ingredients.setPeriodicZ(1);
+    ingredients.modifyMolecules().addMonomer(6.,6.,6.);
+    ingredients.modifyMolecules().addMonomer(6.,4.,6.);
+    ingredients.modifyMolecules().addMonomer(6.,8.,6.);
+    ingredients.modifyMolecules().addMonomer(4.,6.,6.);
+    ingredients.modifyMolecules().addMonomer(8.,6.,6.);
+    for(uint32_t i=1; i < 5; i++ )
+        ingredients.modifyMolecules().connect(0,i);
+    //dangling ends give the fixed crosslinks three bonds 
+    for(uint32_t i=1; i < 5; i++ ){
+        VectorDouble3 pos(ingredients.getMolecules()[i].getVector3D());
+        ingredients.modifyMolecules().addMonomer(pos.getX(),pos.getY(),pos.getZ());
+        ingredients.modifyMolecules().connect(i,ingredients.getMolecules().size()-1);
+        ingredients.modifyMolecules().addMonomer(pos.getX(),pos.getY(),pos.getZ());
+        ingredients.modifyMolecules().connect(i,ingredients.getMolecules().size()-1);
+    }
+    ingredients.modifyMolecules()[0].setReactive(true); 
+    ingredients.modifyMolecules()[0].setNumMaxLinks(4); 
+    for(uint32_t i=1; i < 5; i++ ){
+        ingredients.modifyMolecules()[i].setReactive(true); 
+        ingredients.modifyMolecules()[i].setNumMaxLinks(3); 
+    }
+    for(uint32_t i=1; i < ingredients.getMolecules().size(); i++ )
+        ingredients.modifyMolecules()[i].setMovableTag(false);
+    ingredients.modifyMolecules()[0].setAllCoordinates(6.5,5.,7.);
+    REQUIRE_NOTHROW(ingredients.synchronize(ingredients));
+}
+
+TEST_CASE( "Test class UpdaterLinearResponse" ) 
+{
+    typedef LOKI_TYPELIST_4(FeatureBox, FeatureCrosslinkConnectionsLookUp,FeatureFixedMonomers,FeatureSystemInformationLinearMeltWithCrosslinker ) Features;
+    typedef ConfigureSystem<VectorDouble3,Features,4> Config;
+    typedef Ingredients<Config> IngredientsType;
+
+    std::streambuf* originalBuffer;
+    std::ostringstream tempStream;
+    //redirect stdout 
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+
+    SECTION(" Compare the linear response to the strain sweep ","[UpdaterLinearResponse]")
+    {
+        IngredientsType ingredients, ingredients2;
+        setupStar(ingredients);
+        setupStar(ingredients2);
+
+        std::vector<DeformationTensor> deformations;
+        deformations.push_back(DeformationTensor::uniaxial(2.0));
+        deformations.push_back(DeformationTensor::shear(0.3));
+        deformations.push_back(DeformationTensor::biaxial(1.3));
+        deformations.push_back(DeformationTensor::uniaxial(1.5));
+        UpdaterLinearResponse<IngredientsType> response(ingredients,deformations,1.E-10,"LinearResponseTest.dat");
+        response.execute();
+        const std::vector< std::vector<double> >& results(response.getResults());
+        REQUIRE(results.size()==10);
+        REQUIRE(results[0].size()==deformations.size());
+        const double k(3./(2.68*2.68));
+        const double volume(16.*16.*16.);
+        //uniaxial: two strands along x with length 2 lambda and two along y with length 2/sqrt(lambda)
+        REQUIRE(results[1][0]==DeformationTensor::UNIAXIAL);
+        REQUIRE(results[3][0]==Approx(2.*k*4.*4./volume));
+        REQUIRE(results[4][0]==Approx(2.*k*4./2./volume));
+        //shear: sigma_xy = gamma M_yy/V 
+        REQUIRE(results[6][1]==Approx(0.3*2.*k*4./volume));
+        REQUIRE(results[9][1]==Approx(2.*k*4./volume));
+
+        //same result as the full equilibration 
+        std::vector<double> lambdas(1,1.5);
+        UpdaterStrainSweep<IngredientsType,MoveForceEquilibrium> sweep(ingredients2,lambdas,1.E-10,1.0,"LinearResponseSweepTest.dat");
+        sweep.execute();
+        for(size_t a=0; a < 6; a++ )
+            REQUIRE(results[3+a][3]==Approx(sweep.getResults()[1+a][0]).margin(1.E-10));
+        REQUIRE(results[9][3]==Approx(sweep.getResults()[7][0]));
+        //the system is left in the last deformation 
+        for(size_t i=0; i < ingredients.getMolecules().size(); i++ ){
+            REQUIRE(ingredients.getMolecules()[i].getX()==Approx(ingredients2.getMolecules()[i].getX()));
+            REQUIRE(ingredients.getMolecules()[i].getY()==Approx(ingredients2.getMolecules()[i].getY()));
+            REQUIRE(ingredients.getMolecules()[i].getZ()==Approx(ingredients2.getMolecules()[i].getZ()));
+        }
+        remove("LinearResponseTest.dat");
+        remove("LinearResponseSweepTest.dat");
+    }
+
+    SECTION(" The prestrain changes the volume ","[UpdaterLinearResponse]")
+    {
+        IngredientsType ingredients, ingredients2;
+        setupStar(ingredients);
+        setupStar(ingredients2);
+        //the prestrain doubles the volume, the box is not changed 
+        UpdaterAffineDeformation<IngredientsType>(ingredients,1.0,2.0,1.0,1.0).execute();
+        UpdaterAffineDeformation<IngredientsType>(ingredients2,1.0,2.0,1.0,1.0).execute();
+
+        std::vector<DeformationTensor> deformations(1,DeformationTensor::uniaxial(1.0));
+        UpdaterLinearResponse<IngredientsType> response(ingredients,deformations,1.E-10,"LinearResponseTest.dat");
+        response.setPrestrain(2.0,1.0,1.0);
+        response.execute();
+        const double k(3./(2.68*2.68));
+        const double volume(2.*16.*16.*16.);
+        //two strands along x with length 4 and two along y with length 2
+        REQUIRE(response.getResults()[3][0]==Approx(2.*k*4.*4./volume));
+        REQUIRE(response.getResults()[4][0]==Approx(2.*k*2.*2./volume));
+        REQUIRE(response.getResults()[5][0]==Approx(0.).margin(1.E-12));
+
+        std::vector<double> lambdas(1,1.0);
+        UpdaterStrainSweep<IngredientsType,MoveForceEquilibrium> sweep(ingredients2,lambdas,1.E-10,1.0,"LinearResponseSweepTest.dat");
+        sweep.setPrestrain(2.0,1.0,1.0);
+        sweep.execute();
+        for(size_t a=0; a < 6; a++ )
+            REQUIRE(response.getResults()[3+a][0]==Approx(sweep.getResults()[1+a][0]).margin(1.E-10));
+        remove("LinearResponseTest.dat");
+        remove("LinearResponseSweepTest.dat");
+    }
+    //restore cout 
+    std::cout.rdbuf(originalBuffer);
+
+}
@@ -0,0 +1,245 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <exception>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <LeMonADE/core/Molecules.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureBox.h>
+
+#include <LeMonADE/utility/Vector3D.h>
+#include <LeMonADE/feature/FeatureSystemInformationLinearMeltWithCrosslinker.h>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/feature/FeatureCrosslinkConnectionsLookUp.h>
+#include <LeMonADE_PM/feature/FeatureFixedMonomers.h>
+#include <LeMonADE_PM/updater/moves/MoveForceEquilibrium.h>
+#include <LeMonADE_PM/updater/UpdaterStrainSweep.h>
+
+namespace {
+  //! one movable crosslink connected to four fixed crosslinks 
+  template<class IngredientsType>
+  void setupStar(IngredientsType& ingredients){
+    ingredients.setBoxX(16);
+    ingredients.setBoxY(16);
+    ingredients.setBoxZ(16);
+    ingredients.setPeriodicX(1);
+    ingredients.setPeriodicY(1);
+    ingredients.setPeriodicZ(1);
+    ingredients.modifyMolecules().addMonomer(6.,6.,6.);
+    ingredients.modifyMolecules().addMonomer(6.,4.,6.);
+    ingredients.modifyMolecules().addMonomer(6.,8.,6.);
+    ingredients.modifyMolecules().addMonomer(4.,6.,6.);
+    ingredients.modifyMolecules().addMonomer(8.,6.,6.);
+    for(uint32_t i=1; i < 5; i++ )
+      ingredients.modifyMolecules().connect(0,i);
+    //dangling ends give the fixed crosslinks three bonds 
+    for(uint32_t i=1; i < 5; i++ ){
+      VectorDouble3 pos(ingredients.getMolecules()[i].getVector3D());
+      ingredients.modifyMolecules().addMonomer(pos.getX(),pos.getY(),pos.getZ());
+      ingredients.modifyMolecules().connect(i,ingredients.getMolecules().size()-1);
+      ingredients.modifyMolecules().addMonomer(pos.getX(),pos.getY(),pos.getZ());
+      ingredients.modifyMolecules().connect(i,ingredients.getMolecules().size()-1);
+    }
+    ingredients.modifyMolecules()[0].setReactive(true); 
+    ingredients.modifyMolecules()[0].setNumMaxLinks(4); 
+    for(uint32_t i=1; i < 5; i++ ){
+      ingredients.modifyMolecules()[i].setReactive(true); 
+      ingredients.modifyMolecules()[i].setNumMaxLinks(3); 
+    }
+    for(uint32_t i=1; i < ingredients.getMolecules().size(); i++ )
+      ingredients.modifyMolecules()[i].setMovableTag(false);
+    ingredients.modifyMolecules()[0].setAllCoordinates(6.5,5.,7.);
+  }
+
+  //! gaussian move which aborts the equilibration after the first sweep
+  class InterruptedMove:public MoveForceEquilibrium{
+  public:
+    template<class IngredientsType> bool check(IngredientsType& ing){
+      if( ing.getMolecules().getAge() > 0 )
+        throw std::runtime_error("InterruptedMove: interrupted");
+      return MoveForceEquilibrium::check(ing);
+    }
+  };
+
+  //! stretching factors of the data rows (lines without #) in the output file
+  std::vector<double> readLambdas(const std::string& filename){
+    std::ifstream in(filename.c_str());
+    std::vector<double> lambdas;
+    std::string line;
+    while( std::getline(in,line) ){
+      if( line.empty() || line[0] == '#' ) continue;
+      std::stringstream ss(line);
+      double lambda;
+      ss >> lambda;
+      lambdas.push_back(lambda);
+    }
+    return lambdas;
+  }
+}
+
+
+TEST_CASE( "Test class UpdaterStrainSweep" ) 
+{
+    typedef LOKI_TYPELIST_4(FeatureBox, FeatureCrosslinkConnectionsLookUp,FeatureFixedMonomers,FeatureSystemInformationLinearMeltWithCrosslinker ) Features;
+    typedef ConfigureSystem<VectorDouble3,Features,4> Config;
+    typedef Ingredients<Config> IngredientsType;
+
+    std::streambuf* originalBuffer;
+    std::ostringstream tempStream;
+    //redirect stdout 
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+
+    SECTION(" Check the modulus ","[UpdaterStrainSweep]")
+    {
+        std::vector<double> stress(6,0.);
+        stress[0]=3.; stress[1]=1.; stress[2]=1.;
+        REQUIRE(UpdaterStrainSweep<IngredientsType,MoveForceEquilibrium>::calculateModulus(stress,2.)==Approx(2./3.5));
+        REQUIRE(std::isnan(UpdaterStrainSweep<IngredientsType,MoveForceEquilibrium>::calculateModulus(stress,1.)));
+    }
+
+    SECTION(" Sweep over the stretching factors ","[UpdaterStrainSweep]")
+    {
+        IngredientsType ingredients;
+        setupStar(ingredients);
+        REQUIRE_NOTHROW(ingredients.synchronize(ingredients));
+
+        std::vector<double> lambdas;
+        lambdas.push_back(1.0);
+        lambdas.push_back(1.2);
+        lambdas.push_back(1.5);
+        lambdas.push_back(2.0);
+        UpdaterStrainSweep<IngredientsType,MoveForceEquilibrium> sweep(ingredients,lambdas,1.E-8,1.0,"StrainSweepTest.dat");
+        //the movable crosslink is picked in the first sweep
+        sweep.getForceUpdater().setSeed(3);
+        sweep.execute();
+        const std::vector< std::vector<double> >& results(sweep.getResults());
+        REQUIRE(results.size()==8);
+        REQUIRE(results[0].size()==lambdas.size());
+        const double k(3./(2.68*2.68));
+        const double volume(16.*16.*16.);
+        for(size_t i=0; i < lambdas.size(); i++ ){
+            double lambda(lambdas[i]);
+            REQUIRE(results[0][i]==lambda);
+            //two strands along x with length 2 lambda and two along y with length 2/sqrt(lambda)
+            REQUIRE(results[1][i]==Approx(2.*k*4.*lambda*lambda/volume));
+            REQUIRE(results[2][i]==Approx(2.*k*4./lambda/volume));
+            REQUIRE(results[3][i]==Approx(0.).margin(1.E-10));
+            REQUIRE(results[4][i]==Approx(0.).margin(1.E-10));
+        }
+        REQUIRE(std::isnan(results[7][0]));
+        REQUIRE(results[7][3]==Approx((results[1][3]-0.5*(results[2][3]+results[3][3]))/(4.-0.5)));
+        //the crosslink is in the center of the deformed neighbors
+        VectorDouble3 pos(ingredients.getMolecules()[0].getVector3D());
+        REQUIRE(pos.getX()==Approx(12.));
+        REQUIRE(pos.getY()==Approx(6./std::sqrt(2.)));
+        REQUIRE(pos.getZ()==Approx(6./std::sqrt(2.)));
+        //fixed crosslinks are deformed affinely
+        REQUIRE(ingredients.getMolecules()[4].getX()==Approx(16.));
+        REQUIRE(ingredients.getMolecules()[2].getY()==Approx(8./std::sqrt(2.)));
+        remove("StrainSweepTest.dat");
+    }
+    SECTION(" Restart the sweep from a checkpoint ","[UpdaterStrainSweep]")
+    {
+        std::vector<double> lambdas;
+        lambdas.push_back(1.0);
+        lambdas.push_back(1.2);
+        lambdas.push_back(1.5);
+        lambdas.push_back(2.0);
+        const std::string checkpointFile("StrainSweepTest.ckpt");
+
+        IngredientsType initial;
+        setupStar(initial);
+        initial.synchronize(initial);
+        IngredientsType reference(initial);
+        UpdaterStrainSweep<IngredientsType,MoveForceEquilibrium> sweep(reference,lambdas,1.E-8,1.0,"StrainSweepReference.dat");
+        sweep.getForceUpdater().setSeed(3);
+        sweep.execute();
+        REQUIRE(readLambdas("StrainSweepReference.dat")==lambdas);
+
+        //restart from the completed second step: the sweep was stopped after it
+        IngredientsType first(initial);
+        UpdaterStrainSweep<IngredientsType,MoveForceEquilibrium> firstSweep(first,std::vector<double>(lambdas.begin(),lambdas.begin()+2),1.E-8,1.0,"StrainSweepCompleted.dat");
+        firstSweep.getForceUpdater().setSeed(3);
+        firstSweep.setCheckpoint(checkpointFile,0);
+        firstSweep.execute();
+        IngredientsType completed(initial);
+        UpdaterStrainSweep<IngredientsType,MoveForceEquilibrium> completedSweep(completed,lambdas,1.E-8,1.0,"StrainSweepCompleted.dat");
+        completedSweep.setRestart(checkpointFile);
+        completedSweep.execute();
+        REQUIRE(completedSweep.getResults()[0].size()==2);
+        REQUIRE(readLambdas("StrainSweepCompleted.dat")==lambdas);
+        for(uint32_t i=0; i < initial.getMolecules().size(); i++ ){
+            REQUIRE(completed.getMolecules()[i].getX()==Approx(reference.getMolecules()[i].getX()));
+            REQUIRE(completed.getMolecules()[i].getY()==Approx(reference.getMolecules()[i].getY()));
+            REQUIRE(completed.getMolecules()[i].getZ()==Approx(reference.getMolecules()[i].getZ()));
+        }
+        //a completed checkpoint of the last step leaves nothing to do
+        IngredientsType finished(initial);
+        UpdaterStrainSweep<IngredientsType,MoveForceEquilibrium> lastSweep(finished,std::vector<double>(lambdas.begin(),lambdas.begin()+2),1.E-8,1.0,"StrainSweepCompleted.dat");
+        lastSweep.setRestart(checkpointFile);
+        lastSweep.execute();
+        REQUIRE(lastSweep.getResults()[0].empty());
+        REQUIRE(readLambdas("StrainSweepCompleted.dat")==lambdas);
+
+        //restart in the middle of the equilibration of the first step
+        IngredientsType interrupted(initial);
+        UpdaterStrainSweep<IngredientsType,InterruptedMove> interruptedSweep(interrupted,lambdas,1.E-8,1.0,"StrainSweepInterrupted.dat");
+        interruptedSweep.getForceUpdater().setSeed(3);
+        interruptedSweep.setCheckpoint(checkpointFile,1);
+        REQUIRE_THROWS_AS(interruptedSweep.execute(),std::runtime_error);
+        ForceEquilibriumCheckpoint checkpoint;
+        checkpoint.read(checkpointFile);
+        REQUIRE(checkpoint.getConversionIndex()==0);
+        REQUIRE(!checkpoint.isCompleted());
+        IngredientsType restarted(initial);
+        UpdaterStrainSweep<IngredientsType,MoveForceEquilibrium> restartedSweep(restarted,lambdas,1.E-8,1.0,"StrainSweepInterrupted.dat");
+        restartedSweep.setRestart(checkpointFile);
+        restartedSweep.execute();
+        REQUIRE(readLambdas("StrainSweepInterrupted.dat")==lambdas);
+        for(uint32_t i=0; i < initial.getMolecules().size(); i++ )
+            REQUIRE(restarted.getMolecules()[i].getX()==Approx(reference.getMolecules()[i].getX()));
+
+        REQUIRE(0==remove("StrainSweepReference.dat"));
+        REQUIRE(0==remove("StrainSweepCompleted.dat"));
+        REQUIRE(0==remove("StrainSweepInterrupted.dat"));
+        REQUIRE(0==remove(checkpointFile.c_str()));
+    }
+    //restore cout 
+    std::cout.rdbuf(originalBuffer);
+
+}
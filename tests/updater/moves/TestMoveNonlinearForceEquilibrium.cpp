@@ -28,6 +28,7 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  *********************************************************************/
 #include <iostream>
 #include <exception>
+#include <stdexcept>
 
 #include <LeMonADE/core/Molecules.h>
 #include <LeMonADE/core/Ingredients.h>
@@ -75,8 +76,8 @@ TEST_CASE( "Test class MoveNonLinearForceEquilibrium" )
         MoveNonLinearForceEquilibrium move(filename); 
         REQUIRE(move.EF(VectorDouble3( 0.0,0.,0.)).getLength()==Approx(0.));
         REQUIRE(move.EF(VectorDouble3( 5.0,0.,0.)).getLength()==Approx(0.06526370015));
-        REQUIRE(move.EF(VectorDouble3( 5.4,0.,0.)).getLength()==Approx(0.06526370015));
-        REQUIRE(move.EF(VectorDouble3( 4.6,0.,0.)).getLength()==Approx(0.06526370015));
+        REQUIRE(move.EF(VectorDouble3( 5.4,0.,0.)).getLength()==Approx(0.07048479616));
+        REQUIRE(move.EF(VectorDouble3( 4.6,0.,0.)).getLength()==Approx(0.06004260414));
         REQUIRE(0==remove(filename.c_str()));    
     }
     SECTION ("Check the reading of a file2", "[MoveNonLinearForceEquilibrium_READIN2]")
@@ -95,8 +96,8 @@ TEST_CASE( "Test class MoveNonLinearForceEquilibrium" )
         MoveNonLinearForceEquilibrium move(filename); 
         REQUIRE(move.EF(VectorDouble3( 0.0,0.,0.)).getLength()==Approx(0.));
         REQUIRE(move.EF(VectorDouble3( 5.0,0.,0.)).getLength()==Approx(0.06526370015));
-        REQUIRE(move.EF(VectorDouble3( 5.4,0.,0.)).getLength()==Approx(0.06526370015));
-        REQUIRE(move.EF(VectorDouble3( 4.6,0.,0.)).getLength()==Approx(0.06526370015));
+        REQUIRE(move.EF(VectorDouble3( 5.4,0.,0.)).getLength()==Approx(0.07048479616));
+        REQUIRE(move.EF(VectorDouble3( 4.6,0.,0.)).getLength()==Approx(0.06004260414));
         REQUIRE(0==remove(filename.c_str()));    
     }
     SECTION ("Check the reading of a file3", "[MoveNonLinearForceEquilibrium_READIN3]")
@@ -115,10 +116,104 @@ TEST_CASE( "Test class MoveNonLinearForceEquilibrium" )
         MoveNonLinearForceEquilibrium move(filename); 
         REQUIRE(move.EF(VectorDouble3( 0.0,0.,0.)).getLength()==Approx(0.));
         REQUIRE(move.EF(VectorDouble3( 5.0,0.,0.)).getLength()==Approx(0.06526370015));
-        REQUIRE(move.EF(VectorDouble3( 5.4,0.,0.)).getLength()==Approx(0.06526370015));
-        REQUIRE(move.EF(VectorDouble3( 4.6,0.,0.)).getLength()==Approx(0.06526370015));
+        REQUIRE(move.EF(VectorDouble3( 5.4,0.,0.)).getLength()==Approx(0.07048479616));
+        REQUIRE(move.EF(VectorDouble3( 4.6,0.,0.)).getLength()==Approx(0.06004260414));
         REQUIRE(0==remove(filename.c_str()));    
     }
+    SECTION ("Check the block evaluation", "[MoveNonLinearForceEquilibrium_BLOCK]")
+    {
+        //nonlinear curve which ends at an extension of 95
+        std::string filename("TanhCurve.dat");
+        std::ofstream out(filename);
+        out << "# force extension\n";
+        out << "\n";
+        for(auto i=0; i <100; i+=5 ){
+            //force extension :
+            out << std::tanh(static_cast<double>(i)/50.)  << "\t"<<i << "\n"; 
+        }
+        out.close();
+        MoveNonLinearForceEquilibrium move(filename); 
+        move.setRelaxationParameter(16.);
+        const uint32_t n(5);
+        double rx[n]={0.,  3., 10.,  94.99, 200.};
+        double ry[n]={0.,  4., 0.,   0.,    0.};
+        double rz[n]={0.,  0., 0.,   0.,    0.};
+        double fx[n], fy[n], fz[n];
+        move.EFBlock(rx,ry,rz,fx,fy,fz,n);
+        for(uint32_t i=0; i < n; i++ ){
+            VectorDouble3 force(move.EF(VectorDouble3(rx[i],ry[i],rz[i])));
+            REQUIRE(fx[i]==Approx(force.getX()));
+            REQUIRE(fy[i]==Approx(force.getY()));
+            REQUIRE(fz[i]==Approx(force.getZ()));
+        }
+        //no force for a vanishing extension
+        REQUIRE(fx[0]==0.);
+        //interpolated curve at the nodes and the direction of the extension
+        REQUIRE(fx[2]==Approx(std::tanh(0.2)));
+        REQUIRE(fy[1]/fx[1]==Approx(4./3.));
+        //the curve is monotone
+        REQUIRE(fx[3] < std::tanh(95./50.)+1e-10);
+        REQUIRE(fx[3] > std::tanh(90./50.));
+        //gaussian behaviour behind the last point of the curve 
+        REQUIRE(fx[4]==Approx(move.EFGauss(VectorDouble3(200.,0.,0.)).getX()));
+        REQUIRE(0==remove(filename.c_str()));    
+    }
+    SECTION ("Check the curves per segment count", "[MoveNonLinearForceEquilibrium_SEGMENTS]")
+    {
+        //reference curve for strands of 10 segments 
+        std::string filename("TanhCurve.dat");
+        std::ofstream out(filename);
+        for(auto i=0; i <100; i+=5 )
+            out << std::tanh(static_cast<double>(i)/50.)  << "\t"<<i << "\n"; 
+        out.close();
+        //own curve for strands of 7 segments 
+        std::string filename7("TanhCurve_7.dat");
+        out.open(filename7);
+        for(auto i=0; i <50; i+=5 )
+            out << 2.*std::tanh(static_cast<double>(i)/50.)  << "\t"<<i << "\n"; 
+        out.close();
+        MoveNonLinearForceEquilibrium move(filename); 
+        move.setRelaxationParameter(16.);
+        //without scaling all strands use the reference curve
+        REQUIRE(move.getTableRow(20)==0);
+        REQUIRE(move.EF(VectorDouble3(10.,0.,0.),20).getX()==Approx(std::tanh(0.2)));
+        //scaling rule f_N(R)=f_ref(R*Nref/N)
+        move.setReferenceSegments(10);
+        REQUIRE(move.getReferenceSegments()==10);
+        REQUIRE(move.EF(VectorDouble3(10.,0.,0.),10).getX()==Approx(std::tanh(0.2)));
+        REQUIRE(move.EF(VectorDouble3(20.,0.,0.),20).getX()==Approx(std::tanh(0.2)));
+        REQUIRE(move.EF(VectorDouble3(0.,5.,0.),5).getY()==Approx(std::tanh(0.2)));
+        //the table covers the scaled maximum extension
+        REQUIRE(move.EF(VectorDouble3(180.,0.,0.),20).getX()==Approx(std::tanh(1.8)));
+        REQUIRE(move.EF(VectorDouble3(0.,0.,60.),5).getZ()==Approx(move.EFGauss(VectorDouble3(0.,0.,60.)).getZ()));
+        //rows are build once and reused
+        uint32_t row(move.getTableRow(20));
+        REQUIRE(row > 0);
+        REQUIRE(move.getTableRow(20)==row);
+        //own curve files 
+        move.setSegmentFilenamePattern("TanhCurve_{N}.dat");
+        REQUIRE(move.getSegmentFilenamePattern()=="TanhCurve_{N}.dat");
+        REQUIRE(move.EF(VectorDouble3(10.,0.,0.),7).getX()==Approx(2.*std::tanh(0.2)));
+        //scaling rule for segment counts without own file 
+        REQUIRE(move.EF(VectorDouble3(20.,0.,0.),20).getX()==Approx(std::tanh(0.2)));
+        //block evaluation with one row per element 
+        const uint32_t n(3);
+        double rx[n]={10., 20., 10.};
+        double ry[n]={0.,  0.,  0.};
+        double rz[n]={0.,  0.,  0.};
+        double fx[n], fy[n], fz[n];
+        uint32_t rows[n]={move.getTableRow(10), move.getTableRow(20), move.getTableRow(7)};
+        move.EFBlock(rx,ry,rz,fx,fy,fz,n,rows);
+        REQUIRE(fx[0]==Approx(std::tanh(0.2)));
+        REQUIRE(fx[1]==Approx(std::tanh(0.2)));
+        REQUIRE(fx[2]==Approx(2.*std::tanh(0.2)));
+        //without the scaling rule a missing file is an error
+        move.setReferenceSegments(0);
+        REQUIRE(move.EF(VectorDouble3(10.,0.,0.),7).getX()==Approx(2.*std::tanh(0.2)));
+        REQUIRE_THROWS_AS(move.getTableRow(20),std::runtime_error);
+        REQUIRE(0==remove(filename.c_str()));    
+        REQUIRE(0==remove(filename7.c_str()));    
+    }
 
     //restore cout 
     std::cout.rdbuf(originalBuffer);
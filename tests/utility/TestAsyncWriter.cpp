@@ -0,0 +1,95 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <thread>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/utility/AsyncWriter.h>
+
+namespace {
+  //! appends the value to the output and waits a bit to let the queue fill 
+  struct SlowJob{
+    SlowJob(std::vector<int>& output_, std::mutex& mutex_, int value_):output(output_),mutex(mutex_),value(value_){}
+    void operator()() const {
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      std::lock_guard<std::mutex> lock(mutex);
+      output.push_back(value);
+    }
+    std::vector<int>& output;
+    std::mutex& mutex;
+    int value;
+  };
+  void failingJob(){ throw std::runtime_error("disk full"); }
+}
+
+TEST_CASE( "Test class AsyncWriter" ) 
+{
+    std::vector<int> output;
+    std::mutex mutex;
+
+    SECTION(" Jobs are done in order ","[AsyncWriter]")
+    {
+        AsyncWriter writer(2);
+        REQUIRE(writer.getMaxQueued()==2);
+        for(int i=0; i < 20; i++)
+            writer.submit(SlowJob(output,mutex,i));
+        writer.flush();
+        REQUIRE(output.size()==20);
+        for(int i=0; i < 20; i++)
+            REQUIRE(output[i]==i);
+    }
+
+    SECTION(" The destructor finishes the queue ","[AsyncWriter]")
+    {
+        {
+            AsyncWriter writer(5);
+            for(int i=0; i < 5; i++)
+                writer.submit(SlowJob(output,mutex,i));
+        }
+        REQUIRE(output.size()==5);
+    }
+
+    SECTION(" Errors are reported to the caller ","[AsyncWriter]")
+    {
+        AsyncWriter writer(1);
+        writer.submit(failingJob);
+        REQUIRE_THROWS_AS(writer.flush(),std::runtime_error);
+        //the error is reported once, the writer can be used further
+        REQUIRE_NOTHROW(writer.flush());
+        writer.submit(SlowJob(output,mutex,1));
+        writer.flush();
+        REQUIRE(output.size()==1);
+    }
+}
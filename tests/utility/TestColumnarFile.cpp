@@ -0,0 +1,132 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <exception>
+#include <fstream>
+#include <vector>
+#include <cstdio>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/utility/ColumnarFile.h>
+
+TEST_CASE( "Test class ColumnarFile" ) 
+{
+    std::vector<uint32_t> IDs;
+    std::vector<float> x;
+    std::vector<uint16_t> segments;
+    for(uint32_t i=0; i < 1000; i++){
+        IDs.push_back(3*i+1);
+        x.push_back(0.25f*i-10.f);
+        segments.push_back(i%37);
+    }
+
+    SECTION(" Write and read frames ","[ColumnarFile]")
+    {
+        {
+            ColumnarFileWriter writer("ColumnarTest.bin",false,64);
+            for(uint32_t frame=0; frame < 3; frame++){
+                writer.beginFrame(0.5+0.1*frame,1000*frame);
+                writer.writeColumn("strands","ID1",IDs);
+                writer.writeColumn("strands","x",x);
+                writer.writeColumn("strands","segments",segments);
+                writer.writeColumn("positions","ID",std::vector<uint32_t>(1,frame));
+                writer.endFrame();
+            }
+            REQUIRE(writer.getNumFrames()==3);
+            writer.close();
+        }
+        ColumnarFileReader reader("ColumnarTest.bin");
+        REQUIRE(reader.isIndexed());
+        REQUIRE(reader.getNumFrames()==3);
+        REQUIRE(reader.getKey(2)==Approx(0.7));
+        REQUIRE(reader.getMCS(1)==1000);
+        REQUIRE(reader.hasColumn(1,"strands","x"));
+        REQUIRE_FALSE(reader.hasColumn(1,"strands","y"));
+        REQUIRE(reader.getColumnType(0,"strands","segments")==ColumnarFile::UINT16);
+        REQUIRE(reader.readColumn<uint32_t>(2,"strands","ID1")==IDs);
+        REQUIRE(reader.readColumn<float>(1,"strands","x")==x);
+        REQUIRE(reader.readColumn<uint16_t>(0,"strands","segments")==segments);
+        REQUIRE(reader.readColumn<uint32_t>(2,"positions","ID")[0]==2);
+        //conversion to other types
+        std::vector<double> xd(reader.readColumn<double>(1,"strands","x"));
+        REQUIRE(xd.size()==x.size());
+        REQUIRE(xd[999]==Approx(0.25*999-10.));
+        REQUIRE(reader.readColumn<uint64_t>(0,"strands","segments")[36]==36);
+        REQUIRE_THROWS(reader.readColumn<float>(3,"strands","x"));
+        REQUIRE_THROWS(reader.readColumn<float>(0,"bonds","x"));
+        remove("ColumnarTest.bin");
+    }
+
+    SECTION(" Read a file without index ","[ColumnarFile]")
+    {
+        {
+            ColumnarFileWriter writer("ColumnarTest.bin");
+            writer.beginFrame(0.5,10);
+            writer.writeColumn("strands","ID1",IDs);
+            writer.endFrame();
+            writer.beginFrame(0.6,20);
+            writer.writeColumn("strands","ID1",IDs);
+            writer.endFrame();
+        }
+        //cut the index and a part of the second frame
+        std::ifstream in("ColumnarTest.bin",std::ios::binary);
+        std::vector<char> content((std::istreambuf_iterator<char>(in)),std::istreambuf_iterator<char>());
+        in.close();
+        size_t frameSize(4+8+8+4 + 4+2+7+2+3+1+8+4+4 + 1+8+8+4*IDs.size());
+        std::ofstream out("ColumnarTest.bin",std::ios::binary|std::ios::trunc);
+        out.write(&content[0],16+frameSize+100);
+        out.close();
+        ColumnarFileReader reader("ColumnarTest.bin");
+        REQUIRE_FALSE(reader.isIndexed());
+        REQUIRE(reader.getNumFrames()==1);
+        REQUIRE(reader.getMCS(0)==10);
+        REQUIRE(reader.readColumn<uint32_t>(0,"strands","ID1")==IDs);
+        remove("ColumnarTest.bin");
+    }
+
+    SECTION(" Compressed chunks ","[ColumnarFile]")
+    {
+        if( ColumnarFile::compressionAvailable() ){
+            {
+                ColumnarFileWriter writer("ColumnarTest.bin",true,100);
+                writer.beginFrame(1.,0);
+                writer.writeColumn("strands","segments",segments);
+                writer.writeColumn("strands","x",x);
+                writer.close();
+            }
+            ColumnarFileReader reader("ColumnarTest.bin");
+            REQUIRE(reader.readColumn<uint16_t>(0,"strands","segments")==segments);
+            REQUIRE(reader.readColumn<float>(0,"strands","x")==x);
+            remove("ColumnarTest.bin");
+        }else{
+            REQUIRE_THROWS(ColumnarFileWriter("ColumnarTest.bin",true));
+        }
+    }
+}
@@ -0,0 +1,110 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <exception>
+#include <cmath>
+
+#include <LeMonADE/utility/Vector3D.h>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/utility/DeformationTensor.h>
+
+TEST_CASE( "Test class DeformationTensor" ) 
+{
+    SECTION(" Check the factories ","[DeformationTensor]")
+    {
+        DeformationTensor identity;
+        REQUIRE(identity.determinant()==Approx(1.));
+        REQUIRE(identity.getType()==DeformationTensor::GENERAL);
+
+        DeformationTensor uniaxial(DeformationTensor::uniaxial(4.));
+        REQUIRE(uniaxial.getType()==DeformationTensor::UNIAXIAL);
+        REQUIRE(uniaxial.getParameter()==4.);
+        REQUIRE(uniaxial(0,0)==Approx(4.));
+        REQUIRE(uniaxial(1,1)==Approx(0.5));
+        REQUIRE(uniaxial(2,2)==Approx(0.5));
+        REQUIRE(uniaxial.determinant()==Approx(1.));
+
+        DeformationTensor biaxial(DeformationTensor::biaxial(2.));
+        REQUIRE(biaxial(1,1)==Approx(2.));
+        REQUIRE(biaxial(2,2)==Approx(0.25));
+        REQUIRE(biaxial.determinant()==Approx(1.));
+
+        DeformationTensor shear(DeformationTensor::shear(0.5));
+        VectorDouble3 v(shear.apply(VectorDouble3(1.,2.,3.)));
+        REQUIRE(v.getX()==Approx(2.));
+        REQUIRE(v.getY()==Approx(2.));
+        REQUIRE(v.getZ()==Approx(3.));
+        REQUIRE(shear.determinant()==Approx(1.));
+
+        DeformationTensor product(uniaxial*DeformationTensor::diagonal(1.,2.,3.));
+        REQUIRE(product.getType()==DeformationTensor::GENERAL);
+        REQUIRE(product(2,2)==Approx(1.5));
+        REQUIRE(product.determinant()==Approx(6.));
+
+        REQUIRE_THROWS(DeformationTensor::uniaxial(-1.));
+    }
+
+    SECTION(" Check the parser ","[DeformationTensor]")
+    {
+        REQUIRE(DeformationTensor::parse("uniaxial:2").getType()==DeformationTensor::UNIAXIAL);
+        REQUIRE(DeformationTensor::parse("biaxial:1.5").getParameter()==1.5);
+        REQUIRE(DeformationTensor::parse("shear:0.1")(0,1)==Approx(0.1));
+        DeformationTensor prestrain(DeformationTensor::parse("prestrain:1.1:1.2:1.3"));
+        REQUIRE(prestrain(0,0)==Approx(1.1));
+        REQUIRE(prestrain(1,1)==Approx(1.2));
+        REQUIRE(prestrain(2,2)==Approx(1.3));
+        REQUIRE_THROWS(DeformationTensor::parse("uniaxial"));
+        REQUIRE_THROWS(DeformationTensor::parse("uniaxial:a"));
+        REQUIRE_THROWS(DeformationTensor::parse("twist:1"));
+        REQUIRE_THROWS(DeformationTensor::parse("prestrain:1:1"));
+    }
+
+    SECTION(" Check the transformation and the moduli ","[DeformationTensor]")
+    {
+        //isotropic tensor 
+        std::vector<double> M(6,0.);
+        M[0]=M[1]=M[2]=2.;
+        std::vector<double> stress(DeformationTensor::uniaxial(2.).transform(M));
+        REQUIRE(stress[0]==Approx(8.));
+        REQUIRE(stress[1]==Approx(1.));
+        REQUIRE(stress[2]==Approx(1.));
+        REQUIRE(stress[3]==Approx(0.));
+        REQUIRE(DeformationTensor::uniaxial(2.).modulus(stress)==Approx(2.));
+        stress=DeformationTensor::biaxial(2.).transform(M);
+        REQUIRE(DeformationTensor::biaxial(2.).modulus(stress)==Approx(2.));
+        stress=DeformationTensor::shear(0.3).transform(M);
+        REQUIRE(stress[0]==Approx(2.*(1.+0.09)));
+        REQUIRE(stress[3]==Approx(0.6));
+        REQUIRE(DeformationTensor::shear(0.3).modulus(stress)==Approx(2.));
+        REQUIRE(std::isnan(DeformationTensor::uniaxial(1.).modulus(M)));
+        REQUIRE(std::isnan(DeformationTensor::diagonal(1.,2.,3.).modulus(M)));
+    }
+}
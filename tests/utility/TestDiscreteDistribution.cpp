@@ -0,0 +1,123 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/utility/DiscreteDistribution.h>
+
+TEST_CASE( "Test class DiscreteDistribution" ) 
+{
+    std::streambuf* originalBuffer;
+    std::ostringstream tempStream;
+    //redirect stdout 
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+
+    SECTION(" Invalid weights are rejected ","[DiscreteDistribution]")
+    {
+        DiscreteDistribution distribution;
+        std::mt19937 engine(1);
+        REQUIRE(distribution.empty());
+        REQUIRE_THROWS_AS(distribution(engine), std::runtime_error);
+        REQUIRE_THROWS_AS(distribution.setWeights(std::vector<double>()), std::runtime_error);
+        REQUIRE_THROWS_AS(distribution.setWeights(std::vector<double>(3,0.0)), std::runtime_error);
+        double negative[3]={1.0,-0.5,1.0};
+        REQUIRE_THROWS_AS(distribution.setWeights(std::vector<double>(negative,negative+3)), std::runtime_error);
+        double notFinite[2]={1.0,std::numeric_limits<double>::infinity()};
+        REQUIRE_THROWS_AS(distribution.setWeights(std::vector<double>(notFinite,notFinite+2)), std::runtime_error);
+        REQUIRE_THROWS_AS(DiscreteDistribution::convolve(distribution,distribution), std::runtime_error);
+    }
+
+    SECTION(" Weights are normalized and sampled without bias ","[DiscreteDistribution]")
+    {
+        double weights[6]={0.0,1.0,2.0,0.0,4.0,1.0};
+        DiscreteDistribution distribution(std::vector<double>(weights,weights+6));
+        REQUIRE(distribution.size()==6);
+        for(uint32_t k=0; k<6; k++)
+            REQUIRE(distribution.getProbability(k)==Approx(weights[k]/8.0));
+        REQUIRE(distribution.getProbability(6)==0.0);
+        REQUIRE(distribution.getMean()==Approx((1.0+4.0+16.0+5.0)/8.0));
+
+        std::mt19937 engine(42);
+        const uint32_t nDraws(400000);
+        std::vector<uint32_t> counts(7,0);
+        for(uint32_t n=0; n<nDraws; n++)
+            counts[std::min<uint32_t>(distribution(engine),6)]++;
+        REQUIRE(counts[6]==0);
+        REQUIRE(counts[0]==0);
+        REQUIRE(counts[3]==0);
+        //five standard deviations of the binomial distribution
+        for(uint32_t k=0; k<6; k++){
+            double p(weights[k]/8.0);
+            REQUIRE(std::fabs(counts[k]-nDraws*p) <= 5.0*std::sqrt(nDraws*p*(1.0-p)));
+        }
+        //the same seed gives the same values
+        std::mt19937 engine1(7), engine2(7);
+        for(uint32_t n=0; n<100; n++)
+            REQUIRE(distribution(engine1)==distribution(engine2));
+    }
+
+    SECTION(" The convolution is exact ","[DiscreteDistribution]")
+    {
+        //two dice with the values 0..5
+        DiscreteDistribution die(std::vector<double>(6,1.0));
+        DiscreteDistribution sum(DiscreteDistribution::convolve(die,die));
+        REQUIRE(sum.size()==11);
+        for(uint32_t k=0; k<11; k++)
+            REQUIRE(sum.getProbability(k)==Approx((6.0-std::fabs(k-5.0))/36.0));
+        REQUIRE(sum.getMean()==Approx(2.0*die.getMean()));
+
+        double shiftedWeights[3]={0.0,0.0,1.0};
+        DiscreteDistribution shifted(std::vector<double>(shiftedWeights,shiftedWeights+3));
+        DiscreteDistribution shiftedDie(DiscreteDistribution::convolve(die,shifted));
+        REQUIRE(shiftedDie.size()==8);
+        REQUIRE(shiftedDie.getProbability(1)==0.0);
+        for(uint32_t k=2; k<8; k++)
+            REQUIRE(shiftedDie.getProbability(k)==Approx(1.0/6.0));
+        std::mt19937 engine(3);
+        uint32_t minValue(8), maxValue(0);
+        for(uint32_t n=0; n<1000; n++){
+            uint32_t k(shiftedDie(engine));
+            minValue=std::min(minValue,k);
+            maxValue=std::max(maxValue,k);
+        }
+        REQUIRE(minValue==2);
+        REQUIRE(maxValue==7);
+    }
+    //restore cout 
+    std::cout.rdbuf(originalBuffer);
+}
@@ -0,0 +1,226 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <LeMonADE/core/Molecules.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureBox.h>
+#include <LeMonADE/feature/FeatureSystemInformationLinearMeltWithCrosslinker.h>
+#include <LeMonADE/utility/Vector3D.h>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/updater/UpdaterReadCrosslinkConnections.h>
+#include <LeMonADE_PM/utility/EndLinkedNetworkGenerator.h>
+
+namespace {
+  //! minimum image of a lattice difference
+  int32_t fold(int32_t d, int32_t box){
+    d%=box;
+    if( 2*d >  box ) d-=box;
+    if( 2*d < -box ) d+=box;
+    return d;
+  }
+  //! true if a and b are connected by a classic BFM bond vector (minimum image)
+  template<class MoleculesType>
+  bool isBond(const MoleculesType& molecules, uint32_t a, uint32_t b, int32_t box){
+    const VectorInt3 d(molecules[b].getVector3D()-molecules[a].getVector3D());
+    return EndLinkedNetworkGenerator::isBridgeable(fold(d.getX(),box),fold(d.getY(),box),fold(d.getZ(),box),1);
+  }
+}
+
+TEST_CASE( "Test class EndLinkedNetworkGenerator" ) 
+{
+    typedef LOKI_TYPELIST_2(FeatureBox, FeatureSystemInformationLinearMeltWithCrosslinker) Features;
+    typedef ConfigureSystem<VectorInt3,Features,7> Config;
+    typedef Ingredients<Config> IngredientsType;
+
+    SECTION(" Bridgeable displacements ","[EndLinkedNetworkGenerator]")
+    {
+        REQUIRE(EndLinkedNetworkGenerator::isBridgeable(0,0,0,0));
+        REQUIRE(!EndLinkedNetworkGenerator::isBridgeable(2,0,0,0));
+        REQUIRE(EndLinkedNetworkGenerator::isBridgeable(-3,1,0,1));
+        REQUIRE(EndLinkedNetworkGenerator::isBridgeable(2,2,1,1));
+        REQUIRE(!EndLinkedNetworkGenerator::isBridgeable(2,2,2,1));
+        REQUIRE(!EndLinkedNetworkGenerator::isBridgeable(1,0,0,1));
+        REQUIRE(EndLinkedNetworkGenerator::isBridgeable(0,0,0,2));
+        REQUIRE(EndLinkedNetworkGenerator::isBridgeable(1,0,0,2));
+        REQUIRE(EndLinkedNetworkGenerator::isBridgeable(4,3,0,2));
+        REQUIRE(!EndLinkedNetworkGenerator::isBridgeable(4,4,0,2));
+        REQUIRE(!EndLinkedNetworkGenerator::isBridgeable(5,0,0,2));
+        REQUIRE(EndLinkedNetworkGenerator::isBridgeable(-20,10,9,10));
+        REQUIRE(!EndLinkedNetworkGenerator::isBridgeable(-21,0,0,10));
+    }
+
+    SECTION(" Invalid parameters are rejected ","[EndLinkedNetworkGenerator]")
+    {
+        REQUIRE_THROWS_AS(EndLinkedNetworkGenerator(1,4,8),std::runtime_error);
+        REQUIRE_THROWS_AS(EndLinkedNetworkGenerator(10,2,8),std::runtime_error);
+        REQUIRE_THROWS_AS(EndLinkedNetworkGenerator(5,3,8),std::runtime_error);
+        REQUIRE_THROWS_AS(EndLinkedNetworkGenerator(10,4,0),std::runtime_error);
+        REQUIRE_THROWS_AS(EndLinkedNetworkGenerator(10,4,2),std::runtime_error);
+        REQUIRE_NOTHROW(EndLinkedNetworkGenerator(10,4,1));
+        EndLinkedNetworkGenerator generator(10,4,8);
+        IngredientsType ingredients;
+        REQUIRE_THROWS_AS(generator.copyTo(ingredients),std::runtime_error);
+    }
+
+    SECTION(" The network consists of valid bonds ","[EndLinkedNetworkGenerator]")
+    {
+        EndLinkedNetworkGenerator generator(200,4,8);
+        generator.setNumThreads(3);
+        generator.generate(7);
+        REQUIRE(generator.getNumOfChains()==400);
+        REQUIRE(generator.getNumOfMonomers()==3400);
+        REQUIRE(generator.getFirstCrosslink()==3200);
+        REQUIRE(generator.getBoxSize()%2==0);
+        REQUIRE(generator.getBoxSize()*generator.getBoxSize()*generator.getBoxSize()>=16*3400);
+        REQUIRE(generator.getConversion()>0.9);
+        REQUIRE(generator.getConnections().size()==static_cast<size_t>(generator.getConversion()*800+0.5));
+
+        IngredientsType ingredients;
+        generator.copyTo(ingredients);
+        const int32_t box(generator.getBoxSize());
+        REQUIRE(ingredients.getBoxX()==box);
+        REQUIRE(ingredients.getNumOfChains()==400);
+        REQUIRE(ingredients.getNumOfCrosslinks()==200);
+        REQUIRE(ingredients.getNumOfMonomersPerChain()==8);
+        REQUIRE(ingredients.getFunctionality()==4);
+        const auto& molecules(ingredients.getMolecules());
+        REQUIRE(molecules.size()==3400);
+        std::vector<uint32_t> links(200,0);
+        for(uint32_t chain=0; chain<400; chain++){
+            const uint32_t first(8*chain);
+            for(uint32_t k=first+1; k<first+8; k++)
+                REQUIRE(isBond(molecules,k-1,k,box));
+            REQUIRE(molecules[first].isReactive());
+            REQUIRE(molecules[first+7].isReactive());
+            REQUIRE(molecules[first+7].getNumMaxLinks()==2);
+            REQUIRE(!molecules[first+3].isReactive());
+            for(uint32_t end=0; end<2; end++){
+                const uint32_t crosslink(generator.getCrosslink(chain,end));
+                if( crosslink == EndLinkedNetworkGenerator::NO_CROSSLINK ) continue;
+                REQUIRE(crosslink!=generator.getCrosslink(chain,1-end));
+                REQUIRE(isBond(molecules,first+7*end,3200+crosslink,box));
+                links[crosslink]++;
+            }
+        }
+        for(uint32_t i=0; i<200; i++){
+            REQUIRE(molecules[3200+i].isReactive());
+            REQUIRE(molecules[3200+i].getNumMaxLinks()==4);
+            REQUIRE(molecules.getNumLinks(3200+i)==links[i]);
+            REQUIRE(links[i]<=4);
+        }
+    }
+
+    SECTION(" The network does not depend on the number of threads ","[EndLinkedNetworkGenerator]")
+    {
+        EndLinkedNetworkGenerator serial(3000,3,5), parallel(3000,3,5);
+        serial.setNumThreads(1);
+        parallel.setNumThreads(4);
+        serial.generate(11);
+        parallel.generate(11);
+        REQUIRE(serial.getConnections()==parallel.getConnections());
+        for(uint32_t i=0; i<serial.getNumOfMonomers(); i++)
+            REQUIRE(serial.getPosition(i)==parallel.getPosition(i));
+        parallel.generate(12);
+        REQUIRE(serial.getConnections()!=parallel.getConnections());
+    }
+
+    SECTION(" The local history grows from a point ","[EndLinkedNetworkGenerator]")
+    {
+        EndLinkedNetworkGenerator random(1000,4,16), local(1000,4,16);
+        local.setHistory(EndLinkedNetworkGenerator::LOCAL_HISTORY);
+        random.generate(3);
+        local.generate(3);
+        //same network, different order
+        REQUIRE(random.getConnections().size()==local.getConnections().size());
+        REQUIRE(random.getConnections()!=local.getConnections());
+        //the first half of the local connections uses fewer crosslinks
+        const size_t half(local.getConnections().size()/2);
+        std::vector<bool> usedRandom(1000,false), usedLocal(1000,false);
+        size_t nRandom(0), nLocal(0);
+        for(size_t t=0; t<half; t++){
+            const uint32_t a(random.getConnections()[t]), b(local.getConnections()[t]);
+            if( !usedRandom[random.getCrosslink(a/2,a%2)] ){ usedRandom[random.getCrosslink(a/2,a%2)]=true; nRandom++; }
+            if( !usedLocal[local.getCrosslink(b/2,b%2)] ){ usedLocal[local.getCrosslink(b/2,b%2)]=true; nLocal++; }
+        }
+        REQUIRE(nLocal<nRandom);
+    }
+
+    SECTION(" The connection table rebuilds the network ","[EndLinkedNetworkGenerator]")
+    {
+        std::streambuf* originalBuffer(std::cout.rdbuf());
+        std::ostringstream tempStream;
+        std::cout.rdbuf(tempStream.rdbuf());
+
+        EndLinkedNetworkGenerator generator(100,3,4);
+        generator.setHistory(EndLinkedNetworkGenerator::LOCAL_HISTORY);
+        generator.generate(5);
+        const std::string filename("EndLinkedNetworkConnections.dat");
+        generator.writeConnectionTable(filename);
+        {
+            std::ifstream in(filename.c_str());
+            std::string line;
+            uint32_t nLines(0);
+            while( std::getline(in,line) ){
+                std::stringstream ss(line);
+                uint32_t time, chain, monomer1, p1x, p1y, p1z, monomer2, p2x, p2y, p2z;
+                ss >> time >> chain >> monomer1 >> p1x >> p1y >> p1z >> monomer2 >> p2x >> p2y >> p2z;
+                REQUIRE(!ss.fail());
+                REQUIRE(time==++nLines);
+                const uint32_t end(generator.getConnections()[time-1]);
+                REQUIRE(chain==end/2);
+                REQUIRE(monomer1==generator.getFirstCrosslink()+generator.getCrosslink(chain,end%2));
+                REQUIRE(generator.getPosition(monomer1)==VectorInt3(p1x,p1y,p1z));
+            }
+            REQUIRE(nLines==generator.getConnections().size());
+        }
+        IngredientsType network;
+        generator.copyTo(network);
+        IngredientsType ingredients(network);
+        UpdaterReadCrosslinkConnections<IngredientsType> updater(ingredients, filename, 0., 1.);
+        updater.initialize();
+        for(uint32_t i=generator.getFirstCrosslink(); i<generator.getNumOfMonomers(); i++)
+            REQUIRE(ingredients.getMolecules().getNumLinks(i)==0);
+        updater.execute();
+        for(uint32_t i=0; i<generator.getNumOfMonomers(); i++){
+            REQUIRE(ingredients.getMolecules().getNumLinks(i)==network.getMolecules().getNumLinks(i));
+            for(uint32_t j=0; j<network.getMolecules().getNumLinks(i); j++)
+                REQUIRE(ingredients.getMolecules().areConnected(i,network.getMolecules().getNeighborIdx(i,j)));
+        }
+        REQUIRE(0==remove(filename.c_str()));
+        std::cout.rdbuf(originalBuffer);
+    }
+}
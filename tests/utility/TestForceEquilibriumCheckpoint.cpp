@@ -0,0 +1,202 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <LeMonADE/core/Molecules.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureBox.h>
+#include <LeMonADE/feature/FeatureSystemInformationLinearMeltWithCrosslinker.h>
+#include <LeMonADE/utility/Vector3D.h>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/feature/FeatureCrosslinkConnectionsLookUp.h>
+#include <LeMonADE_PM/utility/ForceEquilibriumCheckpoint.h>
+
+namespace {
+  //! two crosslinks (f=3) joined by three chains of one monomer
+  template<class IngredientsType>
+  void setupTheta(IngredientsType& ingredients){
+    ingredients.setBoxX(32);
+    ingredients.setBoxY(32);
+    ingredients.setBoxZ(32);
+    ingredients.setPeriodicX(1);
+    ingredients.setPeriodicY(1);
+    ingredients.setPeriodicZ(1);
+    ingredients.setNumOfChains(3);
+    ingredients.setNumOfCrosslinks(2);
+    ingredients.setFunctionality(3);
+    ingredients.setNumOfMonomersPerChain(1);
+    ingredients.setNumOfMonomersPerCrosslink(1);
+    //chains
+    ingredients.modifyMolecules().addMonomer(10.,8.,8.);
+    ingredients.modifyMolecules().addMonomer(10.,10.,8.);
+    ingredients.modifyMolecules().addMonomer(10.,8.,10.);
+    //crosslinks
+    ingredients.modifyMolecules().addMonomer(8.,8.,8.);
+    ingredients.modifyMolecules().addMonomer(12.,9.,9.);
+    for(uint32_t i=0; i<3; i++){
+      ingredients.modifyMolecules().connect(i,3);
+      ingredients.modifyMolecules().connect(i,4);
+    }
+    for(uint32_t i=3; i<5; i++){
+      ingredients.modifyMolecules()[i].setReactive(true);
+      ingredients.modifyMolecules()[i].setNumMaxLinks(3);
+    }
+  }
+}
+
+TEST_CASE( "Test class ForceEquilibriumCheckpoint" ) 
+{
+    typedef LOKI_TYPELIST_3(FeatureBox, FeatureCrosslinkConnectionsLookUp, FeatureSystemInformationLinearMeltWithCrosslinker) Features;
+    typedef ConfigureSystem<VectorDouble3,Features,4> Config;
+    typedef Ingredients<Config> IngredientsType;
+
+    std::streambuf* originalBuffer;
+    std::ostringstream tempStream;
+    //redirect stdout 
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+
+    const std::string filename("ForceEquilibriumCheckpointTest.ckpt");
+
+    SECTION(" Write and read a checkpoint ","[ForceEquilibriumCheckpoint]")
+    {
+        IngredientsType ingredients;
+        setupTheta(ingredients);
+        ingredients.synchronize(ingredients);
+        const std::vector<uint32_t> IDs(ingredients.getCrosslinkIDs());
+        REQUIRE(IDs.size()==2);
+
+        ForceEquilibriumCheckpoint checkpoint;
+        checkpoint.setConversionIndex(3);
+        checkpoint.setCompleted(true);
+        checkpoint.setStartAge(100);
+        checkpoint.setAge(142);
+        checkpoint.setRelaxationParameter(0.25);
+        checkpoint.setRngState("1 2 3 rng state");
+        checkpoint.store(ingredients,IDs);
+        checkpoint.write(filename);
+        //the temporary file is renamed
+        REQUIRE(!std::ifstream((filename+".tmp").c_str()).good());
+
+        ForceEquilibriumCheckpoint read;
+        read.read(filename);
+        REQUIRE(read.getConversionIndex()==3);
+        REQUIRE(read.isCompleted());
+        REQUIRE(read.getStartAge()==100);
+        REQUIRE(read.getAge()==142);
+        REQUIRE(read.getRelaxationParameter()==0.25);
+        REQUIRE(read.getRngState()=="1 2 3 rng state");
+        REQUIRE(read.getNumCrosslinks()==2);
+
+        //the positions of the crosslinks are restored
+        ingredients.modifyMolecules()[3].modifyVector3D()=VectorDouble3(1.5,2.,3.);
+        ingredients.modifyMolecules()[4].modifyVector3D()=VectorDouble3(-4.,5.,6.25);
+        read.restore(ingredients);
+        REQUIRE(ingredients.getMolecules()[3].getVector3D()==VectorDouble3(8.,8.,8.));
+        REQUIRE(ingredients.getMolecules()[4].getVector3D()==VectorDouble3(12.,9.,9.));
+        REQUIRE(0==remove(filename.c_str()));
+    }
+
+    SECTION(" Truncated and foreign files are rejected ","[ForceEquilibriumCheckpoint]")
+    {
+        IngredientsType ingredients;
+        setupTheta(ingredients);
+        ingredients.synchronize(ingredients);
+        ForceEquilibriumCheckpoint checkpoint;
+        checkpoint.setRngState("rng state");
+        checkpoint.store(ingredients,ingredients.getCrosslinkIDs());
+        checkpoint.write(filename);
+        std::string content;
+        {
+            std::ifstream in(filename.c_str(), std::ios::binary);
+            std::stringstream buffer;
+            buffer << in.rdbuf();
+            content=buffer.str();
+        }
+        //cut off a part of the positions
+        {
+            std::ofstream out(filename.c_str(), std::ios::binary | std::ios::trunc);
+            out.write(content.data(),content.size()-4);
+        }
+        ForceEquilibriumCheckpoint read;
+        REQUIRE_THROWS_AS(read.read(filename),std::runtime_error);
+        //header only
+        {
+            std::ofstream out(filename.c_str(), std::ios::binary | std::ios::trunc);
+            out.write(content.data(),10);
+        }
+        REQUIRE_THROWS_AS(read.read(filename),std::runtime_error);
+        //not a checkpoint
+        {
+            std::ofstream out(filename.c_str(), std::ios::trunc);
+            out << "!number_of_monomers=5\n";
+        }
+        REQUIRE_THROWS_AS(read.read(filename),std::runtime_error);
+        REQUIRE(0==remove(filename.c_str()));
+        REQUIRE_THROWS_AS(read.read(filename),std::runtime_error);
+    }
+
+    SECTION(" A checkpoint of another network is rejected ","[ForceEquilibriumCheckpoint]")
+    {
+        IngredientsType ingredients;
+        setupTheta(ingredients);
+        ingredients.synchronize(ingredients);
+        ForceEquilibriumCheckpoint checkpoint;
+        checkpoint.store(ingredients,ingredients.getCrosslinkIDs());
+
+        //same number of monomers, one chain less between the crosslinks
+        IngredientsType other;
+        setupTheta(other);
+        other.modifyMolecules().disconnect(2,4);
+        other.synchronize(other);
+        REQUIRE(ForceEquilibriumCheckpoint::computeTopologyHash(other,other.getCrosslinkIDs())
+             != ForceEquilibriumCheckpoint::computeTopologyHash(ingredients,ingredients.getCrosslinkIDs()));
+        REQUIRE_THROWS_AS(checkpoint.restore(other),std::runtime_error);
+        REQUIRE(other.getMolecules()[4].getVector3D()==VectorDouble3(12.,9.,9.));
+
+        //more monomers
+        IngredientsType larger;
+        setupTheta(larger);
+        larger.modifyMolecules().addMonomer(1.,1.,1.);
+        larger.synchronize(larger);
+        REQUIRE_THROWS_AS(checkpoint.restore(larger),std::runtime_error);
+
+        REQUIRE_NOTHROW(checkpoint.restore(ingredients));
+    }
+    //restore cout 
+    std::cout.rdbuf(originalBuffer);
+}
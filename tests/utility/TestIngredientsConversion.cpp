@@ -0,0 +1,106 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <exception>
+
+#include <LeMonADE/core/Molecules.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureBox.h>
+#include <LeMonADE/feature/FeatureMoleculesIOUnsaveCheck.h>
+#include <LeMonADE/feature/FeatureReactiveBonds.h>
+
+#include <LeMonADE/utility/Vector3D.h>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/utility/IngredientsConversion.h>
+#include <LeMonADE_PM/feature/FeatureCrosslinkConnectionsLookUp.h>
+
+TEST_CASE( "Test IngredientsConversion" ) 
+{
+    typedef LOKI_TYPELIST_2(FeatureMoleculesIOUnsaveCheck, FeatureReactiveBonds) Features;
+    typedef ConfigureSystem<VectorInt3,Features,4> Config;
+    typedef Ingredients<Config> IngredientsType;
+
+    typedef LOKI_TYPELIST_2(FeatureBox, FeatureCrosslinkConnectionsLookUp) Features2;
+    typedef ConfigureSystem<VectorDouble3,Features2,4> Config2;
+    typedef Ingredients<Config2> IngredientsType2;
+
+    std::streambuf* originalBuffer;
+    std::ostringstream tempStream;
+    //redirect stdout 
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+
+    SECTION(" Test copy of box, positions, reactivity and bonds ","[IngredientsConversion]")
+    {
+        IngredientsType ingredients;
+        ingredients.setBoxX(16);
+        ingredients.setBoxY(32);
+        ingredients.setBoxZ(64);
+        ingredients.setPeriodicX(1);
+        ingredients.setPeriodicY(0);
+        ingredients.setPeriodicZ(1);
+        ingredients.modifyBondset().addBFMclassicBondset();
+        ingredients.modifyMolecules().addMonomer(2,2,2);
+        ingredients.modifyMolecules().addMonomer(4,2,2);
+        ingredients.modifyMolecules().addMonomer(6,2,2);
+        ingredients.modifyMolecules().addMonomer(4,4,2);
+        ingredients.modifyMolecules()[1].setReactive(true);
+        ingredients.modifyMolecules()[1].setNumMaxLinks(3);
+        ingredients.modifyMolecules().connect(0,1);
+        ingredients.modifyMolecules().connect(2,1);
+        ingredients.modifyMolecules().connect(1,3);
+        ingredients.modifyMolecules().setAge(1234);
+
+        IngredientsType2 ingredients2;
+        IngredientsConversion::copy(ingredients,ingredients2);
+
+        REQUIRE(ingredients2.getBoxX() == 16);
+        REQUIRE(ingredients2.getBoxY() == 32);
+        REQUIRE(ingredients2.getBoxZ() == 64);
+        REQUIRE(ingredients2.isPeriodicX() == true);
+        REQUIRE(ingredients2.isPeriodicY() == false);
+        REQUIRE(ingredients2.isPeriodicZ() == true);
+        REQUIRE(ingredients2.getMolecules().size() == 4);
+        REQUIRE(ingredients2.getMolecules().getAge() == 1234);
+        for (uint32_t i = 0 ; i < 4 ; i++){
+            REQUIRE(ingredients2.getMolecules()[i].getVector3D() == VectorDouble3(ingredients.getMolecules()[i].getVector3D()));
+            REQUIRE(ingredients2.getMolecules()[i].isReactive() == ingredients.getMolecules()[i].isReactive());
+            REQUIRE(ingredients2.getMolecules()[i].getNumMaxLinks() == ingredients.getMolecules()[i].getNumMaxLinks());
+            REQUIRE(ingredients2.getMolecules().getNumLinks(i) == ingredients.getMolecules().getNumLinks(i));
+        }
+        REQUIRE(ingredients2.getMolecules().areConnected(0,1));
+        REQUIRE(ingredients2.getMolecules().areConnected(1,2));
+        REQUIRE(ingredients2.getMolecules().areConnected(1,3));
+        REQUIRE(!ingredients2.getMolecules().areConnected(0,2));
+    }
+    //restore cout 
+    std::cout.rdbuf(originalBuffer);
+}
@@ -0,0 +1,168 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <LeMonADE/core/Molecules.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureBox.h>
+#include <LeMonADE/utility/Vector3D.h>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/feature/FeatureFixedMonomers.h>
+#include <LeMonADE_PM/utility/MonomerReordering.h>
+
+namespace {
+  typedef std::vector<double> Coordinates;
+  typedef std::set< std::pair<Coordinates,Coordinates> > BondSet;
+  //! bonds as pairs of positions, which do not depend on the numbering
+  template<class MoleculesType>
+  BondSet bondPositions(const MoleculesType& molecules){
+    BondSet bonds;
+    for(uint32_t i=0; i<molecules.size(); i++)
+      for(uint32_t j=0; j<molecules.getNumLinks(i); j++){
+        const VectorDouble3& a(molecules[i].getVector3D());
+        const VectorDouble3& b(molecules[molecules.getNeighborIdx(i,j)].getVector3D());
+        Coordinates ca={a.getX(),a.getY(),a.getZ()}, cb={b.getX(),b.getY(),b.getZ()};
+        bonds.insert( ca < cb ? std::make_pair(ca,cb) : std::make_pair(cb,ca) );
+      }
+    return bonds;
+  }
+}
+
+TEST_CASE( "Test MonomerReordering" ) 
+{
+    typedef LOKI_TYPELIST_2(FeatureBox, FeatureFixedMonomers) Features;
+    typedef ConfigureSystem<VectorDouble3,Features,4> Config;
+    typedef Ingredients<Config> IngredientsType;
+
+    std::streambuf* originalBuffer;
+    std::ostringstream tempStream;
+    //redirect stdout 
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+
+    SECTION(" Branches of a star are stored in blocks ","[MonomerReordering]")
+    {
+        //core 0, three branches of three monomers along x,y,z, numbered alternately
+        IngredientsType ingredients;
+        ingredients.modifyMolecules().resize(10);
+        ingredients.modifyMolecules()[0].modifyVector3D()=VectorDouble3(0,0,0);
+        for(uint32_t k=0; k<3; k++)
+          for(uint32_t b=0; b<3; b++){
+            uint32_t idx(1+3*k+b);
+            double pos[3]={0,0,0};
+            pos[b]=2.*(k+1);
+            ingredients.modifyMolecules()[idx].modifyVector3D()=VectorDouble3(pos[0],pos[1],pos[2]);
+            ingredients.modifyMolecules()[idx].setMovableTag(k!=2);
+            ingredients.modifyMolecules().connect(idx, k==0 ? 0 : idx-3);
+          }
+        BondSet bonds(bondPositions(ingredients.getMolecules()));
+
+        std::vector<uint32_t> order(MonomerReordering::depthFirstOrder(ingredients.getMolecules()));
+        uint32_t expected[10]={0,1,4,7,2,5,8,3,6,9};
+        REQUIRE(order==std::vector<uint32_t>(expected,expected+10));
+        MonomerReordering::apply(ingredients.modifyMolecules(),order);
+
+        REQUIRE(ingredients.getMolecules().size()==10);
+        REQUIRE(ingredients.getMolecules()[0].getVector3D()==VectorDouble3(0,0,0));
+        for(uint32_t b=0; b<3; b++)
+          for(uint32_t k=0; k<3; k++){
+            uint32_t idx(1+3*b+k);
+            double pos[3]={0,0,0};
+            pos[b]=2.*(k+1);
+            REQUIRE(ingredients.getMolecules()[idx].getVector3D()==VectorDouble3(pos[0],pos[1],pos[2]));
+            REQUIRE(ingredients.getMolecules()[idx].getMovableTag()==(k!=2));
+            REQUIRE(ingredients.getMolecules().areConnected(idx, k==0 ? 0 : idx-1));
+          }
+        REQUIRE(bondPositions(ingredients.getMolecules())==bonds);
+        //the order is stable
+        order=MonomerReordering::depthFirstOrder(ingredients.getMolecules());
+        for(uint32_t i=0; i<10; i++)
+          REQUIRE(order[i]==i);
+    }
+
+    SECTION(" Random numbering of several chains ","[MonomerReordering]")
+    {
+        //50 chains of 20 monomers with shuffled indices
+        const uint32_t nChains(50), chainLength(20), nMonomers(nChains*chainLength);
+        std::vector<uint32_t> index(nMonomers);
+        for(uint32_t i=0; i<nMonomers; i++) index[i]=i;
+        std::mt19937 rng(5);
+        std::shuffle(index.begin(),index.end(),rng);
+        IngredientsType ingredients;
+        ingredients.modifyMolecules().resize(nMonomers);
+        for(uint32_t c=0; c<nChains; c++)
+          for(uint32_t m=0; m<chainLength; m++){
+            uint32_t idx(index[c*chainLength+m]);
+            ingredients.modifyMolecules()[idx].modifyVector3D()=VectorDouble3(2.*m,2.*c,0);
+            ingredients.modifyMolecules()[idx].setMovableTag(m%3!=0);
+            if( m > 0 ) ingredients.modifyMolecules().connect(idx,index[c*chainLength+m-1]);
+          }
+        BondSet bonds(bondPositions(ingredients.getMolecules()));
+
+        MonomerReordering::apply(ingredients.modifyMolecules(),MonomerReordering::depthFirstOrder(ingredients.getMolecules()));
+
+        REQUIRE(bondPositions(ingredients.getMolecules())==bonds);
+        for(uint32_t i=0; i<nMonomers; i++){
+          const VectorDouble3& pos(ingredients.getMolecules()[i].getVector3D());
+          REQUIRE(ingredients.getMolecules()[i].getMovableTag()==(uint32_t(pos.getX()/2.+0.5)%3!=0));
+        }
+        //each chain is one block, which starts at its monomer with the lowest old index
+        for(uint32_t c=0; c<nChains; c++)
+          for(uint32_t m=0; m<chainLength; m++){
+            uint32_t idx(c*chainLength+m);
+            REQUIRE(ingredients.getMolecules()[idx].getVector3D().getY()==ingredients.getMolecules()[c*chainLength].getVector3D().getY());
+            for(uint32_t j=0; j<ingredients.getMolecules().getNumLinks(idx); j++)
+              REQUIRE(ingredients.getMolecules().getNeighborIdx(idx,j)/chainLength==c);
+          }
+    }
+
+    SECTION(" Invalid orders are rejected ","[MonomerReordering]")
+    {
+        IngredientsType ingredients;
+        ingredients.modifyMolecules().resize(3);
+        ingredients.modifyMolecules().connect(0,1);
+        REQUIRE_THROWS_AS(MonomerReordering::apply(ingredients.modifyMolecules(),std::vector<uint32_t>(2,0)), std::runtime_error);
+        uint32_t twice[3]={0,1,1};
+        REQUIRE_THROWS_AS(MonomerReordering::apply(ingredients.modifyMolecules(),std::vector<uint32_t>(twice,twice+3)), std::runtime_error);
+        uint32_t outside[3]={0,1,3};
+        REQUIRE_THROWS_AS(MonomerReordering::apply(ingredients.modifyMolecules(),std::vector<uint32_t>(outside,outside+3)), std::runtime_error);
+        REQUIRE(ingredients.getMolecules().areConnected(0,1));
+    }
+    //restore cout 
+    std::cout.rdbuf(originalBuffer);
+}
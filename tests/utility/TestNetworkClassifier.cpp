@@ -0,0 +1,229 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <exception>
+#include <vector>
+#include <map>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/utility/NetworkClassifier.h>
+
+namespace {
+  //! jump vector with the interface of VectorDouble3 used by NetworkClassifier::classify
+  struct Jump{
+    Jump(double x_, double y_, double z_):x(x_),y(y_),z(z_){}
+    double getX() const {return x;}
+    double getY() const {return y;}
+    double getZ() const {return z;}
+    double x,y,z;
+  };
+  struct Neighbor{
+    Neighbor(uint32_t ID_, Jump jump_):ID(ID_),jump(jump_){}
+    uint32_t ID;
+    Jump jump;
+  };
+  //! minimal crosslink lookup with the interface of FeatureCrosslinkConnectionsLookUp
+  struct LookUp{
+    uint32_t getBoxX() const {return 32;}
+    uint32_t getBoxY() const {return 32;}
+    uint32_t getBoxZ() const {return 32;}
+    const std::vector<uint32_t>& getCrosslinkIDs() const {return IDs;}
+    std::vector<Neighbor> getCrossLinkNeighborIDs(uint32_t ID) const {return neighbors.at(ID);}
+    void connect(uint32_t ID1, uint32_t ID2, Jump jump){
+      neighbors[ID1].push_back(Neighbor(ID2,jump));
+      neighbors[ID2].push_back(Neighbor(ID1,Jump(-jump.x,-jump.y,-jump.z)));
+    }
+    std::vector<uint32_t> IDs;
+    std::map<uint32_t, std::vector<Neighbor> > neighbors;
+  };
+  struct Monomer{
+    Monomer():attribute(-1){}
+    void setAttributeTag(int32_t attribute_){attribute=attribute_;}
+    int32_t attribute;
+  };
+  //! minimal tendomer system: the tendomers are followed by the crosslinks
+  struct TendomerSystem{
+    TendomerSystem(uint32_t nTendomers_, uint32_t nMonomersPerChain_, uint32_t nCrossLinks_)
+    :nTendomers(nTendomers_),nMonomersPerChain(nMonomersPerChain_),nCrossLinks(nCrossLinks_)
+    ,monomers(nTendomers*2*nMonomersPerChain+nCrossLinks),links(monomers.size()){}
+    uint32_t getNumTendomers() const {return nTendomers;}
+    uint32_t getNumMonomersPerChain() const {return nMonomersPerChain;}
+    uint32_t getNumCrossLinkers() const {return nCrossLinks;}
+    const TendomerSystem& getMolecules() const {return *this;}
+    TendomerSystem& modifyMolecules() {return *this;}
+    uint32_t getNumLinks(uint32_t ID) const {return links[ID].size();}
+    uint32_t getNeighborIdx(uint32_t ID, uint32_t n) const {return links[ID][n];}
+    Monomer& operator[](uint32_t ID){return monomers[ID];}
+    void connect(uint32_t ID1, uint32_t ID2){links[ID1].push_back(ID2); links[ID2].push_back(ID1);}
+    uint32_t nTendomers, nMonomersPerChain, nCrossLinks;
+    std::vector<Monomer> monomers;
+    std::vector<std::vector<uint32_t> > links;
+  };
+}
+
+TEST_CASE( "Test class NetworkClassifier" ) 
+{
+    SECTION(" Wrapping cycle with dangling ends and sol ","[NetworkClassifier]")
+    {
+        NetworkClassifier network;
+        for(uint32_t ID=10; ID<16; ID++) network.addCrossLink(ID);
+        //cycle of two strands between 10 and 11 wrapping the box in x
+        network.addStrand(10,11);
+        network.addStrand(11,10,1,0,0);
+        //dangling 11-12-13
+        network.addStrand(11,12);
+        network.addStrand(12,13);
+        //sol 14-15
+        network.addStrand(14,15);
+        REQUIRE_THROWS_AS(network.getCrossLinkTag(10), std::runtime_error);
+        network.classify();
+        REQUIRE(network.getNumBridges()==3);
+        REQUIRE(network.isGelPercolating());
+        REQUIRE(network.getNumGelCrossLinks()==4);
+        REQUIRE(network.getNumActiveCrossLinks()==2);
+        REQUIRE(network.getNumActiveStrands()==2);
+        REQUIRE(network.getNumActiveComponents()==1);
+        REQUIRE(network.getCrossLinkTag(10)==NetworkClassifier::ACTIVE);
+        REQUIRE(network.getCrossLinkTag(11)==NetworkClassifier::ACTIVE);
+        REQUIRE(network.getCrossLinkTag(12)==NetworkClassifier::GEL);
+        REQUIRE(network.getCrossLinkTag(13)==NetworkClassifier::GEL);
+        REQUIRE(network.getCrossLinkTag(14)==NetworkClassifier::SOL);
+        REQUIRE(network.getStrandTag(11,10)==NetworkClassifier::ACTIVE);
+        REQUIRE(network.getStrandTag(11,12)==NetworkClassifier::GEL);
+        REQUIRE(network.getStrandTag(13,12)==NetworkClassifier::GEL);
+        REQUIRE(network.getStrandTag(14,15)==NetworkClassifier::SOL);
+        REQUIRE(network.getStrandTag(10,13)==NetworkClassifier::SOL);
+        REQUIRE_THROWS_AS(network.getCrossLinkTag(16), std::runtime_error);
+        REQUIRE_THROWS_AS(network.addStrand(10,16), std::runtime_error);
+    }
+
+    SECTION(" Bridges between wrapping parts are active ","[NetworkClassifier]")
+    {
+        NetworkClassifier network;
+        for(uint32_t ID=0; ID<7; ID++) network.addCrossLink(ID);
+        //0-1 wraps in x, 3-4 wraps in y, connected by the bridges 1-2-3
+        network.addStrand(0,1);
+        network.addStrand(0,1,-1,0,0);
+        network.addStrand(1,2);
+        network.addStrand(2,3);
+        network.addStrand(3,4);
+        network.addStrand(4,3,0,1,0);
+        //closed loop at 0 and a loop of two parallel strands 5-6 hanging at 4
+        network.addStrand(0,0);
+        network.addStrand(4,5);
+        network.addStrand(5,6);
+        network.addStrand(6,5);
+        network.classify();
+        REQUIRE(network.getNumBridges()==3);
+        REQUIRE(network.getCrossLinkTag(2)==NetworkClassifier::ACTIVE);
+        REQUIRE(network.getStrandTag(1,2)==NetworkClassifier::ACTIVE);
+        REQUIRE(network.getStrandTag(3,2)==NetworkClassifier::ACTIVE);
+        REQUIRE(network.getStrandTag(0,0)==NetworkClassifier::GEL);
+        REQUIRE(network.getStrandTag(4,5)==NetworkClassifier::GEL);
+        REQUIRE(network.getStrandTag(5,6)==NetworkClassifier::GEL);
+        REQUIRE(network.getCrossLinkTag(5)==NetworkClassifier::GEL);
+        REQUIRE(network.getNumActiveCrossLinks()==5);
+        REQUIRE(network.getNumActiveStrands()==6);
+    }
+
+    SECTION(" Finite cluster is not active ","[NetworkClassifier]")
+    {
+        NetworkClassifier network;
+        for(uint32_t ID=0; ID<4; ID++) network.addCrossLink(ID);
+        network.addStrand(0,1);
+        network.addStrand(1,2);
+        network.addStrand(2,0);
+        network.classify();
+        REQUIRE(network.getNumBridges()==0);
+        REQUIRE_FALSE(network.isGelPercolating());
+        REQUIRE(network.getNumGelCrossLinks()==3);
+        REQUIRE(network.getNumActiveStrands()==0);
+        REQUIRE(network.getNumActiveComponents()==0);
+        REQUIRE(network.getCrossLinkTag(0)==NetworkClassifier::GEL);
+        REQUIRE(network.getCrossLinkTag(3)==NetworkClassifier::SOL);
+    }
+
+    SECTION(" Graph from the crosslink lookup ","[NetworkClassifier]")
+    {
+        LookUp lookUp;
+        for(uint32_t ID=20; ID<24; ID++){
+            lookUp.IDs.push_back(ID);
+            lookUp.neighbors[ID];
+        }
+        lookUp.connect(20,21,Jump(0,0,0));
+        lookUp.connect(21,20,Jump(0,0,32));
+        lookUp.connect(22,22,Jump(0,0,0));
+        lookUp.connect(21,23,Jump(0,0,0));
+        NetworkClassifier network;
+        network.classify(lookUp);
+        REQUIRE(network.getNumCrossLinks()==4);
+        REQUIRE(network.getNumStrands()==4);
+        REQUIRE(network.getStrandTag(20,21)==NetworkClassifier::ACTIVE);
+        REQUIRE(network.getStrandTag(21,23)==NetworkClassifier::GEL);
+        REQUIRE(network.getCrossLinkTag(22)==NetworkClassifier::SOL);
+        REQUIRE(network.getStrandTag(22,22)==NetworkClassifier::SOL);
+    }
+
+    SECTION(" Tags of the tendomers and their monomers ","[NetworkClassifier]")
+    {
+        //3 tendomers of 2 monomers (0-5) and 3 crosslinks (6-8): tendomer 0 is the
+        //wrapping cycle 6-7, tendomer 1 hangs on 7 and tendomer 2 and crosslink 8 are sol
+        TendomerSystem system(3,1,3);
+        system.connect(0,6);
+        system.connect(1,7);
+        system.connect(2,7);
+        NetworkClassifier network;
+        for(uint32_t ID=6; ID<9; ID++) network.addCrossLink(ID);
+        network.addStrand(6,7);
+        network.addStrand(7,6,0,1,0);
+        network.classify();
+        std::vector<uint32_t> tags(getTendomerTags(system,network));
+        REQUIRE(tags.size()==6);
+        REQUIRE(tags[0]==NetworkClassifier::ACTIVE);
+        REQUIRE(tags[1]==NetworkClassifier::ACTIVE);
+        REQUIRE(tags[2]==NetworkClassifier::SOL);
+        REQUIRE(tags[3]==NetworkClassifier::ACTIVE);
+        REQUIRE(tags[4]==NetworkClassifier::GEL);
+        REQUIRE(tags[5]==NetworkClassifier::SOL);
+
+        uint32_t nCrossLinks(0), nTendomers(0);
+        tagTendomerMonomers(system,tags,NetworkClassifier::ACTIVE,nCrossLinks,nTendomers);
+        REQUIRE(nCrossLinks==2);
+        REQUIRE(nTendomers==1);
+        const int32_t active[9]={1,1,0,0,0,0,1,1,0};
+        for(uint32_t ID=0; ID<9; ID++) REQUIRE(system[ID].attribute==active[ID]);
+
+        tagTendomerMonomers(system,tags,NetworkClassifier::GEL,nCrossLinks,nTendomers);
+        REQUIRE(nCrossLinks==2);
+        REQUIRE(nTendomers==2);
+        const int32_t gel[9]={1,1,1,1,0,0,1,1,0};
+        for(uint32_t ID=0; ID<9; ID++) REQUIRE(system[ID].attribute==gel[ID]);
+    }
+}
@@ -0,0 +1,110 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <exception>
+
+#include <LeMonADE/core/Molecules.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureBox.h>
+
+#include <LeMonADE/utility/Vector3D.h>
+#include <LeMonADE/feature/FeatureSystemInformationLinearMeltWithCrosslinker.h>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/feature/FeatureCrosslinkConnectionsLookUp.h>
+#include <LeMonADE_PM/utility/NetworkConversion.h>
+
+TEST_CASE( "Test NetworkConversion" ) 
+{
+    typedef LOKI_TYPELIST_3(FeatureBox, FeatureCrosslinkConnectionsLookUp,FeatureSystemInformationLinearMeltWithCrosslinker ) Features;
+    typedef ConfigureSystem<VectorDouble3,Features,7> Config;
+    typedef Ingredients<Config> IngredientsType;
+
+    std::streambuf* originalBuffer;
+    std::ostringstream tempStream;
+    //redirect stdout 
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+
+    //setup system: crosslink 0 (f=4) is bonded to the crosslinks 1 and 2 (f=3)
+    //and irreversibly to the non-reactive monomer 3
+    IngredientsType ingredients;
+    ingredients.setBoxX(16);
+    ingredients.setBoxY(16);
+    ingredients.setBoxZ(16);
+    ingredients.setPeriodicX(1);
+    ingredients.setPeriodicY(1);
+    ingredients.setPeriodicZ(1);
+    ingredients.modifyMolecules().addMonomer(4.,4.,4.);
+    ingredients.modifyMolecules().addMonomer(6.,4.,4.);
+    ingredients.modifyMolecules().addMonomer(2.,4.,4.);
+    ingredients.modifyMolecules().addMonomer(4.,6.,4.);
+    ingredients.modifyMolecules()[0].setReactive(true);
+    ingredients.modifyMolecules()[0].setNumMaxLinks(4);
+    ingredients.modifyMolecules()[1].setReactive(true);
+    ingredients.modifyMolecules()[1].setNumMaxLinks(3);
+    ingredients.modifyMolecules()[2].setReactive(true);
+    ingredients.modifyMolecules()[2].setNumMaxLinks(3);
+
+    SECTION(" Check the conversion without bonds ","[NetworkConversion]")
+    {
+        REQUIRE_NOTHROW(ingredients.synchronize(ingredients));
+        NetworkConversion::Sites sites(NetworkConversion::countSites(ingredients));
+        REQUIRE(sites.reacted==0.);
+        REQUIRE(sites.reactive==10.);
+        REQUIRE(NetworkConversion::calculate(ingredients)==0.);
+    }
+
+    SECTION(" Check that irreversible bonds are no reactive sites ","[NetworkConversion]")
+    {
+        ingredients.modifyMolecules().connect(0,1);
+        ingredients.modifyMolecules().connect(0,2);
+        ingredients.modifyMolecules().connect(0,3);
+        REQUIRE_NOTHROW(ingredients.synchronize(ingredients));
+        NetworkConversion::Sites sites(NetworkConversion::countSites(ingredients));
+        REQUIRE(sites.reacted==4.);
+        REQUIRE(sites.reactive==9.);
+        REQUIRE(NetworkConversion::calculate(ingredients)==Approx(4./9.));
+    }
+
+    SECTION(" Check the conversion of a system without crosslinks ","[NetworkConversion]")
+    {
+        IngredientsType empty;
+        empty.setBoxX(16);
+        empty.setBoxY(16);
+        empty.setBoxZ(16);
+        empty.modifyMolecules().addMonomer(4.,4.,4.);
+        REQUIRE_NOTHROW(empty.synchronize(empty));
+        REQUIRE(NetworkConversion::countSites(empty).reactive==0.);
+        REQUIRE(NetworkConversion::calculate(empty)==0.);
+    }
+
+    //restore cout 
+    std::cout.rdbuf(originalBuffer);
+}
@@ -0,0 +1,137 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <exception>
+#include <vector>
+#include <map>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/utility/NetworkLaplacian.h>
+
+namespace {
+  struct Neighbor{
+    Neighbor(uint32_t ID_, uint32_t segDistance_):ID(ID_),segDistance(segDistance_){}
+    uint32_t ID;
+    uint32_t segDistance;
+  };
+  //! minimal crosslink lookup with the interface of FeatureCrosslinkConnectionsLookUp
+  struct LookUp{
+    const std::vector<uint32_t>& getCrosslinkIDs() const {return IDs;}
+    std::vector<Neighbor> getCrossLinkNeighborIDs(uint32_t ID) const {return neighbors.at(ID);}
+    void connect(uint32_t ID1, uint32_t ID2, uint32_t segments){
+      neighbors[ID1].push_back(Neighbor(ID2,segments));
+      neighbors[ID2].push_back(Neighbor(ID1,segments));
+    }
+    std::vector<uint32_t> IDs;
+    std::map<uint32_t, std::vector<Neighbor> > neighbors;
+  };
+}
+
+TEST_CASE( "Test class NetworkLaplacian" ) 
+{
+    //ring of ten crosslinks with one segment per strand
+    NetworkLaplacian ring;
+    const uint32_t n(10);
+    for(uint32_t ID=0; ID<n; ID++) ring.addCrossLink(ID);
+    for(uint32_t ID=0; ID<n; ID++) ring.addStrand(ID,(ID+1)%n,1);
+
+    SECTION(" Solve the pseudoinverse of the ring ","[NetworkLaplacian]")
+    {
+        std::vector<double> b(n,0.0), x;
+        b[0]=1.0; b[5]=-1.0;
+        REQUIRE(ring.solve(b,x)>0);
+        REQUIRE(ring.getNumComponents()==1);
+        //two parallel paths of five strands
+        REQUIRE(x[0]-x[5]==Approx(2.5));
+        double sum(0.0);
+        for(uint32_t i=0; i<n; i++) sum+=x[i];
+        REQUIRE(sum==Approx(0.).margin(1e-10));
+        //a right hand side with non zero sum is projected first
+        b.assign(n,0.0); b[0]=1.0;
+        REQUIRE_NOTHROW(ring.solve(b,x));
+        REQUIRE(x[0]==Approx(double(n*n-1)/(12.*n)));
+        REQUIRE_THROWS_AS(ring.addStrand(0,10,1), std::runtime_error);
+        REQUIRE_THROWS_AS(ring.addStrand(0,1,0), std::runtime_error);
+    }
+
+    SECTION(" Estimate fluctuations of the ring ","[NetworkLaplacian]")
+    {
+        REQUIRE_THROWS_AS(ring.estimate(1), std::runtime_error);
+        ring.estimate(4000,42);
+        REQUIRE(ring.getNumStrands()==n);
+        double meanVariance(0.0), meanResistance(0.0);
+        for(uint32_t i=0; i<n; i++){
+            REQUIRE(ring.getVariance(i)==Approx(double(n*n-1)/(12.*n)).epsilon(0.1));
+            REQUIRE(ring.getVarianceError(i)>0.0);
+            REQUIRE(ring.getVarianceError(i)<0.05*ring.getVariance(i));
+            REQUIRE(ring.getResistance(i)==Approx(double(n-1)/n).epsilon(0.1));
+            meanVariance+=ring.getVariance(i)/n;
+            meanResistance+=ring.getResistance(i)/n;
+        }
+        REQUIRE(meanVariance==Approx(double(n*n-1)/(12.*n)).epsilon(0.03));
+        REQUIRE(meanResistance==Approx(double(n-1)/n).epsilon(0.03));
+        //the same seed gives the same estimate
+        std::vector<double> first(n);
+        for(uint32_t i=0; i<n; i++) first[i]=ring.getVariance(i);
+        ring.estimate(4000,42);
+        for(uint32_t i=0; i<n; i++)
+            REQUIRE(ring.getVariance(i)==Approx(first[i]));
+    }
+
+    SECTION(" Dangling strands, sol and self-loops from the lookup ","[NetworkLaplacian]")
+    {
+        LookUp lookup;
+        for(uint32_t ID=20; ID<26; ID++) lookup.IDs.push_back(ID);
+        //tree 20-21-22 with 2 and 3 segments, a closed loop at 22, sol 23-24, free 25
+        lookup.connect(20,21,2);
+        lookup.connect(21,22,3);
+        lookup.connect(22,22,4);
+        lookup.connect(23,24,5);
+        lookup.neighbors[25];
+        NetworkLaplacian network;
+        network.fill(lookup);
+        REQUIRE(network.getNumCrossLinks()==6);
+        REQUIRE(network.getNumStrands()==4);
+        network.estimate(16,7);
+        REQUIRE(network.getNumComponents()==3);
+        REQUIRE(network.getMaxIterations()>0);
+        //the strands of a tree fluctuate with all of their segments
+        for(uint32_t e=0; e<network.getNumStrands(); e++){
+            if( network.getStrandID1(e) == network.getStrandID2(e) )
+                REQUIRE(network.getResistance(e)==Approx(0.).margin(1e-10));
+            else
+                REQUIRE(network.getResistance(e)==Approx(network.getStrandSegments(e)).epsilon(1e-4));
+        }
+        //the sol dimer fluctuates around its center of mass
+        REQUIRE(network.getCrossLinkID(3)==23);
+        REQUIRE(network.getVariance(3)==Approx(5./4.).epsilon(1e-4));
+        REQUIRE(network.getVariance(5)==Approx(0.).margin(1e-10));
+    }
+}
@@ -0,0 +1,146 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <exception>
+#include <vector>
+#include <map>
+#include <sstream>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE/utility/Vector3D.h>
+#include <LeMonADE_PM/utility/NetworkReduction.h>
+
+namespace {
+  struct Monomer{
+    const VectorDouble3& getVector3D() const {return position;}
+    VectorDouble3& modifyVector3D(){return position;}
+    VectorDouble3 position;
+  };
+  //! crosslinks in a box of 10 with the lookup interface of FeatureCrosslinkConnectionsLookUp
+  struct MockLookUp{
+    MockLookUp(uint32_t n):molecules(n){for(uint32_t i=0;i<n;i++) crosslinkIDs.push_back(i);}
+    uint32_t getBoxX() const {return 10;}
+    uint32_t getBoxY() const {return 10;}
+    uint32_t getBoxZ() const {return 10;}
+    const std::vector<Monomer>& getMolecules() const {return molecules;}
+    std::vector<Monomer>& modifyMolecules(){return molecules;}
+    const std::vector<uint32_t>& getCrosslinkIDs() const {return crosslinkIDs;}
+    std::vector<neighborX> getCrossLinkNeighborIDs(uint32_t ID) const {return neighbors.at(ID);}
+    void reduceToBackbone(bool collapseSeries){reduction.reduce(*this,crosslinkIDs,neighbors,collapseSeries);}
+    void restoreFromBackbone(){reduction.restore(*this,crosslinkIDs,neighbors);}
+    //! strand with the extension R=r2-r1-jump seen from ID1
+    void connect(uint32_t ID1, uint32_t ID2, uint32_t N, VectorDouble3 jump){
+      neighbors[ID1].push_back(neighborX(ID2,N,jump));
+      neighbors[ID2].push_back(neighborX(ID1,N,VectorDouble3(0.,0.,0.)-jump));
+    }
+    //! gaussian force sum R/N on the crosslink
+    VectorDouble3 getForce(uint32_t ID) const {
+      VectorDouble3 force(0.,0.,0.);
+      const std::vector<neighborX>& list(neighbors.at(ID));
+      for(size_t j=0; j<list.size(); j++)
+        force+=(molecules[list[j].ID].getVector3D()-molecules[ID].getVector3D()-list[j].jump)/double(list[j].segDistance);
+      return force;
+    }
+    std::vector<Monomer> molecules;
+    std::vector<uint32_t> crosslinkIDs;
+    std::map<uint32_t,std::vector<neighborX> > neighbors;
+    NetworkReduction reduction;
+  };
+}
+
+TEST_CASE( "Test class NetworkReduction" ) 
+{
+    //redirect std::cout
+    std::streambuf* originalBuffer;
+    std::ostringstream tempStream;
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+
+    //ring 0-1-2 wrapping the box in x, dangling 3-4 at 2 and the sol cluster 5-6
+    MockLookUp lookUp(7);
+    lookUp.connect(0,1,1,VectorDouble3(0.,0.,0.));
+    lookUp.connect(1,2,1,VectorDouble3(0.,0.,0.));
+    lookUp.connect(2,0,1,VectorDouble3(10.,0.,0.));
+    lookUp.connect(2,3,5,VectorDouble3(0.,10.,0.));
+    lookUp.connect(3,4,2,VectorDouble3(0.,0.,0.));
+    lookUp.connect(5,6,1,VectorDouble3(0.,0.,0.));
+    for(uint32_t i=0; i<7; i++)
+        lookUp.modifyMolecules()[i].modifyVector3D()=VectorDouble3(1.*i,2.,3.);
+
+    SECTION(" Prune the dangling crosslinks and the sol ","[NetworkReduction]")
+    {
+        lookUp.reduceToBackbone(false);
+        REQUIRE(lookUp.reduction.isReduced());
+        REQUIRE(lookUp.reduction.getNumPruned()==3);
+        REQUIRE(lookUp.reduction.getNumCollapsed()==0);
+        REQUIRE(lookUp.getCrosslinkIDs().size()==3);
+        REQUIRE(lookUp.getCrossLinkNeighborIDs(2).size()==2);
+        REQUIRE_THROWS(lookUp.getCrossLinkNeighborIDs(3));
+        REQUIRE_THROWS_AS(lookUp.reduceToBackbone(false), std::runtime_error);
+        lookUp.restoreFromBackbone();
+        REQUIRE_FALSE(lookUp.reduction.isReduced());
+        REQUIRE(lookUp.getCrosslinkIDs().size()==7);
+        REQUIRE(lookUp.getCrossLinkNeighborIDs(2).size()==3);
+        //the dangling strands have no extension, the sol keeps its first crosslink
+        REQUIRE(lookUp.getMolecules()[3].getVector3D().getY()==Approx(12.));
+        REQUIRE(lookUp.getMolecules()[4].getVector3D().getX()==Approx(2.));
+        REQUIRE(lookUp.getMolecules()[4].getVector3D().getY()==Approx(12.));
+        REQUIRE(lookUp.getMolecules()[5].getVector3D().getX()==Approx(5.));
+        REQUIRE(lookUp.getMolecules()[6].getVector3D().getX()==Approx(5.));
+        for(uint32_t i=3; i<7; i++)
+            REQUIRE(lookUp.getForce(i).getLength()==Approx(0.).margin(1e-12));
+    }
+
+    SECTION(" Collapse the series crosslinks of the ring ","[NetworkReduction]")
+    {
+        lookUp.reduceToBackbone(true);
+        REQUIRE(lookUp.reduction.getNumPruned()==3);
+        REQUIRE(lookUp.reduction.getNumCollapsed()==2);
+        //only crosslink 2 with the ring as a self-loop of 3 segments remains
+        REQUIRE(lookUp.getCrosslinkIDs().size()==1);
+        REQUIRE(lookUp.getCrosslinkIDs()[0]==2);
+        std::vector<neighborX> loop(lookUp.getCrossLinkNeighborIDs(2));
+        REQUIRE(loop.size()==2);
+        REQUIRE(loop[0].ID==2);
+        REQUIRE(loop[0].segDistance==3);
+        REQUIRE(std::abs(loop[0].jump.getX())==Approx(10.));
+        REQUIRE((loop[0].jump+loop[1].jump).getLength()==Approx(0.));
+        lookUp.restoreFromBackbone();
+        //the ring is divided into three equal strands
+        REQUIRE(lookUp.getMolecules()[1].getVector3D().getX()==Approx(2.+10./3.));
+        REQUIRE(lookUp.getMolecules()[0].getVector3D().getX()==Approx(2.+20./3.));
+        REQUIRE(lookUp.getMolecules()[0].getVector3D().getY()==Approx(2.));
+        for(uint32_t i=0; i<7; i++)
+            REQUIRE(lookUp.getForce(i).getLength()==Approx(0.).margin(1e-12));
+    }
+
+    //restore cout
+    std::cout.rdbuf(originalBuffer);
+}
@@ -0,0 +1,140 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <stdexcept>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <LeMonADE/core/Molecules.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureBox.h>
+#include <LeMonADE/utility/Vector3D.h>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/feature/FeatureFixedMonomers.h>
+#include <LeMonADE_PM/utility/PhantomReferenceBuilder.h>
+
+namespace {
+  //! true if the bond between a and b is a bond vector of the builder
+  template<class MoleculesType>
+  bool isBond(const MoleculesType& molecules, uint32_t a, uint32_t b, const std::set<std::vector<double> >& bonds){
+    const VectorDouble3 bond(molecules[b].getVector3D()-molecules[a].getVector3D());
+    return molecules.areConnected(a,b) && bonds.count(std::vector<double>({bond.getX(),bond.getY(),bond.getZ()})) == 1;
+  }
+}
+
+TEST_CASE( "Test class PhantomReferenceBuilder" ) 
+{
+    typedef LOKI_TYPELIST_2(FeatureBox, FeatureFixedMonomers) Features;
+    typedef ConfigureSystem<VectorDouble3,Features,7> Config;
+    typedef Ingredients<Config> IngredientsType;
+
+    PhantomReferenceBuilder builder;
+    std::set<std::vector<double> > bonds;
+    for(size_t i=0; i<builder.getBondVectors().size(); i++){
+        const VectorDouble3& b(builder.getBondVectors()[i]);
+        bonds.insert(std::vector<double>({b.getX(),b.getY(),b.getZ()}));
+    }
+
+    SECTION(" The bond vectors are the classic BFM bond set ","[PhantomReferenceBuilder]")
+    {
+        REQUIRE(builder.getBondVectors().size()==108);
+        REQUIRE(bonds.size()==108);
+        std::set<double> lengths;
+        for(size_t i=0; i<builder.getBondVectors().size(); i++)
+            lengths.insert(builder.getBondVectors()[i]*builder.getBondVectors()[i]);
+        REQUIRE(lengths==std::set<double>({4.,5.,6.,9.,10.}));
+    }
+
+    SECTION(" A star is a core with linear branches ","[PhantomReferenceBuilder]")
+    {
+        IngredientsType ing;
+        ing.setBoxX(32); ing.setBoxY(32); ing.setBoxZ(32);
+        ing.setPeriodicX(1); ing.setPeriodicY(1); ing.setPeriodicZ(1);
+        ing.modifyMolecules().addMonomer(1,1,1);
+        std::mt19937 rng(1);
+        const uint32_t nBranches(4), nMono(7);
+        REQUIRE(builder.addStar(ing,nMono,nBranches,rng)==1);
+        const auto& molecules(ing.getMolecules());
+        REQUIRE(molecules.size()==2+nBranches*nMono);
+        REQUIRE(molecules.getNumLinks(0)==0);
+        REQUIRE(molecules.getNumLinks(1)==nBranches);
+        for(uint32_t j=0; j<nBranches; j++){
+            const uint32_t first(2+j*nMono);
+            REQUIRE(isBond(molecules,1,first,bonds));
+            for(uint32_t b=1; b<nMono; b++)
+                REQUIRE(isBond(molecules,first+b-1,first+b,bonds));
+            REQUIRE(molecules.getNumLinks(first+nMono-1)==1);
+            REQUIRE(molecules[first+nMono-1].getMovableTag());
+        }
+        //the same stream gives the same star
+        IngredientsType other;
+        other.setBoxX(32); other.setBoxY(32); other.setBoxZ(32);
+        other.modifyMolecules().addMonomer(1,1,1);
+        std::mt19937 rng2(1);
+        builder.addStar(other,nMono,nBranches,rng2);
+        for(uint32_t i=0; i<molecules.size(); i++)
+            REQUIRE(other.getMolecules()[i].getVector3D()==molecules[i].getVector3D());
+    }
+
+    SECTION(" A double star has fixed branch ends at both ends of the main chain ","[PhantomReferenceBuilder]")
+    {
+        IngredientsType ing;
+        ing.setBoxX(64); ing.setBoxY(64); ing.setBoxZ(64);
+        std::mt19937 rng(2);
+        const std::vector<uint32_t> branchLengths({3,1,4,2});
+        REQUIRE(builder.addTMDoubleStar(ing,5,branchLengths,rng)==0);
+        const auto& molecules(ing.getMolecules());
+        REQUIRE(molecules.size()==15);
+        for(uint32_t i=1; i<5; i++)
+            REQUIRE(isBond(molecules,i-1,i,bonds));
+        REQUIRE(molecules.getNumLinks(0)==3);
+        REQUIRE(molecules.getNumLinks(4)==3);
+        //branches 5-7 and 8 at monomer 0, 9-12 and 13-14 at monomer 4
+        REQUIRE(isBond(molecules,0,5,bonds));
+        REQUIRE(isBond(molecules,0,8,bonds));
+        REQUIRE(isBond(molecules,4,9,bonds));
+        REQUIRE(isBond(molecules,4,13,bonds));
+        uint32_t nFixed(0);
+        for(uint32_t i=0; i<molecules.size(); i++)
+            if( !molecules[i].getMovableTag() ) nFixed++;
+        REQUIRE(nFixed==4);
+        REQUIRE(!molecules[7].getMovableTag());
+        REQUIRE(!molecules[8].getMovableTag());
+        REQUIRE(!molecules[12].getMovableTag());
+        REQUIRE(!molecules[14].getMovableTag());
+
+        REQUIRE_THROWS_AS(builder.addTMDoubleStar(ing,0,branchLengths,rng), std::runtime_error);
+        REQUIRE_THROWS_AS(builder.addTMDoubleStar(ing,2,std::vector<uint32_t>({1,2,3}),rng), std::runtime_error);
+        REQUIRE_THROWS_AS(builder.addTMDoubleStar(ing,2,std::vector<uint32_t>({1,0}),rng), std::runtime_error);
+        REQUIRE(molecules.size()==15);
+    }
+}
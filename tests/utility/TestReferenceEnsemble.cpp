@@ -0,0 +1,165 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <fstream>
+#include <random>
+
+#include <LeMonADE/core/Molecules.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureBox.h>
+#include <LeMonADE/utility/Vector3D.h>
+#include <LeMonADE/feature/FeatureSystemInformationLinearMeltWithCrosslinker.h>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/feature/FeatureCrosslinkConnectionsLookUpIdealReference.h>
+#include <LeMonADE_PM/feature/FeatureFixedMonomers.h>
+#include <LeMonADE_PM/updater/moves/MoveForceEquilibrium.h>
+#include <LeMonADE_PM/utility/ReferenceEnsemble.h>
+
+namespace {
+  //! crosslink 0 and six fixed monomers at +-2 along the axes, which are shifted by up to jitter
+  template<class IngredientsType>
+  void buildStar(IngredientsType& ingredients, std::mt19937& rng, double jitter){
+    std::uniform_real_distribution<double> shift(-jitter,jitter);
+    std::uniform_real_distribution<double> start(-0.5,0.5);
+    ingredients.setBoxX(16);
+    ingredients.setBoxY(16);
+    ingredients.setBoxZ(16);
+    ingredients.setPeriodicX(1);
+    ingredients.setPeriodicY(1);
+    ingredients.setPeriodicZ(1);
+    //every fixed monomer ends a strand of one segment
+    ingredients.setNumOfMonomersPerChain(0);
+    ingredients.modifyMolecules().addMonomer(8.+start(rng),8.+start(rng),8.+start(rng));
+    const double arms[6][3]={{2,0,0},{-2,0,0},{0,2,0},{0,-2,0},{0,0,2},{0,0,-2}};
+    for(uint32_t i=0; i<6; i++){
+      ingredients.modifyMolecules().addMonomer(8.+arms[i][0]+shift(rng),8.+arms[i][1]+shift(rng),8.+arms[i][2]+shift(rng));
+      ingredients.modifyMolecules()[i+1].setMovableTag(false);
+    }
+  }
+}
+
+TEST_CASE( "Test class ReferenceEnsemble" ) 
+{
+    typedef LOKI_TYPELIST_4(FeatureBox, FeatureCrosslinkConnectionsLookUpIdealReference,FeatureSystemInformationLinearMeltWithCrosslinker,FeatureFixedMonomers ) Features;
+    typedef ConfigureSystem<VectorDouble3,Features,7> Config;
+    typedef Ingredients<Config> IngredientsType;
+    typedef ReferenceEnsemble<IngredientsType,MoveForceEquilibrium> Ensemble;
+
+    std::streambuf* originalBuffer;
+    std::ostringstream tempStream;
+    //redirect stdout 
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+
+    SECTION(" Strands of all realizations are collected ","[ReferenceEnsemble]")
+    {
+        Ensemble ensemble([](IngredientsType& ing, std::mt19937& rng){buildStar(ing,rng,0.0);}, MoveForceEquilibrium(), 1e-8);
+        ensemble.setNumThreads(3);
+        ensemble.setBinWidth(0.3);
+        REQUIRE_THROWS_AS(ensemble.setBinWidth(0.0), std::runtime_error);
+        REQUIRE_THROWS_AS(ensemble.write("EnsembleTest.dat"), std::runtime_error);
+        ensemble.run(10,42);
+        REQUIRE(ensemble.getNumRealizations()==10);
+        REQUIRE(ensemble.getNumStrands()==60);
+        REQUIRE(ensemble.getMeanSquaredLength()==Approx(4.0));
+        REQUIRE(ensemble.getMeanSquaredLengthPerSegment()==Approx(4.0));
+        for(uint32_t dim=0; dim<3; dim++)
+            REQUIRE(ensemble.getMeanSquaredComponent(dim)==Approx(4.0/3.0));
+        REQUIRE(ensemble.getHistogram().size()==7);
+        REQUIRE(ensemble.getHistogram()[6]==60);
+        ensemble.write("EnsembleTest.dat");
+        std::ifstream file("EnsembleTest.dat");
+        REQUIRE(file.good());
+    }
+
+    SECTION(" The result does not depend on the number of threads ","[ReferenceEnsemble]")
+    {
+        Ensemble::Builder builder([](IngredientsType& ing, std::mt19937& rng){buildStar(ing,rng,0.3);});
+        Ensemble serial(builder, MoveForceEquilibrium(), 1e-8);
+        serial.setNumThreads(1);
+        serial.run(12,7);
+        Ensemble parallel(builder, MoveForceEquilibrium(), 1e-8);
+        parallel.setNumThreads(4);
+        parallel.run(12,7);
+        REQUIRE(serial.getNumStrands()==72);
+        REQUIRE(serial.getMeanSquaredLength()==parallel.getMeanSquaredLength());
+        REQUIRE(serial.getMeanSquaredComponent(0)==parallel.getMeanSquaredComponent(0));
+        REQUIRE(serial.getHistogram()==parallel.getHistogram());
+        REQUIRE(serial.getMeanSquaredLength()!=Approx(4.0));
+        //another seed gives other realizations
+        parallel.run(12,8);
+        REQUIRE(serial.getMeanSquaredLength()!=parallel.getMeanSquaredLength());
+    }
+
+    SECTION(" The lanes give the equilibrium of the updater ","[ReferenceEnsemble]")
+    {
+        Ensemble::Builder builder([](IngredientsType& ing, std::mt19937& rng){buildStar(ing,rng,0.3);});
+        Ensemble updater(builder, MoveForceEquilibrium(), 1e-10);
+        updater.run(12,7);
+        Ensemble lanes(builder, MoveForceEquilibrium(), 1e-10);
+        REQUIRE(lanes.getNumLanes()==0);
+        lanes.setNumLanes(5);
+        lanes.setNumThreads(2);
+        lanes.run(12,7);
+        REQUIRE(lanes.getNumStrands()==72);
+        REQUIRE(lanes.getMeanSquaredLength()==Approx(updater.getMeanSquaredLength()).epsilon(1e-8));
+        for(uint32_t dim=0; dim<3; dim++)
+            REQUIRE(lanes.getMeanSquaredComponent(dim)==Approx(updater.getMeanSquaredComponent(dim)).epsilon(1e-8));
+        REQUIRE(lanes.getNumUnconverged()==0);
+        //lanes stopped after one sweep are counted, although the shift to the
+        //weighted mean already is the equilibrium of the star
+        lanes.setMaxSweeps(1);
+        lanes.run(12,7);
+        REQUIRE(lanes.getNumRealizations()==12);
+        REQUIRE(lanes.getNumUnconverged()==12);
+        //realizations with another graph cannot share the lanes
+        Ensemble mixed([](IngredientsType& ing, std::mt19937& rng){
+            buildStar(ing,rng,0.0);
+            if( rng() % 2 == 0 ) ing.modifyMolecules()[6].setMovableTag(true);
+        }, MoveForceEquilibrium(), 1e-8);
+        mixed.setNumLanes(8);
+        REQUIRE_THROWS_AS(mixed.run(8,1), std::runtime_error);
+    }
+
+    SECTION(" Errors of a realization are rethrown ","[ReferenceEnsemble]")
+    {
+        Ensemble ensemble([](IngredientsType& ing, std::mt19937& rng){
+            buildStar(ing,rng,0.0);
+            if( rng() % 2 == 0 ) throw std::runtime_error("builder failed");
+        }, MoveForceEquilibrium(), 1e-8);
+        REQUIRE_THROWS_AS(ensemble.run(20,1), std::runtime_error);
+        REQUIRE(std::cout.rdbuf()==tempStream.rdbuf());
+    }
+    //restore cout 
+    std::cout.rdbuf(originalBuffer);
+}
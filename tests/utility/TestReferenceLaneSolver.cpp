@@ -0,0 +1,190 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/utility/ReferenceLaneSolver.h>
+
+namespace {
+//! double star: crosslinks 0 and 1 connected by a strand and a loop, four fixed ends each, returns the segments per lane
+std::vector< std::vector<double> > buildDoubleStar(ReferenceLaneSolver& lanes, std::mt19937& rng)
+{
+    std::vector< std::vector<double> > N(lanes.getNumLanes());
+    std::uniform_real_distribution<double> position(-4.0,4.0);
+    std::uniform_int_distribution<int> segments(1,8);
+    lanes.addNode(true);
+    lanes.addNode(true);
+    for(uint32_t i=0; i<8; i++){
+        const uint32_t end(lanes.addNode(false));
+        lanes.addStrand(i/4,end);
+    }
+    lanes.addStrand(0,1);
+    lanes.addStrand(1,1);
+    for(uint32_t l=0; l<lanes.getNumLanes(); l++){
+        for(uint32_t n=0; n<lanes.getNumNodes(); n++)
+            lanes.setPosition(n,l,position(rng),position(rng),position(rng));
+        for(uint32_t e=0; e<lanes.getNumStrands(); e++){
+            N[l].push_back(segments(rng));
+            lanes.setStrand(e,l,N[l][e],(e==8)?16.:0.,0.,(e==9)?16.:0.);
+        }
+    }
+    return N;
+}
+//! exact equilibrium of crosslink 0 of buildDoubleStar for gaussian strands in lane l
+double exactX0(const ReferenceLaneSolver& lanes, const std::vector<double>& N, uint32_t l)
+{
+    //solve the 2x2 system of the weighted means along x
+    double a00(0.), a11(0.), b0(0.), b1(0.);
+    for(uint32_t e=0; e<8; e++){
+        const double w(1./N[e]);
+        if( e < 4 ){ a00+=w; b0+=w*lanes.getX(2+e,l); }
+        else       { a11+=w; b1+=w*lanes.getX(2+e,l); }
+    }
+    const double w(1./N[8]);
+    a00+=w; a11+=w; b0-=w*16.; b1+=w*16.;
+    return (b0*a11+w*b1)/(a00*a11-w*w);
+}
+}
+
+TEST_CASE( "Test class ReferenceLaneSolver" ) 
+{
+    SECTION(" Gaussian strands converge to the weighted mean in every lane ","[ReferenceLaneSolver]")
+    {
+        std::mt19937 rng(5);
+        ReferenceLaneSolver lanes(7);
+        REQUIRE(lanes.getNumLanes()==7);
+        REQUIRE(lanes.getStride()==8);
+        const std::vector< std::vector<double> > N(buildDoubleStar(lanes,rng));
+        const ReferenceLaneSolver copy(lanes);
+        REQUIRE(lanes.relax(1e-12)>1);
+        for(uint32_t l=0; l<7; l++){
+            REQUIRE(lanes.getX(0,l)==Approx(exactX0(copy,N[l],l)).epsilon(1e-9));
+            REQUIRE(lanes.getShift(l)<=1e-12);
+            //fixed nodes do not move
+            REQUIRE(lanes.getX(5,l)==copy.getX(5,l));
+        }
+    }
+    SECTION(" The kernels agree ","[ReferenceLaneSolver]")
+    {
+        std::vector<double> table;
+        for(uint32_t i=0; i<42; i++) table.push_back(0.2*i+0.01*i*i);
+        for(int tabulated=0; tabulated<2; tabulated++){
+            std::mt19937 rngA(11), rngB(11);
+            ReferenceLaneSolver scalar(13), vector(13);
+            buildDoubleStar(scalar,rngA);
+            buildDoubleStar(vector,rngB);
+            if( tabulated ){
+                scalar.useForceExtensionTable(table,4.,10.,0.5);
+                vector.useForceExtensionTable(table,4.,10.,0.5);
+                scalar.setDecreaseFactor(0.95);
+                vector.setDecreaseFactor(0.95);
+            }
+            scalar.setInstructionSet(ReferenceLaneSolver::SCALAR);
+            REQUIRE(scalar.getInstructionSet()==ReferenceLaneSolver::SCALAR);
+            const uint32_t sweeps(scalar.relax(1e-8));
+            if( ReferenceLaneSolver::supportsAVX2() ){
+                vector.setInstructionSet(ReferenceLaneSolver::AVX2);
+                REQUIRE(vector.getInstructionSet()==ReferenceLaneSolver::AVX2);
+            }else{
+                vector.setInstructionSet(ReferenceLaneSolver::AVX2);
+                REQUIRE_THROWS_AS(vector.getInstructionSet(),std::runtime_error);
+                vector.setInstructionSet(ReferenceLaneSolver::AUTO);
+            }
+            REQUIRE(vector.relax(1e-8)==sweeps);
+            for(uint32_t l=0; l<13; l++)
+                for(uint32_t n=0; n<2; n++){
+                    REQUIRE(vector.getX(n,l)==Approx(scalar.getX(n,l)).epsilon(1e-12));
+                    REQUIRE(vector.getY(n,l)==Approx(scalar.getY(n,l)).epsilon(1e-12));
+                    REQUIRE(vector.getZ(n,l)==Approx(scalar.getZ(n,l)).epsilon(1e-12));
+                }
+        }
+    }
+    SECTION(" A linear force-extension curve has the equilibrium of equal gaussian strands ","[ReferenceLaneSolver]")
+    {
+        std::vector<double> table;
+        for(uint32_t i=0; i<102; i++) table.push_back(0.1*i);
+        ReferenceLaneSolver gaussian(5), tabulated(5);
+        std::mt19937 rng(3);
+        std::uniform_real_distribution<double> position(-3.0,3.0);
+        for(uint32_t n=0; n<7; n++){ gaussian.addNode(n==0); tabulated.addNode(n==0); }
+        for(uint32_t n=1; n<7; n++){ gaussian.addStrand(0,n); tabulated.addStrand(0,n); }
+        for(uint32_t l=0; l<5; l++){
+            for(uint32_t n=0; n<7; n++){
+                const double x(position(rng)), y(position(rng)), z(position(rng));
+                gaussian.setPosition(n,l,x,y,z);
+                tabulated.setPosition(n,l,x,y,z);
+            }
+            for(uint32_t e=0; e<6; e++){
+                gaussian.setStrand(e,l,3.,0.,0.,0.);
+                tabulated.setStrand(e,l,3.,0.,0.,0.);
+            }
+        }
+        tabulated.useForceExtensionTable(table,1.,100.,2.);
+        REQUIRE(gaussian.relax(1e-12)==2);
+        tabulated.relax(1e-10);
+        for(uint32_t l=0; l<5; l++){
+            REQUIRE(tabulated.getX(0,l)==Approx(gaussian.getX(0,l)).epsilon(1e-8));
+            REQUIRE(tabulated.getZ(0,l)==Approx(gaussian.getZ(0,l)).epsilon(1e-8));
+        }
+    }
+    SECTION(" Reaching the maximum number of sweeps is reported ","[ReferenceLaneSolver]")
+    {
+        std::mt19937 rng(5);
+        ReferenceLaneSolver lanes(3);
+        REQUIRE_FALSE(lanes.isConverged());
+        buildDoubleStar(lanes,rng);
+        REQUIRE(lanes.relax(1e-12,3)==3);
+        REQUIRE_FALSE(lanes.isConverged());
+        for(uint32_t l=0; l<3; l++)
+            REQUIRE_FALSE(lanes.isConverged(l));
+        REQUIRE(lanes.relax(1e-12)>1);
+        REQUIRE(lanes.isConverged());
+        for(uint32_t l=0; l<3; l++)
+            REQUIRE(lanes.isConverged(l));
+    }
+    SECTION(" Invalid input throws ","[ReferenceLaneSolver]")
+    {
+        REQUIRE_THROWS_AS(ReferenceLaneSolver(0),std::runtime_error);
+        ReferenceLaneSolver lanes(2);
+        lanes.addNode(true);
+        REQUIRE_THROWS_AS(lanes.addStrand(0,1),std::runtime_error);
+        lanes.addNode(false);
+        lanes.addStrand(0,1);
+        REQUIRE_THROWS_AS(lanes.setPosition(0,2,0.,0.,0.),std::runtime_error);
+        REQUIRE_THROWS_AS(lanes.setStrand(0,0,0.,0.,0.,0.),std::runtime_error);
+        REQUIRE_THROWS_AS(lanes.useForceExtensionTable(std::vector<double>(1,0.),1.,1.,1.),std::runtime_error);
+        lanes.clear();
+        REQUIRE(lanes.getNumNodes()==0);
+        REQUIRE(lanes.getNumStrands()==0);
+    }
+}
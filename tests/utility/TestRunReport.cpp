@@ -0,0 +1,122 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <limits>
+#include <vector>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/utility/RunReport.h>
+#include <LeMonADE_PM/utility/WorkerPool.h>
+
+TEST_CASE( "Test class RunReport" ) 
+{
+    SECTION(" Phases, counters, rates and series are collected ","[RunReport]")
+    {
+        RunReport report;
+        {
+            ScopedPhase phase("sweep",report);
+        }
+        report.addPhase("sweep",2.0);
+        report.addCount("moves",100);
+        report.addCount("moves",300);
+        report.addRate("movesPerSecond","moves","sweep");
+        report.addRate("missing","unknown","sweep");
+        report.addValue("residual",0.5);
+        report.addValue("residual",0.25);
+
+        REQUIRE(report.getPhase("sweep").calls==2);
+        REQUIRE(report.getPhase("sweep").seconds>=2.0);
+        REQUIRE(report.getPhase("sweep").maxSeconds==2.0);
+        REQUIRE(report.getPhase("unknown").calls==0);
+        REQUIRE(report.getCount("moves")==400);
+        REQUIRE(report.getSeries("residual")==std::vector<double>({0.5,0.25}));
+
+        std::string json(report.toJSON());
+        REQUIRE(json.find("\"sweep\": {\"calls\": 2")!=std::string::npos);
+        REQUIRE(json.find("\"moves\": 400")!=std::string::npos);
+        REQUIRE(json.find("\"movesPerSecond\": ")!=std::string::npos);
+        REQUIRE(json.find("\"missing\"")==std::string::npos);
+        REQUIRE(json.find("\"residual\": {\"dropped\": 0, \"values\": [0.5, 0.25]}")!=std::string::npos);
+
+        report.clear();
+        REQUIRE(report.getCount("moves")==0);
+        REQUIRE(report.toJSON().find("\"phases\": {},")!=std::string::npos);
+    }
+
+    SECTION(" Series are limited and JSON stays valid ","[RunReport]")
+    {
+        RunReport report;
+        report.setMaxSeriesLength(2);
+        for(uint32_t i=0; i<5; i++)
+            report.addValue("residual",i);
+        report.addValue("inf",std::numeric_limits<double>::infinity());
+        report.addPhase("quote\"d",1.0);
+        REQUIRE(report.getSeries("residual").size()==2);
+        std::string json(report.toJSON());
+        REQUIRE(json.find("\"dropped\": 3")!=std::string::npos);
+        REQUIRE(json.find("[null]")!=std::string::npos);
+        REQUIRE(json.find("\"quote\\\"d\"")!=std::string::npos);
+    }
+
+    SECTION(" The report is written by the destructor ","[RunReport]")
+    {
+        {
+            RunReport report;
+            report.setOutput("RunReportTest.json");
+            report.addCount("moves",1);
+        }
+        std::ifstream file("RunReportTest.json");
+        REQUIRE(file.good());
+        std::stringstream content;
+        content << file.rdbuf();
+        REQUIRE(content.str().find("\"moves\": 1")!=std::string::npos);
+        RunReport report;
+        REQUIRE_THROWS_AS(report.write("/nonexistent/RunReportTest.json"), std::runtime_error);
+    }
+
+    SECTION(" Threads may share a report ","[RunReport]")
+    {
+        RunReport report;
+        WorkerPool pool(4);
+        pool.run(100,[&](uint32_t task, uint32_t /*worker*/){
+            ScopedPhase phase("task",report);
+            report.addCount("tasks",1);
+            report.addValue("index",task);
+        });
+        REQUIRE(report.getPhase("task").calls==100);
+        REQUIRE(report.getCount("tasks")==100);
+        REQUIRE(report.getSeries("index").size()==100);
+    }
+}
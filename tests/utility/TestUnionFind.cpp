@@ -0,0 +1,131 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <exception>
+#include <vector>
+#include <map>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/utility/UnionFind.h>
+
+namespace {
+  //! minimal bond container with the interface of the LeMonADE molecules used by uniteBonds
+  struct BondList{
+    explicit BondList(uint32_t n):links(n){}
+    void connect(uint32_t i, uint32_t j){links[i].push_back(j); links[j].push_back(i);}
+    uint32_t size() const {return links.size();}
+    uint32_t getNumLinks(uint32_t i) const {return links[i].size();}
+    uint32_t getNeighborIdx(uint32_t i, uint32_t n) const {return links[i][n];}
+    std::vector< std::vector<uint32_t> > links;
+  };
+}
+
+TEST_CASE( "Test class UnionFind" ) 
+{
+    SECTION(" Unite single elements ","[UnionFind]")
+    {
+        UnionFind clusters(6);
+        REQUIRE(clusters.getNumClusters()==6);
+        REQUIRE(clusters.getLargestClusterSize()==1);
+        REQUIRE(clusters.unite(0,1));
+        REQUIRE(clusters.unite(1,2));
+        REQUIRE_FALSE(clusters.unite(0,2));
+        REQUIRE(clusters.unite(4,5));
+        REQUIRE(clusters.connected(0,2));
+        REQUIRE_FALSE(clusters.connected(2,3));
+        REQUIRE(clusters.getClusterSize(2)==3);
+        REQUIRE(clusters.getNumClusters()==3);
+        REQUIRE(clusters.getLargestClusterSize()==3);
+        //sizes 3,1,2
+        REQUIRE(clusters.getNumberAverage()==Approx(2.));
+        REQUIRE(clusters.getWeightAverage()==Approx(14./6.));
+        REQUIRE(clusters.getReducedWeightAverage()==Approx(5./3.));
+        REQUIRE(clusters.getLargestClusterFraction()==Approx(0.5));
+        std::map<uint32_t,uint32_t> distribution(clusters.getSizeDistribution());
+        REQUIRE(distribution.size()==3);
+        REQUIRE(distribution[1]==1);
+        REQUIRE(distribution[2]==1);
+        REQUIRE(distribution[3]==1);
+        REQUIRE(clusters.addElement()==6);
+        REQUIRE(clusters.getNumClusters()==4);
+    }
+
+    SECTION(" Unite the bonds of a molecules container ","[UnionFind]")
+    {
+        //100 chains of 10 monomers, every 10th chain is linked to the next one
+        BondList bonds(1000);
+        for(uint32_t c=0; c < 100; c++){
+            for(uint32_t i=0; i < 9; i++)
+                bonds.connect(10*c+i,10*c+i+1);
+            if( c%10 != 9 )
+                bonds.connect(10*c+9,10*(c+1));
+        }
+        //one large cluster over all 
+        bonds.connect(5,995);
+        bonds.connect(15,205);
+        UnionFind clusters;
+        clusters.uniteBonds(bonds);
+        REQUIRE(clusters.getNumElements()==1000);
+        //chains 0-9 and 90-99 and 20-29 are joined
+        REQUIRE(clusters.getNumClusters()==8);
+        REQUIRE(clusters.getLargestClusterSize()==300);
+        REQUIRE(clusters.connected(0,999));
+        REQUIRE(clusters.connected(0,250));
+        REQUIRE_FALSE(clusters.connected(0,350));
+        REQUIRE(clusters.getWeightAverage()==Approx((300.*300.+7*100.*100.)/1000.));
+        REQUIRE(clusters.getNumberAverage()==Approx(1000./8.));
+        //the result does not depend on the order of the bonds 
+        UnionFind serial(1000);
+        for(uint32_t i=0; i < 1000; i++)
+            for(uint32_t n=0; n < bonds.getNumLinks(i); n++)
+                serial.unite(i,bonds.getNeighborIdx(i,n));
+        REQUIRE(serial.getSizeDistribution()==clusters.getSizeDistribution());
+    }
+
+    SECTION(" Unite the bonds into a forest with merged sets ","[UnionFind]")
+    {
+        //100 chains of 10 monomers
+        BondList bonds(1000);
+        for(uint32_t c=0; c < 100; c++)
+            for(uint32_t i=0; i < 9; i++)
+                bonds.connect(10*c+i,10*c+i+1);
+        //sets merged before across the blocks of the threads
+        UnionFind clusters(1000);
+        REQUIRE(clusters.unite(5,505));
+        REQUIRE(clusters.unite(15,995));
+        clusters.uniteBonds(bonds);
+        REQUIRE(clusters.getNumClusters()==98);
+        REQUIRE(clusters.getLargestClusterSize()==20);
+        REQUIRE(clusters.connected(0,509));
+        REQUIRE(clusters.connected(10,990));
+        REQUIRE_FALSE(clusters.connected(0,10));
+        REQUIRE(clusters.getWeightAverage()==Approx((2*20.*20.+96*10.*10.)/1000.));
+    }
+}
@@ -0,0 +1,77 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2021 by 
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers
+    ooo                        | 
+----------------------------------------------------------------------------------
+This file is part of LeMonADE.
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+--------------------------------------------------------------------------------*/
+
+
+/*********************************************************************
+ * written by      : Toni Müller
+ * email           : mueller-toni@ipfdd.de
+ * subprojecttitle : Phantom modulus
+ *********************************************************************/
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <vector>
+#include <atomic>
+
+#include <extern/catch.hpp>
+
+#include <LeMonADE_PM/utility/WorkerPool.h>
+
+TEST_CASE( "Test class WorkerPool" ) 
+{
+    SECTION(" Every task runs once ","[WorkerPool]")
+    {
+        WorkerPool pool(4);
+        REQUIRE(pool.getNumThreads()==4);
+        std::vector<std::atomic<int> > counts(1000);
+        for(size_t i=0; i < counts.size(); i++) counts[i]=0;
+        std::vector<int> threadUsed(4,0);
+        pool.run(counts.size(),[&](uint32_t task, uint32_t thread){
+            counts[task]++;
+            if( thread >= 4 ) throw std::runtime_error("wrong thread index");
+        });
+        for(size_t i=0; i < counts.size(); i++)
+            REQUIRE(counts[i]==1);
+        //no tasks and a single thread
+        REQUIRE_NOTHROW(pool.run(0,[&](uint32_t, uint32_t){throw std::runtime_error("no task");}));
+        WorkerPool serial(1);
+        std::vector<uint32_t> order;
+        serial.run(5,[&](uint32_t task, uint32_t thread){order.push_back(task+10*thread);});
+        REQUIRE(order==std::vector<uint32_t>({0,1,2,3,4}));
+        REQUIRE(WorkerPool().getNumThreads()>0);
+    }
+
+    SECTION(" Exceptions are rethrown ","[WorkerPool]")
+    {
+        WorkerPool pool(3);
+        std::atomic<int> done(0);
+        REQUIRE_THROWS_AS(pool.run(100,[&](uint32_t task, uint32_t){
+            if( task == 7 ) throw std::runtime_error("task 7");
+            done++;
+        }), std::runtime_error);
+        REQUIRE(done < 100);
+        //the pool can be used again
+        done=0;
+        pool.run(10,[&](uint32_t, uint32_t){done++;});
+        REQUIRE(done==10);
+    }
+}